@@ -50,56 +50,165 @@ inline void bpt_copy_key(void *to, int index_to, void *from, int index_from, int
           size_of_key);
 }
 
-bpt_nd_t *bpt_nd_init(int size_of_key, int m)
+#define BPT_ALIGN(size, to) (((size) + (to) - 1) & ~((size_t) (to) - 1))
+#define BPT_CHUNK_SIZE (64 * 1024)
+
+static void bpt_pool_init(bpt_pool_t *pool, size_t item_size)
+{
+   memset(pool, 0, sizeof(bpt_pool_t));
+   pool->item_size = BPT_ALIGN(item_size, 16);
+   pool->items_per_chunk = BPT_CHUNK_SIZE / pool->item_size;
+   if (pool->items_per_chunk == 0) {
+      pool->items_per_chunk = 1;
+   }
+   pool->chunk_used = pool->items_per_chunk;
+}
+
+static void bpt_pool_clean(bpt_pool_t *pool)
+{
+   void *chunk, *next;
+   chunk = pool->chunks;
+   while (chunk != NULL) {
+      next = *(void **) chunk;
+      free(chunk);
+      chunk = next;
+   }
+   pool->chunks = NULL;
+   pool->free_list = NULL;
+   pool->chunk_used = pool->items_per_chunk;
+}
+
+void *bpt_pool_alloc(bpt_pool_t *pool)
+{
+   void *item;
+   if (pool->free_list != NULL) {
+      item = pool->free_list;
+      pool->free_list = *(void **) item;
+   } else {
+      if (pool->chunk_used == pool->items_per_chunk) {
+         //first 16 bytes of chunk keep the list of chunks and alignment of items
+         void *chunk = malloc(16 + pool->items_per_chunk * pool->item_size);
+         if (chunk == NULL) {
+            return (NULL);
+         }
+         *(void **) chunk = pool->chunks;
+         pool->chunks = chunk;
+         pool->chunk_used = 0;
+      }
+      item = (char *) pool->chunks + 16 + pool->chunk_used * pool->item_size;
+      pool->chunk_used++;
+   }
+   memset(item, 0, pool->item_size);
+   return item;
+}
+
+void bpt_pool_free(bpt_pool_t *pool, void *item)
+{
+   if (item == NULL) {
+      return;
+   }
+   *(void **) item = pool->free_list;
+   pool->free_list = item;
+}
+
+int bpt_alloc_init(bpt_t *btree)
+{
+   size_t keys;
+   keys = BPT_ALIGN((size_t) btree->size_of_key * btree->m, 16);
+   bpt_pool_init(&BPT_PRIV(btree)->alloc.leaf_pool, BPT_ALIGN(sizeof(bpt_nd_t), 16) +
+                 BPT_ALIGN(sizeof(bpt_nd_ext_leaf_t), 16) + keys +
+                 sizeof(void *) * btree->m);
+   bpt_pool_init(&BPT_PRIV(btree)->alloc.inner_pool, BPT_ALIGN(sizeof(bpt_nd_t), 16) +
+                 BPT_ALIGN(sizeof(bpt_nd_ext_inner_t), 16) + keys +
+                 sizeof(bpt_nd_t *) * (btree->m + 1));
+   bpt_pool_init(&BPT_PRIV(btree)->alloc.value_pool, btree->size_of_value > (int) sizeof(void *) ?
+                 (size_t) btree->size_of_value : sizeof(void *));
+   return 1;
+}
+
+void bpt_alloc_clean(bpt_t *btree)
+{
+   bpt_pool_clean(&BPT_PRIV(btree)->alloc.leaf_pool);
+   bpt_pool_clean(&BPT_PRIV(btree)->alloc.inner_pool);
+   bpt_pool_clean(&BPT_PRIV(btree)->alloc.value_pool);
+}
+
+bpt_nd_t *bpt_nd_init(bpt_t *btree, unsigned char state_extend)
 {
    bpt_nd_t *node = NULL;
-   node = (bpt_nd_t *) calloc(sizeof(bpt_nd_t), 1);
+   char *block;
+   size_t keys;
+   node = (bpt_nd_t *) bpt_pool_alloc(state_extend == EXTEND_LEAF ?
+                                      &BPT_PRIV(btree)->alloc.leaf_pool : &BPT_PRIV(btree)->alloc.inner_pool);
    if (node == NULL) {
       return node;
    }
-   node->key = (void *) calloc(size_of_key, m);
-   if (node->key == NULL) {
-      free(node);
-      return (NULL);
+   //header, extension, keys and pointers are in one block
+   block = (char *) node + BPT_ALIGN(sizeof(bpt_nd_t), 16);
+   node->extend = (void *) block;
+   keys = BPT_ALIGN((size_t) btree->size_of_key * btree->m, 16);
+   if (state_extend == EXTEND_LEAF) {
+      block += BPT_ALIGN(sizeof(bpt_nd_ext_leaf_t), 16);
+      ((bpt_nd_ext_leaf_t *) node->extend)->value = (void **) (block + keys);
+   } else {
+      block += BPT_ALIGN(sizeof(bpt_nd_ext_inner_t), 16);
+      ((bpt_nd_ext_inner_t *) node->extend)->child = (bpt_nd_t **) (block + keys);
    }
+   node->key = (void *) block;
+   node->state_extend = state_extend;
    node->count = 1;
    return node;
 }
 
-void bpt_nd_clean(bpt_nd_t *node)
+void bpt_nd_clean(bpt_nd_t *node, bpt_t *btree)
 {
    if (node == NULL) {
       return;
    }
-   if (node->key != NULL) {
-      free(node->key);
-      node->key = NULL;
+   bpt_pool_free(node->state_extend == EXTEND_LEAF ?
+                 &BPT_PRIV(btree)->alloc.leaf_pool : &BPT_PRIV(btree)->alloc.inner_pool, node);
+}
+
+int bpt_compare_uint32(void *key1, void *key2)
+{
+   uint32_t a, b;
+   memcpy(&a, key1, sizeof(a));
+   memcpy(&b, key2, sizeof(b));
+   if (a < b) {
+      return LESS;
+   } else if (a > b) {
+      return MORE;
    }
+   return EQUAL;
+}
 
-   if (node->state_extend == EXTEND_LEAF) {
-      //free leaf
-      bpt_nd_ext_leaf_t *leaf;
-      leaf = (bpt_nd_ext_leaf_t *) node->extend;
-      if (leaf != NULL) {
-         if (leaf->value != NULL) {
-            free(leaf->value);
-            leaf->value = NULL;
-         }
-         free(leaf);
-         leaf = NULL;
-      }
-   } else if (node->state_extend == EXTEND_INNER) {
-      //free inner
-      if (node->extend != NULL) {
-         if (((bpt_nd_ext_inner_t *) node->extend)->child != NULL) {
-            free(((bpt_nd_ext_inner_t *) node->extend)->child);
-            ((bpt_nd_ext_inner_t *) node->extend)->child = NULL;
-         }
-         free(node->extend);
-         node->extend = NULL;
+int bpt_compare_uint64(void *key1, void *key2)
+{
+   uint64_t a, b;
+   memcpy(&a, key1, sizeof(a));
+   memcpy(&b, key2, sizeof(b));
+   if (a < b) {
+      return LESS;
+   } else if (a > b) {
+      return MORE;
+   }
+   return EQUAL;
+}
+
+int bpt_nd_lower_bound(void *key, bpt_nd_t *node, bpt_t *btree)
+{
+   int low, high, mid;
+   low = 0;
+   high = node->count - 1;
+   while (low < high) {
+      mid = (low + high) / 2;
+      if (bpt_cmp(btree, (char *) (node->key) + (mid * btree->size_of_key), key) < 0) {
+         low = mid + 1;
+      } else {
+         high = mid;
       }
    }
-   free(node);
+   return low;
 }
 
 inline unsigned char bpt_nd_key(void *key, bpt_nd_t *node, bpt_t *btree)
@@ -110,10 +219,10 @@ inline unsigned char bpt_nd_key(void *key, bpt_nd_t *node, bpt_t *btree)
 int bpt_nd_index_key(void *key, bpt_nd_t *node, bpt_t *btree)
 {
    int i;
-   for (i = 0; i < node->count - 1; i++) {
-      if (btree->compare((char *) (node->key) + (i * btree->size_of_key), key) == 0) {
-         return i;
-      }
+   i = bpt_nd_lower_bound(key, node, btree);
+   if (i < node->count - 1 &&
+       bpt_cmp(btree, (char *) (node->key) + (i * btree->size_of_key), key) == 0) {
+      return i;
    }
    return (-1);
 }
@@ -133,28 +242,9 @@ inline void *bpt_nd_key_on_index(bpt_nd_t *node, int index, int size_of_key)
    return (char*) (node->key) + (index - 1) * size_of_key;
 }
 
-bpt_nd_t *bpt_ndlf_init(int m, int size_of_value, int size_of_key)
+bpt_nd_t *bpt_ndlf_init(bpt_t *btree)
 {
-   bpt_nd_t *node = NULL;
-   bpt_nd_ext_leaf_t *leaf = NULL;
-   node = bpt_nd_init(size_of_key, m);
-   if (node == NULL) {
-      return (NULL);
-   }
-   leaf = (bpt_nd_ext_leaf_t *) calloc(sizeof(bpt_nd_ext_leaf_t), 1);
-   if (leaf == NULL) {
-      bpt_nd_clean(node);
-      return (NULL);
-   }
-   leaf->value = (void *) calloc(sizeof(void *), m);
-   if (leaf->value == NULL) {
-      bpt_nd_clean(node);
-      free(leaf);
-      return (NULL);
-   }
-   node->extend = (void *) leaf;
-   node->state_extend = EXTEND_LEAF;
-   return node;
+   return bpt_nd_init(btree, EXTEND_LEAF);
 }
 
 inline void *bpt_ndlf_get_val(bpt_nd_ext_leaf_t *node, int index)
@@ -170,16 +260,18 @@ inline bpt_nd_t *bpt_ndlf_next(bpt_nd_t *node)
    return ((bpt_nd_ext_leaf_t *) node->extend)->right;
 }
 
-int bpt_ndlf_del_item(bpt_nd_t *node, int index, int size_of_key)
+int bpt_ndlf_del_item(bpt_nd_t *node, int index, bpt_t *btree)
 {
-   int i;
    bpt_nd_ext_leaf_t *leaf;
    leaf = (bpt_nd_ext_leaf_t *) node->extend;
-   free(leaf->value[index]);
+   bpt_pool_free(&BPT_PRIV(btree)->alloc.value_pool, leaf->value[index]);
    leaf->value[index] = NULL;
-   for (i = index; i < node->count - 2; ++i) {
-      bpt_copy_key(node->key, i, node->key, i + 1, size_of_key);
-      leaf->value[i] = leaf->value[i + 1];
+   if (index < node->count - 2) {
+      memmove((char *) (node->key) + index * btree->size_of_key,
+              (char *) (node->key) + (index + 1) * btree->size_of_key,
+              (node->count - 2 - index) * btree->size_of_key);
+      memmove(&leaf->value[index], &leaf->value[index + 1],
+              (node->count - 2 - index) * sizeof(void *));
    }
    node->count--;
    return node->count - 1;
@@ -190,29 +282,29 @@ int bpt_ndlf_insert(void *key, bpt_nd_t *node, bpt_t *btree,
 {
    //return value is index in leaf. If it returns -1, key is already in tree
    int i;
+   void *value;
    bpt_nd_ext_leaf_t *leaf;
    leaf = ((bpt_nd_ext_leaf_t *) node->extend);
-   //check if there is key or not
-   i = bpt_nd_index_key(key, node, btree);
-   if (i != -1) {
+   //find position of new item and check if there is key or not
+   i = bpt_nd_lower_bound(key, node, btree);
+   if (i < node->count - 1 &&
+       bpt_cmp(btree, (char *) (node->key) + (i * btree->size_of_key), key) == 0) {
       //key is already in leaf
       *return_value = leaf->value[i];
       return -1;
    }
-   //find position of new item
-   i = node->count - 2; //index of last item
-   while (i >= 0 && btree->compare((char *) (node->key) + (i * btree->size_of_key), key) > 0) {
-      //node->key[i + 1] = node->key[i];
-      memcpy((char*) (node->key) + (i + 1) * btree->size_of_key,
-             (char*) (node->key) + (i) * btree->size_of_key,
-             btree->size_of_key);
-      leaf->value[i + 1] = leaf->value[i];
-      i--;
-   }
-   leaf->value[++i] = (void *) calloc(btree->size_of_value, 1);
-   if (leaf->value[i] == NULL) {
+   value = bpt_pool_alloc(&BPT_PRIV(btree)->alloc.value_pool);
+   if (value == NULL) {
+      *return_value = NULL;
       return (-1);
    }
+   if (i < node->count - 1) {
+      memmove((char *) (node->key) + (i + 1) * btree->size_of_key,
+              (char *) (node->key) + i * btree->size_of_key,
+              (node->count - 1 - i) * btree->size_of_key);
+      memmove(&leaf->value[i + 1], &leaf->value[i], (node->count - 1 - i) * sizeof(void *));
+   }
+   leaf->value[i] = value;
    bpt_copy_key(node->key, i, key, 0, btree->size_of_key);
    node->count++;
 
@@ -220,24 +312,9 @@ int bpt_ndlf_insert(void *key, bpt_nd_t *node, bpt_t *btree,
    return i;
 }
 
-bpt_nd_t *bpt_ndin_init(int size_of_key, int m)
+bpt_nd_t *bpt_ndin_init(bpt_t *btree)
 {
-   bpt_nd_ext_inner_t *inner;
-   bpt_nd_t *node;
-   inner = (bpt_nd_ext_inner_t *) calloc(sizeof(bpt_nd_ext_inner_t), 1);
-   if (inner == NULL) {
-      return (NULL);
-   }
-   inner->child = (bpt_nd_t **) calloc(sizeof(bpt_nd_t *), m + 1);
-   if (inner->child == NULL) {
-      free(inner);
-      inner = NULL;
-      return (NULL);
-   }
-   node = bpt_nd_init(size_of_key, m);
-   node->extend = (void *) inner;
-   node->state_extend = EXTEND_INNER;
-   return node;
+   return bpt_nd_init(btree, EXTEND_INNER);
 }
 
 inline bpt_nd_t *bpt_ndin_child(bpt_nd_t *node, int index)
@@ -250,21 +327,22 @@ int bpt_ndin_insert(void *add, bpt_nd_t * left, bpt_nd_t * right, bpt_nd_t * nod
 {
    int i;
    bpt_nd_ext_inner_t *inner;
-   if (bpt_nd_key(add, node, btree)) {
+   inner = (bpt_nd_ext_inner_t *) node->extend;
+   i = bpt_nd_lower_bound(add, node, btree);
+   if (i < node->count - 1 &&
+       bpt_cmp(btree, (char *) (node->key) + i * btree->size_of_key, add) == 0) {
       return (-1);
    }
-
-   inner = (bpt_nd_ext_inner_t *) node->extend;
-   i = node->count - 2;
-   while (i >= 0 && btree->compare((char *) (node->key) + i * btree->size_of_key, add) > 0) {
-      //key[i + 1] = key[i];
-      bpt_copy_key(node->key, i + 1, node->key, i, btree->size_of_key);
-      inner->child[i + 2] = inner->child[i + 1];
-      i--;
+   if (i < node->count - 1) {
+      memmove((char *) (node->key) + (i + 1) * btree->size_of_key,
+              (char *) (node->key) + i * btree->size_of_key,
+              (node->count - 1 - i) * btree->size_of_key);
+      memmove(&inner->child[i + 2], &inner->child[i + 1],
+              (node->count - 1 - i) * sizeof(bpt_nd_t *));
    }
-   bpt_copy_key(node->key, i + 1, add, 0, btree->size_of_key);
-   inner->child[i + 2] = right;
-   inner->child[i + 1] = left;
+   bpt_copy_key(node->key, i, add, 0, btree->size_of_key);
+   inner->child[i + 1] = right;
+   inner->child[i] = left;
 
    node->count++;
    return node->count;
@@ -274,48 +352,157 @@ bpt_t *bpt_init(unsigned int size_of_btree_node, int (*comp)(void *, void *),
                                     unsigned int size_of_value, unsigned int size_of_key)
 {
    bpt_t *tree = NULL;
-   tree = (bpt_t *) calloc(sizeof(bpt_t), 1);
+   tree = (bpt_t *) calloc(sizeof(bpt_priv_t), 1);
    if (tree == NULL) {
       return (NULL);
    }
    tree->m = size_of_btree_node;
-   tree->root = bpt_ndlf_init(size_of_btree_node, size_of_value, size_of_key);
+   tree->compare = comp;
+   tree->size_of_value = size_of_value;
+   tree->size_of_key = size_of_key;
+   if (comp == bpt_compare_uint32 && size_of_key == sizeof(uint32_t)) {
+      BPT_PRIV(tree)->key_type = BPT_KEY_UINT32;
+   } else if (comp == bpt_compare_uint64 && size_of_key == sizeof(uint64_t)) {
+      BPT_PRIV(tree)->key_type = BPT_KEY_UINT64;
+   } else {
+      BPT_PRIV(tree)->key_type = BPT_KEY_CUSTOM;
+   }
+   if (!bpt_alloc_init(tree)) {
+      free(tree);
+      return (NULL);
+   }
+   tree->root = bpt_ndlf_init(tree);
    if (tree->root == NULL) {
+      bpt_alloc_clean(tree);
       free(tree);
       return (NULL);
    }
-   tree->compare = comp;
-   tree->size_of_value = size_of_value;
-   tree->size_of_key = size_of_key;
    return tree;
 }
 
 void bpt_clean(bpt_t *btree)
 {
-   bpt_del_all(btree->root);
+   //all nodes and values are in pools of the tree
+   bpt_alloc_clean(btree);
    free(btree);
 }
 
-void bpt_del_all(bpt_nd_t *del)
+int bpt_bulk_load(bpt_t *btree, void *keys, void *values, unsigned long int count)
 {
-   int i;
-   if (del->state_extend == EXTEND_LEAF) {
-      bpt_nd_ext_leaf_t *leaf = NULL;
-      leaf = (bpt_nd_ext_leaf_t *) del->extend;
-      for (i = 0; i < del->count - 1; i++) {
-         free(leaf->value[i]);
-         leaf->value[i] = NULL;
+   bpt_nd_t **level, **inners, *node, *prev, *head;
+   unsigned long int nodes, parents, i, j, first, per_node, extra, items, inner_cnt;
+   int size_of_key, k;
+   size_of_key = btree->size_of_key;
+   if (btree->count_of_values != 0 || btree->root->state_extend != EXTEND_LEAF) {
+      return 0;
+   }
+   for (i = 1; i < count; i++) {
+      if (bpt_cmp(btree, (char *) keys + (i - 1) * size_of_key,
+                  (char *) keys + i * size_of_key) >= 0) {
+         return 0;
       }
-      bpt_nd_clean(del);
-      return;
-   } else {
-      bpt_nd_ext_inner_t *inner;
-      inner = (bpt_nd_ext_inner_t *) del->extend;
-      for (i = 0; i < del->count; i++) {
-         bpt_del_all(inner->child[i]);
+   }
+   if (count == 0) {
+      return 1;
+   }
+   //leaves are filled up to m - 1 keys, so the next insert does not split them
+   per_node = btree->m > 2 ? btree->m - 1 : 1;
+   nodes = (count + per_node - 1) / per_node;
+   level = (bpt_nd_t **) calloc(sizeof(bpt_nd_t *), nodes);
+   //inner nodes are kept for cleanup, there is less of them than leaves
+   inners = (bpt_nd_t **) calloc(sizeof(bpt_nd_t *), nodes);
+   if (level == NULL || inners == NULL) {
+      free(level);
+      free(inners);
+      return 0;
+   }
+   inner_cnt = 0;
+   head = NULL;
+   //items are spread evenly, so every leaf has at least (m - 1) / 2 keys
+   first = 0;
+   prev = NULL;
+   for (i = 0; i < nodes; i++) {
+      bpt_nd_ext_leaf_t *leaf;
+      items = count / nodes + (i < count % nodes ? 1 : 0);
+      node = bpt_ndlf_init(btree);
+      if (node == NULL) {
+         goto error;
+      }
+      level[i] = node;
+      leaf = (bpt_nd_ext_leaf_t *) node->extend;
+      leaf->left = prev;
+      if (prev != NULL) {
+         ((bpt_nd_ext_leaf_t *) prev->extend)->right = node;
+      } else {
+         head = node;
       }
-      bpt_nd_clean(del);
+      prev = node;
+      memcpy(node->key, (char *) keys + first * size_of_key, items * size_of_key);
+      for (j = 0; j < items; j++) {
+         leaf->value[j] = bpt_pool_alloc(&BPT_PRIV(btree)->alloc.value_pool);
+         if (leaf->value[j] == NULL) {
+            goto error;
+         }
+         node->count++;
+         if (values != NULL) {
+            memcpy(leaf->value[j], (char *) values + (first + j) * btree->size_of_value,
+                   btree->size_of_value);
+         }
+      }
+      first += items;
+   }
+   //build inner levels, every child is separated by its highest key
+   while (nodes > 1) {
+      parents = (nodes + btree->m - 1) / btree->m;
+      first = 0;
+      for (i = 0; i < parents; i++) {
+         bpt_nd_ext_inner_t *inner;
+         bpt_nd_t *last;
+         extra = nodes / parents + (i < nodes % parents ? 1 : 0);
+         node = bpt_ndin_init(btree);
+         if (node == NULL) {
+            goto error;
+         }
+         inners[inner_cnt++] = node;
+         inner = (bpt_nd_ext_inner_t *) node->extend;
+         for (k = 0; k < (int) extra; k++) {
+            inner->child[k] = level[first + k];
+            inner->child[k]->parent = node;
+            if (k < (int) extra - 1) {
+               last = bpt_nd_rightmost_leaf(inner->child[k]);
+               bpt_copy_key(node->key, k, last->key, last->count - 2, size_of_key);
+            }
+         }
+         node->count = extra;
+         first += extra;
+         level[i] = node;
+      }
+      nodes = parents;
+   }
+   bpt_nd_clean(btree->root, btree);
+   btree->root = level[0];
+   btree->root->parent = NULL;
+   btree->count_of_values = count;
+   free(level);
+   free(inners);
+   return 1;
+
+error:
+   //release everything built so far, the tree stays empty
+   while (head != NULL) {
+      node = head;
+      head = ((bpt_nd_ext_leaf_t *) node->extend)->right;
+      for (k = 0; k < node->count - 1; k++) {
+         bpt_pool_free(&BPT_PRIV(btree)->alloc.value_pool, ((bpt_nd_ext_leaf_t *) node->extend)->value[k]);
+      }
+      bpt_nd_clean(node, btree);
+   }
+   for (i = 0; i < inner_cnt; i++) {
+      bpt_nd_clean(inners[i], btree);
    }
+   free(level);
+   free(inners);
+   return 0;
 }
 
 int bpt_search_leaf_and_index(void *key, bpt_nd_ext_leaf_t **val, bpt_t *btree)
@@ -356,7 +543,7 @@ void bpt_ndin_insert_to_new_node(void *key, bpt_nd_t *left, bpt_nd_t *right,
    par = left->parent;
    //parent does not exist, has to be created and added as a parent to his children
    if (par == NULL) {
-      par = bpt_ndin_init(btree->size_of_key, btree->m);
+      par = bpt_ndin_init(btree);
       bpt_ndin_insert(key, left, right, par, btree);
       left->parent = par;
       right->parent = par;
@@ -373,7 +560,7 @@ void bpt_ndin_insert_to_new_node(void *key, bpt_nd_t *left, bpt_nd_t *right,
    else {
       bpt_nd_t *right_par, *righest_node_in_left_node;
       int cut, insert, i;
-      right_par = bpt_ndin_init(btree->size_of_key, btree->m);
+      right_par = bpt_ndin_init(btree);
       cut = (par->count - 1) / 2;
       insert = 0;
       for (i = cut + 1; i < par->count - 1; i++) {
@@ -399,24 +586,11 @@ bpt_nd_t *bpt_search_leaf(void *key, bpt_t *btree)
    //find leaf where is key, or where to add key
    int i;
    bpt_nd_t *pos;
-   unsigned char go_right;
-   int result;
-   go_right = 0;
    pos = btree->root;
    while (pos->state_extend == EXTEND_INNER) {
-      bpt_nd_ext_inner_t *pos2 = (bpt_nd_ext_inner_t *) pos->extend;
-      go_right = 0;
-      for (i = 0; i < pos->count - 1; i++) {
-         result = btree->compare(key, (char *) (pos->key) + i * btree->size_of_key);
-         if ((result <= 0)) {
-            pos = pos2->child[i];
-            go_right = 1;
-            break;
-         }
-      }
-      if (!go_right) {
-         pos = pos2->child[pos->count - 1];
-      }
+      //first child whose highest key is not less than key, or the last child
+      i = bpt_nd_lower_bound(key, pos, btree);
+      pos = ((bpt_nd_ext_inner_t *) pos->extend)->child[i];
    }
    if (pos->state_extend == EXTEND_LEAF) {
       return pos;
@@ -455,7 +629,7 @@ void *bpt_search_or_insert_inner(void *key, bpt_t *btree, int search)
    //size is KO, we have to create new leaf and move half datas
    size--;        //real count of values, not just default size m;
    splitVal = size / 2;
-   r_node = bpt_ndlf_init(btree->m, btree->size_of_value, btree->size_of_key);
+   r_node = bpt_ndlf_init(btree);
    r_leaf = (bpt_nd_ext_leaf_t *) r_node->extend;
    insert = 0;
    //copy half datas to new leaf node
@@ -515,7 +689,7 @@ int bpt_ndlf_delete_from_tree(int index, bpt_nd_t *leaf_del,
    }
    btree->count_of_values--;
    parent_index = bpt_nd_index_in_parent(leaf_del);
-   size = bpt_ndlf_del_item(leaf_del, index, btree->size_of_key);
+   size = bpt_ndlf_del_item(leaf_del, index, btree);
    if (size >= ((btree->m - 1) / 2) || btree->root->state_extend == EXTEND_LEAF) {
       //size is ok, just check parents keys;
       bpt_nd_check(leaf_del, btree);
@@ -589,7 +763,7 @@ int bpt_ndlf_delete_from_tree(int index, bpt_nd_t *leaf_del,
          bpt_nd_check(brother, btree);
          bpt_ndin_check(brother->parent, btree);
          leaf_del->count = 0;
-         bpt_nd_clean(leaf_del);
+         bpt_nd_clean(leaf_del, btree);
       } else if (parent_index < leaf_del->parent->count - 1) {
          //merge with right brother
          brother = ((bpt_nd_ext_inner_t *) leaf_del->parent->extend)->child[parent_index + 1];
@@ -615,7 +789,7 @@ int bpt_ndlf_delete_from_tree(int index, bpt_nd_t *leaf_del,
          bpt_nd_check(leaf_del, btree);
          bpt_ndin_check(leaf_del->parent, btree);
          brother->count = 0;
-         bpt_nd_clean(brother);
+         bpt_nd_clean(brother, btree);
       }
    }
    return 1;
@@ -637,7 +811,7 @@ void bpt_ndin_check(bpt_nd_t *check, bpt_t *btree)
          btree->root = ((bpt_nd_ext_inner_t *) btree->root->extend)->child[0];
          btree->root->parent = NULL;
          check->count = 0;
-         bpt_nd_clean(check);
+         bpt_nd_clean(check, btree);
       }
       return;
    }
@@ -702,7 +876,7 @@ void bpt_ndin_check(bpt_nd_t *check, bpt_t *btree)
          bpt_nd_check(bpt_nd_rightmost_leaf(brother_inner->child[i]), btree);
       }
       check->count = 0;
-      bpt_nd_clean(check);
+      bpt_nd_clean(check, btree);
       bpt_ndin_check(brother->parent, btree);
       return;
    } else if (parent_index < check->parent->count - 1) {
@@ -731,7 +905,7 @@ void bpt_ndin_check(bpt_nd_t *check, bpt_t *btree)
          bpt_nd_check(bpt_nd_rightmost_leaf(check_inner->child[i]), btree);
       }
       brother->count = 0;
-      bpt_nd_clean(brother);
+      bpt_nd_clean(brother, btree);
       bpt_ndin_check(check->parent, btree);
       return;
    }
@@ -864,3 +1038,77 @@ int bpt_list_item_next(bpt_t *tree, bpt_list_item_t *item)
    return 0;
 }
 
+static int bpt_list_set(bpt_t *tree, bpt_list_item_t *item, bpt_nd_t *node, int index)
+{
+   //index can be behind the last key, then the item is the first one in the next leaf
+   while (node != NULL && index >= node->count - 1) {
+      node = bpt_ndlf_next(node);
+      index = 0;
+   }
+   if (node == NULL) {
+      return 0;
+   }
+   item->leaf = node;
+   item->index_of_value = index;
+   item->value = ((bpt_nd_ext_leaf_t *) node->extend)->value[index];
+   bpt_copy_key(item->key, 0, node->key, index, tree->size_of_key);
+   return 1;
+}
+
+int bpt_list_lower_bound(bpt_t *tree, bpt_list_item_t *item, void *key)
+{
+   bpt_nd_t *node;
+   node = bpt_search_leaf(key, tree);
+   if (node == NULL) {
+      return 0;
+   }
+   return bpt_list_set(tree, item, node, bpt_nd_lower_bound(key, node, tree));
+}
+
+int bpt_list_upper_bound(bpt_t *tree, bpt_list_item_t *item, void *key)
+{
+   bpt_nd_t *node;
+   int index;
+   node = bpt_search_leaf(key, tree);
+   if (node == NULL) {
+      return 0;
+   }
+   index = bpt_nd_lower_bound(key, node, tree);
+   if (index < node->count - 1 &&
+       bpt_cmp(tree, (char *) (node->key) + index * tree->size_of_key, key) == 0) {
+      index++;
+   }
+   return bpt_list_set(tree, item, node, index);
+}
+
+unsigned long int bpt_range_scan(bpt_t *tree, void *from, void *to,
+                                 int (*func)(void *key, void *value, void *arg), void *arg)
+{
+   bpt_nd_t *node;
+   bpt_nd_ext_leaf_t *leaf;
+   unsigned long int cnt = 0;
+   int index;
+   if (from != NULL) {
+      node = bpt_search_leaf(from, tree);
+      index = bpt_nd_lower_bound(from, node, tree);
+   } else {
+      node = bpt_nd_leftmost_leaf(tree->root);
+      index = 0;
+   }
+   while (node != NULL) {
+      leaf = (bpt_nd_ext_leaf_t *) node->extend;
+      for (; index < node->count - 1; index++) {
+         void *key = (char *) (node->key) + index * tree->size_of_key;
+         if (to != NULL && bpt_cmp(tree, key, to) > 0) {
+            return cnt;
+         }
+         cnt++;
+         if (func(key, leaf->value[index], arg) != 0) {
+            return cnt;
+         }
+      }
+      node = leaf->right;
+      index = 0;
+   }
+   return cnt;
+}
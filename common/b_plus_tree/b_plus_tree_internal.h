@@ -62,6 +62,17 @@
 #define EXTEND_INNER 0
  /* /} */
 
+/*!
+ * \name Types of keys
+ * Keys compared by bpt_compare_uint32() or bpt_compare_uint64() are
+ * recognized by bpt_init() and compared inline without calling the
+ * compare function.
+ * \{ */
+#define BPT_KEY_CUSTOM 0
+#define BPT_KEY_UINT32 1
+#define BPT_KEY_UINT64 2
+ /* /} */
+
 
 
 
@@ -85,6 +96,103 @@ typedef struct bpt_nd_ext_leaf_t {
 } bpt_nd_ext_leaf_t;
 
 
+/*!
+ * \brief Pool of fixed size objects
+ * Objects are carved from large chunks and returned to a free list,
+ * so nodes and values of one tree lie close to each other in memory
+ * and the whole tree is freed by releasing the chunks.
+ */
+typedef struct bpt_pool_t {
+   size_t item_size;       /*< size of one object (aligned) */
+   size_t items_per_chunk; /*< count of objects in one chunk */
+   size_t chunk_used;      /*< count of objects carved from the last chunk */
+   void *chunks;           /*< list of chunks, the first word of a chunk points to the next one */
+   void *free_list;        /*< list of returned objects */
+} bpt_pool_t;
+
+/*!
+ * \brief Allocators of one tree
+ * Every node is one block from a pool: the bpt_nd_t header is followed by the
+ * leaf or inner extension, the key array and the value or child pointer array.
+ */
+typedef struct bpt_alloc_t {
+   bpt_pool_t leaf_pool;   /*< pool of leaf nodes */
+   bpt_pool_t inner_pool;  /*< pool of inner nodes */
+   bpt_pool_t value_pool;  /*< pool of values */
+} bpt_alloc_t;
+
+/*!
+ * \brief B+ tree with private data
+ * bpt_init() allocates this structure, the public bpt_t has to stay
+ * the first member, so the layout of bpt_t does not change.
+ */
+typedef struct bpt_priv_t {
+   bpt_t pub;           /*< public part of the tree */
+   int key_type;        /*< BPT_KEY_CUSTOM or type of integer key */
+   bpt_alloc_t alloc;   /*< pools of nodes and values */
+} bpt_priv_t;
+
+/*!
+ * \brief Private data of the tree
+ */
+#define BPT_PRIV(btree) ((bpt_priv_t *) (btree))
+
+/*!
+ * \brief Initialization of the allocators
+ * \param[in] btree pointer to B+ tree with m, size_of_key and size_of_value set.
+ * \return 1 ON SUCCESS, 0 OTHERWISE.
+ */
+int bpt_alloc_init(bpt_t *btree);
+
+/*!
+ * \brief Destroy the allocators
+ * Function frees all nodes and values of the tree at once.
+ * \param[in] btree pointer to B+ tree.
+ */
+void bpt_alloc_clean(bpt_t *btree);
+
+/*!
+ * \brief Allocate zeroed object from pool
+ * \param[in] pool pointer to pool.
+ * \return pointer to object or NULL in case of error.
+ */
+void *bpt_pool_alloc(bpt_pool_t *pool);
+
+/*!
+ * \brief Return object to pool
+ * \param[in] pool pointer to pool.
+ * \param[in] item pointer to object.
+ */
+void bpt_pool_free(bpt_pool_t *pool, void *item);
+
+/*!
+ * \brief Compare two keys
+ * Integer keys are compared inline, other keys by the compare function.
+ * \param[in] btree pointer to B+ tree.
+ * \param[in] a first key.
+ * \param[in] b second key.
+ * \return negative, zero or positive number like the compare function.
+ */
+static inline int bpt_cmp(bpt_t *btree, void *a, void *b)
+{
+   switch (BPT_PRIV(btree)->key_type) {
+   case BPT_KEY_UINT32: {
+      uint32_t x, y;
+      memcpy(&x, a, sizeof(x));
+      memcpy(&y, b, sizeof(y));
+      return (x > y) - (x < y);
+   }
+   case BPT_KEY_UINT64: {
+      uint64_t x, y;
+      memcpy(&x, a, sizeof(x));
+      memcpy(&y, b, sizeof(y));
+      return (x > y) - (x < y);
+   }
+   default:
+      return btree->compare(a, b);
+   }
+}
+
 /*!
  * \brief Copy key
  * Function copies key from key array to another key array.
@@ -99,19 +207,20 @@ void bpt_copy_key(void *to, int index_to, void *from, int index_from, int size_o
 
 /*!
  * \brief Initialization of node
- * Function creates bpt_nd_t structure and prepares
- * it for usage.
- * \param[in] size_of_key size of key.
- * \param[in] m count of keys in one node.
+ * Function allocates leaf or inner node as one block from the pool
+ * and prepares it for usage.
+ * \param[in] btree pointer to B+ tree.
+ * \param[in] state_extend EXTEND_LEAF or EXTEND_INNER.
  * \return pointer to bpt_nd_t structure or NULL in case of error.
  */
-bpt_nd_t *bpt_nd_init(int size_of_key, int m);
+bpt_nd_t *bpt_nd_init(bpt_t *btree, unsigned char state_extend);
 
 /*!
  * \brief Destroy bpt_nd_t structure
  * \param[in] node pointer to bpt_nd_t structure
+ * \param[in] btree pointer to B+ tree.
  */
-void bpt_nd_clean(bpt_nd_t *node);
+void bpt_nd_clean(bpt_nd_t *node, bpt_t *btree);
 
 /*!
  * \brief Is key in node?
@@ -124,6 +233,17 @@ void bpt_nd_clean(bpt_nd_t *node);
  */
 unsigned char bpt_nd_key(void *key, bpt_nd_t *node, bpt_t *btree);
 
+/*!
+ * \brief Lower bound of key in node.
+ * Function finds the first key in node which is not less than
+ * the given key (binary search).
+ * \param[in] key key to search.
+ * \param[in] node pointer to the node.
+ * \param[in] btree pointer to B+ tree.
+ * \return index of the key or count of keys if all keys are less.
+ */
+int bpt_nd_lower_bound(void *key, bpt_nd_t *node, bpt_t *btree);
+
 /*!
  * \brief Search key in node.
  * Function searches key in node and returns it's index.
@@ -163,12 +283,10 @@ void *bpt_nd_key_on_index(bpt_nd_t *node, int index, int size_of_key);
 /*!
  * \brief Initialization of leaf node
  * Function creates bpt_nd_t structure extended by structure bpt_nd_ext_leaf_t (leaf).
- * \param[in] m count of keys in node.
- * \param[in] size_of_value size of value.
- * \param[in] size_of_key size of key.
+ * \param[in] btree pointer to B+ tree.
  * \return pointer to bpt_nd_t structure or NULL in case of error.
  */
-bpt_nd_t *bpt_ndlf_init(int m, int size_of_value, int size_of_key);
+bpt_nd_t *bpt_ndlf_init(bpt_t *btree);
 
 /*!
  * \brief Value on index
@@ -193,10 +311,10 @@ bpt_nd_t *bpt_ndlf_next(bpt_nd_t *node);
  * Function remove item from given leaf on given index.
  * \param[in] node Pointer to leaf.
  * \param[in] index index in leaf.
- * \param[in] size_of_key size of key.
+ * \param[in] btree pointer to B+ tree.
  * \return updated count of items in leaf.
  */
-int bpt_ndlf_del_item(bpt_nd_t *node, int index, int size_of_key);
+int bpt_ndlf_del_item(bpt_nd_t *node, int index, bpt_t *btree);
 
 /*!
  * \brief Insert item to leaf.
@@ -214,12 +332,10 @@ int bpt_ndlf_insert(void *key, bpt_nd_t *node, bpt_t *btree,
 /*!
  * \brief Initialization of inner node
  * Function creates bpt_nd_t structure extended by structure bpt_nd_ext_inner_t (inner extension).
- * \param[in] size_of_key size of key.
- * \param[in] m count of keys in node.
+ * \param[in] btree pointer to B+ tree.
  * \return pointer to bpt_nd_t structure or NULL in case of error.
-
  */
-bpt_nd_t *bpt_ndin_init(int size_of_key, int m);
+bpt_nd_t *bpt_ndin_init(bpt_t *btree);
 
 /*!
  * \brief Child on index
@@ -246,13 +362,6 @@ bpt_nd_t *bpt_ndin_child(bpt_nd_t *node, int index);
 int bpt_ndin_insert(void *add, bpt_nd_t *left, bpt_nd_t *right, bpt_nd_t *node,
                         bpt_t *btree);
 
-/*!
- * \brief Recursive deletion of nodes
- * Recursive function to delete all descendant nodes from given node.
- * \param[in] del pointer to node.
- */
-void bpt_del_all(bpt_nd_t *del);
-
 /*!
  * \brief Search leaf and index in B+ tree
  * Function searches leaf and index of given key in B+ tree.
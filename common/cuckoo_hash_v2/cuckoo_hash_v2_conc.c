@@ -0,0 +1,797 @@
+/**
+ * \file cuckoo_hash_v2_conc.c
+ * \brief Concurrent hash table with bucketized Cuckoo hashing.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "../include/cuckoo_hash_v2.h"
+
+/**
+ * Number of stripe locks, buckets are mapped onto them by index.
+ */
+#define HT_CONC_LOCK_COUNT 4096
+
+/**
+ * Limits of the breadth-first search of a cuckoo path.
+ */
+#define HT_CONC_BFS_MAX_DEPTH 5
+#define HT_CONC_BFS_MAX_NODES 256
+
+/**
+ * Default load factor which triggers background resize.
+ */
+#define HT_CONC_DEFAULT_MAX_LOAD 0.9
+
+/**
+ * Results of the cuckoo path search and execution.
+ */
+#define CUCKOO_PATH_DONE 0
+#define CUCKOO_PATH_RETRY 1
+#define CUCKOO_PATH_NONE 2
+
+/**
+ * Node of the breadth-first search of a cuckoo path.
+ */
+typedef struct {
+    uint64_t bucket; /**< Bucket reached by the node. */
+    int parent; /**< Index of the parent node, -1 for roots. */
+    int from_slot; /**< Slot of the parent bucket whose item moves to this bucket. */
+    int depth; /**< Length of the path from the root. */
+} cuckoo_bfs_node_t;
+
+/**
+ * Hash function of the concurrent table (64-bit FNV-1a with a final mix).
+ * Lower half selects the first bucket, upper half the second one.
+ */
+static inline uint64_t conc_hash(const char *key, unsigned int key_length)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (unsigned int i = 0; i < key_length; i++) {
+        hash ^= (uint8_t) key[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static inline uint64_t conc_bucket_1(uint64_t hash, uint64_t mask)
+{
+    return hash & mask;
+}
+
+static inline uint64_t conc_bucket_2(uint64_t hash, uint64_t mask)
+{
+    uint64_t b = (hash >> 32) & mask;
+
+    // both candidate buckets must differ
+    if (b == (hash & mask)) {
+        b = (b + 1) & mask;
+    }
+    return b;
+}
+
+/**
+ * Alternative bucket of an item stored in the given bucket.
+ */
+static inline uint64_t conc_alt_bucket(uint64_t hash, uint64_t bucket, uint64_t mask)
+{
+    uint64_t b1 = conc_bucket_1(hash, mask);
+    return (bucket == b1) ? conc_bucket_2(hash, mask) : b1;
+}
+
+static inline char *conc_item(const cc_hash_table_v2_conc_t *ht, const ht_conc_storage_t *st, uint64_t bucket, int slot)
+{
+    return st->items + (bucket * HT_CONC_SLOTS_PER_BUCKET + slot) * ht->item_size;
+}
+
+static inline void conc_relax(unsigned int *spins)
+{
+    if (++(*spins) > 100) {
+        *spins = 0;
+        sched_yield();
+    }
+}
+
+/*
+ * Stripe locks are sequence locks, the counter is odd while a writer holds
+ * the lock. Readers remember the even value and check it did not change
+ * after they copied the data.
+ */
+
+static inline void conc_lock(ht_conc_lock_t *l)
+{
+    unsigned int spins = 0;
+    uint32_t v;
+
+    for (;;) {
+        v = __atomic_load_n(&l->version, __ATOMIC_RELAXED);
+        if ((v & 1) == 0 &&
+            __atomic_compare_exchange_n(&l->version, &v, v + 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+        conc_relax(&spins);
+    }
+}
+
+static inline void conc_unlock(ht_conc_lock_t *l)
+{
+    __atomic_store_n(&l->version, __atomic_load_n(&l->version, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t conc_read_begin(ht_conc_lock_t *l)
+{
+    unsigned int spins = 0;
+    uint32_t v;
+
+    while ((v = __atomic_load_n(&l->version, __ATOMIC_ACQUIRE)) & 1) {
+        conc_relax(&spins);
+    }
+    return v;
+}
+
+static inline int conc_read_changed(ht_conc_lock_t *l, uint32_t v)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&l->version, __ATOMIC_RELAXED) != v;
+}
+
+/**
+ * Lock stripes of two buckets, always in ascending order to avoid deadlock.
+ */
+static void conc_lock_two(cc_hash_table_v2_conc_t *ht, uint64_t b1, uint64_t b2)
+{
+    uint64_t l1 = b1 & ht->lock_mask, l2 = b2 & ht->lock_mask;
+
+    if (l1 > l2) {
+        uint64_t tmp = l1;
+        l1 = l2;
+        l2 = tmp;
+    }
+    conc_lock(&ht->locks[l1]);
+    if (l2 != l1) {
+        conc_lock(&ht->locks[l2]);
+    }
+}
+
+static void conc_unlock_two(cc_hash_table_v2_conc_t *ht, uint64_t b1, uint64_t b2)
+{
+    uint64_t l1 = b1 & ht->lock_mask, l2 = b2 & ht->lock_mask;
+
+    conc_unlock(&ht->locks[l1]);
+    if (l2 != l1) {
+        conc_unlock(&ht->locks[l2]);
+    }
+}
+
+/**
+ * Lock both buckets of the hash in the current storage.
+ * Storage is checked again after locking because a resize may have replaced it.
+ */
+static ht_conc_storage_t *conc_lock_buckets(cc_hash_table_v2_conc_t *ht, uint64_t hash, uint64_t *b1, uint64_t *b2)
+{
+    ht_conc_storage_t *st;
+
+    for (;;) {
+        st = __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE);
+        *b1 = conc_bucket_1(hash, st->bucket_mask);
+        *b2 = conc_bucket_2(hash, st->bucket_mask);
+        conc_lock_two(ht, *b1, *b2);
+        if (st == __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE)) {
+            return st;
+        }
+        conc_unlock_two(ht, *b1, *b2);
+    }
+}
+
+static int conc_find_slot(const cc_hash_table_v2_conc_t *ht, const ht_conc_storage_t *st, uint64_t bucket, uint64_t hash, const char *key)
+{
+    const ht_conc_bucket_t *b = &st->buckets[bucket];
+
+    for (int s = 0; s < HT_CONC_SLOTS_PER_BUCKET; s++) {
+        if (__atomic_load_n(&b->occupied[s], __ATOMIC_RELAXED) &&
+            __atomic_load_n(&b->hash[s], __ATOMIC_RELAXED) == hash &&
+            memcmp(key, conc_item(ht, st, bucket, s), ht->key_length) == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+static int conc_free_slot(const ht_conc_storage_t *st, uint64_t bucket)
+{
+    for (int s = 0; s < HT_CONC_SLOTS_PER_BUCKET; s++) {
+        if (!__atomic_load_n(&st->buckets[bucket].occupied[s], __ATOMIC_RELAXED)) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+static void conc_store(cc_hash_table_v2_conc_t *ht, ht_conc_storage_t *st, uint64_t bucket, int slot,
+                       uint64_t hash, const char *key, const void *data)
+{
+    char *item = conc_item(ht, st, bucket, slot);
+
+    memcpy(item, key, ht->key_length);
+    memcpy(item + ht->data_offset, data, ht->data_size);
+    __atomic_store_n(&st->buckets[bucket].hash[slot], hash, __ATOMIC_RELAXED);
+    __atomic_store_n(&st->buckets[bucket].occupied[slot], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Move an item between slots of its two buckets.
+ * When locking is requested, stripes of both buckets are locked and the move
+ * is validated first because the path was found without holding any lock.
+ *
+ * @return 0 on success, -1 if the path is no longer valid.
+ */
+static int conc_move(cc_hash_table_v2_conc_t *ht, ht_conc_storage_t *st, uint64_t from, int from_slot,
+                     uint64_t to, int to_slot, int locking)
+{
+    ht_conc_bucket_t *src = &st->buckets[from], *dst = &st->buckets[to];
+    int ret = -1;
+
+    if (locking) {
+        conc_lock_two(ht, from, to);
+        if (st != __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE)) {
+            goto unlock;
+        }
+    }
+
+    if (!src->occupied[from_slot] || dst->occupied[to_slot] ||
+        conc_alt_bucket(src->hash[from_slot], from, st->bucket_mask) != to) {
+        goto unlock;
+    }
+
+    memcpy(conc_item(ht, st, to, to_slot), conc_item(ht, st, from, from_slot), ht->item_size);
+    __atomic_store_n(&dst->hash[to_slot], src->hash[from_slot], __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->occupied[to_slot], 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&src->occupied[from_slot], 0, __ATOMIC_RELAXED);
+    ret = 0;
+
+unlock:
+    if (locking) {
+        conc_unlock_two(ht, from, to);
+    }
+    return ret;
+}
+
+/**
+ * Free a slot in one of the two buckets by moving items along a cuckoo path.
+ * The shortest path to a bucket with a free slot is found by breadth-first
+ * search without holding locks, then it is executed backwards from the free
+ * slot, one locked and validated move at a time, so that every item stays
+ * reachable by readers during the whole operation.
+ *
+ * @return CUCKOO_PATH_DONE when a slot was freed, CUCKOO_PATH_RETRY when the
+ * table changed meanwhile, CUCKOO_PATH_NONE when no path exists (table is full).
+ */
+static int conc_cuckoo(cc_hash_table_v2_conc_t *ht, ht_conc_storage_t *st, uint64_t b1, uint64_t b2, int locking)
+{
+    cuckoo_bfs_node_t queue[HT_CONC_BFS_MAX_NODES];
+    int head = 0, tail = 0, free_slot = -1, node;
+
+    queue[tail++] = (cuckoo_bfs_node_t) { b1, -1, -1, 0 };
+    queue[tail++] = (cuckoo_bfs_node_t) { b2, -1, -1, 0 };
+
+    while (head < tail) {
+        node = head++;
+        free_slot = conc_free_slot(st, queue[node].bucket);
+        if (free_slot >= 0) {
+            break;
+        }
+        if (queue[node].depth >= HT_CONC_BFS_MAX_DEPTH) {
+            continue;
+        }
+        for (int s = 0; s < HT_CONC_SLOTS_PER_BUCKET && tail < HT_CONC_BFS_MAX_NODES; s++) {
+            uint64_t hash = __atomic_load_n(&st->buckets[queue[node].bucket].hash[s], __ATOMIC_RELAXED);
+            queue[tail++] = (cuckoo_bfs_node_t) {
+                conc_alt_bucket(hash, queue[node].bucket, st->bucket_mask), node, s, queue[node].depth + 1
+            };
+        }
+    }
+    if (free_slot < 0) {
+        return CUCKOO_PATH_NONE;
+    }
+
+    // execute the path backwards: each item moves into the slot freed by the previous move
+    while (queue[node].parent >= 0) {
+        int parent = queue[node].parent;
+        if (conc_move(ht, st, queue[parent].bucket, queue[node].from_slot,
+                      queue[node].bucket, free_slot, locking) != 0) {
+            return CUCKOO_PATH_RETRY;
+        }
+        free_slot = queue[node].from_slot;
+        node = parent;
+    }
+    return CUCKOO_PATH_DONE;
+}
+
+static ht_conc_storage_t *conc_storage_alloc(const cc_hash_table_v2_conc_t *ht, uint64_t bucket_count)
+{
+    ht_conc_storage_t *st = (ht_conc_storage_t *) calloc(1, sizeof(ht_conc_storage_t));
+    if (st == NULL) {
+        return NULL;
+    }
+
+    st->buckets = (ht_conc_bucket_t *) calloc(bucket_count, sizeof(ht_conc_bucket_t));
+    st->items = (char *) malloc(bucket_count * HT_CONC_SLOTS_PER_BUCKET * ht->item_size);
+    if (st->buckets == NULL || st->items == NULL) {
+        free(st->buckets);
+        free(st->items);
+        free(st);
+        return NULL;
+    }
+    st->bucket_mask = bucket_count - 1;
+    return st;
+}
+
+static void conc_storage_free(ht_conc_storage_t *st)
+{
+    while (st != NULL) {
+        ht_conc_storage_t *retired = st->retired;
+        free(st->buckets);
+        free(st->items);
+        free(st);
+        st = retired;
+    }
+}
+
+/**
+ * Rehash all items of the old storage into a new (empty and private) one.
+ *
+ * @return 0 on success, -1 if some item could not be placed.
+ */
+static int conc_migrate(cc_hash_table_v2_conc_t *ht, ht_conc_storage_t *old, ht_conc_storage_t *new_st)
+{
+    for (uint64_t b = 0; b <= old->bucket_mask; b++) {
+        for (int s = 0; s < HT_CONC_SLOTS_PER_BUCKET; s++) {
+            if (!old->buckets[b].occupied[s]) {
+                continue;
+            }
+
+            uint64_t hash = old->buckets[b].hash[s];
+            uint64_t nb1 = conc_bucket_1(hash, new_st->bucket_mask);
+            uint64_t nb2 = conc_bucket_2(hash, new_st->bucket_mask);
+            uint64_t nb = nb1;
+            int ns = conc_free_slot(new_st, nb1);
+
+            if (ns < 0) {
+                nb = nb2;
+                ns = conc_free_slot(new_st, nb2);
+            }
+            if (ns < 0) {
+                if (conc_cuckoo(ht, new_st, nb1, nb2, 0) != CUCKOO_PATH_DONE) {
+                    return -1;
+                }
+                nb = nb1;
+                ns = conc_free_slot(new_st, nb1);
+                if (ns < 0) {
+                    nb = nb2;
+                    ns = conc_free_slot(new_st, nb2);
+                }
+            }
+
+            memcpy(conc_item(ht, new_st, nb, ns), conc_item(ht, old, b, s), ht->item_size);
+            new_st->buckets[nb].hash[ns] = hash;
+            new_st->buckets[nb].occupied[ns] = 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Double the table, caller must hold resize_mutex.
+ * All stripes are locked during the migration, readers and writers wait.
+ * The old storage is kept until destruction since lock-free readers may
+ * still be reading from it.
+ */
+static int conc_resize_locked(cc_hash_table_v2_conc_t *ht)
+{
+    ht_conc_storage_t *old = ht->storage, *new_st = NULL;
+    uint64_t bucket_count = old->bucket_mask + 1;
+
+    for (uint64_t l = 0; l <= ht->lock_mask; l++) {
+        conc_lock(&ht->locks[l]);
+    }
+
+    do {
+        conc_storage_free(new_st);
+        bucket_count *= 2;
+        new_st = conc_storage_alloc(ht, bucket_count);
+    } while (new_st != NULL && conc_migrate(ht, old, new_st) != 0);
+
+    if (new_st != NULL) {
+        new_st->retired = old;
+        __atomic_store_n(&ht->storage, new_st, __ATOMIC_RELEASE);
+    }
+
+    for (uint64_t l = 0; l <= ht->lock_mask; l++) {
+        conc_unlock(&ht->locks[l]);
+    }
+
+    if (new_st == NULL) {
+        fprintf(stderr, "ERROR: Hash table couldn't be resized.\n");
+        return REHASH_FAILURE;
+    }
+    return 0;
+}
+
+/**
+ * Resize the table unless some other thread has already replaced the storage.
+ */
+static int conc_grow(cc_hash_table_v2_conc_t *ht, ht_conc_storage_t *st)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&ht->resize_mutex);
+    if (st == __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE)) {
+        ret = conc_resize_locked(ht);
+    }
+    pthread_mutex_unlock(&ht->resize_mutex);
+    return ret;
+}
+
+/**
+ * Body of the background resize thread.
+ */
+static void *conc_resize_thread(void *arg)
+{
+    cc_hash_table_v2_conc_t *ht = (cc_hash_table_v2_conc_t *) arg;
+
+    pthread_mutex_lock(&ht->resize_mutex);
+    for (;;) {
+        while (!ht->resize_pending && !ht->stop) {
+            pthread_cond_wait(&ht->resize_cond, &ht->resize_mutex);
+        }
+        if (ht->stop) {
+            break;
+        }
+        conc_resize_locked(ht);
+        __atomic_store_n(&ht->resize_pending, 0, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&ht->resize_mutex);
+    return NULL;
+}
+
+/**
+ * Wake up the background resize thread when the load factor is exceeded.
+ */
+static void conc_check_load(cc_hash_table_v2_conc_t *ht, uint64_t count)
+{
+    if (!ht->background_resize || __atomic_load_n(&ht->resize_pending, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    if (count <= ht->max_load * ht_conc_capacity_v2(ht)) {
+        return;
+    }
+
+    pthread_mutex_lock(&ht->resize_mutex);
+    if (!ht->resize_pending) {
+        ht->resize_pending = 1;
+        pthread_cond_signal(&ht->resize_cond);
+    }
+    pthread_mutex_unlock(&ht->resize_mutex);
+}
+
+/**
+ * Initialization function for the concurrent hash table.
+ * The table is organized into buckets of HT_CONC_SLOTS_PER_BUCKET items,
+ * number of buckets is a power of two large enough to hold table_size items.
+ *
+ * @param ht Pointer to a table structure.
+ * @param table_size Expected number of stored items.
+ * @param data_size Size of the data being stored in the table.
+ * @param key_length Length of the key used for referencing the items.
+ * @param background_resize If non-zero, a thread which resizes the table in
+ * advance when the load factor gets high is started.
+ * @return -1 if the table wasn't created, 0 otherwise.
+ */
+int ht_conc_init_v2(cc_hash_table_v2_conc_t *ht, unsigned int table_size, unsigned int data_size, unsigned int key_length, int background_resize)
+{
+    uint64_t bucket_count = 2;
+
+    memset(ht, 0, sizeof(*ht));
+    ht->data_size = data_size;
+    ht->key_length = key_length;
+    // data are aligned to 8 bytes so that the update callback can access them directly
+    ht->data_offset = (key_length + 7) & ~7U;
+    ht->item_size = (ht->data_offset + data_size + 7) & ~7U;
+    ht->max_load = HT_CONC_DEFAULT_MAX_LOAD;
+
+    while (bucket_count * HT_CONC_SLOTS_PER_BUCKET < table_size) {
+        bucket_count *= 2;
+    }
+
+    ht->storage = conc_storage_alloc(ht, bucket_count);
+    ht->locks = (ht_conc_lock_t *) calloc(HT_CONC_LOCK_COUNT, sizeof(ht_conc_lock_t));
+    if (ht->storage == NULL || ht->locks == NULL) {
+        fprintf(stderr, "ERROR: Hash table couldn't be initialized.\n");
+        conc_storage_free(ht->storage);
+        free(ht->locks);
+        return -1;
+    }
+    ht->lock_mask = HT_CONC_LOCK_COUNT - 1;
+
+    pthread_mutex_init(&ht->resize_mutex, NULL);
+    pthread_cond_init(&ht->resize_cond, NULL);
+    if (background_resize) {
+        if (pthread_create(&ht->resize_thread, NULL, conc_resize_thread, ht) != 0) {
+            fprintf(stderr, "ERROR: Hash table resize thread couldn't be started.\n");
+            ht_conc_destroy_v2(ht);
+            return -1;
+        }
+        ht->background_resize = 1;
+    }
+    return 0;
+}
+
+static int conc_insert(cc_hash_table_v2_conc_t *ht, const char *key, const void *new_data,
+                       void (*update)(void *data, void *arg), void *arg)
+{
+    uint64_t hash = conc_hash(key, ht->key_length);
+    ht_conc_storage_t *st;
+    uint64_t b1, b2, b;
+    int s;
+
+    for (;;) {
+        st = conc_lock_buckets(ht, hash, &b1, &b2);
+
+        // update existing item
+        b = b1;
+        s = conc_find_slot(ht, st, b1, hash, key);
+        if (s < 0) {
+            b = b2;
+            s = conc_find_slot(ht, st, b2, hash, key);
+        }
+        if (s >= 0) {
+            char *data = conc_item(ht, st, b, s) + ht->data_offset;
+            if (update != NULL) {
+                update(data, arg);
+            } else {
+                memcpy(data, new_data, ht->data_size);
+            }
+            conc_unlock_two(ht, b1, b2);
+            return HT_CONC_UPDATED;
+        }
+
+        // insert into free slot
+        b = b1;
+        s = conc_free_slot(st, b1);
+        if (s < 0) {
+            b = b2;
+            s = conc_free_slot(st, b2);
+        }
+        if (s >= 0) {
+            conc_store(ht, st, b, s, hash, key, new_data);
+            conc_unlock_two(ht, b1, b2);
+            conc_check_load(ht, __atomic_add_fetch(&ht->count, 1, __ATOMIC_RELAXED));
+            return HT_CONC_INSERTED;
+        }
+        conc_unlock_two(ht, b1, b2);
+
+        // both buckets are full --> make space by cuckoo moves or by resizing
+        if (conc_cuckoo(ht, st, b1, b2, 1) == CUCKOO_PATH_NONE) {
+            if (conc_grow(ht, st) != 0) {
+                return HT_CONC_FAILURE;
+            }
+        }
+    }
+}
+
+/**
+ * Function for inserting the item into the concurrent table.
+ * If an item with the same key is present, its data are overwritten.
+ * When there is no free slot in the two buckets of the key, items are moved
+ * to their alternative buckets along the shortest cuckoo path found. If no
+ * such path exists, the table is resized. Safe to call from multiple threads.
+ *
+ * @param ht Table in which we want to insert the item.
+ * @param key Key of the newly inserted data.
+ * @param new_data Pointer to new data to be inserted.
+ * @return HT_CONC_INSERTED, HT_CONC_UPDATED or HT_CONC_FAILURE.
+ */
+int ht_conc_insert_v2(cc_hash_table_v2_conc_t *ht, const char *key, const void *new_data)
+{
+    return conc_insert(ht, key, new_data, NULL, NULL);
+}
+
+/**
+ * Function for inserting or updating the item in place.
+ * If the item is present, update callback is called on its data while the
+ * bucket is locked (e.g. for adding counters of a flow record), otherwise
+ * new_data are inserted. Callback must be short and must not access the table.
+ *
+ * @param ht Table in which we want to insert the item.
+ * @param key Key of the item.
+ * @param new_data Pointer to data inserted if the key is not present.
+ * @param update Callback modifying the data of a present item.
+ * @param arg Argument passed to the callback.
+ * @return HT_CONC_INSERTED, HT_CONC_UPDATED or HT_CONC_FAILURE.
+ */
+int ht_conc_upsert_v2(cc_hash_table_v2_conc_t *ht, const char *key, const void *new_data, void (*update)(void *data, void *arg), void *arg)
+{
+    return conc_insert(ht, key, new_data, update, arg);
+}
+
+/**
+ * Function for getting a copy of data from the concurrent table.
+ * Lookup does not take any lock: it reads both buckets of the key optimistically
+ * and retries if a writer modified any of them meanwhile. Data are copied
+ * because items may be moved by other threads after the function returns.
+ *
+ * @param ht Hash table to be searched for data.
+ * @param key Key of the desired item.
+ * @param data Buffer of data_size bytes for the copy of data, may be NULL.
+ * @return 1 if the item was found, 0 otherwise.
+ */
+int ht_conc_get_v2(cc_hash_table_v2_conc_t *ht, const char *key, void *data)
+{
+    uint64_t hash = conc_hash(key, ht->key_length);
+    ht_conc_storage_t *st;
+    ht_conc_lock_t *l1, *l2;
+    uint32_t v1, v2;
+    uint64_t b1, b2, b;
+    int s;
+
+    for (;;) {
+        st = __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE);
+        b1 = conc_bucket_1(hash, st->bucket_mask);
+        b2 = conc_bucket_2(hash, st->bucket_mask);
+        l1 = &ht->locks[b1 & ht->lock_mask];
+        l2 = &ht->locks[b2 & ht->lock_mask];
+
+        v1 = conc_read_begin(l1);
+        v2 = conc_read_begin(l2);
+        if (st != __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        b = b1;
+        s = conc_find_slot(ht, st, b1, hash, key);
+        if (s < 0) {
+            b = b2;
+            s = conc_find_slot(ht, st, b2, hash, key);
+        }
+        if (s >= 0 && data != NULL) {
+            memcpy(data, conc_item(ht, st, b, s) + ht->data_offset, ht->data_size);
+        }
+
+        if (!conc_read_changed(l1, v1) && !conc_read_changed(l2, v2)) {
+            return s >= 0;
+        }
+    }
+}
+
+/**
+ * Procedure for removing the item from the concurrent table.
+ *
+ * @param ht Hash table to be searched for data.
+ * @param key Key of the desired item.
+ * @return 1 if the item was removed, 0 if it was not found.
+ */
+int ht_conc_remove_v2(cc_hash_table_v2_conc_t *ht, const char *key)
+{
+    uint64_t hash = conc_hash(key, ht->key_length);
+    ht_conc_storage_t *st;
+    uint64_t b1, b2, b;
+    int s;
+
+    st = conc_lock_buckets(ht, hash, &b1, &b2);
+    b = b1;
+    s = conc_find_slot(ht, st, b1, hash, key);
+    if (s < 0) {
+        b = b2;
+        s = conc_find_slot(ht, st, b2, hash, key);
+    }
+    if (s >= 0) {
+        __atomic_store_n(&st->buckets[b].occupied[s], 0, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&ht->count, 1, __ATOMIC_RELAXED);
+    }
+    conc_unlock_two(ht, b1, b2);
+    return s >= 0;
+}
+
+/**
+ * Function for doubling the size of the concurrent table.
+ * Access to the table is blocked during the resize.
+ *
+ * @param ht Table to be resized.
+ * @return 0 on success otherwise REHASH_FAILURE.
+ */
+int ht_conc_resize_v2(cc_hash_table_v2_conc_t *ht)
+{
+    int ret;
+
+    pthread_mutex_lock(&ht->resize_mutex);
+    ret = conc_resize_locked(ht);
+    pthread_mutex_unlock(&ht->resize_mutex);
+    return ret;
+}
+
+/**
+ * Number of items stored in the concurrent table.
+ */
+uint64_t ht_conc_count_v2(cc_hash_table_v2_conc_t *ht)
+{
+    return __atomic_load_n(&ht->count, __ATOMIC_RELAXED);
+}
+
+/**
+ * Number of item slots of the concurrent table.
+ */
+uint64_t ht_conc_capacity_v2(cc_hash_table_v2_conc_t *ht)
+{
+    ht_conc_storage_t *st = __atomic_load_n(&ht->storage, __ATOMIC_ACQUIRE);
+    return (st->bucket_mask + 1) * HT_CONC_SLOTS_PER_BUCKET;
+}
+
+/**
+ * Clean-up procedure of the concurrent table.
+ * Stops the resize thread and frees all memory. No other thread may use
+ * the table during and after this call.
+ *
+ * @param ht Hash table to be destroyed.
+ */
+void ht_conc_destroy_v2(cc_hash_table_v2_conc_t *ht)
+{
+    if (ht->background_resize) {
+        pthread_mutex_lock(&ht->resize_mutex);
+        ht->stop = 1;
+        pthread_cond_signal(&ht->resize_cond);
+        pthread_mutex_unlock(&ht->resize_mutex);
+        pthread_join(ht->resize_thread, NULL);
+        ht->background_resize = 0;
+    }
+    pthread_cond_destroy(&ht->resize_cond);
+    pthread_mutex_destroy(&ht->resize_mutex);
+
+    conc_storage_free(ht->storage);
+    ht->storage = NULL;
+    free(ht->locks);
+    ht->locks = NULL;
+    ht->count = 0;
+}
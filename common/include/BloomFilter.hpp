@@ -24,9 +24,15 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <new>
 #include <string>
 #include <vector>
+#include <cstring>
 #include <inttypes.h>
+#include <stdlib.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 
 static const std::size_t bits_per_char = 0x08;    // 8 bits in 1 char(unsigned)
@@ -198,6 +204,7 @@ public:
    }
 
    bloom_filter(const bloom_filter& filter)
+   : bit_table_(0)
    {
       this->operator=(filter);
    }
@@ -691,6 +698,982 @@ private:
    std::vector<uint64_t> size_list;
 };
 
+/*!
+ * \brief Bloom filter with 4-bit counters which supports deletion of elements.
+ * Every bit of the bloom_filter table has an associated saturating counter,
+ * the bit table is kept in sync with the counters (a bit is set iff its
+ * counter is non-zero), so lookups cost the same as in bloom_filter.
+ * A saturated counter is never decremented again, to avoid false negatives.
+ * Only elements that were inserted may be erased, otherwise false negatives
+ * may appear.
+ * bloom_filter is a private base, so that the counters cannot be bypassed by
+ * modifying the filter through a bloom_filter reference; only the lookups
+ * are exported.
+ */
+class counting_bloom_filter : private bloom_filter
+{
+public:
+
+   using bloom_filter::operator!;
+   using bloom_filter::contains;
+   using bloom_filter::contains_all;
+   using bloom_filter::contains_none;
+   using bloom_filter::size;
+   using bloom_filter::element_count;
+   using bloom_filter::effective_fpp;
+   using bloom_filter::table;
+   using bloom_filter::hash_count;
+
+   static const unsigned char counter_max = 0x0F;
+
+   counting_bloom_filter()
+   : bloom_filter()
+   {}
+
+   counting_bloom_filter(const bloom_parameters& p)
+   : bloom_filter(p),
+     counter_table_(static_cast<std::size_t>((table_size_ + 1) / 2), 0x00)
+   {}
+
+   inline bool operator == (const counting_bloom_filter& f) const
+   {
+      return bloom_filter::operator==(f) && (counter_table_ == f.counter_table_);
+   }
+
+   inline bool operator != (const counting_bloom_filter& f) const
+   {
+      return !operator==(f);
+   }
+
+   inline void clear()
+   {
+      bloom_filter::clear();
+      std::fill(counter_table_.begin(), counter_table_.end(), 0x00);
+   }
+
+   inline bool containsinsert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      const bool present = contains(key_begin, length);
+      insert(key_begin, length);
+      return present;
+   }
+
+   inline void insert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      std::size_t bit_index = 0;
+      std::size_t bit = 0;
+      for (std::size_t i = 0; i < salt_.size(); ++i)
+      {
+         compute_indices(hash_ap(key_begin,length,salt_[i]),bit_index,bit);
+         const unsigned char counter = get_counter(bit_index);
+         if (counter < counter_max)
+         {
+            set_counter(bit_index, counter + 1);
+         }
+         bit_table_[bit_index / bits_per_char] |= bit_mask[bit];
+      }
+      ++inserted_element_count_;
+   }
+
+   template<typename T>
+   inline void insert(const T& t)
+   {
+      // Note: T must be a C++ POD type.
+      insert(reinterpret_cast<const unsigned char*>(&t),sizeof(T));
+   }
+
+   inline void insert(const std::string& key)
+   {
+      insert(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline void insert(const char* data, const std::size_t& length)
+   {
+      insert(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   template<typename InputIterator>
+   inline void insert(const InputIterator begin, const InputIterator end)
+   {
+      InputIterator itr = begin;
+      while (end != itr)
+      {
+         insert(*(itr++));
+      }
+   }
+
+   /*!
+    * \brief Remove one occurrence of the element from the filter.
+    * \return False if the element is not present (nothing is changed), true otherwise.
+    */
+   inline bool erase(const unsigned char* key_begin, const std::size_t& length)
+   {
+      if (!contains(key_begin, length))
+      {
+         return false;
+      }
+
+      std::size_t bit_index = 0;
+      std::size_t bit = 0;
+      for (std::size_t i = 0; i < salt_.size(); ++i)
+      {
+         compute_indices(hash_ap(key_begin,length,salt_[i]),bit_index,bit);
+         const unsigned char counter = get_counter(bit_index);
+         if ((counter == 0) || (counter == counter_max))
+         {
+            /* already cleared by a repeated index of this key or saturated */
+            continue;
+         }
+         set_counter(bit_index, counter - 1);
+         if (counter == 1)
+         {
+            bit_table_[bit_index / bits_per_char] &= ~bit_mask[bit];
+         }
+      }
+      if (inserted_element_count_ > 0)
+      {
+         --inserted_element_count_;
+      }
+      return true;
+   }
+
+   template<typename T>
+   inline bool erase(const T& t)
+   {
+      // Note: T must be a C++ POD type.
+      return erase(reinterpret_cast<const unsigned char*>(&t),sizeof(T));
+   }
+
+   inline bool erase(const std::string& key)
+   {
+      return erase(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline bool erase(const char* data, const std::size_t& length)
+   {
+      return erase(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   /*!
+    * \brief Estimate how many times the element was inserted (upper bound, saturates at counter_max).
+    */
+   inline unsigned char count(const unsigned char* key_begin, const std::size_t& length) const
+   {
+      std::size_t bit_index = 0;
+      std::size_t bit = 0;
+      unsigned char result = counter_max;
+      for (std::size_t i = 0; i < salt_.size(); ++i)
+      {
+         compute_indices(hash_ap(key_begin,length,salt_[i]),bit_index,bit);
+         result = std::min(result, get_counter(bit_index));
+      }
+      return result;
+   }
+
+   template<typename T>
+   inline unsigned char count(const T& t) const
+   {
+      return count(reinterpret_cast<const unsigned char*>(&t),sizeof(T));
+   }
+
+   inline unsigned char count(const std::string& key) const
+   {
+      return count(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline counting_bloom_filter& operator &= (const counting_bloom_filter& f)
+   {
+      /* intersection, counters are combined by minimum */
+      if (compatible(f))
+      {
+         for (std::size_t i = 0; i < table_size_; ++i)
+         {
+            set_counter(i, std::min(get_counter(i), f.get_counter(i)));
+         }
+         sync_bits();
+      }
+      return *this;
+   }
+
+   inline counting_bloom_filter& operator |= (const counting_bloom_filter& f)
+   {
+      /* union, counters are summed with saturation */
+      if (compatible(f))
+      {
+         for (std::size_t i = 0; i < table_size_; ++i)
+         {
+            const unsigned int sum = get_counter(i) + f.get_counter(i);
+            set_counter(i, static_cast<unsigned char>(std::min<unsigned int>(sum, counter_max)));
+         }
+         sync_bits();
+         inserted_element_count_ += f.inserted_element_count_;
+      }
+      return *this;
+   }
+
+protected:
+
+   inline bool compatible(const counting_bloom_filter& f) const
+   {
+      return (salt_count_  == f.salt_count_) &&
+             (table_size_  == f.table_size_) &&
+             (random_seed_ == f.random_seed_);
+   }
+
+   inline unsigned char get_counter(const std::size_t& index) const
+   {
+      return (counter_table_[index >> 1] >> ((index & 0x01) << 2)) & counter_max;
+   }
+
+   inline void set_counter(const std::size_t& index, const unsigned char& value)
+   {
+      const unsigned int shift = (index & 0x01) << 2;
+      unsigned char& cell = counter_table_[index >> 1];
+      cell = static_cast<unsigned char>((cell & ~(counter_max << shift)) | (value << shift));
+   }
+
+   void sync_bits()
+   {
+      for (std::size_t i = 0; i < table_size_; ++i)
+      {
+         if (get_counter(i) != 0)
+            bit_table_[i / bits_per_char] |= bit_mask[i % bits_per_char];
+         else
+            bit_table_[i / bits_per_char] &= ~bit_mask[i % bits_per_char];
+      }
+   }
+
+   std::vector<unsigned char> counter_table_;
+};
+
+/*!
+ * \brief Bloom filter answering "was the element seen in the last N time units".
+ * The filter consists of a ring of generations (ordinary bloom filters, each
+ * sized by the given bloom_parameters for the expected number of elements
+ * inserted during one generation interval). Elements are inserted into the
+ * current generation, lookups check all generations. When advance() moves the
+ * time past the end of the current interval, the oldest generation is cleared
+ * and reused as the current one, so elements expire after between
+ * (generations - 1) and generations intervals.
+ * Time units are up to the caller (e.g. seconds or UniRec time in ms),
+ * they only have to be consistent with generation_interval.
+ */
+class time_decaying_bloom_filter
+{
+public:
+
+   time_decaying_bloom_filter()
+   : current_(0),
+     generation_interval_(0),
+     generation_start_(0),
+     started_(false)
+   {}
+
+   time_decaying_bloom_filter(const bloom_parameters& p, const std::size_t& generations, const uint64_t& generation_interval)
+   : generations_(std::max<std::size_t>(generations, 1), bloom_filter(p)),
+     current_(0),
+     generation_interval_(generation_interval),
+     generation_start_(0),
+     started_(false)
+   {}
+
+   inline bool operator!() const
+   {
+      return generations_.empty() || !generations_[0];
+   }
+
+   inline void clear()
+   {
+      for (std::size_t i = 0; i < generations_.size(); ++i)
+      {
+         generations_[i].clear();
+      }
+      current_ = 0;
+      started_ = false;
+   }
+
+   /*!
+    * \brief Drop the oldest generation and start a new one.
+    */
+   inline void rotate()
+   {
+      current_ = (current_ + 1) % generations_.size();
+      generations_[current_].clear();
+   }
+
+   /*!
+    * \brief Set current time, expire generations older than the window.
+    * Time going backwards is ignored.
+    */
+   inline void advance(const uint64_t& now)
+   {
+      if (!started_)
+      {
+         generation_start_ = now;
+         started_ = true;
+         return;
+      }
+      if ((generation_interval_ == 0) || (now < generation_start_ + generation_interval_))
+      {
+         return;
+      }
+
+      const uint64_t elapsed = (now - generation_start_) / generation_interval_;
+      if (elapsed >= generations_.size())
+      {
+         for (std::size_t i = 0; i < generations_.size(); ++i)
+         {
+            generations_[i].clear();
+         }
+      }
+      else
+      {
+         for (uint64_t i = 0; i < elapsed; ++i)
+         {
+            rotate();
+         }
+      }
+      generation_start_ += elapsed * generation_interval_;
+   }
+
+   inline bool containsinsert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      const bool present = contains(key_begin, length);
+      insert(key_begin, length);
+      return present;
+   }
+
+   inline void insert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      generations_[current_].insert(key_begin, length);
+   }
+
+   template<typename T>
+   inline void insert(const T& t)
+   {
+      // Note: T must be a C++ POD type.
+      insert(reinterpret_cast<const unsigned char*>(&t),sizeof(T));
+   }
+
+   inline void insert(const std::string& key)
+   {
+      insert(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline void insert(const char* data, const std::size_t& length)
+   {
+      insert(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   template<typename InputIterator>
+   inline void insert(const InputIterator begin, const InputIterator end)
+   {
+      InputIterator itr = begin;
+      while (end != itr)
+      {
+         insert(*(itr++));
+      }
+   }
+
+   inline bool contains(const unsigned char* key_begin, const std::size_t length) const
+   {
+      /* the newest generation is the most likely to contain the element */
+      for (std::size_t i = 0; i < generations_.size(); ++i)
+      {
+         const std::size_t g = (current_ + generations_.size() - i) % generations_.size();
+         if (generations_[g].contains(key_begin, length))
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   template<typename T>
+   inline bool contains(const T& t) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(&t),static_cast<std::size_t>(sizeof(T)));
+   }
+
+   inline bool contains(const std::string& key) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline bool contains(const char* data, const std::size_t& length) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   inline time_decaying_bloom_filter& operator &= (const time_decaying_bloom_filter& f)
+   {
+      /* intersection of the corresponding generations, counted from the newest */
+      if (generations_.size() == f.generations_.size())
+      {
+         for (std::size_t i = 0; i < generations_.size(); ++i)
+         {
+            generations_[(current_ + i) % generations_.size()] &= f.generations_[(f.current_ + i) % f.generations_.size()];
+         }
+      }
+      return *this;
+   }
+
+   inline time_decaying_bloom_filter& operator |= (const time_decaying_bloom_filter& f)
+   {
+      /* union of the corresponding generations, counted from the newest */
+      if (generations_.size() == f.generations_.size())
+      {
+         for (std::size_t i = 0; i < generations_.size(); ++i)
+         {
+            generations_[(current_ + i) % generations_.size()] |= f.generations_[(f.current_ + i) % f.generations_.size()];
+         }
+      }
+      return *this;
+   }
+
+   inline uint64_t size() const
+   {
+      return generations_.empty() ? 0 : generations_.size() * generations_[0].size();
+   }
+
+   inline std::size_t element_count() const
+   {
+      std::size_t count = 0;
+      for (std::size_t i = 0; i < generations_.size(); ++i)
+      {
+         count += generations_[i].element_count();
+      }
+      return count;
+   }
+
+   inline double effective_fpp() const
+   {
+      /* probability that at least one generation reports a false positive */
+      double negative = 1.0;
+      for (std::size_t i = 0; i < generations_.size(); ++i)
+      {
+         negative *= 1.0 - generations_[i].effective_fpp();
+      }
+      return 1.0 - negative;
+   }
+
+   inline std::size_t generation_count() const
+   {
+      return generations_.size();
+   }
+
+   inline uint64_t window() const
+   {
+      return generations_.size() * generation_interval_;
+   }
+
+protected:
+
+   std::vector<bloom_filter> generations_;
+   std::size_t               current_;
+   uint64_t                  generation_interval_;
+   uint64_t                  generation_start_;
+   bool                      started_;
+};
+
+/*!
+ * \brief Cache-blocked variant of the bloom filter.
+ * All bits of one key are stored inside a single 64-byte block (one cache line),
+ * so both insert and contains touch exactly one cache line per key. Block and
+ * bit positions are derived from one 64-bit hash and the bits of a key are
+ * collected into a block-wide mask, so the whole block is probed with a few
+ * SIMD instructions (AVX2 when available, scalar code otherwise).
+ * The number of hashes is limited to 16,
+ * the table size is rounded up to whole blocks. Blocking slightly increases
+ * the false positive rate compared to bloom_filter with the same size.
+ * The same restriction on padding bytes as for bloom_filter applies.
+ */
+class blocked_bloom_filter
+{
+protected:
+
+   typedef uint32_t word_type;
+
+   static const std::size_t block_size = 64;
+   static const std::size_t words_per_block = block_size / sizeof(word_type);
+   static const std::size_t bits_per_block = block_size * bits_per_char;
+   static const std::size_t batch_size = 16;
+
+public:
+
+   blocked_bloom_filter()
+   : block_table_(0),
+     block_count_(0),
+     hash_count_(0),
+     projected_element_count_(0),
+     inserted_element_count_(0),
+     random_seed_(0),
+     desired_false_positive_probability_(0.0)
+   {}
+
+   blocked_bloom_filter(const bloom_parameters& p)
+   : block_table_(0),
+     projected_element_count_(p.projected_element_count),
+     inserted_element_count_(0),
+     random_seed_((p.random_seed * 0xA5A5A5A5) + 1),
+     desired_false_positive_probability_(p.false_positive_probability)
+   {
+      hash_count_ = std::min<std::size_t>(std::max<std::size_t>(p.optimal_parameters.number_of_hashes, 1), words_per_block);
+      block_count_ = (p.optimal_parameters.table_size + bits_per_block - 1) / bits_per_block;
+      if (block_count_ == 0) {
+         block_count_ = 1;
+      }
+      allocate_table();
+      std::memset(block_table_, 0, raw_table_size());
+   }
+
+   blocked_bloom_filter(const blocked_bloom_filter& filter)
+   : block_table_(0),
+     block_count_(0)
+   {
+      this->operator=(filter);
+   }
+
+   inline bool operator == (const blocked_bloom_filter& f) const
+   {
+      if (this != &f)
+      {
+         return
+            (block_count_                        == f.block_count_)                        &&
+            (hash_count_                         == f.hash_count_)                         &&
+            (projected_element_count_            == f.projected_element_count_)            &&
+            (inserted_element_count_             == f.inserted_element_count_)             &&
+            (random_seed_                        == f.random_seed_)                        &&
+            (desired_false_positive_probability_ == f.desired_false_positive_probability_) &&
+            (0 == std::memcmp(block_table_, f.block_table_, raw_table_size()));
+      }
+      else
+         return true;
+   }
+
+   inline bool operator != (const blocked_bloom_filter& f) const
+   {
+      return !operator==(f);
+   }
+
+   inline blocked_bloom_filter& operator = (const blocked_bloom_filter& f)
+   {
+      if (this != &f)
+      {
+         free(block_table_);
+         block_table_ = 0;
+         block_count_ = f.block_count_;
+         hash_count_ = f.hash_count_;
+         projected_element_count_ = f.projected_element_count_;
+         inserted_element_count_ = f.inserted_element_count_;
+         random_seed_ = f.random_seed_;
+         desired_false_positive_probability_ = f.desired_false_positive_probability_;
+         if (block_count_ != 0) {
+            allocate_table();
+            std::memcpy(block_table_, f.block_table_, raw_table_size());
+         }
+      }
+      return *this;
+   }
+
+   virtual ~blocked_bloom_filter()
+   {
+      free(block_table_);
+   }
+
+   inline bool operator!() const
+   {
+      return (0 == block_count_);
+   }
+
+   inline void clear()
+   {
+      std::memset(block_table_, 0, raw_table_size());
+      inserted_element_count_ = 0;
+   }
+
+   inline bool containsinsert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      word_type mask[words_per_block];
+      const uint64_t hash = hash_64(key_begin, length);
+      word_type* block = block_of(hash);
+      compute_mask(static_cast<word_type>(hash), mask);
+
+      const bool present = block_contains(block, mask);
+      block_insert(block, mask);
+      if (!present) {
+         ++inserted_element_count_;
+      }
+      return present;
+   }
+
+   inline void insert(const unsigned char* key_begin, const std::size_t& length)
+   {
+      word_type mask[words_per_block];
+      const uint64_t hash = hash_64(key_begin, length);
+      compute_mask(static_cast<word_type>(hash), mask);
+      block_insert(block_of(hash), mask);
+      ++inserted_element_count_;
+   }
+
+   template<typename T>
+   inline void insert(const T& t)
+   {
+      // Note: T must be a C++ POD type.
+      insert(reinterpret_cast<const unsigned char*>(&t),sizeof(T));
+   }
+
+   inline void insert(const std::string& key)
+   {
+      insert(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline void insert(const char* data, const std::size_t& length)
+   {
+      insert(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   template<typename InputIterator>
+   inline void insert(const InputIterator begin, const InputIterator end)
+   {
+      InputIterator itr = begin;
+      while (end != itr)
+      {
+         insert(*(itr++));
+      }
+   }
+
+   inline bool contains(const unsigned char* key_begin, const std::size_t length) const
+   {
+      word_type mask[words_per_block];
+      const uint64_t hash = hash_64(key_begin, length);
+      compute_mask(static_cast<word_type>(hash), mask);
+      return block_contains(block_of(hash), mask);
+   }
+
+   template<typename T>
+   inline bool contains(const T& t) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(&t),static_cast<std::size_t>(sizeof(T)));
+   }
+
+   inline bool contains(const std::string& key) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(key.c_str()),key.size());
+   }
+
+   inline bool contains(const char* data, const std::size_t& length) const
+   {
+      return contains(reinterpret_cast<const unsigned char*>(data),length);
+   }
+
+   /*!
+    * \brief Batch lookup of `count` keys of `length` bytes stored contiguously at `keys`.
+    * Hashes of a group of keys are computed and their blocks prefetched before
+    * probing, so the cache misses of the group overlap.
+    * \param[out] result Array of `count` items, set to true for keys that are (probably) present.
+    * \return Number of keys that are (probably) present.
+    */
+   inline std::size_t contains(const unsigned char* keys, const std::size_t length, const std::size_t count, bool* result) const
+   {
+      uint64_t hash[batch_size];
+      word_type mask[words_per_block];
+      std::size_t found = 0;
+
+      for (std::size_t start = 0; start < count; start += batch_size)
+      {
+         const std::size_t n = std::min(batch_size, count - start);
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            hash[i] = hash_64(keys + (start + i) * length, length);
+            __builtin_prefetch(block_of(hash[i]));
+         }
+         for (std::size_t i = 0; i < n; ++i)
+         {
+            compute_mask(static_cast<word_type>(hash[i]), mask);
+            result[start + i] = block_contains(block_of(hash[i]), mask);
+            found += result[start + i];
+         }
+      }
+      return found;
+   }
+
+   template<typename T>
+   inline std::size_t contains(const T* keys, const std::size_t count, bool* result) const
+   {
+      // Note: T must be a C++ POD type.
+      return contains(reinterpret_cast<const unsigned char*>(keys), sizeof(T), count, result);
+   }
+
+   template<typename InputIterator>
+   inline InputIterator contains_all(const InputIterator begin, const InputIterator end) const
+   {
+      InputIterator itr = begin;
+      while (end != itr)
+      {
+         if (!contains(*itr))
+         {
+            return itr;
+         }
+         ++itr;
+      }
+      return end;
+   }
+
+   template<typename InputIterator>
+   inline InputIterator contains_none(const InputIterator begin, const InputIterator end) const
+   {
+      InputIterator itr = begin;
+      while (end != itr)
+      {
+         if (contains(*itr))
+         {
+            return itr;
+         }
+         ++itr;
+      }
+      return end;
+   }
+
+   inline uint64_t size() const
+   {
+      return block_count_ * bits_per_block;
+   }
+
+   inline std::size_t element_count() const
+   {
+      return inserted_element_count_;
+   }
+
+   inline double effective_fpp() const
+   {
+      /*
+        Note:
+        Approximation which ignores the uneven load of blocks,
+        the real false positive probability is slightly higher.
+      */
+      return std::pow(1.0 - std::exp(-1.0 * hash_count_ * inserted_element_count_ / size()), 1.0 * hash_count_);
+   }
+
+   inline blocked_bloom_filter& operator &= (const blocked_bloom_filter& f)
+   {
+      /* intersection */
+      if (compatible(f))
+      {
+         word_type* table = block_table_;
+         const word_type* other = f.block_table_;
+         for (std::size_t i = 0; i < block_count_ * words_per_block; ++i)
+         {
+            table[i] &= other[i];
+         }
+      }
+      return *this;
+   }
+
+   inline blocked_bloom_filter& operator |= (const blocked_bloom_filter& f)
+   {
+      /* union */
+      if (compatible(f))
+      {
+         word_type* table = block_table_;
+         const word_type* other = f.block_table_;
+         for (std::size_t i = 0; i < block_count_ * words_per_block; ++i)
+         {
+            table[i] |= other[i];
+         }
+      }
+      return *this;
+   }
+
+   inline blocked_bloom_filter& operator ^= (const blocked_bloom_filter& f)
+   {
+      /* difference */
+      if (compatible(f))
+      {
+         word_type* table = block_table_;
+         const word_type* other = f.block_table_;
+         for (std::size_t i = 0; i < block_count_ * words_per_block; ++i)
+         {
+            table[i] ^= other[i];
+         }
+      }
+      return *this;
+   }
+
+   inline const unsigned char* table() const
+   {
+      return reinterpret_cast<const unsigned char*>(block_table_);
+   }
+
+   inline std::size_t hash_count() const
+   {
+      return hash_count_;
+   }
+
+protected:
+
+   inline std::size_t raw_table_size() const
+   {
+      return block_count_ * block_size;
+   }
+
+   void allocate_table()
+   {
+      void* mem = 0;
+      if (posix_memalign(&mem, block_size, raw_table_size()) != 0) {
+         throw std::bad_alloc();
+      }
+      block_table_ = static_cast<word_type*>(mem);
+   }
+
+   inline bool compatible(const blocked_bloom_filter& f) const
+   {
+      return (block_count_ == f.block_count_) &&
+             (hash_count_  == f.hash_count_)  &&
+             (random_seed_ == f.random_seed_);
+   }
+
+   inline word_type* block_of(const uint64_t& hash) const
+   {
+      /* upper 32 bits of the hash are mapped onto [0, block_count_) without division */
+      return block_table_ + ((hash >> 32) * block_count_ >> 32) * words_per_block;
+   }
+
+   inline void compute_mask(const word_type& hash, word_type* mask) const
+   {
+      /*
+        Note:
+        Odd multipliers derive up to words_per_block independent 9-bit
+        bit positions inside the 512-bit block from the lower 32 bits of
+        the hash (multiply-shift hashing as in Impala's split block bloom
+        filter, but positions are not restricted to one bit per word so
+        that all words are used for any number of hashes).
+      */
+      static const word_type salt[words_per_block] = {
+         0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+         0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+         0x1e5a3f97U, 0xc9c5b1e3U, 0x6a1c8d45U, 0xe2d1f4a9U,
+         0x3b9e7c25U, 0x8d4b6a0fU, 0xf0a3c867U, 0x57e1b2d3U
+      };
+      word_type position[words_per_block];
+#if defined(__AVX2__)
+      const __m256i h = _mm256_set1_epi32(static_cast<int>(hash));
+      for (std::size_t i = 0; i < words_per_block; i += 8)
+      {
+         const __m256i p = _mm256_mullo_epi32(h, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt + i)));
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(position + i), _mm256_srli_epi32(p, 23));
+      }
+#else
+      for (std::size_t i = 0; i < hash_count_; ++i)
+      {
+         position[i] = (hash * salt[i]) >> 23;
+      }
+#endif
+      std::memset(mask, 0, block_size);
+      for (std::size_t i = 0; i < hash_count_; ++i)
+      {
+         mask[position[i] >> 5] |= static_cast<word_type>(1) << (position[i] & 0x1F);
+      }
+   }
+
+   inline static void block_insert(word_type* block, const word_type* mask)
+   {
+#if defined(__AVX2__)
+      for (std::size_t i = 0; i < words_per_block; i += 8)
+      {
+         __m256i* b = reinterpret_cast<__m256i*>(block + i);
+         _mm256_store_si256(b, _mm256_or_si256(_mm256_load_si256(b),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i))));
+      }
+#else
+      for (std::size_t i = 0; i < words_per_block; ++i)
+      {
+         block[i] |= mask[i];
+      }
+#endif
+   }
+
+   inline static bool block_contains(const word_type* block, const word_type* mask)
+   {
+#if defined(__AVX2__)
+      const __m256i* b = reinterpret_cast<const __m256i*>(block);
+      const __m256i* m = reinterpret_cast<const __m256i*>(mask);
+      /* testc returns 1 when all bits set in the mask are set in the block */
+      return _mm256_testc_si256(_mm256_load_si256(b), _mm256_loadu_si256(m)) &&
+             _mm256_testc_si256(_mm256_load_si256(b + 1), _mm256_loadu_si256(m + 1));
+#else
+      word_type missing = 0;
+      for (std::size_t i = 0; i < words_per_block; ++i)
+      {
+         missing |= mask[i] & ~block[i];
+      }
+      return (0 == missing);
+#endif
+   }
+
+   inline uint64_t hash_64(const unsigned char* begin, std::size_t remaining_length) const
+   {
+      /* MurmurHash64A by Austin Appleby, seeded with the filter's random seed */
+      const uint64_t m = 0xC6A4A7935BD1E995ULL;
+      const int r = 47;
+      uint64_t hash = random_seed_ ^ (remaining_length * m);
+      const unsigned char* itr = begin;
+
+      while (remaining_length >= 8)
+      {
+         uint64_t k;
+         std::memcpy(&k, itr, sizeof(k));
+         k *= m;
+         k ^= k >> r;
+         k *= m;
+         hash ^= k;
+         hash *= m;
+         itr += 8;
+         remaining_length -= 8;
+      }
+      if (remaining_length)
+      {
+         uint64_t k = 0;
+         std::memcpy(&k, itr, remaining_length);
+         hash ^= k;
+         hash *= m;
+      }
+      hash ^= hash >> r;
+      hash *= m;
+      hash ^= hash >> r;
+      return hash;
+   }
+
+   word_type*  block_table_;
+   uint64_t    block_count_;
+   std::size_t hash_count_;
+   uint64_t    projected_element_count_;
+   std::size_t inserted_element_count_;
+   uint64_t    random_seed_;
+   double      desired_false_positive_probability_;
+};
+
+inline blocked_bloom_filter operator & (const blocked_bloom_filter& a, const blocked_bloom_filter& b)
+{
+   blocked_bloom_filter result = a;
+   result &= b;
+   return result;
+}
+
+inline blocked_bloom_filter operator | (const blocked_bloom_filter& a, const blocked_bloom_filter& b)
+{
+   blocked_bloom_filter result = a;
+   result |= b;
+   return result;
+}
+
+inline blocked_bloom_filter operator ^ (const blocked_bloom_filter& a, const blocked_bloom_filter& b)
+{
+   blocked_bloom_filter result = a;
+   result ^= b;
+   return result;
+}
+
 #endif
 
 
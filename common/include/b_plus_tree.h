@@ -126,6 +126,41 @@ bpt_t *bpt_init(unsigned int size_of_btree_node,
                              unsigned int size_of_value,
                              unsigned int size_of_key);
 
+/*!
+ * \brief Compare function for uint32_t keys
+ * Passing this function to bpt_init() with 4 byte keys enables inline
+ * comparison of keys in the tree.
+ * \param[in] key1 pointer to the first key.
+ * \param[in] key2 pointer to the second key.
+ * \return EQUAL, LESS or MORE.
+ */
+int bpt_compare_uint32(void *key1, void *key2);
+
+/*!
+ * \brief Compare function for uint64_t keys
+ * Passing this function to bpt_init() with 8 byte keys enables inline
+ * comparison of keys in the tree (e.g. timestamps).
+ * \param[in] key1 pointer to the first key.
+ * \param[in] key2 pointer to the second key.
+ * \return EQUAL, LESS or MORE.
+ */
+int bpt_compare_uint64(void *key1, void *key2);
+
+/*!
+ * \brief Bulk load of sorted items to B+ tree
+ * Function builds the tree bottom-up from an array of keys sorted in
+ * ascending order (without duplicates). Leaves are filled almost
+ * completely, so it is much faster than inserting items one by one.
+ * The tree has to be empty.
+ * \param[in] btree pointer to B+ tree.
+ * \param[in] keys array of count keys, size_of_key bytes each.
+ * \param[in] values array of count values, size_of_value bytes each,
+ *     or NULL to zero the values.
+ * \param[in] count count of items.
+ * \return 1 ON SUCCESS, 0 tree is not empty, keys are not sorted or memory error.
+ */
+int bpt_bulk_load(bpt_t *btree, void *keys, void *values, unsigned long int count);
+
 /*!
  * \brief Destroy B+ tree
  * Function removes all the keys, values and nodes in the tree.
@@ -222,6 +257,47 @@ int bpt_list_start(bpt_t *tree, bpt_list_item_t *item);
  */
 int bpt_list_item_next(bpt_t *tree, bpt_list_item_t *item);
 
+/*!
+ * \brief Find first item not less than key
+ * Function sets the iteration structure to the first item in the sorted
+ * list whose key is greater than or equal to the given key. The iteration
+ * can continue by bpt_list_item_next().
+ * \param[in] tree pointer to B+ tree.
+ * \param[out] item pointer to iteration structure.
+ * \param[in] key key to search.
+ * \return 1 ON SUCCESS, 0 there is no such item.
+ */
+int bpt_list_lower_bound(bpt_t *tree, bpt_list_item_t *item, void *key);
+
+/*!
+ * \brief Find first item greater than key
+ * Function sets the iteration structure to the first item in the sorted
+ * list whose key is greater than the given key. The iteration
+ * can continue by bpt_list_item_next().
+ * \param[in] tree pointer to B+ tree.
+ * \param[out] item pointer to iteration structure.
+ * \param[in] key key to search.
+ * \return 1 ON SUCCESS, 0 there is no such item.
+ */
+int bpt_list_upper_bound(bpt_t *tree, bpt_list_item_t *item, void *key);
+
+/*!
+ * \brief Iterate items in range of keys
+ * Function calls func for every item with key from <from, to> in sorted order.
+ * It searches the first item and then walks through the linked leaves, so
+ * the complexity is O(log n + k). Keys and values passed to func point directly
+ * to the tree, func must not insert or delete items.
+ * \param[in] tree pointer to B+ tree.
+ * \param[in] from the lowest key of the range or NULL for the first item.
+ * \param[in] to the highest key of the range or NULL for the last item.
+ * \param[in] func function called for every item, it gets key, value and arg.
+ *     Nonzero return value stops the iteration.
+ * \param[in] arg user argument passed to func.
+ * \return count of items passed to func.
+ */
+unsigned long int bpt_range_scan(bpt_t *tree, void *from, void *to,
+                                 int (*func)(void *key, void *value, void *arg), void *arg);
+
 /*!
  * \brief Remove item
  * Function removes actual item in the iteration structure and sets iteration to next item
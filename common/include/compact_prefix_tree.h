@@ -0,0 +1,193 @@
+/*!
+ * \file compact_prefix_tree.h
+ * \brief Memory efficient variant of prefix tree for storing domains.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+#ifndef _COMPACT_PREFIX_TREE_
+#define _COMPACT_PREFIX_TREE_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "prefix_tree.h"
+
+/*!
+ * \name Default values
+ *  Defines macros used by compact prefix tree
+ * \{ */
+#define CPT_ARENA_BLOCK_SIZE (1024 * 1024) /*< Size of one block of the arena */
+#define CPT_LINEAR_SEARCH_LIMIT 8 /*< Children are searched linearly up to this count, binary search is used otherwise */
+/* /} */
+
+typedef struct cpt_node_t cpt_node_t;
+typedef struct cpt_domain_t cpt_domain_t;
+
+/*!
+ * \brief Structure - Compact prefix tree - radix node
+ * Node holds a part of one label of domain (the part between separators).
+ * The string is a slice of memory owned by the arena, nodes created by
+ * splitting share it with the original node. Children are kept in one
+ * block: array of `capacity` pointers followed by `capacity` first
+ * characters of the children, both sorted by the character.
+ */
+struct cpt_node_t {
+   const char *string;     /*< stored part of label (reversed for suffix tree) */
+   cpt_node_t *parent;     /*< pointer to parent, NULL for the first node of label */
+   cpt_domain_t *domain;   /*< if the label ends here, pointer to its domain structure */
+   cpt_node_t **child;     /*< sorted descendants followed by their first characters */
+   uint16_t length;        /*< length of stored string */
+   uint16_t count_of_children; /*< count of descendants */
+   uint16_t capacity;      /*< size of child block */
+};
+
+/*!
+ * \brief Structure - Compact prefix tree - domain structure
+ * It has the same meaning as prefix_tree_domain_t, user value is stored in
+ * the arena right behind the structure.
+ */
+struct cpt_domain_t {
+   unsigned char exception;  /*< 1 for exception in detection, 0 for classic domain */
+   unsigned char degree;     /*< degree of domain */
+   unsigned int count_of_insert;  /*< count of inserting this domain name */
+   unsigned int count_of_different_subdomains; /*< count of descendants - subdomains */
+   cpt_node_t *parent;       /*< pointer to parent (node with last character of domain) */
+   cpt_domain_t *parent_domain;  /*< pointer to parent (domain name) */
+   cpt_node_t *child;        /*< pointer to the first node of subdomain labels */
+   void *value;              /*< pointer to user value - specified by init function */
+};
+
+/*!
+ * \brief Structure - Compact prefix tree - memory arena
+ * Nodes, domains, values and strings are allocated by bumping a pointer in
+ * large blocks. Memory is returned to the system only by destroying the tree,
+ * child blocks released by growing nodes are reused through free lists.
+ */
+typedef struct cpt_arena_t {
+   void *blocks;        /*< linked list of allocated blocks */
+   char *pos;           /*< first free byte of the current block */
+   char *end;           /*< end of the current block */
+   void *free_child[9]; /*< free child blocks by log2 of capacity */
+   size_t allocated;    /*< memory allocated from the system */
+} cpt_arena_t;
+
+/*!
+ * \brief Structure - Compact prefix tree main structure
+ */
+typedef struct cpt_t {
+   cpt_node_t *root;       /*< first node of the top level labels */
+   cpt_domain_t root_domain; /*< domain of empty string, parent of top level domains */
+   unsigned int size_of_value; /*< size of value stored for every domain node */
+   int domain_separator;   /*< separator in text, which creates domain node */
+   unsigned char prefix_suffix; /*< prefix or suffix tree */
+   unsigned int count_of_inserting;   /*< Count of inserting (all domains) */
+   unsigned int count_of_different_domains; /*< Count of unique inserted domains */
+   unsigned int count_of_nodes;   /*< Count of radix nodes */
+   cpt_arena_t arena;      /*< memory of the tree */
+} cpt_t;
+
+/*!
+ * \brief Init function for compact prefix tree
+ * Unlike prefix_tree_initialize(), there are no domain extension lists and
+ * nodes cannot be deleted, the tree is released as a whole.
+ * \param[in] prefix_suffix PREFIX for prefix tree or SUFFIX for suffix tree
+ * \param[in] size_of_value size of space for value
+ * \param[in] domain_separator character of domain separator, -1 for none
+ * \return pointer to tree structure or NULL on memory error
+ */
+cpt_t *cpt_initialize(unsigned char prefix_suffix, unsigned int size_of_value, int domain_separator);
+
+/*!
+ * \brief Destroy function for compact prefix tree
+ * \param[in] tree pointer to the tree
+ */
+void cpt_destroy(cpt_t *tree);
+
+/*!
+ * \brief Add domain to the tree
+ * Function has the same semantics as prefix_tree_insert().
+ * \param[in] tree pointer to the tree
+ * \param[in] string string which should be added
+ * \param[in] length length of string
+ * \return added or found domain, NULL for exception or memory error
+ */
+cpt_domain_t *cpt_insert(cpt_t *tree, const char *string, int length);
+
+/*!
+ * \brief Search domain in the tree
+ * \param[in] tree pointer to the tree
+ * \param[in] string string which should be found
+ * \param[in] length length of string
+ * \return found domain or NULL
+ */
+cpt_domain_t *cpt_search(cpt_t *tree, const char *string, int length);
+
+/*!
+ * \brief Add domain to the tree and set it to the exception state
+ * \param[in] tree pointer to the tree
+ * \param[in] string string which should be added
+ * \param[in] length length of string
+ * \return added or found domain
+ */
+cpt_domain_t *cpt_add_string_exception(cpt_t *tree, const char *string, int length);
+
+/*!
+ * \brief Test domain if it or some of its parent domains is in exception state
+ * \param[in] tree pointer to the tree
+ * \param[in] string string which should be tested
+ * \param[in] length length of string
+ * \return 1 is in exception, 0 not in exception
+ */
+int cpt_is_string_in_exception(cpt_t *tree, const char *string, int length);
+
+/*!
+ * \brief Read domain from tree
+ * \param[in] tree pointer to the tree
+ * \param[in] domain pointer to domain, which should be returned in string
+ * \param[out] string pointer on memory where to store string
+ * \return pointer to string
+ */
+char *cpt_read_string(cpt_t *tree, cpt_domain_t *domain, char *string);
+
+/*!
+ * \brief Get memory allocated by the tree
+ * \param[in] tree pointer to the tree
+ * \return count of bytes allocated from the system
+ */
+size_t cpt_memory_usage(cpt_t *tree);
+
+#endif /* _COMPACT_PREFIX_TREE_ */
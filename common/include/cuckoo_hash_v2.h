@@ -6,6 +6,7 @@
  */
 
 #include <stdint.h>
+#include <pthread.h>
 
 #ifndef CUCKOO_HASH_V2_H
 #define CUCKOO_HASH_V2_H
@@ -91,6 +92,117 @@ void ht_clear_v2(cc_hash_table_v2_t *ht);
  */
 void ht_destroy_v2(cc_hash_table_v2_t *ht);
 
+/**
+ * Number of item slots in one bucket of the concurrent table.
+ */
+#define HT_CONC_SLOTS_PER_BUCKET 4
+
+/**
+ * Return codes of the concurrent table operations.
+ */
+#define HT_CONC_INSERTED 0 /**< New item was inserted. */
+#define HT_CONC_UPDATED 1 /**< Item with the same key was present and was updated. */
+#define HT_CONC_FAILURE -1 /**< Operation failed (no memory). */
+
+/**
+ * Bucket of the concurrent table. Items are stored out of line in the
+ * key/data slab, the bucket holds their hashes to avoid rehashing keys
+ * during cuckoo path search and resize.
+ */
+typedef struct {
+    /*@{*/
+    uint64_t hash[HT_CONC_SLOTS_PER_BUCKET]; /**< Hashes of stored items. */
+    uint8_t occupied[HT_CONC_SLOTS_PER_BUCKET]; /**< Flags of slot usage. */
+    /*@}*/
+} ht_conc_bucket_t;
+
+/**
+ * One generation of bucket storage of the concurrent table (replaced on resize).
+ */
+typedef struct ht_conc_storage_s {
+    /*@{*/
+    ht_conc_bucket_t *buckets; /**< Array of buckets. */
+    char *items; /**< Slab of key + data pairs, one per slot. */
+    uint64_t bucket_mask; /**< Number of buckets - 1 (number of buckets is power of 2). */
+    struct ht_conc_storage_s *retired; /**< Previous generations, freed on destroy. */
+    /*@}*/
+} ht_conc_storage_t;
+
+/**
+ * Lock of a stripe of buckets, sequence counter is odd while locked.
+ */
+typedef struct {
+    /*@{*/
+    uint32_t version; /**< Sequence counter. */
+    char padding[60]; /**< Padding to the size of a cache line. */
+    /*@}*/
+} ht_conc_lock_t;
+
+/**
+ * Structure of the concurrent hash table.
+ * Readers do not take any locks, they validate their snapshot by sequence
+ * counters of the lock stripes. Writers lock only the stripes of the two
+ * buckets of the key (and of the buckets on the cuckoo path being executed).
+ * Resizing locks all stripes; with background resize enabled it is started
+ * by a dedicated thread when the load factor exceeds the threshold.
+ */
+typedef struct {
+    /*@{*/
+    ht_conc_storage_t *storage; /**< Current bucket storage. */
+    ht_conc_lock_t *locks; /**< Array of stripe locks. */
+    uint64_t lock_mask; /**< Number of stripe locks - 1. */
+    uint64_t count; /**< Number of stored items. */
+    unsigned int data_size; /**< Size of the data stored in every item. */
+    unsigned int key_length; /**< Length of the key used for items. */
+    unsigned int data_offset; /**< Offset of data from the key in the slab. */
+    unsigned int item_size; /**< Size of key + data (with alignment) in the slab. */
+    double max_load; /**< Load factor that triggers background resize. */
+    int background_resize; /**< Flag of the background resize thread. */
+    int resize_pending; /**< Resize was requested from the resize thread. */
+    int stop; /**< Flag for the resize thread to terminate. */
+    pthread_t resize_thread; /**< Background resize thread. */
+    pthread_mutex_t resize_mutex; /**< Serializes resizes and guards the flags above. */
+    pthread_cond_t resize_cond; /**< Signals requests to and completion of resizes. */
+    /*@}*/
+} cc_hash_table_v2_conc_t;
+
+/*
+ * Initialization function for the concurrent table.
+ */
+int ht_conc_init_v2(cc_hash_table_v2_conc_t *ht, unsigned int table_size, unsigned int data_size, unsigned int key_length, int background_resize);
+
+/*
+ * Functions for inserting or updating an element of the concurrent table.
+ */
+int ht_conc_insert_v2(cc_hash_table_v2_conc_t *ht, const char *key, const void *new_data);
+int ht_conc_upsert_v2(cc_hash_table_v2_conc_t *ht, const char *key, const void *new_data, void (*update)(void *data, void *arg), void *arg);
+
+/*
+ * Getter of a copy of data from the concurrent table.
+ */
+int ht_conc_get_v2(cc_hash_table_v2_conc_t *ht, const char *key, void *data);
+
+/*
+ * Procedure for removing single item from the concurrent table.
+ */
+int ht_conc_remove_v2(cc_hash_table_v2_conc_t *ht, const char *key);
+
+/*
+ * Function for doubling the size of the concurrent table.
+ */
+int ht_conc_resize_v2(cc_hash_table_v2_conc_t *ht);
+
+/*
+ * Number of items and capacity of the concurrent table.
+ */
+uint64_t ht_conc_count_v2(cc_hash_table_v2_conc_t *ht);
+uint64_t ht_conc_capacity_v2(cc_hash_table_v2_conc_t *ht);
+
+/*
+ * Destructor of the concurrent table.
+ */
+void ht_conc_destroy_v2(cc_hash_table_v2_conc_t *ht);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,550 @@
+/*!
+ * \file compact_prefix_tree.c
+ * \brief Memory efficient variant of prefix tree for storing domains.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+#include "../include/compact_prefix_tree.h"
+
+#define CPT_ALIGN(size, align) (((size) + (align) - 1) & ~((size_t) (align) - 1))
+#define CPT_BLOCK_HEADER 16
+#define CPT_MAX_NODE_LENGTH UINT16_MAX
+
+/* size of child block for given capacity: pointers followed by first characters */
+#define CPT_CHILD_BLOCK_SIZE(capacity) CPT_ALIGN((capacity) * (sizeof(cpt_node_t *) + 1), sizeof(void *))
+/* first characters of children */
+#define CPT_KEYS(node) ((unsigned char *) ((node)->child + (node)->capacity))
+
+static void *cpt_arena_alloc(cpt_arena_t *arena, size_t size, size_t align)
+{
+   char *item = NULL;
+
+   if (arena->pos != NULL) {
+      item = (char *) CPT_ALIGN((uintptr_t) arena->pos, align);
+   }
+   if (item == NULL || item + size > arena->end) {
+      size_t block_size = CPT_ARENA_BLOCK_SIZE;
+      char *block;
+
+      if (size + CPT_BLOCK_HEADER > block_size) {
+         block_size = size + CPT_BLOCK_HEADER;
+      }
+      block = (char *) malloc(block_size);
+      if (block == NULL) {
+         return NULL;
+      }
+      *(void **) block = arena->blocks;
+      arena->blocks = block;
+      arena->allocated += block_size;
+      arena->end = block + block_size;
+      item = block + CPT_BLOCK_HEADER;
+   }
+   arena->pos = item + size;
+   memset(item, 0, size);
+   return item;
+}
+
+static void cpt_arena_clean(cpt_arena_t *arena)
+{
+   void *block, *next;
+
+   block = arena->blocks;
+   while (block != NULL) {
+      next = *(void **) block;
+      free(block);
+      block = next;
+   }
+   memset(arena, 0, sizeof(cpt_arena_t));
+}
+
+static int cpt_capacity_order(int capacity)
+{
+   int order = 0;
+   while ((1 << order) < capacity) {
+      order++;
+   }
+   return order;
+}
+
+/*!
+ * \brief Make room for one more child
+ * Child block is doubled, the old one is kept in the free list for other nodes.
+ */
+static int cpt_grow_children(cpt_arena_t *arena, cpt_node_t *node)
+{
+   int capacity, order;
+   cpt_node_t **child;
+
+   capacity = node->capacity == 0 ? 1 : node->capacity * 2;
+   order = cpt_capacity_order(capacity);
+   if (arena->free_child[order] != NULL) {
+      child = (cpt_node_t **) arena->free_child[order];
+      arena->free_child[order] = *(void **) child;
+   } else {
+      child = (cpt_node_t **) cpt_arena_alloc(arena, CPT_CHILD_BLOCK_SIZE(capacity), sizeof(void *));
+      if (child == NULL) {
+         return -1;
+      }
+   }
+   if (node->capacity != 0) {
+      memcpy(child, node->child, node->count_of_children * sizeof(cpt_node_t *));
+      memcpy(child + capacity, CPT_KEYS(node), node->count_of_children);
+      order = cpt_capacity_order(node->capacity);
+      *(void **) node->child = arena->free_child[order];
+      arena->free_child[order] = node->child;
+   }
+   node->child = child;
+   node->capacity = capacity;
+   return 0;
+}
+
+/*!
+ * \brief Find position of child starting by the character
+ * \param[out] pos index of the child, or index where it should be inserted
+ * \return 1 if the child exists, 0 otherwise
+ */
+static inline int cpt_find_child(const cpt_node_t *node, unsigned char letter, int *pos)
+{
+   const unsigned char *keys;
+   int left, right, middle;
+
+   if (node->count_of_children == 0) {
+      *pos = 0;
+      return 0;
+   }
+   keys = CPT_KEYS(node);
+   if (node->count_of_children <= CPT_LINEAR_SEARCH_LIMIT) {
+      for (left = 0; left < node->count_of_children && keys[left] < letter; left++);
+   } else {
+      left = 0;
+      right = node->count_of_children;
+      while (left < right) {
+         middle = (left + right) / 2;
+         if (keys[middle] < letter) {
+            left = middle + 1;
+         } else {
+            right = middle;
+         }
+      }
+   }
+   *pos = left;
+   return left < node->count_of_children && keys[left] == letter;
+}
+
+static int cpt_add_child(cpt_arena_t *arena, cpt_node_t *node, int pos, cpt_node_t *child)
+{
+   unsigned char *keys;
+
+   if (node->count_of_children == node->capacity && cpt_grow_children(arena, node) != 0) {
+      return -1;
+   }
+   keys = CPT_KEYS(node);
+   memmove(node->child + pos + 1, node->child + pos, (node->count_of_children - pos) * sizeof(cpt_node_t *));
+   memmove(keys + pos + 1, keys + pos, node->count_of_children - pos);
+   node->child[pos] = child;
+   keys[pos] = (unsigned char) child->string[0];
+   node->count_of_children++;
+   child->parent = node;
+   return 0;
+}
+
+static cpt_node_t *cpt_new_node(cpt_t *tree, const char *string, int length)
+{
+   cpt_node_t *node;
+
+   node = (cpt_node_t *) cpt_arena_alloc(&tree->arena, sizeof(cpt_node_t), sizeof(void *));
+   if (node == NULL) {
+      return NULL;
+   }
+   node->string = string;
+   node->length = length;
+   tree->count_of_nodes++;
+   return node;
+}
+
+/*!
+ * \brief Add rest of label as new child of node
+ * The string is copied to the arena, labels longer than a node can hold are
+ * split into a chain of nodes.
+ * \return last node of the label
+ */
+static cpt_node_t *cpt_add_leaf(cpt_t *tree, cpt_node_t *node, int pos, const char *label, int length)
+{
+   char *string;
+   cpt_node_t *leaf;
+   int part;
+
+   string = (char *) cpt_arena_alloc(&tree->arena, length, 1);
+   if (string == NULL) {
+      return NULL;
+   }
+   memcpy(string, label, length);
+   while (length > 0) {
+      part = length > CPT_MAX_NODE_LENGTH ? CPT_MAX_NODE_LENGTH : length;
+      leaf = cpt_new_node(tree, string, part);
+      if (leaf == NULL || cpt_add_child(&tree->arena, node, pos, leaf) != 0) {
+         return NULL;
+      }
+      node = leaf;
+      pos = 0;
+      string += part;
+      length -= part;
+   }
+   return node;
+}
+
+/*!
+ * \brief Find or create the node where the label ends
+ * \param[in] node first node of the level of labels
+ */
+static cpt_node_t *cpt_insert_label(cpt_t *tree, cpt_node_t *node, const char *label, int length)
+{
+   cpt_node_t *child, *middle;
+   int i = 0, pos, common, limit;
+
+   while (i < length) {
+      if (!cpt_find_child(node, (unsigned char) label[i], &pos)) {
+         return cpt_add_leaf(tree, node, pos, label + i, length - i);
+      }
+      child = node->child[pos];
+      limit = child->length < length - i ? child->length : length - i;
+      for (common = 1; common < limit && child->string[common] == label[i + common]; common++);
+      if (common < child->length) {
+         //split the child, both parts share its string
+         middle = cpt_new_node(tree, child->string, common);
+         if (middle == NULL) {
+            return NULL;
+         }
+         middle->parent = node;
+         node->child[pos] = middle;
+         child->string += common;
+         child->length -= common;
+         if (cpt_add_child(&tree->arena, middle, 0, child) != 0) {
+            return NULL;
+         }
+         child = middle;
+      }
+      node = child;
+      i += common;
+   }
+   return node;
+}
+
+static cpt_node_t *cpt_search_label(cpt_node_t *node, const char *label, int length)
+{
+   int i = 0, pos;
+
+   while (i < length) {
+      if (!cpt_find_child(node, (unsigned char) label[i], &pos)) {
+         return NULL;
+      }
+      node = node->child[pos];
+      if (node->length > length - i || memcmp(node->string, label + i, node->length) != 0) {
+         return NULL;
+      }
+      i += node->length;
+   }
+   return node;
+}
+
+static cpt_domain_t *cpt_new_domain(cpt_t *tree, cpt_node_t *node, cpt_domain_t *parent_domain)
+{
+   cpt_domain_t *domain, *iter;
+   size_t size;
+
+   size = CPT_ALIGN(sizeof(cpt_domain_t), sizeof(void *));
+   domain = (cpt_domain_t *) cpt_arena_alloc(&tree->arena, size + tree->size_of_value, sizeof(void *));
+   if (domain == NULL) {
+      return NULL;
+   }
+   if (tree->size_of_value > 0) {
+      domain->value = (char *) domain + size;
+   }
+   domain->parent = node;
+   domain->parent_domain = parent_domain;
+   domain->degree = parent_domain->degree + 1;
+   for (iter = parent_domain; iter != NULL; iter = iter->parent_domain) {
+      iter->count_of_different_subdomains++;
+   }
+   node->domain = domain;
+   return domain;
+}
+
+/*!
+ * \brief Get string in order of the tree
+ * Suffix tree is a prefix tree of reversed strings.
+ */
+static const char *cpt_key(cpt_t *tree, const char *string, int length, char *buffer, char **allocated)
+{
+   int i;
+
+   if (tree->prefix_suffix == PREFIX) {
+      return string;
+   }
+   if (length > MAX_SIZE_OF_DOMAIN) {
+      *allocated = (char *) malloc(length);
+      if (*allocated == NULL) {
+         return NULL;
+      }
+      buffer = *allocated;
+   }
+   for (i = 0; i < length; i++) {
+      buffer[i] = string[length - i - 1];
+   }
+   return buffer;
+}
+
+static inline int cpt_label_end(cpt_t *tree, const char *key, int start, int length)
+{
+   const char *end;
+
+   if (tree->domain_separator < 0) {
+      return length;
+   }
+   end = (const char *) memchr(key + start, (unsigned char) tree->domain_separator, length - start);
+   return end == NULL ? length : end - key;
+}
+
+static cpt_domain_t *cpt_add_domain(cpt_t *tree, const char *string, int length)
+{
+   char buffer[MAX_SIZE_OF_DOMAIN], *allocated = NULL;
+   const char *key;
+   cpt_domain_t *domain = &tree->root_domain;
+   cpt_node_t *node;
+   int start = 0, end;
+
+   key = cpt_key(tree, string, length, buffer, &allocated);
+   if (key == NULL) {
+      return NULL;
+   }
+   while (1) {
+      if (domain->child == NULL) {
+         domain->child = cpt_new_node(tree, "", 0);
+         if (domain->child == NULL) {
+            domain = NULL;
+            break;
+         }
+      }
+      end = cpt_label_end(tree, key, start, length);
+      node = cpt_insert_label(tree, domain->child, key + start, end - start);
+      if (node == NULL) {
+         domain = NULL;
+         break;
+      }
+      if (node->domain == NULL) {
+         if (cpt_new_domain(tree, node, domain) == NULL) {
+            domain = NULL;
+            break;
+         }
+      } else if (node->domain->exception) {
+         domain = NULL;
+         break;
+      }
+      domain = node->domain;
+      if (end >= length) {
+         break;
+      }
+      start = end + 1;
+   }
+   free(allocated);
+   return domain;
+}
+
+cpt_t *cpt_initialize(unsigned char prefix_suffix, unsigned int size_of_value, int domain_separator)
+{
+   cpt_t *tree;
+
+   tree = (cpt_t *) calloc(1, sizeof(cpt_t));
+   if (tree == NULL) {
+      return NULL;
+   }
+   tree->prefix_suffix = prefix_suffix;
+   tree->size_of_value = size_of_value;
+   tree->domain_separator = domain_separator;
+   tree->root = cpt_new_node(tree, "", 0);
+   if (tree->root == NULL) {
+      cpt_destroy(tree);
+      return NULL;
+   }
+   tree->root_domain.child = tree->root;
+   return tree;
+}
+
+void cpt_destroy(cpt_t *tree)
+{
+   if (tree != NULL) {
+      cpt_arena_clean(&tree->arena);
+      free(tree);
+   }
+}
+
+cpt_domain_t *cpt_insert(cpt_t *tree, const char *string, int length)
+{
+   cpt_domain_t *found;
+
+   found = cpt_add_domain(tree, string, length);
+   if (found == NULL) {
+      //exception or error
+      return NULL;
+   }
+   found->count_of_insert++;
+   tree->count_of_inserting++;
+   if (found->count_of_insert == 1) {
+      tree->count_of_different_domains++;
+   }
+   return found;
+}
+
+cpt_domain_t *cpt_add_string_exception(cpt_t *tree, const char *string, int length)
+{
+   cpt_domain_t *found;
+
+   found = cpt_add_domain(tree, string, length);
+   if (found != NULL) {
+      found->exception = 1;
+   }
+   return found;
+}
+
+cpt_domain_t *cpt_search(cpt_t *tree, const char *string, int length)
+{
+   char buffer[MAX_SIZE_OF_DOMAIN], *allocated = NULL;
+   const char *key;
+   cpt_domain_t *domain = &tree->root_domain;
+   cpt_node_t *node;
+   int start = 0, end;
+
+   key = cpt_key(tree, string, length, buffer, &allocated);
+   if (key == NULL) {
+      return NULL;
+   }
+   while (domain != NULL) {
+      if (domain->child == NULL) {
+         domain = NULL;
+         break;
+      }
+      end = cpt_label_end(tree, key, start, length);
+      node = cpt_search_label(domain->child, key + start, end - start);
+      domain = node == NULL ? NULL : node->domain;
+      if (end >= length) {
+         break;
+      }
+      start = end + 1;
+   }
+   free(allocated);
+   return domain;
+}
+
+int cpt_is_string_in_exception(cpt_t *tree, const char *string, int length)
+{
+   char buffer[MAX_SIZE_OF_DOMAIN], *allocated = NULL;
+   const char *key;
+   cpt_domain_t *domain = &tree->root_domain;
+   cpt_node_t *node;
+   int start = 0, end, ret = 0;
+
+   key = cpt_key(tree, string, length, buffer, &allocated);
+   if (key == NULL) {
+      return 0;
+   }
+   while (domain->child != NULL) {
+      end = cpt_label_end(tree, key, start, length);
+      node = cpt_search_label(domain->child, key + start, end - start);
+      if (node == NULL || node->domain == NULL) {
+         break;
+      }
+      domain = node->domain;
+      if (domain->exception) {
+         ret = 1;
+         break;
+      }
+      if (end >= length) {
+         break;
+      }
+      start = end + 1;
+   }
+   free(allocated);
+   return ret;
+}
+
+char *cpt_read_string(cpt_t *tree, cpt_domain_t *domain, char *string)
+{
+   cpt_node_t *node;
+   int pos = 0, i;
+
+   if (tree->prefix_suffix == PREFIX) {
+      //labels are read from the end, count length of the string first
+      cpt_domain_t *iter;
+      for (iter = domain; iter->parent_domain != NULL; iter = iter->parent_domain) {
+         for (node = iter->parent; node != NULL; node = node->parent) {
+            pos += node->length;
+         }
+         if (iter->parent_domain->parent_domain != NULL) {
+            pos++;
+         }
+      }
+      string[pos] = 0;
+      for (; domain->parent_domain != NULL; domain = domain->parent_domain) {
+         for (node = domain->parent; node != NULL; node = node->parent) {
+            pos -= node->length;
+            memcpy(string + pos, node->string, node->length);
+         }
+         if (domain->parent_domain->parent_domain != NULL) {
+            string[--pos] = tree->domain_separator;
+         }
+      }
+   } else {
+      for (; domain->parent_domain != NULL; domain = domain->parent_domain) {
+         for (node = domain->parent; node != NULL; node = node->parent) {
+            for (i = node->length - 1; i >= 0; i--) {
+               string[pos++] = node->string[i];
+            }
+         }
+         if (domain->parent_domain->parent_domain != NULL) {
+            string[pos++] = tree->domain_separator;
+         }
+      }
+      string[pos] = 0;
+   }
+   return string;
+}
+
+size_t cpt_memory_usage(cpt_t *tree)
+{
+   return sizeof(cpt_t) + tree->arena.allocated;
+}
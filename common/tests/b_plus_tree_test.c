@@ -43,6 +43,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <stdint.h>
 #include <time.h>
@@ -244,7 +245,123 @@ exit_label:
    return ret_val;
 }
 
-int run_tests(int test_count, int tree_size_leaf)
+typedef struct range_check_t {
+   test_pair_t *pairs; //indexed by key
+   uint32_t last;
+   unsigned long int cnt;
+   int ok; //items are sorted and have expected values
+} range_check_t;
+
+static int range_callback(void *key, void *value, void *arg)
+{
+   range_check_t *check = (range_check_t *) arg;
+   uint32_t k = ((b_key_t *) key)->key;
+   if ((check->cnt > 0 && k <= check->last) || ((b_value_t *) value)->value != check->pairs[k].value) {
+      check->ok = 0;
+   }
+   check->last = k;
+   check->cnt++;
+   return 0;
+}
+
+int check_range_of_items(test_pair_t *pairs, void *tree, uint32_t test_count)
+{
+   int ret_val = 0, round, found;
+   uint32_t i, from, to, expected_first, expected_next;
+   unsigned long int expected_cnt;
+   range_check_t check;
+   bpt_list_item_t *b_item = NULL;
+   b_key_t key_st, key_to;
+   double time_diff;
+   struct timespec start_time = {0,0}, end_time = {0,0};
+   clock_gettime(CLOCK_MONOTONIC, &start_time);
+   b_item = bpt_list_init(tree);
+   if (b_item == NULL) {
+      fprintf(stderr,"ERROR during initializing list iterator structure\n");
+      ret_val = -1;
+      goto exit_label3;
+   }
+   for (round = 0; round < 100; round++) {
+      //keys in pairs are 0 .. test_count - 1
+      from = rand() % (test_count + 2);
+      to = from + rand() % (test_count / 10 + 2);
+      expected_cnt = 0;
+      expected_first = test_count + 1;
+      expected_next = test_count + 1;
+      for (i = from; i < test_count && i <= to; i++) {
+         if (pairs[i].deleted == 0) {
+            if (expected_cnt == 0) {
+               expected_first = i;
+            }
+            expected_cnt++;
+         }
+      }
+      for (i = from + 1; i < test_count; i++) {
+         if (pairs[i].deleted == 0) {
+            expected_next = i;
+            break;
+         }
+      }
+      if (expected_cnt == 0) {
+         for (i = to + 1; i < test_count; i++) {
+            if (pairs[i].deleted == 0) {
+               expected_first = i;
+               break;
+            }
+         }
+      }
+      key_st.key = from;
+      key_to.key = to;
+      memset(&check, 0, sizeof(check));
+      check.pairs = pairs;
+      check.ok = 1;
+      if (bpt_range_scan(tree, &key_st, &key_to, range_callback, &check) != expected_cnt ||
+          check.cnt != expected_cnt || check.ok == 0) {
+         fprintf(stderr, "ERROR, range <%u, %u> has %lu items, expected %lu.\n", from, to, check.cnt, expected_cnt);
+         ret_val = -7;
+         goto exit_label3;
+      }
+      found = bpt_list_lower_bound(tree, b_item, &key_st);
+      if (expected_first > test_count ? found != 0 :
+          (found != 1 || ((b_key_t *) b_item->key)->key != expected_first ||
+           ((b_value_t *) b_item->value)->value != pairs[expected_first].value)) {
+         fprintf(stderr, "ERROR, lower bound of %u is not %u.\n", from, expected_first);
+         ret_val = -7;
+         goto exit_label3;
+      }
+      found = bpt_list_upper_bound(tree, b_item, &key_st);
+      if (expected_next > test_count ? found != 0 :
+          (found != 1 || ((b_key_t *) b_item->key)->key != expected_next)) {
+         fprintf(stderr, "ERROR, upper bound of %u is not %u.\n", from, expected_next);
+         ret_val = -7;
+         goto exit_label3;
+      }
+   }
+   //whole tree
+   memset(&check, 0, sizeof(check));
+   check.pairs = pairs;
+   check.ok = 1;
+   expected_cnt = bpt_range_scan(tree, NULL, NULL, range_callback, &check);
+   if (expected_cnt != bpt_item_cnt(tree) || check.ok == 0) {
+      fprintf(stderr, "ERROR, range scan of the whole tree returned %lu items, expected %lu.\n", expected_cnt, bpt_item_cnt(tree));
+      ret_val = -7;
+   }
+
+exit_label3:
+   if (b_item != NULL) {
+      bpt_list_clean(b_item);
+      b_item = NULL;
+   }
+   if (ret_val >= 0) {
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+      time_diff = difftime_ms(end_time, start_time);
+      time_one_set_of_test += time_diff;
+      printf("OK. Time: %fs\n", time_diff);
+   }
+   return ret_val;
+}
+
+int run_tests(int test_count, int tree_size_leaf, int bulk)
 {
    int rand_del, is_there_next, ret;
    uint32_t i, count_of_deleted_items = 0;
@@ -259,7 +376,9 @@ int run_tests(int test_count, int tree_size_leaf)
 
    b_key_t key_st;
    b_key_t *key_pt = NULL;
+   b_key_t *bulk_keys = NULL;
    b_value_t *value_pt = NULL;
+   b_value_t *bulk_values = NULL;
    bpt_list_item_t *b_item = NULL;
    //allocate structures for testing
    pairs = malloc(test_count * sizeof(test_pair_t));
@@ -296,29 +415,76 @@ int run_tests(int test_count, int tree_size_leaf)
    // Sort pairs on random value for delete
    qsort(pairs_sorted_random_for_delete, test_count, sizeof(test_pair_t*), &compare_random_delete_value_in_pairs);
    //initialize tree
-   tree = bpt_init(tree_size_leaf, &compare_key, sizeof(b_value_t), sizeof(b_key_t));
+   tree = bpt_init(tree_size_leaf, bulk ? &bpt_compare_uint32 : &compare_key, sizeof(b_value_t), sizeof(b_key_t));
    if (tree == NULL) {
       fprintf(stderr,"ERROR during initializing b_plus_tree\n");
       ret_val = -1;
       goto exit_label;
    }
-   //insert items to the tree
-   printf("TEST - Item insertion\n");
-   clock_gettime(CLOCK_MONOTONIC, &start_time);
-   for (i = 0; i < test_count; i++) {
-      key_st.key = pairs[i].key;
-      value_pt = bpt_insert(tree, &key_st);
-      if (value_pt == NULL) {
-         fprintf(stderr,"ERROR during insertion. Key %u, value %lu \n", pairs[i].key, pairs[i].value);
+   if (bulk) {
+      //bulk load of sorted items to the tree
+      printf("TEST - Bulk load\n");
+      bulk_keys = malloc(test_count * sizeof(b_key_t));
+      bulk_values = malloc(test_count * sizeof(b_value_t));
+      if (bulk_keys == NULL || bulk_values == NULL) {
+         fprintf(stderr,"ERROR: There are not enaugh memmory for this test. Please decrease the test_count\n Actual test_count = %u\n", test_count);
+         ret_val = -1;
+         goto exit_label;
+      }
+      for (i = 0; i < (uint32_t) test_count; i++) {
+         bulk_keys[i].key = pairs[i].key;
+         bulk_values[i].value = pairs[i].value;
+      }
+      if (test_count > 1) {
+         //unsorted keys have to be refused
+         bulk_keys[0].key = pairs[1].key;
+         if (bpt_bulk_load(tree, bulk_keys, bulk_values, test_count) != 0 || bpt_item_cnt(tree) != 0) {
+            fprintf(stderr,"ERROR, bulk load accepted unsorted keys.\n");
+            ret_val = -2;
+            goto exit_label;
+         }
+         bulk_keys[0].key = pairs[0].key;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      if (bpt_bulk_load(tree, bulk_keys, bulk_values, test_count) != 1) {
+         fprintf(stderr,"ERROR during bulk load.\n");
+         ret_val = -2;
+         goto exit_label;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+      time_diff = difftime_ms(end_time, start_time);
+      time_one_set_of_test += time_diff;
+      if (bpt_item_cnt(tree) != (unsigned long int) test_count) {
+         fprintf(stderr,"ERROR, bulk load inserted %lu items instead of %d.\n", bpt_item_cnt(tree), test_count);
          ret_val = -2;
          goto exit_label;
       }
-      value_pt->value = pairs[i].value;
+      //tree is not empty anymore
+      if (bpt_bulk_load(tree, bulk_keys, bulk_values, test_count) != 0) {
+         fprintf(stderr,"ERROR, bulk load to not empty tree.\n");
+         ret_val = -2;
+         goto exit_label;
+      }
+      printf("OK - %d items loaded. Time: %fs\n", test_count, time_diff);
+   } else {
+      //insert items to the tree
+      printf("TEST - Item insertion\n");
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      for (i = 0; i < test_count; i++) {
+         key_st.key = pairs[i].key;
+         value_pt = bpt_insert(tree, &key_st);
+         if (value_pt == NULL) {
+            fprintf(stderr,"ERROR during insertion. Key %u, value %lu \n", pairs[i].key, pairs[i].value);
+            ret_val = -2;
+            goto exit_label;
+         }
+         value_pt->value = pairs[i].value;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+      time_diff = difftime_ms(end_time, start_time);
+      time_one_set_of_test += time_diff;
+      printf("OK - %d items inserted. Time: %fs\n", test_count, time_diff);
    }
-   clock_gettime(CLOCK_MONOTONIC, &end_time);
-   time_diff = difftime_ms(end_time, start_time);
-   time_one_set_of_test += time_diff;
-   printf("OK - %d items inserted. Time: %fs\n", test_count, time_diff);
 
    //test sort of items
    printf("TEST - Sort of inserted items\n");
@@ -377,6 +543,13 @@ int run_tests(int test_count, int tree_size_leaf)
       ret_val = ret;
       goto exit_label;
    }
+   printf("TEST - Range scan and bounds of remaining items.\n");
+   ret = check_range_of_items(pairs, tree, test_count);
+   if (ret < 0) {
+      //error
+      ret_val = ret;
+      goto exit_label;
+   }
 
    //delete items during iterating the list of items.
    printf("TEST - Delete approximately 50%% remaining items during iteration the sorted list of items.\n");
@@ -460,6 +633,13 @@ int run_tests(int test_count, int tree_size_leaf)
       ret_val = ret;
       goto exit_label;
    }
+   printf("TEST - Range scan and bounds of remaining items.\n");
+   ret = check_range_of_items(pairs, tree, test_count);
+   if (ret < 0) {
+      //error
+      ret_val = ret;
+      goto exit_label;
+   }
    printf("Dealocation of memmory\n");
 
 exit_label:
@@ -483,6 +663,14 @@ exit_label:
       free(pairs_sorted_random_for_delete);
       pairs_sorted_random_for_delete = NULL;
    }
+   if (bulk_keys != NULL) {
+      free(bulk_keys);
+      bulk_keys = NULL;
+   }
+   if (bulk_values != NULL) {
+      free(bulk_values);
+      bulk_values = NULL;
+   }
 
    if (ret_val < 0) {
       printf("run_tests failed!\n");
@@ -494,15 +682,17 @@ exit_label:
 
 int main(int argc, char **argv)
 {
-   int test = 1, test_cnt_it, leaf_cnt_it, res;
-   for (leaf_cnt_it = 0; leaf_cnt_it < LEAF_SIZE_ARR_SIZE; leaf_cnt_it++) {
-      for (test_cnt_it = 0; test_cnt_it < TEST_SIZE_ARR_SIZE; test_cnt_it++) {
-         printf("%d.TEST - count of items = %u, leaf size = %u\n"\
-                "---------------------------------------------------\n", test++, test_size_arr[test_cnt_it], leaf_size_arr[leaf_cnt_it]);
-         res = run_tests(test_size_arr[test_cnt_it], leaf_size_arr[leaf_cnt_it]);
-         printf("\n");
-         if (res < 0) {
-            return res;
+   int test = 1, test_cnt_it, leaf_cnt_it, bulk, res;
+   for (bulk = 0; bulk <= 1; bulk++) {
+      for (leaf_cnt_it = 0; leaf_cnt_it < LEAF_SIZE_ARR_SIZE; leaf_cnt_it++) {
+         for (test_cnt_it = 0; test_cnt_it < TEST_SIZE_ARR_SIZE; test_cnt_it++) {
+            printf("%d.TEST - count of items = %u, leaf size = %u%s\n"\
+                   "---------------------------------------------------\n", test++, test_size_arr[test_cnt_it], leaf_size_arr[leaf_cnt_it], bulk ? ", bulk load" : "");
+            res = run_tests(test_size_arr[test_cnt_it], leaf_size_arr[leaf_cnt_it], bulk);
+            printf("\n");
+            if (res < 0) {
+               return res;
+            }
          }
       }
    }
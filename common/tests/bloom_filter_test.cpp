@@ -0,0 +1,243 @@
+/*!
+ * \file bloom_filter_test.cpp
+ * \brief Test suit for bloom filter variants in BloomFilter.hpp
+ * \date 2026
+ */
+
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#include "../include/BloomFilter.hpp"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <type_traits>
+
+#define ITEM_CNT 100000
+
+static bloom_parameters get_parameters()
+{
+   bloom_parameters p;
+   p.projected_element_count = ITEM_CNT;
+   p.false_positive_probability = 0.01;
+   p.compute_optimal_parameters();
+   return p;
+}
+
+static int test_blocked_bloom_filter()
+{
+   int result = 0;
+   bloom_parameters p = get_parameters();
+   blocked_bloom_filter filter(p);
+
+   /* ******************** */
+   printf("TEST 1: BLOCKED - NO FALSE NEGATIVES...");
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      filter.insert(i * 2);
+   }
+   uint32_t missing = 0;
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      if (!filter.contains(i * 2)) {
+         missing++;
+      }
+   }
+   if (missing != 0) {
+      result = 1;
+      printf(" failed - %u inserted keys not found.\n", missing);
+   } else {
+      printf(" ok\n");
+   }
+
+   /* ******************** */
+   printf("TEST 2: BLOCKED - FALSE POSITIVE RATE...");
+   uint32_t false_positives = 0;
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      if (filter.contains(i * 2 + 1)) {
+         false_positives++;
+      }
+   }
+   /* blocking costs some accuracy, allow 3x the requested probability */
+   if (false_positives > 3 * p.false_positive_probability * ITEM_CNT) {
+      result = 1;
+      printf(" failed - %u false positives out of %u.\n", false_positives, ITEM_CNT);
+   } else {
+      printf(" ok\n");
+   }
+
+   /* ******************** */
+   printf("TEST 3: BLOCKED - BATCH CONTAINS...");
+   std::vector<uint32_t> keys(ITEM_CNT);
+   bool found[ITEM_CNT];
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      keys[i] = i;
+   }
+   size_t found_cnt = filter.contains(&keys[0], ITEM_CNT, found);
+   size_t expected_cnt = 0;
+   bool match = true;
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      if (found[i] != filter.contains(keys[i])) {
+         match = false;
+      }
+      expected_cnt += found[i];
+   }
+   if (!match || found_cnt != expected_cnt || found_cnt < ITEM_CNT / 2) {
+      result = 1;
+      printf(" failed - batch results differ from single lookups.\n");
+   } else {
+      printf(" ok\n");
+   }
+
+   /* ******************** */
+   printf("TEST 4: BLOCKED - UNION AND INTERSECTION...");
+   blocked_bloom_filter a(p), b(p);
+   a.insert(std::string("first"));
+   b.insert(std::string("second"));
+   blocked_bloom_filter u = a | b;
+   blocked_bloom_filter n = a & b;
+   if (!u.contains(std::string("first")) || !u.contains(std::string("second")) ||
+       n.contains(std::string("first")) || n.contains(std::string("second"))) {
+      result = 1;
+      printf(" failed\n");
+   } else {
+      printf(" ok\n");
+   }
+
+   /* ******************** */
+   printf("TEST 5: BLOCKED - COPY AND CLEAR...");
+   blocked_bloom_filter copy(filter);
+   copy.clear();
+   if (copy == filter || copy.contains(0U) || !filter.contains(0U) || copy.element_count() != 0) {
+      result = 1;
+      printf(" failed\n");
+   } else {
+      printf(" ok\n");
+   }
+
+   return result;
+}
+
+/* counters could be bypassed through a bloom_filter reference */
+static_assert(!std::is_convertible<counting_bloom_filter*, bloom_filter*>::value,
+              "counting_bloom_filter must not be usable as bloom_filter");
+
+static int test_counting_bloom_filter()
+{
+   int result = 0;
+   bloom_parameters p = get_parameters();
+   counting_bloom_filter filter(p);
+
+   /* ******************** */
+   printf("TEST 6: COUNTING - INSERT AND ERASE...");
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      filter.insert(i);
+   }
+   for (uint32_t i = 0; i < ITEM_CNT; i += 2) {
+      filter.erase(i);
+   }
+   uint32_t missing = 0;
+   uint32_t remaining = 0;
+   for (uint32_t i = 0; i < ITEM_CNT; i++) {
+      if (i % 2 == 1 && !filter.contains(i)) {
+         missing++;
+      } else if (i % 2 == 0 && filter.contains(i)) {
+         remaining++;
+      }
+   }
+   if (missing != 0 || remaining > 3 * p.false_positive_probability * ITEM_CNT) {
+      result = 1;
+      printf(" failed - %u kept keys missing, %u erased keys still present.\n", missing, remaining);
+   } else {
+      printf(" ok\n");
+   }
+
+   /* ******************** */
+   printf("TEST 7: COUNTING - MULTIPLICITY...");
+   counting_bloom_filter small(p);
+   small.insert(std::string("key"));
+   small.insert(std::string("key"));
+   bool first = small.erase(std::string("key"));
+   bool still_present = small.contains(std::string("key"));
+   bool second = small.erase(std::string("key"));
+   bool third = small.erase(std::string("key"));
+   if (!first || !still_present || !second || third || small.contains(std::string("key"))) {
+      result = 1;
+      printf(" failed\n");
+   } else {
+      printf(" ok\n");
+   }
+
+   return result;
+}
+
+static int test_time_decaying_bloom_filter()
+{
+   int result = 0;
+   bloom_parameters p = get_parameters();
+   /* 4 generations of 60 time units */
+   time_decaying_bloom_filter filter(p, 4, 60);
+
+   /* ******************** */
+   printf("TEST 8: TIME DECAYING - WINDOW...");
+   filter.advance(1000);
+   filter.insert(std::string("old"));
+   filter.advance(1100);
+   filter.insert(std::string("recent"));
+   bool ok = filter.contains(std::string("old")) && filter.contains(std::string("recent"));
+   filter.advance(1000 + 4 * 60);
+   ok = ok && !filter.contains(std::string("old")) && filter.contains(std::string("recent"));
+   filter.advance(1000 + 10 * 60);
+   ok = ok && !filter.contains(std::string("recent")) && filter.element_count() == 0;
+   if (!ok || filter.window() != 240) {
+      result = 1;
+      printf(" failed\n");
+   } else {
+      printf(" ok\n");
+   }
+
+   return result;
+}
+
+int main(void)
+{
+   int result = 0;
+
+   result |= test_blocked_bloom_filter();
+   result |= test_counting_bloom_filter();
+   result |= test_time_decaying_bloom_filter();
+
+   return result;
+}
@@ -0,0 +1,394 @@
+/**
+ * \file compact_prefix_tree_test.c
+ * \brief Test and benchmark of compact prefix tree against prefix tree
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../include/compact_prefix_tree.h"
+
+#define MAX_LENGTH 50
+#define MIN_LENGTH 2
+#define RANGE (MAX_LENGTH - MIN_LENGTH)
+#define SEPARATOR "."
+
+#define TEST_SIZE_ARR_SIZE 2
+static uint32_t test_size_arr[] = {999, 99999};
+
+/* default count of domains in benchmark, can be changed by the first argument */
+#define BENCHMARK_COUNT 50000
+
+#define difftime_ms(end, start) \
+ (((double)end.tv_sec + 1.0e-9*end.tv_nsec) - ((double)start.tv_sec + 1.0e-9*start.tv_nsec));
+
+typedef struct value_t{
+   uint32_t value;
+} value_t;
+
+char *gen_random_str(const int len)
+{
+   int i = 0;
+   static const char alphanum[] =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz"
+      SEPARATOR;
+   char *s;
+   s = (char*) malloc (sizeof(char) * (len + 1));
+   if (s == NULL) {
+      return NULL;
+   }
+   for (i = 0; i < len; i++) {
+      if (i == 0 || i == len - 1 || s[i-1] == SEPARATOR[0]) {
+         s[i] = alphanum[rand() % (sizeof(alphanum) - 2)];
+      } else {
+         s[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+      }
+   }
+   s[len] = 0;
+   return s;
+}
+
+/*
+ * Domains similar to DNS tunnel traffic: random subdomains of several
+ * thousands of registered domains.
+ */
+char *gen_random_domain(void)
+{
+   static const char *tld[] = {"com", "net", "org", "cz", "de", "info", "io", "eu"};
+   static const char alphanum[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+   char buffer[MAX_SIZE_OF_DOMAIN];
+   int len, i, labels;
+
+   len = sprintf(buffer, "n%ds%d.%s", rand() % 5000, rand() % 7, tld[rand() % 8]);
+   labels = rand() % 3;
+   while (labels-- > 0) {
+      char label[64];
+      int label_len = 4 + rand() % 28;
+      for (i = 0; i < label_len; i++) {
+         label[i] = alphanum[rand() % (sizeof(alphanum) - 1)];
+      }
+      label[label_len] = 0;
+      memmove(buffer + label_len + 1, buffer, len + 1);
+      memcpy(buffer, label, label_len);
+      buffer[label_len] = SEPARATOR[0];
+      len += label_len + 1;
+   }
+   return strdup(buffer);
+}
+
+int count_degree(const char *str, int len)
+{
+   int degree = 1, i;
+   for (i = 0; i < len; i++) {
+      if (str[i] == SEPARATOR[0]) {
+         degree++;
+      }
+   }
+   return degree;
+}
+
+int run_tests(int test_count, int toward)
+{
+   int ret_val = 0;
+   cpt_t *tree;
+   prefix_tree_t *ref;
+   int i;
+   cpt_domain_t *domain = NULL;
+   prefix_tree_domain_t *ref_domain = NULL;
+   char **array_of_strings = NULL;
+   int *array_of_lengths = NULL;
+   char test_str[MAX_LENGTH + 1];
+   value_t value;
+
+   tree = cpt_initialize(toward, sizeof(value_t), SEPARATOR[0]);
+   ref = prefix_tree_initialize(toward, sizeof(value_t), SEPARATOR[0], DOMAIN_EXTENSION_NO, RELAXATION_AFTER_DELETE_NO);
+   if (tree == NULL || ref == NULL) {
+      fprintf(stderr, "ERROR: Initialization of trees failed\n");
+      ret_val = -1;
+      goto exit_label;
+   }
+   array_of_strings = (char**) calloc(test_count, sizeof(char*));
+   array_of_lengths = (int*) malloc(sizeof(int) * test_count);
+   if (array_of_strings == NULL || array_of_lengths == NULL) {
+      fprintf(stderr, "ERROR: There are not enaugh memmory for this test.\n");
+      ret_val = -1;
+      goto exit_label;
+   }
+   for (i = 0; i < test_count; i++) {
+      array_of_lengths[i] = (rand() % RANGE) + MIN_LENGTH;
+      array_of_strings[i] = gen_random_str(array_of_lengths[i]);
+      if (array_of_strings[i] == NULL) {
+         fprintf(stderr, "ERROR: There are not enaugh memmory for this test.\n");
+         ret_val = -1;
+         goto exit_label;
+      }
+   }
+
+   printf("TEST - Inserting strings to the trees\n");
+   for (i = 0; i < test_count; i++) {
+      domain = cpt_insert(tree, array_of_strings[i], array_of_lengths[i]);
+      ref_domain = prefix_tree_insert(ref, array_of_strings[i], array_of_lengths[i]);
+      if (domain == NULL || ref_domain == NULL) {
+         fprintf(stderr, "ERROR: Inserting string \"%s\" to the tree\n", array_of_strings[i]);
+         ret_val = -2;
+         goto exit_label;
+      }
+      value.value = i;
+      if (domain->count_of_insert == 1) {
+         memcpy(domain->value, &value, sizeof(value_t));
+      }
+   }
+   printf("OK\n");
+
+   printf("TEST - Checking keys, values and counters\n");
+   for (i = 0; i < test_count; i++) {
+      domain = cpt_search(tree, array_of_strings[i], array_of_lengths[i]);
+      ref_domain = prefix_tree_search(ref, array_of_strings[i], array_of_lengths[i]);
+      if (domain == NULL || ref_domain == NULL) {
+         fprintf(stderr, "ERROR: String \"%s\" was not found in the tree\n", array_of_strings[i]);
+         ret_val = -2;
+         goto exit_label;
+      }
+      if (strncmp(array_of_strings[((value_t *) domain->value)->value], array_of_strings[i], array_of_lengths[i] + 1) != 0) {
+         fprintf(stderr, "ERROR: String \"%s\" was found but testing value is different.\n", array_of_strings[i]);
+         ret_val = -2;
+         goto exit_label;
+      }
+      if (domain->degree != count_degree(array_of_strings[i], array_of_lengths[i])) {
+         fprintf(stderr, "ERROR: String \"%s\" has wrong degree %d\n", array_of_strings[i], domain->degree);
+         ret_val = -2;
+         goto exit_label;
+      }
+      if (domain->count_of_insert != ref_domain->count_of_insert ||
+          domain->count_of_different_subdomains != ref_domain->count_of_different_subdomains) {
+         fprintf(stderr, "ERROR: String \"%s\" has counters %u %u, prefix tree says %u %u\n", array_of_strings[i],
+                 domain->count_of_insert, domain->count_of_different_subdomains,
+                 ref_domain->count_of_insert, ref_domain->count_of_different_subdomains);
+         ret_val = -2;
+         goto exit_label;
+      }
+      cpt_read_string(tree, domain, test_str);
+      if (strcmp(test_str, array_of_strings[i]) != 0) {
+         fprintf(stderr, "ERROR: String \"%s\" is not readable from the domain node. It returns %s\n", array_of_strings[i], test_str);
+         ret_val = -2;
+         goto exit_label;
+      }
+      //modified string must not be found unless it is in the tree
+      test_str[array_of_lengths[i] - 1] ^= 0x20;
+      if ((cpt_search(tree, test_str, array_of_lengths[i]) == NULL) !=
+          (prefix_tree_search(ref, test_str, array_of_lengths[i]) == NULL)) {
+         fprintf(stderr, "ERROR: Search of \"%s\" differs from prefix tree\n", test_str);
+         ret_val = -2;
+         goto exit_label;
+      }
+   }
+   printf("OK\n");
+
+   printf("TEST - Exceptions\n");
+   for (i = 0; i < test_count; i += 10) {
+      cpt_add_string_exception(tree, array_of_strings[i], array_of_lengths[i]);
+      prefix_tree_add_string_exception(ref, array_of_strings[i], array_of_lengths[i]);
+   }
+   for (i = 0; i < test_count; i++) {
+      if (cpt_is_string_in_exception(tree, array_of_strings[i], array_of_lengths[i]) !=
+          prefix_tree_is_string_in_exception(ref, array_of_strings[i], array_of_lengths[i])) {
+         fprintf(stderr, "ERROR: Exception state of \"%s\" differs from prefix tree\n", array_of_strings[i]);
+         ret_val = -2;
+         goto exit_label;
+      }
+      if ((cpt_insert(tree, array_of_strings[i], array_of_lengths[i]) == NULL) !=
+          (prefix_tree_insert(ref, array_of_strings[i], array_of_lengths[i]) == NULL)) {
+         fprintf(stderr, "ERROR: Insert of \"%s\" in exception differs from prefix tree\n", array_of_strings[i]);
+         ret_val = -2;
+         goto exit_label;
+      }
+   }
+   printf("OK\n");
+   printf("Nodes: %u, memory: %zu B\n", tree->count_of_nodes, cpt_memory_usage(tree));
+
+exit_label:
+   cpt_destroy(tree);
+   if (ref != NULL) {
+      prefix_tree_destroy(ref);
+   }
+   if (array_of_strings != NULL) {
+      for (i = 0; i < test_count; i++) {
+         free(array_of_strings[i]);
+      }
+      free(array_of_strings);
+   }
+   free(array_of_lengths);
+   return ret_val;
+}
+
+long resident_memory(void)
+{
+   long size, resident = 0;
+   FILE *f = fopen("/proc/self/statm", "r");
+   if (f != NULL) {
+      if (fscanf(f, "%ld %ld", &size, &resident) != 2) {
+         resident = 0;
+      }
+      fclose(f);
+   }
+   return resident * sysconf(_SC_PAGESIZE);
+}
+
+/*
+ * Each tree is filled in a separate process, so that the resident memory
+ * of the process can be compared.
+ */
+void benchmark_tree(int compact, int toward, char **strings, int count)
+{
+   struct timespec start_time = {0,0}, end_time = {0,0};
+   double insert_time, search_time;
+   long memory;
+   int i, found = 0;
+   pid_t pid;
+
+   fflush(stdout);
+   pid = fork();
+   if (pid != 0) {
+      if (pid > 0) {
+         waitpid(pid, NULL, 0);
+      }
+      return;
+   }
+   memory = resident_memory();
+   if (compact) {
+      cpt_t *tree = cpt_initialize(toward, sizeof(value_t), SEPARATOR[0]);
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      for (i = 0; i < count; i++) {
+         cpt_insert(tree, strings[i], strlen(strings[i]));
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+      insert_time = difftime_ms(end_time, start_time);
+      memory = resident_memory() - memory;
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      for (i = 0; i < count; i++) {
+         found += cpt_search(tree, strings[i], strlen(strings[i])) != NULL;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+   } else {
+      prefix_tree_t *tree = prefix_tree_initialize(toward, sizeof(value_t), SEPARATOR[0], DOMAIN_EXTENSION_NO, RELAXATION_AFTER_DELETE_NO);
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      for (i = 0; i < count; i++) {
+         prefix_tree_insert(tree, strings[i], strlen(strings[i]));
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+      insert_time = difftime_ms(end_time, start_time);
+      memory = resident_memory() - memory;
+      clock_gettime(CLOCK_MONOTONIC, &start_time);
+      for (i = 0; i < count; i++) {
+         found += prefix_tree_search(tree, strings[i], strlen(strings[i])) != NULL;
+      }
+      clock_gettime(CLOCK_MONOTONIC, &end_time);
+   }
+   search_time = difftime_ms(end_time, start_time);
+   printf("%-20s memory: %8.1f MiB, insert: %6.3fs (%5.2f M/s), search: %6.3fs (%5.2f M/s), found %d\n",
+          compact ? "compact_prefix_tree" : "prefix_tree", memory / 1048576.0,
+          insert_time, count / insert_time / 1e6, search_time, count / search_time / 1e6, found);
+   fflush(stdout);
+   _exit(0);
+}
+
+int run_benchmark(int count, int toward)
+{
+   char **strings;
+   int i;
+
+   strings = (char **) malloc(sizeof(char *) * count);
+   if (strings == NULL) {
+      return -1;
+   }
+   for (i = 0; i < count; i++) {
+      strings[i] = gen_random_domain();
+      if (strings[i] == NULL) {
+         return -1;
+      }
+   }
+   printf("BENCHMARK - %d domains, %s\n", count, toward == PREFIX ? "PREFIX" : "SUFFIX");
+   benchmark_tree(0, toward, strings, count);
+   benchmark_tree(1, toward, strings, count);
+   for (i = 0; i < count; i++) {
+      free(strings[i]);
+   }
+   free(strings);
+   return 0;
+}
+
+int main(int argc, char **argv)
+{
+   int i, test = 1, ret, count = BENCHMARK_COUNT;
+
+   if (argc > 1) {
+      count = atoi(argv[1]);
+   }
+   srand(0);
+   for (i = 0; i < TEST_SIZE_ARR_SIZE; i++) {
+      printf("%d.TEST - count of items = %u, PREFIX\n"\
+             "---------------------------------------------------\n", test++, test_size_arr[i]);
+      ret = run_tests(test_size_arr[i], PREFIX);
+      if (ret < 0) {
+         return ret;
+      }
+      printf("\n");
+
+      printf("%d.TEST - count of items = %u, SUFFIX\n"\
+             "---------------------------------------------------\n", test++, test_size_arr[i]);
+      ret = run_tests(test_size_arr[i], SUFFIX);
+      if (ret < 0) {
+         return ret;
+      }
+      printf("\n");
+   }
+   if (count > 0) {
+      if (run_benchmark(count, SUFFIX) != 0 || run_benchmark(count, PREFIX) != 0) {
+         fprintf(stderr, "ERROR: Benchmark failed\n");
+         return -1;
+      }
+   }
+   printf("OK - ALL TESTS WERE SUCCESSFUL\n");
+   return 0;
+}
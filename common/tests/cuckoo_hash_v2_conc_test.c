@@ -0,0 +1,195 @@
+/*!
+ * \file cuckoo_hash_v2_conc_test.c
+ * \brief Test of the concurrent cuckoo hash table
+ * \date 2026
+ */
+
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#include "../include/cuckoo_hash_v2.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define THREAD_CNT 4
+#define ITEMS_PER_THREAD 50000
+
+typedef struct test_thread_arg {
+   cc_hash_table_v2_conc_t *ht;
+   uint32_t id;
+   uint32_t errors;
+} test_thread_arg_t;
+
+static void add_one(void *data, void *arg)
+{
+   (void) arg;
+   (*(uint64_t *) data)++;
+}
+
+static void *writer(void *arg)
+{
+   test_thread_arg_t *a = (test_thread_arg_t *) arg;
+
+   for (uint32_t i = 0; i < ITEMS_PER_THREAD; i++) {
+      uint32_t key = a->id * ITEMS_PER_THREAD + i;
+      uint64_t value = (uint64_t) key * 3;
+      if (ht_conc_insert_v2(a->ht, (char *) &key, &value) != HT_CONC_INSERTED) {
+         a->errors++;
+      }
+      /* read back some keys inserted so far */
+      if (i % 7 == 0) {
+         uint32_t old_key = a->id * ITEMS_PER_THREAD + i / 2;
+         if (!ht_conc_get_v2(a->ht, (char *) &old_key, &value) || value != (uint64_t) old_key * 3) {
+            a->errors++;
+         }
+      }
+   }
+   return NULL;
+}
+
+static void *updater(void *arg)
+{
+   test_thread_arg_t *a = (test_thread_arg_t *) arg;
+   uint64_t init = 1;
+
+   for (uint32_t i = 0; i < ITEMS_PER_THREAD; i++) {
+      uint32_t key = i % 1000;
+      if (ht_conc_upsert_v2(a->ht, (char *) &key, &init, add_one, NULL) == HT_CONC_FAILURE) {
+         a->errors++;
+      }
+   }
+   return NULL;
+}
+
+static int run_threads(cc_hash_table_v2_conc_t *ht, void *(*fn)(void *))
+{
+   pthread_t threads[THREAD_CNT];
+   test_thread_arg_t args[THREAD_CNT];
+   uint32_t errors = 0;
+
+   for (uint32_t t = 0; t < THREAD_CNT; t++) {
+      args[t].ht = ht;
+      args[t].id = t;
+      args[t].errors = 0;
+      pthread_create(&threads[t], NULL, fn, &args[t]);
+   }
+   for (uint32_t t = 0; t < THREAD_CNT; t++) {
+      pthread_join(threads[t], NULL);
+      errors += args[t].errors;
+   }
+   return errors;
+}
+
+static int test_table(int background_resize)
+{
+   int result = 0;
+   cc_hash_table_v2_conc_t ht;
+   uint32_t errors;
+
+   /* start small so that the table has to be resized several times */
+   if (ht_conc_init_v2(&ht, 64, sizeof(uint64_t), sizeof(uint32_t), background_resize) != 0) {
+      printf(" failed - init\n");
+      return 1;
+   }
+
+   errors = run_threads(&ht, writer);
+   for (uint32_t key = 0; key < THREAD_CNT * ITEMS_PER_THREAD; key++) {
+      uint64_t value;
+      if (!ht_conc_get_v2(&ht, (char *) &key, &value) || value != (uint64_t) key * 3) {
+         errors++;
+      }
+   }
+   if (errors != 0 || ht_conc_count_v2(&ht) != THREAD_CNT * ITEMS_PER_THREAD) {
+      result = 1;
+      printf(" failed - %u errors after concurrent insert, count %lu.\n", errors, (unsigned long) ht_conc_count_v2(&ht));
+   }
+
+   for (uint32_t key = 0; key < THREAD_CNT * ITEMS_PER_THREAD; key += 2) {
+      if (!ht_conc_remove_v2(&ht, (char *) &key)) {
+         errors++;
+      }
+   }
+   for (uint32_t key = 0; key < THREAD_CNT * ITEMS_PER_THREAD; key++) {
+      if (ht_conc_get_v2(&ht, (char *) &key, NULL) != (int) (key % 2)) {
+         errors++;
+      }
+   }
+   if (errors != 0 || ht_conc_count_v2(&ht) != THREAD_CNT * ITEMS_PER_THREAD / 2) {
+      result = 1;
+      printf(" failed - %u errors after remove.\n", errors);
+   }
+   ht_conc_destroy_v2(&ht);
+
+   /* concurrent in-place updates of shared keys */
+   ht_conc_init_v2(&ht, 64, sizeof(uint64_t), sizeof(uint32_t), background_resize);
+   errors = run_threads(&ht, updater);
+   for (uint32_t key = 0; key < 1000; key++) {
+      uint64_t value = 0;
+      ht_conc_get_v2(&ht, (char *) &key, &value);
+      if (value != THREAD_CNT * ITEMS_PER_THREAD / 1000) {
+         errors++;
+      }
+   }
+   if (errors != 0) {
+      result = 1;
+      printf(" failed - %u errors after concurrent upsert.\n", errors);
+   }
+   ht_conc_destroy_v2(&ht);
+
+   if (result == 0) {
+      printf(" ok\n");
+   }
+   return result;
+}
+
+int main(void)
+{
+   int result = 0;
+
+   /* ******************** */
+   printf("TEST 1: CONCURRENT INSERT, GET, REMOVE, UPSERT...");
+   result |= test_table(0);
+
+   /* ******************** */
+   printf("TEST 2: SAME WITH BACKGROUND RESIZE...");
+   result |= test_table(1);
+
+   return result;
+}
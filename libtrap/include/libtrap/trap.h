@@ -175,6 +175,7 @@ extern char *trap_default_socket_path_format;
 #define TRAP_IFC_TYPE_UNIX      'u' ///< trap_ifc_tcpip via UNIX socket(input&output part)
 #define TRAP_IFC_TYPE_SERVICE   's' ///< service ifc
 #define TRAP_IFC_TYPE_FILE      'f' ///< trap_ifc_file (input&output part)
+#define TRAP_IFC_TYPE_INPROC    'i' ///< trap_ifc_inproc, contexts of one process (input&output part)
 extern char trap_ifc_type_supported[];
 
 /**
@@ -198,10 +199,26 @@ enum trap_ifc_type {
 enum trap_ifcctl_request {
    TRAPCTL_AUTOFLUSH_TIMEOUT = 1,  ///< Set timeout of automatic buffer flushing for interface, expects uint64_t argument with number of microseconds. It can be set to #TRAP_NO_AUTO_FLUSH to disable autoflush.
    TRAPCTL_BUFFERSWITCH = 2,       ///< Enable/disable buffering - could be dangerous on input interface!!! expects char argument with value 1 (default value after libtrap initialization - enabled) or 0 (for disabling buffering on interface).
-   TRAPCTL_SETTIMEOUT = 3          ///< Set interface timeout (int32_t): in microseconds for non-blocking mode; timeout can be also: TRAP_WAIT, TRAP_HALFWAIT, or TRAP_NO_WAIT.
+   TRAPCTL_SETTIMEOUT = 3,         ///< Set interface timeout (int32_t): in microseconds for non-blocking mode; timeout can be also: TRAP_WAIT, TRAP_HALFWAIT, or TRAP_NO_WAIT.
+   TRAPCTL_PARTITION_FUNC = 4      ///< Set function selecting partition of messages on output interface with partitions (parameter partitions= of TCP and UNIX socket IFC), expects #trap_partition_func_t and void * argument passed to the function.
 };
 /**@}*/
 
+/**
+ * Function selecting partition of output interface for a message.
+ *
+ * Messages with the same result are sent to the same client of output
+ * interface with partitions, the interface uses result modulo number
+ * of partitions. When no function is set, hash of the whole message
+ * is used.
+ *
+ * \param[in] data  message
+ * \param[in] size  size of message
+ * \param[in] arg   argument given to trap_ctx_ifcctl() (#TRAPCTL_PARTITION_FUNC)
+ * \return hash of the message key
+ */
+typedef uint32_t (*trap_partition_func_t)(const void *data, uint16_t size, void *arg);
+
 #ifndef TRAP_IFC_MESSAGEQ_SIZE
 #define TRAP_IFC_MESSAGEQ_SIZE 100000 ///< size of message queue used for buffering
 #endif
@@ -0,0 +1,900 @@
+/**
+ * \file ifc_inproc.c
+ * \brief TRAP in-process interfaces
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "../include/libtrap/trap.h"
+#include "trap_ifc.h"
+#include "trap_internal.h"
+#include "trap_error.h"
+#include "ifc_inproc.h"
+#include "ifc_socket_common.h"
+
+/**
+ * \addtogroup trap_ifc TRAP communication module interface
+ * @{
+ */
+/**
+ * \addtogroup inproc_ifc
+ * @{
+ */
+
+/**
+ * Channels of the process, protected by registry_mtx.
+ */
+static inproc_channel_t *registry = NULL;
+static pthread_mutex_t registry_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint64_t get_cur_timestamp()
+{
+   struct timespec spec_time;
+
+   clock_gettime(CLOCK_MONOTONIC, &spec_time);
+   return spec_time.tv_sec * 1000000 + (spec_time.tv_nsec / 1000);
+}
+
+static inline uint64_t calculate_sleep(uint64_t current_sleep)
+{
+   uint64_t sleep = current_sleep * 2;
+   return sleep > 5000 ? 5000 : sleep;
+}
+
+/**
+ * \brief Find channel by name or create a new one and attach to it.
+ *
+ * \param[in] name  Name of the channel.
+ * \return Attached channel or NULL on memory error.
+ */
+static inproc_channel_t *channel_attach(const char *name)
+{
+   inproc_channel_t *ch;
+
+   pthread_mutex_lock(&registry_mtx);
+   for (ch = registry; ch != NULL; ch = ch->next) {
+      if (strcmp(ch->name, name) == 0) {
+         break;
+      }
+   }
+   if (ch == NULL) {
+      ch = calloc(1, sizeof(*ch));
+      if (ch == NULL || (ch->name = strdup(name)) == NULL) {
+         free(ch);
+         pthread_mutex_unlock(&registry_mtx);
+         return NULL;
+      }
+      ch->next = registry;
+      registry = ch;
+   }
+   ch->refs++;
+   pthread_mutex_unlock(&registry_mtx);
+   return ch;
+}
+
+/**
+ * \brief Detach from channel, the last detached IFC destroys it.
+ *
+ * \param[in] ch  Channel.
+ */
+static void channel_detach(inproc_channel_t *ch)
+{
+   inproc_channel_t **p;
+   inproc_format_t *fmt;
+   uint32_t i;
+
+   pthread_mutex_lock(&registry_mtx);
+   if (--ch->refs > 0) {
+      pthread_mutex_unlock(&registry_mtx);
+      return;
+   }
+   for (p = &registry; *p != NULL; p = &(*p)->next) {
+      if (*p == ch) {
+         *p = ch->next;
+         break;
+      }
+   }
+   pthread_mutex_unlock(&registry_mtx);
+
+   if (ch->containers != NULL) {
+      for (i = 0; i < ch->container_count; i++) {
+         free(ch->containers[i].buffer);
+      }
+      free(ch->containers);
+   }
+   while (ch->formats != NULL) {
+      fmt = ch->formats;
+      ch->formats = fmt->next;
+      free(fmt->data_fmt_spec);
+      free(fmt);
+   }
+   free(ch->name);
+   free(ch);
+}
+
+/***** Sender *****/
+
+/**
+ * \brief Get data format of the output IFC to be attached to published containers.
+ *
+ * Called with locked ifc_mtx of the output IFC.
+ *
+ * \param[in] c  Private data of the output IFC.
+ * \return Data format or NULL on memory error.
+ */
+static const inproc_format_t *sender_get_format(inproc_sender_private_t *c)
+{
+   trap_output_ifc_t *ifc = &c->ctx->out_ifc_list[c->ifc_idx];
+   inproc_format_t *fmt;
+
+   if (c->fmt != NULL) {
+      return c->fmt;
+   }
+   fmt = calloc(1, sizeof(*fmt));
+   if (fmt == NULL) {
+      return NULL;
+   }
+   fmt->data_type = ifc->data_type;
+   if (ifc->data_fmt_spec != NULL && (fmt->data_fmt_spec = strdup(ifc->data_fmt_spec)) == NULL) {
+      free(fmt);
+      return NULL;
+   }
+   pthread_mutex_lock(&registry_mtx);
+   fmt->next = c->channel->formats;
+   c->channel->formats = fmt;
+   pthread_mutex_unlock(&registry_mtx);
+   c->fmt = fmt;
+   return fmt;
+}
+
+/**
+ * \brief Pass the active container to the input IFC.
+ *
+ * Called with locked ifc_mtx of the output IFC.
+ *
+ * \param[in] c  Private data of the output IFC.
+ * \return 1 if a container was published, 0 otherwise.
+ */
+static int sender_publish(inproc_sender_private_t *c)
+{
+   inproc_container_t *cont = c->active;
+
+   if (cont == NULL || cont->count == 0) {
+      return 0;
+   }
+   cont->fmt = sender_get_format(c);
+   if (cont->fmt == NULL) {
+      VERBOSE(CL_ERROR, "Not enough memory, container of %"PRIu32" messages dropped.", cont->count);
+      cont->used_bytes = 0;
+      cont->count = 0;
+      return 0;
+   }
+   c->sent_containers++;
+   c->sent_messages += cont->count;
+   c->active = NULL;
+   __sync_add_and_fetch(&c->channel->head, 1);
+   c->autoflush_timestamp = get_cur_timestamp();
+   return 1;
+}
+
+/**
+ * \brief Get an empty container to be filled.
+ *
+ * If the ring is full and no input IFC is attached, the oldest container
+ * is dropped.
+ *
+ * \param[in] c  Private data of the output IFC.
+ * \return 0 on success, 1 if the ring is full.
+ */
+static int sender_acquire(inproc_sender_private_t *c)
+{
+   inproc_channel_t *ch = c->channel;
+   uint64_t head = __sync_fetch_and_add(&ch->head, 0);
+   uint64_t tail = __sync_fetch_and_add(&ch->tail, 0);
+
+   if (head - tail >= ch->container_count) {
+      if (__sync_fetch_and_add(&ch->receivers, 0) != 0 ||
+          !__sync_bool_compare_and_swap(&ch->tail, tail, tail + 1)) {
+         return 1;
+      }
+   }
+   c->active = &ch->containers[head % ch->container_count];
+   c->active->used_bytes = 0;
+   c->active->count = 0;
+   c->active->seq_num = c->processed_messages;
+   return 0;
+}
+
+/**
+ * \brief Store message into container.
+ *
+ * \param[in] priv      pointer to module private data
+ * \param[in] data      pointer to data to write
+ * \param[in] size      size of data to write
+ * \param[in] timeout   maximum time spent waiting for the message to be stored [microseconds]
+ *
+ * \return TRAP_E_OK         Success.
+ * \return TRAP_E_TIMEOUT    Message was not stored into container and the attempt should be repeated.
+ * \return TRAP_E_TERMINATED Libtrap was terminated during the process.
+ */
+int inproc_sender_send(void *priv, const void *data, uint16_t size, int timeout)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   inproc_channel_t *ch = c->channel;
+   pthread_mutex_t *mtx = &c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx;
+   uint64_t sleep_time = 1, deadline = 0;
+   inproc_container_t *cont;
+   uint16_t size_16b = htons(size);
+
+   if (size + sizeof(size) > ch->container_size) {
+      VERBOSE(CL_ERROR, "Container is too small for message of size [%u B]. Skipping...", size);
+      return TRAP_E_OK;
+   }
+   if (timeout > 0) {
+      deadline = get_cur_timestamp() + timeout;
+   }
+
+repeat:
+   if (c->is_terminated) {
+      return TRAP_E_TERMINATED;
+   }
+   if (timeout == TRAP_WAIT && __sync_fetch_and_add(&ch->receivers, 0) == 0) {
+      usleep(NO_CLIENTS_SLEEP);
+      goto repeat;
+   }
+
+   pthread_mutex_lock(mtx);
+   if (c->active != NULL && c->active->used_bytes + size + sizeof(size) > ch->container_size) {
+      sender_publish(c);
+   }
+   if (c->active == NULL && sender_acquire(c) != 0) {
+      pthread_mutex_unlock(mtx);
+      if (timeout == TRAP_NO_WAIT || (timeout == TRAP_HALFWAIT && __sync_fetch_and_add(&ch->receivers, 0) == 0) ||
+          (timeout > 0 && get_cur_timestamp() >= deadline)) {
+         return TRAP_E_TIMEOUT;
+      }
+      usleep(sleep_time);
+      sleep_time = calculate_sleep(sleep_time);
+      goto repeat;
+   }
+
+   cont = c->active;
+   memcpy(cont->buffer + cont->used_bytes, &size_16b, sizeof(size_16b));
+   memcpy(cont->buffer + cont->used_bytes + sizeof(size_16b), data, size);
+   cont->used_bytes += size + sizeof(size_16b);
+   cont->count++;
+   c->processed_messages++;
+
+   /* If bufferswitch is 0, only 1 message is allowed to be stored in buffer */
+   if (c->ctx->out_ifc_list[c->ifc_idx].bufferswitch == 0) {
+      sender_publish(c);
+   }
+   pthread_mutex_unlock(mtx);
+
+   return TRAP_E_OK;
+}
+
+/**
+ * \brief Force flush of active container
+ *
+ * \param[in] priv pointer to interface private data
+ */
+void inproc_sender_flush(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+
+   pthread_mutex_lock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+   if (sender_publish(c)) {
+      __sync_add_and_fetch(&c->ctx->counter_autoflush[c->ifc_idx], 1);
+   }
+   pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+}
+
+static void *autoflush_thread(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   int64_t timeout, time_since_flush;
+
+   pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+
+   while (!c->is_terminated) {
+      timeout = c->ctx->out_ifc_list[c->ifc_idx].timeout;
+      if (timeout <= 0) {
+         usleep(NO_CLIENTS_SLEEP);
+         continue;
+      }
+      time_since_flush = get_cur_timestamp() - c->autoflush_timestamp;
+      if (time_since_flush >= timeout) {
+         inproc_sender_flush(c);
+         usleep(timeout);
+      } else {
+         usleep(timeout - time_since_flush);
+      }
+   }
+   pthread_exit(NULL);
+}
+
+/**
+ * \brief Data format of the output IFC is going to be changed.
+ *
+ * Messages of the active container are published with the old format, the
+ * new one is taken from the context with the next container. Called with
+ * locked ifc_mtx of the output IFC.
+ *
+ * \param[in] priv pointer to interface private data
+ */
+void inproc_sender_disconnect_clients(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+
+   sender_publish(c);
+   c->fmt = NULL;
+}
+
+/**
+ * \brief Set interface state as terminated.
+ *
+ * Active container is published and the input IFC (if attached) is given
+ * a chance to read all published containers.
+ *
+ * \param[in] priv pointer to interface private data
+ */
+void inproc_sender_terminate(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   inproc_channel_t *ch;
+   uint64_t tail, last_tail, last_progress;
+
+   if (c == NULL) {
+      VERBOSE(CL_ERROR, "Destroying IFC that is probably not initialized.");
+      return;
+   }
+   ch = c->channel;
+   inproc_sender_flush(c);
+   last_tail = __sync_fetch_and_add(&ch->tail, 0);
+   last_progress = get_cur_timestamp();
+   while (__sync_fetch_and_add(&ch->receivers, 0) != 0 && !ch->receiver_terminated &&
+          (tail = __sync_fetch_and_add(&ch->tail, 0)) != __sync_fetch_and_add(&ch->head, 0)) {
+      if (tail != last_tail) {
+         last_tail = tail;
+         last_progress = get_cur_timestamp();
+      } else if (get_cur_timestamp() - last_progress >= INPROC_TERMINATE_TIMEOUT) {
+         VERBOSE(CL_VERBOSE_LIBRARY, "Input IFC of channel \"%s\" does not receive, %"PRIu64" containers are left unread.",
+                 ch->name, __sync_fetch_and_add(&ch->head, 0) - tail);
+         break;
+      }
+      usleep(10000); //prevents busy waiting
+   }
+   c->is_terminated = 1;
+}
+
+/**
+ * \brief Destructor of in-process sender (output ifc)
+ *
+ * \param[in] priv pointer to interface private data
+ */
+void inproc_sender_destroy(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   void *res;
+
+   if (c == NULL) {
+      return;
+   }
+   c->is_terminated = 1;
+   if (c->autoflush_running) {
+      pthread_cancel(c->autoflush_thr);
+      pthread_join(c->autoflush_thr, &res);
+   }
+   if (c->channel != NULL) {
+      __sync_sub_and_fetch(&c->channel->senders, 1);
+      channel_detach(c->channel);
+   }
+   free(c);
+}
+
+static void inproc_sender_create_dump(void *priv, uint32_t idx, const char *path)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   char *conf_file = NULL;
+   FILE *f;
+
+   if (asprintf(&conf_file, "%s/trap-o%02"PRIu32"-config.txt", path, idx) == -1) {
+      VERBOSE(CL_ERROR, "Not enough memory, dump failed. (%s:%d)", __FILE__, __LINE__);
+      return;
+   }
+   f = fopen(conf_file, "w");
+   if (f != NULL) {
+      fprintf(f, "Channel: %s\nContainers: %"PRIu32"\nContainer size: %"PRIu32"\n"
+              "Head: %"PRIu64"\nTail: %"PRIu64"\nReceivers: %"PRIu32"\n"
+              "Sent containers: %"PRIu64"\nSent messages: %"PRIu64"\nTerminated: %d\n",
+              c->channel->name, c->channel->container_count, c->channel->container_size,
+              c->channel->head, c->channel->tail, c->channel->receivers,
+              c->sent_containers, c->sent_messages, c->is_terminated);
+      fclose(f);
+   }
+   free(conf_file);
+}
+
+int32_t inproc_sender_get_client_count(void *priv)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   return __sync_fetch_and_add(&c->channel->receivers, 0);
+}
+
+int8_t inproc_sender_get_client_stats_json(void *priv, json_t *client_stats_arr)
+{
+   inproc_sender_private_t *c = (inproc_sender_private_t *) priv;
+   char sent_containers_buf[40];
+   char sent_messages_buf[40];
+   json_t *client_stats;
+
+   if (inproc_sender_get_client_count(priv) == 0) {
+      return 1;
+   }
+   sprintf(sent_containers_buf, "%" PRIu64, c->sent_containers);
+   sprintf(sent_messages_buf, "%" PRIu64, c->sent_messages);
+   client_stats = json_pack("{sisssssssf}",
+      "id", 0,
+      "sent_containers", sent_containers_buf,
+      "sent_messages", sent_messages_buf,
+      "skipped_messages", "0",
+      "skipped_percentage", 0.0);
+   if (client_stats == NULL) {
+      return 0;
+   }
+   if (json_array_append_new(client_stats_arr, client_stats) == -1) {
+      return 0;
+   }
+   return 1;
+}
+
+char *inproc_sender_get_id(void *priv)
+{
+   return ((inproc_sender_private_t *) priv)->channel->name;
+}
+
+int create_inproc_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_ifc_t *ifc, uint32_t idx)
+{
+#define X(pointer) free(pointer); \
+   pointer = NULL;
+   inproc_sender_private_t *c = NULL;
+   inproc_channel_t *ch;
+   char *param_iterator = NULL;
+   char *name = NULL;
+   char *param_str = NULL;
+   unsigned int buffer_count = DEFAULT_BUFFER_COUNT;
+   unsigned int buffer_size = DEFAULT_BUFFER_SIZE;
+   int result = TRAP_E_OK;
+   uint32_t i;
+
+   if (params == NULL) {
+      VERBOSE(CL_ERROR, "No parameters found for output IFC.");
+      return TRAP_E_BADPARAMS;
+   }
+
+   /* Parsing params */
+   param_iterator = trap_get_param_by_delimiter(params, &name, TRAP_IFC_PARAM_DELIMITER);
+   if (name == NULL || strlen(name) == 0) {
+      VERBOSE(CL_ERROR, "Missing 'name' of channel for in-process IFC.");
+      result = TRAP_E_BADPARAMS;
+      goto failsafe_cleanup;
+   }
+   while (param_iterator != NULL) {
+      param_iterator = trap_get_param_by_delimiter(param_iterator, &param_str, TRAP_IFC_PARAM_DELIMITER);
+      if (param_str == NULL) {
+         continue;
+      }
+      if (strncmp(param_str, "buffer_count=x", BUFFER_COUNT_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + BUFFER_COUNT_PARAM_LENGTH, "%u", &buffer_count) != 1 || buffer_count == 0) {
+            VERBOSE(CL_ERROR, "Optional buffer count given, but it is probably in wrong format.");
+            buffer_count = DEFAULT_BUFFER_COUNT;
+         }
+      } else if (strncmp(param_str, "buffer_size=x", BUFFER_SIZE_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + BUFFER_SIZE_PARAM_LENGTH, "%u", &buffer_size) != 1 || buffer_size < sizeof(uint16_t) + 1) {
+            VERBOSE(CL_ERROR, "Optional buffer size given, but it is probably in wrong format.");
+            buffer_size = DEFAULT_BUFFER_SIZE;
+         }
+      } else {
+         VERBOSE(CL_ERROR, "Unknown parameter \"%s\".", param_str);
+      }
+      X(param_str);
+   }
+
+   c = calloc(1, sizeof(*c));
+   if (c == NULL) {
+      VERBOSE(CL_ERROR, "Memory allocation failed.");
+      result = TRAP_E_MEMORY;
+      goto failsafe_cleanup;
+   }
+   c->ctx = ctx;
+   c->ifc_idx = idx;
+
+   ch = c->channel = channel_attach(name);
+   if (ch == NULL) {
+      VERBOSE(CL_ERROR, "Memory allocation failed.");
+      result = TRAP_E_MEMORY;
+      goto failsafe_cleanup;
+   }
+   if (__sync_add_and_fetch(&ch->senders, 1) != 1) {
+      VERBOSE(CL_ERROR, "In-process channel \"%s\" already has an output interface.", name);
+      result = TRAP_E_BADPARAMS;
+      goto failsafe_cleanup;
+   }
+   if (ch->containers == NULL) {
+      ch->containers = calloc(buffer_count, sizeof(*ch->containers));
+      if (ch->containers == NULL) {
+         result = TRAP_E_MEMORY;
+         goto failsafe_cleanup;
+      }
+      ch->container_count = buffer_count;
+      for (i = 0; i < buffer_count; i++) {
+         ch->containers[i].buffer = malloc(buffer_size);
+         if (ch->containers[i].buffer == NULL) {
+            result = TRAP_E_MEMORY;
+            goto failsafe_cleanup;
+         }
+      }
+      ch->container_size = buffer_size;
+   } else if (ch->container_count != buffer_count || ch->container_size != buffer_size) {
+      VERBOSE(CL_WARNING, "In-process channel \"%s\" was already used, keeping its %"PRIu32" containers of %"PRIu32" B.",
+              name, ch->container_count, ch->container_size);
+   }
+   c->autoflush_timestamp = get_cur_timestamp();
+   X(name);
+
+   ifc->send = inproc_sender_send;
+   ifc->flush = inproc_sender_flush;
+   ifc->disconn_clients = inproc_sender_disconnect_clients;
+   ifc->terminate = inproc_sender_terminate;
+   ifc->destroy = inproc_sender_destroy;
+   ifc->get_client_count = inproc_sender_get_client_count;
+   ifc->get_client_stats_json = inproc_sender_get_client_stats_json;
+   ifc->create_dump = inproc_sender_create_dump;
+   ifc->get_id = inproc_sender_get_id;
+   ifc->priv = c;
+
+   if (pthread_create(&c->autoflush_thr, NULL, autoflush_thread, c) != 0) {
+      VERBOSE(CL_ERROR, "Failed to create autoflush thread.");
+      inproc_sender_destroy(c);
+      ifc->priv = NULL;
+      return TRAP_E_IO_ERROR;
+   }
+   c->autoflush_running = 1;
+
+   return TRAP_E_OK;
+
+failsafe_cleanup:
+   X(name);
+   X(param_str);
+   inproc_sender_destroy(c);
+   return result;
+#undef X
+}
+
+/***** Receiver *****/
+
+/**
+ * \brief Check data format of received container against the required one.
+ *
+ * Same rules as in negotiation of socket interfaces are applied, state of
+ * the input IFC and its data format are updated.
+ *
+ * \param[in] c    Private data of the input IFC.
+ * \param[in] fmt  Data format of the container.
+ * \return TRAP_E_OK if the messages can be received, error code otherwise.
+ */
+static int receiver_check_format(inproc_receiver_private_t *c, const inproc_format_t *fmt)
+{
+   trap_input_ifc_t *ifc = &c->ctx->in_ifc_list[c->ifc_idx];
+   const char *spec = fmt->data_fmt_spec != NULL ? fmt->data_fmt_spec : "";
+   int changed = 0, ret;
+
+   if (fmt->data_type == TRAP_FMT_UNKNOWN) {
+      VERBOSE(CL_VERBOSE_LIBRARY, "INPROC INPUT IFC[%"PRIu32"]: unknown data format of the output interface.", c->ifc_idx);
+      ifc->client_state = FMT_WAITING;
+      return TRAP_E_NEGOTIATION_FAILED;
+   }
+   if (fmt->data_type != ifc->req_data_type) {
+      ifc->client_state = FMT_MISMATCH;
+      return TRAP_E_FORMAT_MISMATCH;
+   }
+   if (fmt->data_type == TRAP_FMT_UNIREC) {
+      if (*spec == 0) {
+         ifc->client_state = FMT_MISMATCH;
+         return TRAP_E_FORMAT_MISMATCH;
+      }
+      ret = trap_ctx_cmp_data_fmt(spec, ifc->req_data_fmt_spec);
+      if (ret == TRAP_E_FIELDS_MISMATCH) {
+         ifc->client_state = FMT_MISMATCH;
+         return TRAP_E_FORMAT_MISMATCH;
+      }
+      changed = ret == TRAP_E_FIELDS_SUBSET ||
+                (ifc->data_fmt_spec != NULL && trap_ctx_cmp_data_fmt(ifc->data_fmt_spec, spec) != TRAP_E_OK);
+   } else if (fmt->data_type == TRAP_FMT_JSON) {
+      if (ifc->req_data_fmt_spec != NULL && ifc->req_data_fmt_spec[0] != 0 && strcmp(ifc->req_data_fmt_spec, spec) != 0) {
+         ifc->client_state = FMT_MISMATCH;
+         return TRAP_E_FORMAT_MISMATCH;
+      }
+      changed = ifc->data_fmt_spec != NULL && strcmp(ifc->data_fmt_spec, spec) != 0;
+   }
+
+   if (fmt->data_type != TRAP_FMT_RAW) {
+      char *new_spec = strdup(spec);
+      if (new_spec == NULL) {
+         return TRAP_E_MEMORY;
+      }
+      free(ifc->data_fmt_spec);
+      ifc->data_fmt_spec = new_spec;
+   }
+   ifc->data_type = fmt->data_type;
+   ifc->client_state = changed ? FMT_CHANGED : FMT_OK;
+   c->fmt = fmt;
+   return TRAP_E_OK;
+}
+
+/**
+ * \brief Receive container of messages.
+ *
+ * The container is owned by the input IFC until the next call.
+ *
+ * \param[in] priv  pointer to module private data
+ * \param[out] data  pointer to the received messages
+ * \param[out] size  size of the received messages
+ * \param[in] timeout  timeout in microseconds, see \ref trap_timeout
+ * \param[out] seq_number  sequence number of the first message, may be NULL
+ * \return TRAP_E_OK on success, TRAP_E_TIMEOUT if no container was published in time
+ */
+int inproc_receiver_recv_buffer(void *priv, char **data, uint32_t *size, int timeout, uint64_t *seq_number)
+{
+   inproc_receiver_private_t *c = (inproc_receiver_private_t *) priv;
+   inproc_channel_t *ch = c->channel;
+   inproc_container_t *cont;
+   uint64_t sleep_time = 1, deadline = 0, tail;
+   int ret;
+
+   if (c->holding) {
+      __sync_add_and_fetch(&ch->tail, 1);
+      c->holding = 0;
+   }
+   if (timeout > 0) {
+      deadline = get_cur_timestamp() + timeout;
+   }
+
+   while (1) {
+      if (c->is_terminated) {
+         return trap_error(c->ctx, TRAP_E_TERMINATED);
+      }
+      tail = __sync_fetch_and_add(&ch->tail, 0);
+      if (tail != __sync_fetch_and_add(&ch->head, 0)) {
+         break;
+      }
+      if (timeout == TRAP_NO_WAIT || timeout == TRAP_HALFWAIT || (timeout > 0 && get_cur_timestamp() >= deadline)) {
+         return TRAP_E_TIMEOUT;
+      }
+      usleep(sleep_time);
+      sleep_time = calculate_sleep(sleep_time);
+   }
+
+   cont = &ch->containers[tail % ch->container_count];
+   if (cont->fmt != c->fmt && (ret = receiver_check_format(c, cont->fmt)) != TRAP_E_OK) {
+      // messages of this format cannot be received
+      __sync_add_and_fetch(&ch->tail, 1);
+      return ret;
+   }
+   c->holding = 1;
+   c->received_containers++;
+   c->received_records += cont->count;
+   c->received_bytes += cont->used_bytes;
+
+   /* sequence numbers start from 1 with the first received message like in TCP IFC,
+    * a lower number than expected comes from a new output IFC of the channel */
+   if (!c->seq_started || cont->seq_num < c->seq_next) {
+      c->seq_total += c->seq_next - c->seq_offset;
+      c->seq_offset = cont->seq_num;
+      c->seq_started = 1;
+   } else if (cont->seq_num > c->seq_next) {
+      c->missed_records += cont->seq_num - c->seq_next;
+   }
+   c->seq_next = cont->seq_num + cont->count;
+
+   *data = cont->buffer;
+   *size = cont->used_bytes;
+   if (seq_number != NULL) {
+      *seq_number = c->seq_total + (cont->seq_num - c->seq_offset) + 1;
+   }
+   return TRAP_E_OK;
+}
+
+void inproc_receiver_get_input_stats(void *priv, struct input_ifc_stats *stats)
+{
+   inproc_receiver_private_t *c = (inproc_receiver_private_t *) priv;
+
+   stats->received_bytes = c->received_bytes;
+   stats->received_records = c->received_records;
+   stats->missed_records = c->missed_records;
+}
+
+void inproc_receiver_terminate(void *priv)
+{
+   inproc_receiver_private_t *c = (inproc_receiver_private_t *) priv;
+
+   if (c != NULL) {
+      c->is_terminated = 1;
+      c->channel->receiver_terminated = 1;
+   } else {
+      VERBOSE(CL_ERROR, "Destroying IFC that is probably not initialized.");
+   }
+}
+
+void inproc_receiver_destroy(void *priv)
+{
+   inproc_receiver_private_t *c = (inproc_receiver_private_t *) priv;
+
+   if (c == NULL) {
+      return;
+   }
+   if (c->channel != NULL) {
+      if (c->holding) {
+         __sync_add_and_fetch(&c->channel->tail, 1);
+      }
+      __sync_sub_and_fetch(&c->channel->receivers, 1);
+      channel_detach(c->channel);
+   }
+   free(c);
+}
+
+static void inproc_receiver_create_dump(void *priv, uint32_t idx, const char *path)
+{
+   inproc_receiver_private_t *c = (inproc_receiver_private_t *) priv;
+   char *conf_file = NULL;
+   FILE *f;
+
+   if (asprintf(&conf_file, "%s/trap-i%02"PRIu32"-config.txt", path, idx) == -1) {
+      VERBOSE(CL_ERROR, "Not enough memory, dump failed. (%s:%d)", __FILE__, __LINE__);
+      return;
+   }
+   f = fopen(conf_file, "w");
+   if (f != NULL) {
+      fprintf(f, "Channel: %s\nHead: %"PRIu64"\nTail: %"PRIu64"\nHolding: %d\n"
+              "Received containers: %"PRIu64"\nReceived messages: %"PRIu64"\nTerminated: %d\n"
+              "Timeout: %"PRId32"us (%s)\n",
+              c->channel->name, c->channel->head, c->channel->tail, c->holding,
+              c->received_containers, c->received_records, c->is_terminated,
+              c->ctx->in_ifc_list[idx].datatimeout,
+              TRAP_TIMEOUT_STR(c->ctx->in_ifc_list[idx].datatimeout));
+      fclose(f);
+   }
+   free(conf_file);
+}
+
+char *inproc_receiver_get_id(void *priv)
+{
+   return ((inproc_receiver_private_t *) priv)->channel->name;
+}
+
+uint8_t inproc_receiver_is_conn(void *priv)
+{
+   return __sync_fetch_and_add(&((inproc_receiver_private_t *) priv)->channel->senders, 0) != 0;
+}
+
+/**
+ * \brief Placeholder of the copying receive function, messages are received by inproc_receiver_recv_buffer().
+ */
+int inproc_receiver_recv(void *priv, void *data, uint32_t *size, int timeout)
+{
+   char *buffer;
+   int ret = inproc_receiver_recv_buffer(priv, &buffer, size, timeout, NULL);
+
+   if (ret == TRAP_E_OK) {
+      memcpy(data, buffer, *size);
+   }
+   return ret;
+}
+
+int create_inproc_receiver_ifc(trap_ctx_priv_t *ctx, const char *params, trap_input_ifc_t *ifc, uint32_t idx)
+{
+   inproc_receiver_private_t *c = NULL;
+   char *name = NULL;
+
+   if (params == NULL) {
+      VERBOSE(CL_ERROR, "No parameters found for input IFC.");
+      return TRAP_E_BADPARAMS;
+   }
+   trap_get_param_by_delimiter(params, &name, TRAP_IFC_PARAM_DELIMITER);
+   if (name == NULL || strlen(name) == 0) {
+      VERBOSE(CL_ERROR, "Missing 'name' of channel for in-process IFC.");
+      free(name);
+      return TRAP_E_BADPARAMS;
+   }
+
+   c = calloc(1, sizeof(*c));
+   if (c == NULL) {
+      free(name);
+      return TRAP_E_MEMORY;
+   }
+   c->ctx = ctx;
+   c->ifc_idx = idx;
+   c->channel = channel_attach(name);
+   if (c->channel == NULL) {
+      free(name);
+      free(c);
+      return TRAP_E_MEMORY;
+   }
+   if (__sync_add_and_fetch(&c->channel->receivers, 1) != 1) {
+      VERBOSE(CL_ERROR, "In-process channel \"%s\" already has an input interface.", name);
+      free(name);
+      inproc_receiver_destroy(c);
+      return TRAP_E_BADPARAMS;
+   }
+   free(name);
+   // containers published before the input IFC was attached are skipped as with socket IFCs
+   __sync_lock_test_and_set(&c->channel->tail, __sync_fetch_and_add(&c->channel->head, 0));
+   c->channel->receiver_terminated = 0;
+
+   ifc->recv = inproc_receiver_recv;
+   ifc->recv_buffer = inproc_receiver_recv_buffer;
+   ifc->get_input_stats = inproc_receiver_get_input_stats;
+   ifc->terminate = inproc_receiver_terminate;
+   ifc->destroy = inproc_receiver_destroy;
+   ifc->create_dump = inproc_receiver_create_dump;
+   ifc->get_id = inproc_receiver_get_id;
+   ifc->is_conn = inproc_receiver_is_conn;
+   ifc->priv = c;
+
+   return TRAP_E_OK;
+}
+
+/**
+ * @}
+ *//* inproc_ifc */
+
+/**
+ * @}
+ *//* trap_ifc */
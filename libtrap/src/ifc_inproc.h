@@ -0,0 +1,162 @@
+/**
+ * \file ifc_inproc.h
+ * \brief TRAP in-process interfaces
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+#ifndef _TRAP_IFC_INPROC_H_
+#define _TRAP_IFC_INPROC_H_
+
+#include "trap_ifc.h"
+
+/**
+ * \defgroup inproc_ifc In-process IFC
+ * \ingroup trap_ifc
+ *
+ * Output IFC of one libtrap context is linked with input IFC of another
+ * context of the same process through a named channel. Containers of messages
+ * are passed through a lock-free single-producer single-consumer ring, the
+ * input IFC reads messages directly from the container written by the output
+ * IFC and releases it when all messages were read.
+ * @{
+ */
+
+/**
+ * \brief Time the output IFC waits during termination for the input IFC
+ * that does not release any container [us].
+ */
+#define INPROC_TERMINATE_TIMEOUT 1000000
+
+/**
+ * \brief Container of messages passed through the channel.
+ */
+typedef struct inproc_container_s {
+   char *buffer;              /**< Messages, each prefixed by its size (uint16_t in network byte order) */
+   uint32_t used_bytes;       /**< Number of used bytes of buffer */
+   uint32_t count;            /**< Number of messages */
+   uint64_t seq_num;          /**< Number of messages stored by the output IFC before the first message */
+   const struct inproc_format_s *fmt; /**< Data format of messages */
+} inproc_container_t;
+
+/**
+ * \brief Data format of messages, kept until the channel is destroyed.
+ */
+typedef struct inproc_format_s {
+   uint8_t data_type;         /**< Data type (trap_data_format_t) */
+   char *data_fmt_spec;       /**< Data format specifier */
+   struct inproc_format_s *next;
+} inproc_format_t;
+
+/**
+ * \brief Named channel linking output IFC and input IFC.
+ *
+ * Containers from tail to head are owned by the input IFC, the rest by the
+ * output IFC.
+ */
+typedef struct inproc_channel_s {
+   char *name;                /**< Name of the channel */
+   uint32_t refs;             /**< Number of attached IFCs (protected by registry mutex) */
+   uint32_t senders;          /**< Number of attached output IFCs (0 or 1) */
+   uint32_t receivers;        /**< Number of attached input IFCs (0 or 1) */
+   char receiver_terminated;  /**< Input IFC was terminated */
+   uint32_t container_count;  /**< Number of containers */
+   uint32_t container_size;   /**< Size of buffer of each container [bytes] */
+   inproc_container_t *containers; /**< Ring of containers */
+   uint64_t head;             /**< Number of containers published by output IFC */
+   uint64_t tail;             /**< Number of containers released by input IFC */
+   inproc_format_t *formats;  /**< Data formats used on the channel */
+   struct inproc_channel_s *next;
+} inproc_channel_t;
+
+typedef struct inproc_sender_private_s {
+   trap_ctx_priv_t *ctx;      /**< Libtrap context */
+   uint32_t ifc_idx;          /**< Index of interface in 'ctx->out_ifc_list' array */
+   inproc_channel_t *channel; /**< Attached channel */
+   inproc_container_t *active; /**< Container being filled, NULL if there is none */
+   const inproc_format_t *fmt; /**< Data format of sent messages, NULL if it has to be taken from the context */
+   uint64_t processed_messages; /**< Number of stored messages */
+   uint64_t sent_containers;  /**< Number of published containers */
+   uint64_t sent_messages;    /**< Number of published messages */
+   uint64_t autoflush_timestamp; /**< Time of the last publication [us] */
+   pthread_t autoflush_thr;   /**< Autoflush thread */
+   char autoflush_running;    /**< Autoflush thread was started */
+   char is_terminated;
+} inproc_sender_private_t;
+
+typedef struct inproc_receiver_private_s {
+   trap_ctx_priv_t *ctx;      /**< Libtrap context */
+   uint32_t ifc_idx;          /**< Index of interface in 'ctx->in_ifc_list' array */
+   inproc_channel_t *channel; /**< Attached channel */
+   const inproc_format_t *fmt; /**< Data format of the last received container */
+   char holding;              /**< Container at tail of the ring is being read */
+   char is_terminated;
+   uint64_t received_containers; /**< Number of received containers */
+   uint64_t received_records; /**< Number of received messages */
+   uint64_t received_bytes;   /**< Number of received bytes */
+   uint64_t missed_records;   /**< Number of messages dropped before they were received */
+   char seq_started;          /**< At least one container was received */
+   uint64_t seq_offset;       /**< Sequence number of the first received message given by the current output IFC */
+   uint64_t seq_next;         /**< Sequence number of the next expected message given by the output IFC */
+   uint64_t seq_total;        /**< Number of messages given by previous output IFCs of the channel */
+} inproc_receiver_private_t;
+
+/** Create in-process receive interface (input ifc).
+ *  Receive function of this interface reads containers from the channel.
+ *  @param[in] ctx   Pointer to the private libtrap context data (#trap_ctx_init()).
+ *  @param[in] params <name> of the channel expected.
+ *  @param[out] ifc Created interface.
+ *  @param[in] idx Index of the interface.
+ *  @return Error code (0 on success). Generated interface is returned in ifc.
+ */
+int create_inproc_receiver_ifc(trap_ctx_priv_t *ctx, const char *params, trap_input_ifc_t *ifc, uint32_t idx);
+
+/** Create in-process send interface (output ifc).
+ *  Send function of this interface stores messages into containers of the channel.
+ *  @param[in] ctx   Pointer to the private libtrap context data (#trap_ctx_init()).
+ *  @param[in] params <name>:<buffer_count=>:<buffer_size=>
+ *                    <buffer_count> and <buffer_size> are optional, they set the number and size of containers.
+ *  @param[out] ifc Created interface.
+ *  @param[in] idx Index of the interface.
+ *  @return Error code (0 on success). Generated interface is returned in ifc.
+ */
+int create_inproc_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_ifc_t *ifc, uint32_t idx);
+
+/**
+ * @}
+ */
+#endif
@@ -47,6 +47,17 @@
 #define BUFFER_COUNT_PARAM_LENGTH 13 /**< Used for parsing ifc params */
 #define BUFFER_SIZE_PARAM_LENGTH 12 /**< Used for parsing ifc params */
 #define MAX_CLIENTS_PARAM_LENGTH 12 /**< Used for parsing ifc params */
+#define PARTITIONS_PARAM_LENGTH 11 /**< Used for parsing ifc params */
+#define DISPATCH_PARAM_LENGTH 9 /**< Used for parsing ifc params */
+#define CLAIM_PARAM_LENGTH 6 /**< Used for parsing ifc params */
+#define PROJECTION_PARAM_LENGTH 11 /**< Used for parsing ifc params */
+#define FILTER_PARAM_LENGTH 7 /**< Used for parsing ifc params */
+#define READAHEAD_PARAM_LENGTH 10 /**< Used for parsing ifc params */
+#define HUGEPAGES_PARAM_LENGTH 10 /**< Used for parsing ifc params */
+#define LATENCY_PARAM_LENGTH 8 /**< Used for parsing ifc params */
+#define SPILL_PARAM_LENGTH 6 /**< Used for parsing ifc params */
+#define SPILL_DIR_PARAM_LENGTH 10 /**< Used for parsing ifc params */
+#define KTLS_PARAM_LENGTH 5 /**< Used for parsing ifc params */
 
 #define DEFAULT_MAX_DATA_LENGTH (sizeof(trap_buffer_header_t) + 1024) /**< Obsolete? */
 
@@ -58,12 +69,19 @@
 #define DEFAULT_BUFFER_SIZE 100000 /**< Default buffer size [bytes] */
 #endif
 
+#ifndef DEFAULT_READAHEAD_SIZE
+#define DEFAULT_READAHEAD_SIZE 1048576 /**< Size of read-ahead buffer of input IFC when readahead parameter has no valid size [bytes] */
+#endif
+
 #ifndef DEFAULT_MAX_CLIENTS
 #define DEFAULT_MAX_CLIENTS 64 /**< Default size of client array */
 #endif
 
 #define NO_CLIENTS_SLEEP 100000 /**< Value used in usleep() when waiting for a client to connect */
 
+#define ADAPTIVE_PERIOD 100000 /**< Period of adjusting container size and autoflush timeout in adaptive mode [us] */
+#define ADAPTIVE_MIN_CONTAINER_SIZE 1024 /**< Minimal container size chosen in adaptive mode [bytes] */
+
 /**
  * \brief Output buffer structure.
  */
@@ -51,6 +51,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -62,6 +63,7 @@
 #include <errno.h>
 #include <semaphore.h>
 #include <assert.h>
+#include <ctype.h>
 #include <poll.h>
 
 #include "../include/libtrap/trap.h"
@@ -263,6 +265,93 @@ static int receive_part(void *priv, void **data, uint32_t *size, struct timeval
    return TRAP_E_TERMINATED;
 }
 
+/**
+ * Make sure that read-ahead buffer contains at least the given number of bytes.
+ *
+ * Data are received in chunks as large as the free space of the read-ahead
+ * buffer, so one recv() usually delivers several containers. ppoll() is
+ * used only when no data are ready. Received data are kept in the buffer on
+ * timeout, the buffer is enlarged when a container does not fit into it.
+ *
+ * \param[in] config  private IFC data
+ * \param[in] need    number of bytes to wait for
+ * \param[in] tm      timeout, NULL to block
+ * \return TRAP_E_OK on success, TRAP_E_TIMEOUT, TRAP_E_TERMINATED, TRAP_E_IO_ERROR or TRAP_E_MEMORY otherwise
+ */
+static int readahead_fill(tcpip_receiver_private_t *config, uint32_t need, struct timeval *tm)
+{
+   uint32_t avail;
+   ssize_t recvb;
+   char *p;
+   int retval;
+   struct pollfd pfds;
+   struct timespec ts, *tempts = NULL;
+   if (tm != NULL) {
+      ts.tv_sec = tm->tv_sec;
+      ts.tv_nsec = tm->tv_usec * 1000l;
+      tempts = &ts;
+   }
+
+   if (config->readahead_head == config->readahead_tail) {
+      config->readahead_head = config->readahead_tail = 0;
+   }
+   while ((avail = config->readahead_tail - config->readahead_head) < need) {
+      if (config->is_terminated != 0) {
+         return TRAP_E_TERMINATED;
+      }
+      if (config->readahead == NULL || config->readahead_size - config->readahead_head < need) {
+         /* move the incomplete container to the beginning of the buffer */
+         if (config->readahead_head != 0) {
+            memmove(config->readahead, config->readahead + config->readahead_head, avail);
+            config->readahead_head = 0;
+            config->readahead_tail = avail;
+         }
+         if (config->readahead == NULL || config->readahead_size < need) {
+            if (config->readahead_size < need) {
+               config->readahead_size = need;
+            }
+            p = realloc(config->readahead, config->readahead_size);
+            if (p == NULL) {
+               VERBOSE(CL_ERROR, "Not enough memory for read-ahead buffer of %" PRIu32 " B.", config->readahead_size);
+               client_socket_disconnect(config);
+               return TRAP_E_MEMORY;
+            }
+            config->readahead = p;
+         }
+      }
+
+      recvb = recv(config->sd, config->readahead + config->readahead_tail,
+                   config->readahead_size - config->readahead_tail, MSG_DONTWAIT);
+      if (recvb > 0) {
+         DEBUG_IFC(VERBOSE(CL_VERBOSE_LIBRARY, "readahead_fill got %zd B", recvb));
+         config->readahead_tail += recvb;
+         continue;
+      }
+      if (recvb == 0) {
+         errno = EPIPE;
+      }
+      if (errno == EINTR) {
+         continue;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+         client_socket_disconnect(config);
+         return TRAP_E_IO_ERROR;
+      }
+
+      /* no data are ready, wait for them */
+      pfds = (struct pollfd) {.fd = config->sd, .events = POLLIN};
+      retval = ppoll(&pfds, 1, tempts, NULL);
+      if ((retval == 0) || (retval < 0 && errno == EINTR)) {
+         /* Caller decides according to elapsed time whether to call this function again. */
+         return TRAP_E_TIMEOUT;
+      } else if (retval < 0) {
+         VERBOSE(CL_VERBOSE_OFF, "ppoll() returned %i (%s)", retval, strerror(errno));
+         client_socket_disconnect(config);
+         return TRAP_E_IO_ERROR;
+      }
+   }
+   return TRAP_E_OK;
+}
+
 /**
  * Return current time in microseconds.
  *
@@ -280,9 +369,11 @@ static inline uint64_t get_cur_timestamp()
 }
 
 /**
- * \brief Receive data from interface.
+ * \brief Receive container from interface.
  *
- * It is expected that data is always the same pointer because it is buffer given by trap.c.
+ * It is expected that *data is always the same pointer because it is buffer given by trap.c.
+ * When read-ahead is enabled, the container is not copied into the buffer, *data is set
+ * to the container in read-ahead buffer instead. It is valid until the next call.
  *
  * This function contains finite state machine that controls receiving messages (header
  * and payload), handles timeouts and sleep (to offload CPU during waiting for connection).
@@ -309,12 +400,12 @@ static inline uint64_t get_cur_timestamp()
  * \enddot
  *
  * \param [in,out] priv  private configuration structure
- * \param [out] data  where received data are stored
+ * \param [in,out] data  buffer where received data are stored, set to the received data
  * \param [out] size  size of received data
  * \param [in] timeout  timeout in usec, can be TRAP_WAIT, TRAP_HALFWAIT, or TRAP_NO_WAIT
  * \return TRAP_E_OK (0) on success
  */
-int tcpip_receiver_recv(void *priv, void *data, uint32_t *size, int timeout)
+static int tcpip_receiver_recv_container(void *priv, char **data, uint32_t *size, int timeout)
 {
 #ifdef LIMITED_RECOVERY
    uint32_t recovery = 0;
@@ -337,7 +428,7 @@ int tcpip_receiver_recv(void *priv, void *data, uint32_t *size, int timeout)
     * TRAP_HALFWAIT is not valid value */
    assert(timeout > TRAP_HALFWAIT);
 
-   if ((config == NULL) || (data == NULL) || (size == NULL)) {
+   if ((config == NULL) || (data == NULL) || (*data == NULL) || (size == NULL)) {
       return TRAP_E_BAD_FPARAMS;
    }
    (*size) = 0;
@@ -475,7 +566,15 @@ head_wait:
       /* get and check header of message, next state can be MESS_WAIT or RESET */
       DEBUG_IFC(VERBOSE(CL_VERBOSE_LIBRARY, "recv HEAD_WAIT (%p)", p));
       config->data_wait_size = sizeof(trap_buffer_header_t);
-      retval = receive_part(config, &p, &config->data_wait_size, temptm);
+      if (config->readahead_size != 0) {
+         retval = readahead_fill(config, sizeof(messageframe), temptm);
+         if (retval == TRAP_E_OK) {
+            memcpy(&messageframe, config->readahead + config->readahead_head, sizeof(messageframe));
+            config->readahead_head += sizeof(messageframe);
+         }
+      } else {
+         retval = receive_part(config, &p, &config->data_wait_size, temptm);
+      }
       if (retval != TRAP_E_OK) {
          /* receiving failed */
          DEBUG_IFC(VERBOSE(CL_VERBOSE_LIBRARY, "recv failed HEAD (%p) waiting %d B", p, config->data_wait_size));
@@ -489,7 +588,9 @@ head_wait:
          /* we expect to receive data */
          messageframe.data_length = ntohl(messageframe.data_length);
 
-         if (!config->is_session_reset && config->session_sequence_number + config->session_last_record_size != messageframe.seq_num) {
+         /* records dropped by the filter of output IFC are not missed */
+         if (config->filter == NULL && !config->is_session_reset &&
+             config->session_sequence_number + config->session_last_record_size != messageframe.seq_num) {
             config->session_missed_records += (messageframe.seq_num - (config->session_sequence_number + config->session_last_record_size));
             VERBOSE(CL_VERBOSE_BASIC, "Recv: missed %" PRIu64 " messages. %.1f%% of total seen messages %" 
                PRIu64 " has been missed", 
@@ -521,19 +622,31 @@ head_wait:
          }
 #endif
          /* we got header, now we can start receiving payload */
-         p = data;
-         config->ext_buffer = data;
+         p = *data;
+         config->ext_buffer = *data;
          goto mess_wait;
       }
 mess_wait:
       /* get and check payload of message, next state can be RESET or success exit */
       /* receive payload */
       DEBUG_IFC(VERBOSE(CL_VERBOSE_LIBRARY, "recv waiting MESS (%p) %d B", p, config->data_wait_size));
-      retval = receive_part(config, &p, &config->data_wait_size, temptm);
+      if (config->readahead_size != 0) {
+         /* payload is kept in read-ahead buffer until it is complete */
+         retval = readahead_fill(config, config->data_wait_size, temptm);
+         if (retval == TRAP_E_OK) {
+            *data = config->readahead + config->readahead_head;
+            config->ext_buffer = *data;
+            config->readahead_head += config->data_wait_size;
+            config->data_wait_size = 0;
+         }
+         p = *data;
+      } else {
+         retval = receive_part(config, &p, &config->data_wait_size, temptm);
+      }
       if (retval == TRAP_E_OK) {
          /* Success! Data was already set by recv */
          config->data_pointer = NULL;
-         (*size) = messageframe.data_length;
+         (*size) = config->ext_buffer_size;
          DEBUG_IFC(VERBOSE(CL_VERBOSE_LIBRARY, "recv get MESS (%p) remains: %d B", p, config->data_wait_size));
          return TRAP_E_OK;
       } else {
@@ -549,6 +662,50 @@ mess_wait:
    return TRAP_E_TERMINATED;
 }
 
+/**
+ * \brief Receive data from interface.
+ *
+ * \param [in,out] priv  private configuration structure
+ * \param [out] data  where received data are stored
+ * \param [out] size  size of received data
+ * \param [in] timeout  timeout in usec, can be TRAP_WAIT, TRAP_HALFWAIT, or TRAP_NO_WAIT
+ * \return TRAP_E_OK (0) on success
+ */
+int tcpip_receiver_recv(void *priv, void *data, uint32_t *size, int timeout)
+{
+   char *p = data;
+   int retval = tcpip_receiver_recv_container(priv, &p, size, timeout);
+
+   if (retval == TRAP_E_OK && p != data) {
+      memcpy(data, p, *size);
+   }
+   return retval;
+}
+
+/**
+ * \brief Receive data from interface without copying them from read-ahead buffer.
+ *
+ * \param [in,out] priv  private configuration structure
+ * \param [in,out] data  buffer given by trap.c, set to the received data
+ * \param [out] size  size of received data
+ * \param [in] timeout  timeout in usec, can be TRAP_WAIT, TRAP_HALFWAIT, or TRAP_NO_WAIT
+ * \param [out] seq_number  sequence number of the first received message, may be NULL
+ * \return TRAP_E_OK (0) on success
+ */
+int tcpip_receiver_recv_buffer(void *priv, char **data, uint32_t *size, int timeout, uint64_t *seq_number)
+{
+   int retval = tcpip_receiver_recv_container(priv, data, size, timeout);
+   if (retval != TRAP_E_OK) {
+      return retval;
+   }
+   tcpip_receiver_private_t *config = (tcpip_receiver_private_t *) priv;
+   if (seq_number != NULL) {
+      *seq_number = config->total_sequence_number + (config->session_sequence_number - config->session_sequence_number_offset) + 1;
+   }
+
+   return retval;
+}
+
 int tcpip_receiver_recv_seq_number(void *priv, void *data, uint32_t *size, int timeout, uint64_t *seq_number)
 {
    int retval = tcpip_receiver_recv(priv, data, size, timeout);
@@ -604,6 +761,8 @@ p = NULL; \
       }
       X(config->dest_addr);
       X(config->dest_port);
+      X(config->filter);
+      X(config->readahead);
       X(config);
    } else {
       VERBOSE(CL_ERROR, "Destroying IFC that is probably not initialized.");
@@ -636,10 +795,12 @@ static void tcpip_receiver_create_dump(void *priv, uint32_t idx, const char *pat
            "Terminated: %d\nSocket descriptor: %d\nSocket type: %d\n"
            "Data pointer: %p\nData wait size: %"PRIu32"\nMessage header: %"PRIu32"\n"
            "Extern buffer pointer: %p\nExtern buffer data size: %"PRIu32"\n"
+           "Read-ahead buffer size: %"PRIu32"\nRead-ahead data size: %"PRIu32"\n"
            "Timeout: %"PRId32"us (%s)\n",
            c->dest_addr, c->dest_port, c->connected, c->is_terminated, c->sd, c->socket_type,
            c->data_pointer, c->data_wait_size, c->int_mess_header.data_length,
            c->ext_buffer, c->ext_buffer_size,
+           c->readahead_size, c->readahead_tail - c->readahead_head,
            c->ctx->in_ifc_list[idx].datatimeout,
            TRAP_TIMEOUT_STR(c->ctx->in_ifc_list[idx].datatimeout));
    fclose(f);
@@ -694,6 +855,36 @@ uint8_t tcpip_recv_ifc_is_conn(void *priv)
    return 0;
 }
 
+/**
+ * \brief Parse optional parameter of input TCP/IP IFC.
+ *
+ * \param[in,out] config  Private data of the IFC.
+ * \param[in] param       Parameter in form name=value.
+ */
+static void tcpip_receiver_parse_option(tcpip_receiver_private_t *config, const char *param)
+{
+   unsigned int projection, readahead;
+
+   if (strncmp(param, "projection=x", PROJECTION_PARAM_LENGTH) == 0) {
+      if (sscanf(param + PROJECTION_PARAM_LENGTH, "%u", &projection) != 1) {
+         VERBOSE(CL_ERROR, "Optional projection given, but it is probably in wrong format.");
+         projection = 0;
+      }
+      config->projection = projection ? 1 : 0;
+   } else if (strncmp(param, "filter=x", FILTER_PARAM_LENGTH) == 0) {
+      free(config->filter);
+      config->filter = strdup(param + FILTER_PARAM_LENGTH);
+   } else if (strncmp(param, "readahead=x", READAHEAD_PARAM_LENGTH) == 0) {
+      if (sscanf(param + READAHEAD_PARAM_LENGTH, "%u", &readahead) != 1) {
+         VERBOSE(CL_ERROR, "Optional read-ahead size given, but it is probably in wrong format.");
+         readahead = DEFAULT_READAHEAD_SIZE;
+      }
+      config->readahead_size = readahead;
+   } else {
+      VERBOSE(CL_ERROR, "Unknown parameter \"%s\".", param);
+   }
+}
+
 /**
  * \brief Constructor of input TCP/IP IFC module.
  * This function is called by TRAP library to initialize one input interface.
@@ -732,6 +923,7 @@ int create_tcpip_receiver_ifc(trap_ctx_priv_t *ctx, char *params, trap_input_ifc
    config->is_terminated = 0;
    config->socket_type = type;
    config->ifc_idx = idx;
+   config->readahead_size = 0;
 
    config->is_session_reset = true;
    config->session_sequence_number = 0;
@@ -757,6 +949,22 @@ int create_tcpip_receiver_ifc(trap_ctx_priv_t *ctx, char *params, trap_input_ifc
       }
    }
    param_iterator = trap_get_param_by_delimiter(param_iterator, &dest_port, TRAP_IFC_PARAM_DELIMITER);
+   /* Optional params */
+   while (dest_port != NULL && strchr(dest_port, '=') != NULL) {
+      tcpip_receiver_parse_option(config, dest_port);
+      X(dest_port);
+      if (param_iterator != NULL) {
+         param_iterator = trap_get_param_by_delimiter(param_iterator, &dest_port, TRAP_IFC_PARAM_DELIMITER);
+      }
+   }
+   while (param_iterator != NULL) {
+      char *param_str = NULL;
+      param_iterator = trap_get_param_by_delimiter(param_iterator, &param_str, TRAP_IFC_PARAM_DELIMITER);
+      if (param_str != NULL) {
+         tcpip_receiver_parse_option(config, param_str);
+         X(param_str);
+      }
+   }
    if ((dest_port == NULL) || (strlen(dest_port) == 0)) {
       /* if 2nd param is missing, use localhost as addr and 1st param as "port" */
       free(dest_port);
@@ -806,6 +1014,7 @@ int create_tcpip_receiver_ifc(trap_ctx_priv_t *ctx, char *params, trap_input_ifc
    /* hook functions and store priv */
    ifc->recv = tcpip_receiver_recv;
    ifc->recv_with_seq_number = tcpip_receiver_recv_seq_number;
+   ifc->recv_buffer = tcpip_receiver_recv_buffer;
    ifc->get_input_stats = tcpip_receiver_get_stats;
    ifc->destroy = tcpip_receiver_destroy;
    ifc->terminate = tcpip_receiver_terminate;
@@ -827,6 +1036,9 @@ int create_tcpip_receiver_ifc(trap_ctx_priv_t *ctx, char *params, trap_input_ifc
 failsafe_cleanup:
    X(dest_addr);
    X(dest_port);
+   if (config != NULL) {
+      X(config->filter);
+   }
    X(config);
    return result;
 #undef X
@@ -846,6 +1058,8 @@ static void client_socket_disconnect(void *priv)
       close(config->sd);
       config->connected = 0;
    }
+   /* data of the lost connection are dropped */
+   config->readahead_head = config->readahead_tail = 0;
 }
 
 /**
@@ -879,6 +1093,60 @@ static int wait_for_connection(int sock, struct timeval *tv)
    return TRAP_E_TIMEOUT;
 }
 
+/**
+ * \brief Send whole buffer of client request.
+ *
+ * \param[in] sd    Connected socket.
+ * \param[in] data  Data to send.
+ * \param[in] size  Size of data.
+ * \return 1 if all data were sent, 0 otherwise.
+ */
+static int send_request_part(int sd, const void *data, size_t size)
+{
+   ssize_t sent = send(sd, data, size, MSG_NOSIGNAL);
+
+   return sent >= 0 && (size_t) sent == size;
+}
+
+/**
+ * \brief Ask output IFC to send only the records and fields required by this input IFC.
+ *
+ * The request is sent before the negotiation, output IFC replies by hello
+ * message with the projected data format specifier (or with the whole one
+ * if it does not support projection or the required fields are not a subset).
+ * Filter is applied by output IFC if it supports it and the expression is
+ * valid for its data format; records not matching the filter may be received
+ * anyway.
+ *
+ * \param[in] config  Private data of the IFC.
+ * \param[in] sd      Connected socket.
+ */
+static void send_client_request(tcpip_receiver_private_t *config, int sd)
+{
+   trap_input_ifc_t *ifc = &config->ctx->in_ifc_list[config->ifc_idx];
+   tcpip_client_request_t request;
+   size_t spec_size = 0, filter_size = 0;
+
+   if (config->projection && ifc->req_data_type == TRAP_FMT_UNIREC && ifc->req_data_fmt_spec != NULL) {
+      spec_size = strlen(ifc->req_data_fmt_spec);
+   }
+   if (config->filter != NULL) {
+      filter_size = strlen(config->filter);
+   }
+   if (spec_size > TCPIP_REQUEST_MAX_SIZE || filter_size > TCPIP_REQUEST_MAX_SIZE ||
+       (spec_size == 0 && filter_size == 0)) {
+      return;
+   }
+   request.magic = htonl(TCPIP_REQUEST_MAGIC);
+   request.data_fmt_spec_size = htonl(spec_size);
+   request.filter_size = htonl(filter_size);
+   if (!send_request_part(sd, &request, sizeof(request)) ||
+       (spec_size > 0 && !send_request_part(sd, ifc->req_data_fmt_spec, spec_size)) ||
+       (filter_size > 0 && !send_request_part(sd, config->filter, filter_size))) {
+      VERBOSE(CL_VERBOSE_LIBRARY, "Sending of client request failed.");
+   }
+}
+
 /**
  * \brief client_socket is used as a receiver
  * \param[in] priv  pointer to module private data
@@ -1014,6 +1282,10 @@ static int client_socket_connect(void *priv, const char *dest_addr, const char *
 
    /** Input interface negotiation */
 #ifdef ENABLE_NEGOTIATION
+   if (((tcpip_receiver_private_t *) priv)->projection || ((tcpip_receiver_private_t *) priv)->filter != NULL) {
+      send_client_request((tcpip_receiver_private_t *) priv, sockfd);
+   }
+
    switch (input_ifc_negotiation(priv, TRAP_IFC_TYPE_TCPIP)) {
    case NEG_RES_FMT_UNKNOWN:
       VERBOSE(CL_VERBOSE_LIBRARY, "Input_ifc_negotiation result: failed (unknown data format of the output interface).");
@@ -1071,14 +1343,14 @@ calculate_sleep(uint64_t current_sleep)
 }
 
 static uint64_t
-find_lowest_container_id(tcpip_sender_private_t *c)
+find_lowest_container_id(tcpip_sender_private_t *c, uint32_t partition)
 {
    struct client_s *cl;
    uint64_t lowest = -1;
 
    pthread_mutex_lock(&c->client_list_mtx);
    LIST_FOREACH(cl, &c->clients_list_head, entries) {
-      if (cl->container_id < lowest) {
+      if (cl->partition == partition && cl->container_id < lowest) {
          lowest = cl->container_id;
       }
    }
@@ -1087,135 +1359,1121 @@ find_lowest_container_id(tcpip_sender_private_t *c)
 }
 
 /**
- * \brief This function is called when a client was/is being disconnected.
+ * \brief Get partition of the message.
  *
- * \param[in] c Pointer to interface's private data structure.
- * \param[in] cl Client to disconnect
+ * Partition function set by #TRAPCTL_PARTITION_FUNC is used if there is any,
+ * otherwise the message is hashed by FNV-1a.
  */
-static void
-disconnect_client(tcpip_sender_private_t *c, client_t *cl)
+static inline uint32_t
+get_partition(tcpip_sender_private_t *c, const void *data, uint16_t size)
 {
-   pthread_mutex_lock(&c->client_list_mtx);
-   client_t *next, *cl_iterator = LIST_FIRST(&c->clients_list_head);
-   while (cl_iterator != NULL) {
-      next = LIST_NEXT(cl_iterator, entries);
-      if (cl_iterator == cl) {
-         __sync_sub_and_fetch(&c->connected_clients, 1);
-         LIST_REMOVE(cl, entries);
-         shutdown(cl->sd, SHUT_RDWR);
-         close(cl->sd);
-         free(cl);
-         break;
-      }
-      cl_iterator = next;
+   trap_output_ifc_t *ifc = &c->ctx->out_ifc_list[c->ifc_idx];
+   const uint8_t *p = (const uint8_t *) data;
+   uint32_t hash = 2166136261U;
+   uint16_t i;
+
+   if (c->partition_count == 1) {
+      return 0;
    }
-   pthread_mutex_unlock(&c->client_list_mtx);
+   if (ifc->partition_func != NULL) {
+      return ifc->partition_func(data, size, ifc->partition_arg) % c->partition_count;
+   }
+   for (i = 0; i < size; i++) {
+      hash = (hash ^ p[i]) * 16777619U;
+   }
+   return hash % c->partition_count;
 }
 
 /**
- * \brief Function disconnects all clients of the output interface whose private structure is passed via "priv" parameter.
- *
- * \param[in] priv Pointer to output interface private structure.
+ * \brief Choose partition for a new client - the one with the lowest number of clients.
  */
-void tcpip_server_disconnect_all_clients(void *priv)
+static uint32_t
+assign_partition(tcpip_sender_private_t *c)
 {
-   tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
-   pthread_mutex_lock(&c->client_list_mtx);
-   client_t *next, *cl = LIST_FIRST(&c->clients_list_head);
-   while (cl != NULL) {
-      next = LIST_NEXT(cl, entries);
-      __sync_sub_and_fetch(&c->connected_clients, 1);
-      LIST_REMOVE(cl, entries);
-      shutdown(cl->sd, SHUT_RDWR);
-      close(cl->sd);
-      free(cl);
-      cl = next;
+   uint32_t i, best = 0;
+
+   for (i = 1; i < c->partition_count; i++) {
+      if (c->partitions[i].clients < c->partitions[best].clients) {
+         best = i;
+      }
    }
-   pthread_mutex_unlock(&c->client_list_mtx);
+   return best;
 }
 
-static bool
-is_next_container_ready(tcpip_sender_private_t *c, client_t *cl)
+/**
+ * \brief Get size of UniRec data type.
+ * \return Size of static type, negative size of element for variable-length
+ * type (used for ordering of fields as in UniRec) or 0 for unknown type.
+ */
+static int
+unirec_type_size(const char *type, size_t length)
 {
-	uint64_t head = __sync_fetch_and_add(&c->t_mbuf.to_send.head_, 0); 
-   if (head == 0 || cl->container_id >= head) {
-      return false;
-   } 
-   return true;
+   static const struct {
+      const char *name;
+      int size;
+   } types[] = {
+      {"string", -1}, {"bytes", -1}, {"char", 1}, {"uint8", 1}, {"int8", 1},
+      {"uint16", 2}, {"int16", 2}, {"uint32", 4}, {"int32", 4}, {"uint64", 8},
+      {"int64", 8}, {"float", 4}, {"double", 8}, {"ipaddr", 16}, {"macaddr", 6},
+      {"time", 8}
+   };
+   int array = (length > 0 && type[length - 1] == '*');
+   size_t i;
+
+   if (array) {
+      length--;
+   }
+   for (i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+      if (strlen(types[i].name) == length && strncmp(types[i].name, type, length) == 0) {
+         if (array) {
+            return types[i].size < 0 ? 0 : -types[i].size;
+         }
+         return types[i].size;
+      }
+   }
+   return 0;
 }
 
 /**
- * \brief This function runs in a separate thread. It handles sending data
-          to connected clients for TCPIP and UNIX interfaces (this function is blocking).
- * \param[in] arg pointer to thread_data
+ * \brief Field of UniRec data format specifier, used to compute layout of records.
  */
-static void *
-send_blocking_mode(void *arg)
+struct unirec_spec_field_s {
+   const char *type;
+   const char *name;
+   int type_length;
+   int name_length;
+   int size;
+   uint16_t offset;
+   int required;
+};
+
+/**
+ * \brief Compare fields in the order of UniRec template (by size and name).
+ */
+static int
+unirec_spec_field_cmp(const void *a, const void *b)
 {
-   tcpip_sender_private_t *c = ((struct thread_data *) arg)->arg;
-   client_t *cl = ((struct thread_data *) arg)->client;
-   struct trap_container_s *t_cont;
+   const struct unirec_spec_field_s *f1 = a, *f2 = b;
+   int len = f1->name_length < f2->name_length ? f1->name_length : f2->name_length;
+   int ret;
 
-   uint64_t sleep_time = 1;
-   size_t pending_bytes;
-   char *buffer;
-   int send_ret_code;
+   if (f1->size != f2->size) {
+      return f1->size > f2->size ? -1 : 1;
+   }
+   ret = strncmp(f1->name, f2->name, len);
+   return ret != 0 ? ret : f1->name_length - f2->name_length;
+}
 
-   while (!c->is_terminated) {
-      // is next container ready
-      while (!is_next_container_ready(c, cl)) {
-         if (c->is_terminated) {
-            goto cleanup;
-         }
-         sleep_time = calculate_sleep(sleep_time);
-         usleep(sleep_time);
+/**
+ * \brief Compute layout of UniRec records described by data format specifier.
+ *
+ * \param[in] data_fmt_spec  Data format specifier.
+ * \param[out] count         Number of fields.
+ * \param[out] static_size   Size of static part of records (including headers of variable-length fields).
+ * \return Fields in the order of UniRec template with their offsets (to be freed by caller), NULL on error.
+ */
+static struct unirec_spec_field_s *
+unirec_spec_layout(const char *data_fmt_spec, int *count, uint16_t *static_size)
+{
+   struct unirec_spec_field_s *fields, f;
+   const char *move;
+   uint16_t offset = 0;
+   int i, n = 0;
+
+   fields = calloc(strlen(data_fmt_spec) / 2 + 1, sizeof(*fields));
+   if (fields == NULL) {
+      return NULL;
+   }
+   for (move = data_fmt_spec; *move != 0; n++) {
+      move = trap_get_type_and_name_from_string(move, &f.name, &f.type, &f.name_length, &f.type_length);
+      f.size = unirec_type_size(f.type, f.type_length);
+      f.required = 0;
+      if (f.size == 0) {
+         free(fields);
+         return NULL;
       }
+      fields[n] = f;
+   }
+   qsort(fields, n, sizeof(*fields), unirec_spec_field_cmp);
+   for (i = 0; i < n; i++) {
+      fields[i].offset = offset;
+      offset += fields[i].size < 0 ? 4 : fields[i].size;
+   }
+   *count = n;
+   *static_size = offset;
+   return fields;
+}
 
-      sleep_time = 1;
+static void
+free_projection(tcpip_projection_t *p)
+{
+   if (p != NULL) {
+      free(p->fmt_spec);
+      free(p->fields);
+      free(p);
+   }
+}
 
-      // get next container
-      t_cont = t_rb_at(&c->t_mbuf.to_send, cl->container_id);
-      if (t_cont == NULL) {
-         // we cannot operate with NULL t_cont
-         continue;
-      }
-          
-      buffer = t_cont->buffer;
-      pending_bytes = t_cont->used_bytes;
+/**
+ * \brief Create projection of UniRec records of output IFC to the fields required by a client.
+ *
+ * \param[in] data_fmt_spec  Data format specifier of output IFC.
+ * \param[in] req_fmt_spec   Data format specifier required by the client.
+ * \return Projection or NULL if the required fields are not a strict subset of output fields.
+ */
+static tcpip_projection_t *
+create_projection(const char *data_fmt_spec, const char *req_fmt_spec)
+{
+   struct unirec_spec_field_s *fields = NULL;
+   tcpip_projection_t *p = NULL;
+   const char *move, *name, *type;
+   int name_length, type_length;
+   int count = 0, i, j, spec_length = 0;
+   char *spec;
+
+   if (data_fmt_spec == NULL || req_fmt_spec == NULL || *req_fmt_spec == 0 ||
+       trap_ctx_cmp_data_fmt(data_fmt_spec, req_fmt_spec) != TRAP_E_FIELDS_SUBSET) {
+      return NULL;
+   }
 
-again:
-      send_ret_code = send(cl->sd, &buffer[t_cont->used_bytes - pending_bytes], pending_bytes, MSG_NOSIGNAL);
-      if (send_ret_code < 0) { // Send failed
-         if (c->is_terminated) {
-            break;
-         }
-         switch (errno) {
-         case EBADF:
-         case EPIPE:
-         case EFAULT:
-            goto cleanup;
-         case EAGAIN:
-            goto again;
-         default:    
-            VERBOSE(CL_VERBOSE_OFF, "Unhandled error from send in send_blocking_mode (errno: %i)", errno);
-            goto cleanup;
-         }
-      } else {
-         pending_bytes -= send_ret_code;
-         if (pending_bytes) { // buffer was not send completely. Try again send pending bytes.
-            goto again;
+   p = calloc(1, sizeof(*p));
+   if (p == NULL) {
+      goto failure;
+   }
+   fields = unirec_spec_layout(data_fmt_spec, &count, &p->static_size);
+   if (fields == NULL) {
+      goto failure;
+   }
+   for (move = req_fmt_spec; *move != 0; ) {
+      move = trap_get_type_and_name_from_string(move, &name, &type, &name_length, &type_length);
+      for (i = 0; i < count; i++) {
+         if (fields[i].name_length == name_length && strncmp(fields[i].name, name, name_length) == 0) {
+            fields[i].required = 1;
          }
       }
+   }
 
-      // increase container ID and statistics
-      cl->sent_containers++;
-      cl->sent_messages += t_cont->size; 
-      __sync_add_and_fetch(&cl->container_id, 1);
+   p->fields = calloc(count, sizeof(*p->fields));
+   if (p->fields == NULL) {
+      goto failure;
+   }
+   for (i = 0; i < count; i++) {
+      if (fields[i].required) {
+         p->fields[p->field_count].offset = fields[i].offset;
+         p->fields[p->field_count].size = fields[i].size < 0 ? -1 : fields[i].size;
+         p->projected_static_size += fields[i].size < 0 ? 4 : fields[i].size;
+         p->field_count++;
+         spec_length += fields[i].type_length + fields[i].name_length + 2;
+      }
+   }
+   if (p->field_count == count) {
+      goto failure;
    }
 
-cleanup:
-   disconnect_client(c, cl);
-   free(arg);
+   spec = p->fmt_spec = calloc(spec_length + 1, 1);
+   if (spec == NULL) {
+      goto failure;
+   }
+   for (i = 0, j = 0; i < count; i++) {
+      if (fields[i].required) {
+         spec += sprintf(spec, "%s%.*s %.*s", j++ ? "," : "", fields[i].type_length, fields[i].type,
+                         fields[i].name_length, fields[i].name);
+      }
+   }
+   free(fields);
+   return p;
+
+failure:
+   free(fields);
+   free_projection(p);
+   return NULL;
+}
+
+static void
+free_filter(tcpip_filter_t *f)
+{
+   if (f != NULL) {
+      free(f->terms);
+      free(f);
+   }
+}
+
+static inline const char *
+skip_spaces(const char *str)
+{
+   while (*str == ' ' || *str == '\t') {
+      str++;
+   }
+   return str;
+}
+
+/**
+ * \brief Compile filter expression requested by a client.
+ *
+ * Expression is a disjunction (`||`) of conjunctions (`&&`) of comparisons
+ * `FIELD op constant`, where op is one of `==`, `!=`, `<`, `<=`, `>`, `>=`,
+ * FIELD is a static integer, char, float or double field and constant is
+ * a decimal or hexadecimal number, e.g. `PROTOCOL==17 && DST_PORT==53 || PROTOCOL==1`.
+ *
+ * \param[in] data_fmt_spec  Data format specifier of output IFC.
+ * \param[in] expression     Filter expression.
+ * \return Compiled filter or NULL if the expression is not valid for the data format.
+ */
+static tcpip_filter_t *
+create_filter(const char *data_fmt_spec, const char *expression)
+{
+   static const struct {
+      const char *str;
+      enum tcpip_filter_op op;
+   } ops[] = {
+      {"==", TCPIP_FILTER_EQ}, {"!=", TCPIP_FILTER_NE}, {"<=", TCPIP_FILTER_LE},
+      {">=", TCPIP_FILTER_GE}, {"<", TCPIP_FILTER_LT}, {">", TCPIP_FILTER_GT}
+   };
+   struct unirec_spec_field_s *fields = NULL, *field;
+   tcpip_filter_t *f = NULL;
+   tcpip_filter_term_t *t;
+   const char *move = expression, *name;
+   char *end;
+   int count = 0, name_length, i;
+   size_t op;
+
+   if (data_fmt_spec == NULL || expression == NULL) {
+      return NULL;
+   }
+   f = calloc(1, sizeof(*f));
+   if (f == NULL) {
+      goto failure;
+   }
+   // every term has at least 3 characters and a separator
+   f->terms = calloc(strlen(expression) / 4 + 1, sizeof(*f->terms));
+   fields = unirec_spec_layout(data_fmt_spec, &count, &f->static_size);
+   if (f->terms == NULL || fields == NULL) {
+      goto failure;
+   }
+
+   while (1) {
+      t = &f->terms[f->term_count++];
+
+      // field
+      name = move = skip_spaces(move);
+      while (isalnum((unsigned char) *move) || *move == '_') {
+         move++;
+      }
+      name_length = move - name;
+      for (i = 0, field = NULL; i < count; i++) {
+         if (fields[i].name_length == name_length && strncmp(fields[i].name, name, name_length) == 0) {
+            field = &fields[i];
+            break;
+         }
+      }
+      if (field == NULL || field->size <= 0) {
+         VERBOSE(CL_WARNING, "Filter: unknown or variable-length field \"%.*s\".", name_length, name);
+         goto failure;
+      }
+      t->offset = field->offset;
+      t->size = field->size;
+      if (strncmp(field->type, "float", field->type_length) == 0 ||
+          strncmp(field->type, "double", field->type_length) == 0) {
+         t->type = TCPIP_FILTER_FLOAT;
+      } else if (strncmp(field->type, "int", 3) == 0) {
+         t->type = TCPIP_FILTER_INT;
+      } else if (strncmp(field->type, "uint", 4) == 0 || strncmp(field->type, "char", field->type_length) == 0) {
+         t->type = TCPIP_FILTER_UINT;
+      } else {
+         VERBOSE(CL_WARNING, "Filter: type of field \"%.*s\" is not supported.", name_length, name);
+         goto failure;
+      }
+
+      // operator
+      move = skip_spaces(move);
+      for (op = 0; op < sizeof(ops) / sizeof(ops[0]); op++) {
+         if (strncmp(move, ops[op].str, strlen(ops[op].str)) == 0) {
+            break;
+         }
+      }
+      if (op == sizeof(ops) / sizeof(ops[0])) {
+         VERBOSE(CL_WARNING, "Filter: missing operator after \"%.*s\".", name_length, name);
+         goto failure;
+      }
+      t->op = ops[op].op;
+      move += strlen(ops[op].str);
+
+      // constant
+      move = skip_spaces(move);
+      errno = 0;
+      if (t->type == TCPIP_FILTER_FLOAT) {
+         t->value.d = strtod(move, &end);
+      } else if (t->type == TCPIP_FILTER_INT) {
+         t->value.i = strtoll(move, &end, 0);
+      } else {
+         t->value.u = strtoull(move, &end, 0);
+      }
+      if (end == move || errno != 0) {
+         VERBOSE(CL_WARNING, "Filter: invalid constant compared with \"%.*s\".", name_length, name);
+         goto failure;
+      }
+
+      // separator
+      move = skip_spaces(end);
+      if (*move == 0) {
+         t->last = 1;
+         break;
+      } else if (strncmp(move, "||", 2) == 0) {
+         t->last = 1;
+      } else if (strncmp(move, "&&", 2) != 0) {
+         VERBOSE(CL_WARNING, "Filter: unexpected \"%s\".", move);
+         goto failure;
+      }
+      move += 2;
+   }
+   free(fields);
+   return f;
+
+failure:
+   free(fields);
+   free_filter(f);
+   return NULL;
+}
+
+/**
+ * \brief Evaluate one term of filter.
+ *
+ * \param[in] t    Term.
+ * \param[in] rec  Record.
+ * \return Nonzero if the record satisfies the term.
+ */
+static inline int
+filter_term_match(const tcpip_filter_term_t *t, const char *rec)
+{
+   const char *field = rec + t->offset;
+   uint8_t u8;
+   uint16_t u16;
+   uint32_t u32;
+   uint64_t u64;
+   float fl;
+   double d;
+   int cmp;
+
+   switch (t->type) {
+   case TCPIP_FILTER_UINT:
+      switch (t->size) {
+      case 1: memcpy(&u8, field, 1); u64 = u8; break;
+      case 2: memcpy(&u16, field, 2); u64 = u16; break;
+      case 4: memcpy(&u32, field, 4); u64 = u32; break;
+      default: memcpy(&u64, field, 8); break;
+      }
+      cmp = (u64 > t->value.u) - (u64 < t->value.u);
+      break;
+   case TCPIP_FILTER_INT:
+      switch (t->size) {
+      case 1: memcpy(&u8, field, 1); u64 = (int64_t) (int8_t) u8; break;
+      case 2: memcpy(&u16, field, 2); u64 = (int64_t) (int16_t) u16; break;
+      case 4: memcpy(&u32, field, 4); u64 = (int64_t) (int32_t) u32; break;
+      default: memcpy(&u64, field, 8); break;
+      }
+      cmp = ((int64_t) u64 > t->value.i) - ((int64_t) u64 < t->value.i);
+      break;
+   default:
+      if (t->size == 4) {
+         memcpy(&fl, field, 4);
+         d = fl;
+      } else {
+         memcpy(&d, field, 8);
+      }
+      cmp = (d > t->value.d) - (d < t->value.d);
+      break;
+   }
+
+   switch (t->op) {
+   case TCPIP_FILTER_EQ: return cmp == 0;
+   case TCPIP_FILTER_NE: return cmp != 0;
+   case TCPIP_FILTER_LT: return cmp < 0;
+   case TCPIP_FILTER_LE: return cmp <= 0;
+   case TCPIP_FILTER_GT: return cmp > 0;
+   default: return cmp >= 0;
+   }
+}
+
+/**
+ * \brief Evaluate filter.
+ *
+ * \param[in] f    Filter.
+ * \param[in] rec  Record (its static part is at least f->static_size bytes long).
+ * \return Nonzero if the record satisfies the filter.
+ */
+static inline int
+filter_match(const tcpip_filter_t *f, const char *rec)
+{
+   const tcpip_filter_term_t *t = f->terms, *end = f->terms + f->term_count;
+   int match = 1;
+
+   for (; t < end; t++) {
+      if (match && !filter_term_match(t, rec)) {
+         match = 0;
+      }
+      if (t->last) {
+         if (match) {
+            return 1;
+         }
+         match = 1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * \brief Filter and project records of container as requested by the client.
+ *
+ * \param[in] cl      Client with projection and/or filter.
+ * \param[in] t_cont  Container with original records.
+ * \param[out] size   Size of resulting container, 0 if no record is left.
+ * \return Pointer to resulting container or NULL on memory error.
+ */
+static char *
+prepare_container(client_t *cl, struct trap_container_s *t_cont, size_t *size)
+{
+   const tcpip_projection_t *p = cl->projection;
+   const tcpip_filter_t *flt = cl->filter;
+   const char *src = t_cont->buffer + TRAP_HEADER_SIZE;
+   const char *end = t_cont->buffer + t_cont->used_bytes;
+   char *dst, *out, *dyn;
+   uint16_t rec_size, dyn_offset, var_offset, var_length, count = 0;
+   uint16_t static_size = p != NULL ? p->static_size : flt->static_size;
+   const tcpip_projection_field_t *f;
+   int i;
+
+   if (cl->buffer_size < t_cont->used_bytes) {
+      char *tmp = realloc(cl->buffer, t_cont->used_bytes);
+      if (tmp == NULL) {
+         return NULL;
+      }
+      cl->buffer = tmp;
+      cl->buffer_size = t_cont->used_bytes;
+   }
+   memcpy(cl->buffer, t_cont->buffer, TRAP_HEADER_SIZE);
+   dst = cl->buffer + TRAP_HEADER_SIZE;
+
+   while (src + sizeof(uint16_t) <= end) {
+      rec_size = ntohs(*(const uint16_t *) src);
+      src += sizeof(uint16_t);
+      if (src + rec_size > end) {
+         break;
+      }
+      if (rec_size < static_size) {
+         // malformed record, it cannot be projected nor filtered
+         src += rec_size;
+         continue;
+      }
+      if (flt != NULL && !filter_match(flt, src)) {
+         src += rec_size;
+         continue;
+      }
+      if (p == NULL) {
+         memcpy(dst, src - sizeof(uint16_t), rec_size + sizeof(uint16_t));
+         dst += rec_size + sizeof(uint16_t);
+         src += rec_size;
+         count++;
+         continue;
+      }
+      out = dst + sizeof(uint16_t);
+      dyn = out + p->projected_static_size;
+      dyn_offset = 0;
+      for (i = 0, f = p->fields; i < p->field_count; i++, f++) {
+         if (f->size >= 0) {
+            memcpy(out, src + f->offset, f->size);
+            out += f->size;
+         } else {
+            var_offset = *(const uint16_t *) (src + f->offset);
+            var_length = *(const uint16_t *) (src + f->offset + 2);
+            if (p->static_size + var_offset + var_length > rec_size) {
+               var_length = 0;
+            }
+            memcpy(dyn + dyn_offset, src + p->static_size + var_offset, var_length);
+            *(uint16_t *) out = dyn_offset;
+            *(uint16_t *) (out + 2) = var_length;
+            out += 4;
+            dyn_offset += var_length;
+         }
+      }
+      *(uint16_t *) dst = htons(p->projected_static_size + dyn_offset);
+      dst += sizeof(uint16_t) + p->projected_static_size + dyn_offset;
+      src += rec_size;
+      count++;
+   }
+
+   cl->filtered_messages += t_cont->size - count;
+   if (count == 0) {
+      // empty container is not sent at all
+      *size = 0;
+      return cl->buffer;
+   }
+   *size = dst - cl->buffer;
+   *(uint32_t *) cl->buffer = htonl(*size - TRAP_HEADER_SIZE);
+   *(uint16_t *) &cl->buffer[12] = count;
+   return cl->buffer;
+}
+
+/**
+ * \brief Get data of container to be sent to the client.
+ *
+ * \param[in] cl      Client.
+ * \param[in] t_cont  Container.
+ * \param[out] size   Size of data to send, 0 if nothing is to be sent to the client.
+ * \return Container or its filtered and projected copy if the client requested it.
+ */
+static inline char *
+get_container_data(client_t *cl, struct trap_container_s *t_cont, size_t *size)
+{
+   char *buffer;
+
+   if (cl->projection == NULL && cl->filter == NULL) {
+      *size = t_cont->used_bytes;
+      return t_cont->buffer;
+   }
+   buffer = prepare_container(cl, t_cont, size);
+   if (buffer == NULL) {
+      // records cannot be sent in other form than the client requested
+      *size = 0;
+      return t_cont->buffer;
+   }
+   return buffer;
+}
+
+static void unlock_mutex(void *mtx)
+{
+   pthread_mutex_unlock((pthread_mutex_t *) mtx);
+}
+
+/**
+ * \brief Drop one reference of the spill job, the last one releases its container.
+ *
+ * \param[in] job  Spill job.
+ */
+static void
+spill_job_release(tcpip_spill_job_t *job)
+{
+   if (__sync_sub_and_fetch(&job->refs, 1) == 0) {
+      t_cont_release(job->t_cont);
+      __sync_lock_release(&job->used);
+   }
+}
+
+/**
+ * \brief Free projection, filter, buffers and spill file of the client.
+ *
+ * The spill writer is joined, client_list_mtx must not be held.
+ *
+ * \param[in] cl  Client.
+ */
+static void
+free_client_request(client_t *cl)
+{
+   free_projection(cl->projection);
+   free_filter(cl->filter);
+   free(cl->buffer);
+   cl->projection = NULL;
+   cl->filter = NULL;
+   cl->buffer = NULL;
+   if (cl->spill_fd != -1) {
+      pthread_mutex_lock(&cl->spill_mtx);
+      cl->spill_stop = 1;
+      pthread_cond_broadcast(&cl->spill_cond);
+      pthread_mutex_unlock(&cl->spill_mtx);
+      pthread_join(cl->spill_thread, NULL);
+      while (cl->spill_queue_tail != cl->spill_queue_head) {
+         spill_job_release(cl->spill_queue[cl->spill_queue_tail++ % TCPIP_SPILL_QUEUE_LENGTH]);
+      }
+      close(cl->spill_fd);
+      pthread_cond_destroy(&cl->spill_cond);
+      pthread_mutex_destroy(&cl->spill_mtx);
+      cl->spill_fd = -1;
+   }
+   free(cl->spill_buffer);
+   cl->spill_buffer = NULL;
+}
+
+/**
+ * \brief This function runs in a separate thread. It appends containers queued
+ *        by spill_container() to the spill file of the client.
+ *
+ * \param[in] arg  Client.
+ */
+static void *
+spill_writer(void *arg)
+{
+   client_t *cl = (client_t *) arg;
+   tcpip_spill_job_t *job;
+   struct iovec iov[2];
+   uint64_t offset;
+   ssize_t len, written;
+
+   pthread_mutex_lock(&cl->spill_mtx);
+   while (1) {
+      while (cl->spill_queue_tail == cl->spill_queue_head && !cl->spill_stop) {
+         pthread_cond_wait(&cl->spill_cond, &cl->spill_mtx);
+      }
+      if (cl->spill_stop) {
+         break;
+      }
+      // job stays queued until it is written, the sender waits for it
+      job = cl->spill_queue[cl->spill_queue_tail % TCPIP_SPILL_QUEUE_LENGTH];
+      offset = cl->spill_head;
+      pthread_mutex_unlock(&cl->spill_mtx);
+
+      len = sizeof(job->rec) + job->rec.used_bytes;
+      iov[0].iov_base = &job->rec;
+      iov[0].iov_len = sizeof(job->rec);
+      iov[1].iov_base = job->t_cont->buffer;
+      iov[1].iov_len = job->rec.used_bytes;
+      written = pwritev(cl->spill_fd, iov, 2, offset);
+
+      pthread_mutex_lock(&cl->spill_mtx);
+      cl->spill_queue_tail++;
+      cl->spill_queued -= len;
+      if (written == len) {
+         cl->spill_head += len;
+         cl->spilled_containers++;
+      } else {
+         cl->spill_overflows++;
+      }
+      spill_job_release(job);
+      pthread_cond_broadcast(&cl->spill_cond);
+   }
+   pthread_mutex_unlock(&cl->spill_mtx);
+   return NULL;
+}
+
+/**
+ * \brief Create spill file of a new client and start its spill writer.
+ *
+ * Spill file is used only by clients of non-blocking output IFC with broadcast
+ * dispatch. The file is unlinked right after creation, so it is removed when
+ * the client is disconnected.
+ *
+ * \param[in] c   Pointer to interface's private data structure.
+ * \param[in] cl  Client.
+ */
+static void
+open_client_spill(tcpip_sender_private_t *c, client_t *cl)
+{
+   char *path = NULL;
+
+   cl->spill_fd = -1;
+   if (c->spill_limit == 0 || c->dispatch == TCPIP_DISPATCH_WORKQUEUE ||
+       c->timeout == TRAP_WAIT || c->timeout == TRAP_HALFWAIT) {
+      return;
+   }
+   if (asprintf(&path, "%s/trap-spill-XXXXXX", c->spill_dir) == -1) {
+      return;
+   }
+   cl->spill_fd = mkstemp(path);
+   if (cl->spill_fd == -1) {
+      VERBOSE(CL_WARNING, "Spill file of client %u could not be created in %s (errno: %i).", cl->id, c->spill_dir, errno);
+      free(path);
+      return;
+   }
+   unlink(path);
+   free(path);
+   pthread_mutex_init(&cl->spill_mtx, NULL);
+   pthread_cond_init(&cl->spill_cond, NULL);
+   if (pthread_create(&cl->spill_thread, NULL, spill_writer, cl) != 0) {
+      VERBOSE(CL_WARNING, "Spill writer of client %u could not be started.", cl->id);
+      pthread_cond_destroy(&cl->spill_cond);
+      pthread_mutex_destroy(&cl->spill_mtx);
+      close(cl->spill_fd);
+      cl->spill_fd = -1;
+   }
+}
+
+/**
+ * \brief Queue container that is going to be overwritten for spill files of clients that did not send it yet.
+ *
+ * Only a reference of the container is taken here, spill writers of the
+ * clients write it directly from the container, the producer does not wait
+ * for the disk. Containers are not spilled when the spill file would exceed
+ * the limit or the queue is full (the disk is slower than the producer).
+ * The file is emptied once the client sends all stored containers.
+ *
+ * \param[in] c          Pointer to interface's private data structure.
+ * \param[in] partition  Index of partition of the container.
+ * \param[in] id         ID of the container.
+ */
+static void
+spill_container(tcpip_sender_private_t *c, uint32_t partition, uint64_t id)
+{
+   tcpip_partition_t *part = &c->partitions[partition];
+   struct trap_container_s *t_cont = t_rb_at(&part->t_mbuf.to_send, id);
+   uint64_t len = sizeof(tcpip_spill_record_t) + t_cont->used_bytes;
+   tcpip_spill_job_t *job = NULL;
+   client_t *cl;
+   uint32_t i;
+
+   pthread_mutex_lock(&c->client_list_mtx);
+   LIST_FOREACH(cl, &c->clients_list_head, entries) {
+      if (cl->spill_fd == -1 || cl->partition != partition || __sync_add_and_fetch(&cl->container_id, 0) > id) {
+         continue;
+      }
+      if (job == NULL) {
+         // jobs are taken only by the producer, spill writers just free them
+         for (i = 0; i < TCPIP_SPILL_QUEUE_LENGTH; i++) {
+            if (__sync_bool_compare_and_swap(&part->spill_jobs[i].used, 0, 1)) {
+               job = &part->spill_jobs[i];
+               break;
+            }
+         }
+         if (job == NULL) {
+            cl->spill_overflows++;
+            continue;
+         }
+         // reference of the producer, it is released after queueing
+         job->refs = 1;
+         job->t_cont = t_cont;
+         t_cont_acquiere(t_cont);
+         job->rec.idx = id;
+         job->rec.seq_num = t_cont->seq_num;
+         job->rec.size = t_cont->size;
+         job->rec.used_bytes = t_cont->used_bytes;
+      }
+      pthread_mutex_lock(&cl->spill_mtx);
+      if (cl->spill_queue_head - cl->spill_queue_tail == TCPIP_SPILL_QUEUE_LENGTH ||
+          cl->spill_head + cl->spill_queued + len > c->spill_limit) {
+         cl->spill_overflows++;
+      } else {
+         __sync_add_and_fetch(&job->refs, 1);
+         cl->spill_queue[cl->spill_queue_head++ % TCPIP_SPILL_QUEUE_LENGTH] = job;
+         cl->spill_queued += len;
+         pthread_cond_broadcast(&cl->spill_cond);
+      }
+      pthread_mutex_unlock(&cl->spill_mtx);
+   }
+   pthread_mutex_unlock(&c->client_list_mtx);
+
+   if (job != NULL) {
+      spill_job_release(job);
+   }
+}
+
+/**
+ * \brief Empty the spill file of the client if all its containers were read.
+ *
+ * The file is not truncated when a container was queued or stored meanwhile.
+ *
+ * \param[in] cl  Client.
+ */
+static void
+spill_reset(client_t *cl)
+{
+   pthread_mutex_lock(&cl->spill_mtx);
+   if (cl->spill_tail == cl->spill_head && cl->spill_queue_tail == cl->spill_queue_head) {
+      if (cl->spill_head != 0 && ftruncate(cl->spill_fd, 0) != 0) {
+         VERBOSE(CL_VERBOSE_LIBRARY, "Spill file of client %u could not be truncated (errno: %i).", cl->id, errno);
+      }
+      cl->spill_head = 0;
+      cl->spill_tail = 0;
+   }
+   pthread_mutex_unlock(&cl->spill_mtx);
+}
+
+/**
+ * \brief Read the next container of the client from its spill file.
+ *
+ * Containers the client already sent from the ring buffer are skipped. If some
+ * containers were not stored because the file was full, the client continues
+ * with the next stored one.
+ *
+ * \param[in] cl        Client.
+ * \param[out] spilled  Container to fill, its buffer is owned by the client.
+ * \return Container or NULL if the spill file is empty.
+ */
+static struct trap_container_s *
+read_spilled_container(client_t *cl, struct trap_container_s *spilled)
+{
+   tcpip_spill_record_t rec;
+   uint64_t offset, end;
+   char *tmp;
+
+   while (1) {
+      pthread_mutex_lock(&cl->spill_mtx);
+      // sender threads are cancelled by tcpip_sender_destroy()
+      pthread_cleanup_push(unlock_mutex, &cl->spill_mtx);
+      while (cl->spill_tail == cl->spill_head && cl->spill_queue_tail != cl->spill_queue_head) {
+         // the next container is being written by the spill writer
+         pthread_cond_wait(&cl->spill_cond, &cl->spill_mtx);
+      }
+      offset = cl->spill_tail;
+      end = cl->spill_head;
+      pthread_cleanup_pop(1);
+      if (offset == end) {
+         spill_reset(cl);
+         return NULL;
+      }
+      if (pread(cl->spill_fd, &rec, sizeof(rec), offset) != sizeof(rec)) {
+         goto failure;
+      }
+      if (rec.idx >= cl->container_id) {
+         break;
+      }
+      // container was sent from the ring buffer
+      pthread_mutex_lock(&cl->spill_mtx);
+      cl->spill_tail = offset + sizeof(rec) + rec.used_bytes;
+      pthread_mutex_unlock(&cl->spill_mtx);
+   }
+
+   if (cl->spill_buffer_size < rec.used_bytes) {
+      tmp = realloc(cl->spill_buffer, rec.used_bytes);
+      if (tmp == NULL) {
+         goto failure;
+      }
+      cl->spill_buffer = tmp;
+      cl->spill_buffer_size = rec.used_bytes;
+   }
+   if (pread(cl->spill_fd, cl->spill_buffer, rec.used_bytes, offset + sizeof(rec)) != rec.used_bytes) {
+      goto failure;
+   }
+   pthread_mutex_lock(&cl->spill_mtx);
+   cl->spill_tail = offset + sizeof(rec) + rec.used_bytes;
+   pthread_mutex_unlock(&cl->spill_mtx);
+
+   if (rec.idx > cl->container_id) {
+      // containers between were not spilled
+      __sync_add_and_fetch(&cl->container_id, rec.idx - cl->container_id);
+   }
+   spilled->buffer = cl->spill_buffer;
+   spilled->used_bytes = rec.used_bytes;
+   spilled->size = rec.size;
+   spilled->seq_num = rec.seq_num;
+   spilled->idx = rec.idx;
+   return spilled;
+
+failure:
+   VERBOSE(CL_VERBOSE_LIBRARY, "Reading of spill file of client %u failed, its content is dropped.", cl->id);
+   pthread_mutex_lock(&cl->spill_mtx);
+   cl->spill_tail = cl->spill_head;
+   pthread_mutex_unlock(&cl->spill_mtx);
+   spill_reset(cl);
+   return NULL;
+}
+
+/**
+ * \brief Receive a string of client request.
+ *
+ * \param[in] sd    Socket descriptor of the client.
+ * \param[in] size  Size of the string in network byte order.
+ * \param[out] str  Received string, NULL if the size is 0.
+ * \return 0 on success, -1 on error.
+ */
+static int
+receive_request_string(int sd, uint32_t size, char **str)
+{
+   size = ntohl(size);
+   *str = NULL;
+   if (size == 0) {
+      return 0;
+   }
+   if (size > TCPIP_REQUEST_MAX_SIZE) {
+      return -1;
+   }
+   *str = calloc(size + 1, 1);
+   if (*str == NULL) {
+      return -1;
+   }
+   if (recv(sd, *str, size, MSG_WAITALL) != size) {
+      free(*str);
+      *str = NULL;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * \brief Receive request (projection and filter) of a new client.
+ *
+ * \param[in] sd              Socket descriptor of the client.
+ * \param[out] req_fmt_spec   Data format specifier required by the client, NULL if it did not request projection.
+ * \param[out] filter         Filter expression requested by the client, NULL if it did not request filter.
+ */
+static void
+receive_client_request(int sd, char **req_fmt_spec, char **filter)
+{
+   struct pollfd pfd = {.fd = sd, .events = POLLIN};
+   tcpip_client_request_t request;
+
+   *req_fmt_spec = NULL;
+   *filter = NULL;
+   if (poll(&pfd, 1, TCPIP_REQUEST_TIMEOUT) != 1 || !(pfd.revents & POLLIN)) {
+      return;
+   }
+   if (recv(sd, &request, sizeof(request), MSG_WAITALL) != sizeof(request) ||
+       ntohl(request.magic) != TCPIP_REQUEST_MAGIC) {
+      return;
+   }
+   if (receive_request_string(sd, request.data_fmt_spec_size, req_fmt_spec) != 0 ||
+       receive_request_string(sd, request.filter_size, filter) != 0) {
+      free(*req_fmt_spec);
+      *req_fmt_spec = NULL;
+   }
+}
+
+/**
+ * \brief Close the socket and free a client removed from the list of clients.
+ *
+ * It joins the spill writer of the client, so it must be called without
+ * client_list_mtx held.
+ *
+ * \param[in] cl Client to free.
+ */
+static void
+free_client(client_t *cl)
+{
+   shutdown(cl->sd, SHUT_RDWR);
+   close(cl->sd);
+   free_client_request(cl);
+   free(cl);
+}
+
+/**
+ * \brief This function is called when a client was/is being disconnected.
+ *
+ * \param[in] c Pointer to interface's private data structure.
+ * \param[in] cl Client to disconnect
+ */
+static void
+disconnect_client(tcpip_sender_private_t *c, client_t *cl)
+{
+   bool found = false;
+
+   pthread_mutex_lock(&c->client_list_mtx);
+   client_t *next, *cl_iterator = LIST_FIRST(&c->clients_list_head);
+   while (cl_iterator != NULL) {
+      next = LIST_NEXT(cl_iterator, entries);
+      if (cl_iterator == cl) {
+         __sync_sub_and_fetch(&c->connected_clients, 1);
+         __sync_sub_and_fetch(&c->partitions[cl->partition].clients, 1);
+         LIST_REMOVE(cl, entries);
+         found = true;
+         break;
+      }
+      cl_iterator = next;
+   }
+   pthread_mutex_unlock(&c->client_list_mtx);
+
+   if (found) {
+      free_client(cl);
+   }
+}
+
+/**
+ * \brief Function disconnects all clients of the output interface whose private structure is passed via "priv" parameter.
+ *
+ * \param[in] priv Pointer to output interface private structure.
+ */
+void tcpip_server_disconnect_all_clients(void *priv)
+{
+   tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
+   struct clients_head_s removed = LIST_HEAD_INITIALIZER(removed);
+
+   pthread_mutex_lock(&c->client_list_mtx);
+   client_t *next, *cl = LIST_FIRST(&c->clients_list_head);
+   while (cl != NULL) {
+      next = LIST_NEXT(cl, entries);
+      __sync_sub_and_fetch(&c->connected_clients, 1);
+      __sync_sub_and_fetch(&c->partitions[cl->partition].clients, 1);
+      LIST_REMOVE(cl, entries);
+      LIST_INSERT_HEAD(&removed, cl, entries);
+      cl = next;
+   }
+   pthread_mutex_unlock(&c->client_list_mtx);
+
+   // spill writers are joined without the lock
+   while ((cl = LIST_FIRST(&removed)) != NULL) {
+      LIST_REMOVE(cl, entries);
+      free_client(cl);
+   }
+}
+
+static bool
+is_next_container_ready(struct trap_ring_buffer_s *to_send, client_t *cl)
+{
+	uint64_t head = __sync_fetch_and_add(&to_send->head_, 0); 
+   if (head == 0 || cl->container_id >= head) {
+      return false;
+   } 
+   return true;
+}
+
+/**
+ * \brief This function runs in a separate thread. It handles sending data
+          to connected clients for TCPIP and UNIX interfaces (this function is blocking).
+ * \param[in] arg pointer to thread_data
+ */
+static void *
+send_blocking_mode(void *arg)
+{
+   tcpip_sender_private_t *c = ((struct thread_data *) arg)->arg;
+   client_t *cl = ((struct thread_data *) arg)->client;
+   struct trap_ring_buffer_s *to_send = &c->partitions[cl->partition].t_mbuf.to_send;
+   struct trap_container_s *t_cont;
+
+   uint64_t sleep_time = 1;
+   size_t pending_bytes, total_bytes;
+   char *buffer;
+   int send_ret_code;
+
+   while (!c->is_terminated) {
+      // is next container ready
+      while (!is_next_container_ready(to_send, cl)) {
+         if (c->is_terminated) {
+            goto cleanup;
+         }
+         sleep_time = calculate_sleep(sleep_time);
+         usleep(sleep_time);
+      }
+
+      sleep_time = 1;
+
+      // get next container
+      t_cont = t_rb_at(to_send, cl->container_id);
+      if (t_cont == NULL) {
+         // we cannot operate with NULL t_cont
+         continue;
+      }
+          
+      buffer = get_container_data(cl, t_cont, &total_bytes);
+      pending_bytes = total_bytes;
+
+again:
+      send_ret_code = send(cl->sd, &buffer[total_bytes - pending_bytes], pending_bytes, MSG_NOSIGNAL);
+      if (send_ret_code < 0) { // Send failed
+         if (c->is_terminated) {
+            break;
+         }
+         switch (errno) {
+         case EBADF:
+         case EPIPE:
+         case EFAULT:
+            goto cleanup;
+         case EAGAIN:
+            goto again;
+         default:    
+            VERBOSE(CL_VERBOSE_OFF, "Unhandled error from send in send_blocking_mode (errno: %i)", errno);
+            goto cleanup;
+         }
+      } else {
+         pending_bytes -= send_ret_code;
+         if (pending_bytes) { // buffer was not send completely. Try again send pending bytes.
+            goto again;
+         }
+      }
+
+      // increase container ID and statistics
+      cl->sent_containers++;
+      cl->sent_messages += t_cont->size; 
+      __sync_add_and_fetch(&cl->container_id, 1);
+   }
+
+cleanup:
+   disconnect_client(c, cl);
+   free(arg);
    pthread_exit(NULL);
 }
 
@@ -1224,43 +2482,56 @@ send_non_blocking_mode(void *arg)
 {
    tcpip_sender_private_t *c = ((struct thread_data *) arg)->arg;
    client_t *cl = ((struct thread_data *) arg)->client;
-   struct trap_container_s *t_cont;
+   struct trap_ring_buffer_s *to_send = &c->partitions[cl->partition].t_mbuf.to_send;
+   struct trap_container_s *t_cont, spilled;
 
    uint64_t sleep_time = 1;
    uint64_t next_seq_number = -1;
-   size_t pending_bytes;
+   size_t pending_bytes, total_bytes;
    char *buffer;
    int send_ret_code;
 
    while (!c->is_terminated) {
 again_set_container:
-      while (!is_next_container_ready(c, cl)) {
-        	sleep_time = calculate_sleep(sleep_time);
-         usleep(sleep_time);
-      }
+      if (cl->spill_fd != -1 && __sync_fetch_and_add(&cl->container_id, 0) < __sync_fetch_and_add(&to_send->tail_, 0)) {
+         // container was overwritten, continue from the spill file
+         t_cont = read_spilled_container(cl, &spilled);
+         if (t_cont == NULL) {
+            uint64_t head = __sync_fetch_and_add(&to_send->head_, 0); 
+            __sync_add_and_fetch(&cl->container_id, head - cl->container_id);
+            goto again_set_container;
+         }
+      } else {
+         while (!is_next_container_ready(to_send, cl)) {
+           	sleep_time = calculate_sleep(sleep_time);
+            usleep(sleep_time);
+         }
 
-      sleep_time = 1;
-          
-      // get next container
-      t_cont = t_rb_at(&c->t_mbuf.to_send, cl->container_id);
-      if (t_cont == NULL) {
-         // we cannot operate with NULL t_cont
-         continue;
-      }
+         sleep_time = 1;
+             
+         // get next container
+         t_cont = t_rb_at(to_send, cl->container_id);
+         if (t_cont == NULL) {
+            // we cannot operate with NULL t_cont
+            continue;
+         }
 
-      // container is no longer available
-      if (t_cont_acquiere(t_cont) < 1 || __sync_fetch_and_add(&t_cont->idx, 0) != cl->container_id) {
-         t_cont_release(t_cont);
-         uint64_t head = __sync_fetch_and_add(&c->t_mbuf.to_send.head_, 0); 
-         __sync_add_and_fetch(&cl->container_id, head - cl->container_id);
-         goto again_set_container;
+         // container is no longer available
+         if (t_cont_acquiere(t_cont) < 1 || __sync_fetch_and_add(&t_cont->idx, 0) != cl->container_id) {
+            t_cont_release(t_cont);
+            if (cl->spill_fd == -1) {
+               uint64_t head = __sync_fetch_and_add(&to_send->head_, 0); 
+               __sync_add_and_fetch(&cl->container_id, head - cl->container_id);
+            }
+            goto again_set_container;
+         }
       }
 
-      buffer = t_cont->buffer;
-      pending_bytes = t_cont->used_bytes;
+      buffer = get_container_data(cl, t_cont, &total_bytes);
+      pending_bytes = total_bytes;
 
 again:
-      send_ret_code = send(cl->sd, &buffer[t_cont->used_bytes - pending_bytes], pending_bytes, MSG_NOSIGNAL);
+      send_ret_code = send(cl->sd, &buffer[total_bytes - pending_bytes], pending_bytes, MSG_NOSIGNAL);
       if (send_ret_code < 0) { // Send failed
          if (c->is_terminated) {
             break;
@@ -1269,13 +2540,17 @@ again:
          case EBADF:
          case EPIPE:
          case EFAULT:
-            t_cont_release(t_cont);
+            if (t_cont != &spilled) {
+               t_cont_release(t_cont);
+            }
             goto cleanup;
          case EAGAIN:
             goto again;
          default:    
             VERBOSE(CL_VERBOSE_OFF, "Unhandled error from send in send_non_blocking_mode (errno: %i)", errno);
-            t_cont_release(t_cont);
+            if (t_cont != &spilled) {
+               t_cont_release(t_cont);
+            }
             goto cleanup;
          }
       } else {
@@ -1301,11 +2576,13 @@ again:
       cl->sent_containers++;
       cl->sent_messages += t_cont->size; 
       
-      t_cont_release(t_cont);
-      uint64_t tail = __sync_fetch_and_add(&c->t_mbuf.to_send.tail_, 0);
+      if (t_cont != &spilled) {
+         t_cont_release(t_cont);
+      }
+      uint64_t tail = __sync_fetch_and_add(&to_send->tail_, 0);
 
-      if (cl->container_id < tail) {
-         uint64_t head = __sync_fetch_and_add(&c->t_mbuf.to_send.head_, 0); 
+      if (cl->container_id < tail && cl->spill_fd == -1) {
+         uint64_t head = __sync_fetch_and_add(&to_send->head_, 0); 
          __sync_add_and_fetch(&cl->container_id, head - cl->container_id);
       } else {
          __sync_add_and_fetch(&cl->container_id, 1);
@@ -1318,6 +2595,250 @@ cleanup:
    pthread_exit(NULL);
 }
 
+/**
+ * \brief Wait until a container of the partition is finished (work-queue dispatch).
+ *
+ * Idle clients sleep on a condition variable signaled by finish_container(),
+ * so they do not lose claims to busy clients because of polling. The wait
+ * is limited to 100 ms to check termination of the IFC.
+ *
+ * \param[in] part  partition of the client
+ */
+static void wait_for_container(tcpip_partition_t *part)
+{
+   struct trap_mbuf_s *t_mbuf = &part->t_mbuf;
+   struct timespec ts;
+
+   clock_gettime(CLOCK_REALTIME, &ts);
+   ts.tv_nsec += 100000000;
+   if (ts.tv_nsec >= 1000000000) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+   }
+
+   pthread_mutex_lock(&part->claim_mtx);
+   // sender threads are cancelled by tcpip_sender_destroy()
+   pthread_cleanup_push(unlock_mutex, &part->claim_mtx);
+   // counted before checking the ring, finish_container() checks waiters after moving head
+   __sync_add_and_fetch(&part->claim_waiters, 1);
+   if (__sync_fetch_and_add(&t_mbuf->to_send.head_, 0) <= __sync_fetch_and_add(&t_mbuf->dispatched, 0)) {
+      pthread_cond_timedwait(&part->claim_cond, &part->claim_mtx, &ts);
+   }
+   __sync_sub_and_fetch(&part->claim_waiters, 1);
+   pthread_cleanup_pop(1);
+}
+
+/**
+ * \brief This function runs in a separate thread. It handles sending data
+          to connected clients in work-queue dispatch mode - containers are claimed
+          from the ring of the partition, so every container is sent to one client only.
+ * \param[in] arg pointer to thread_data
+ */
+static void *
+send_work_queue_mode(void *arg)
+{
+   tcpip_sender_private_t *c = ((struct thread_data *) arg)->arg;
+   client_t *cl = ((struct thread_data *) arg)->client;
+   tcpip_partition_t *part = &c->partitions[cl->partition];
+   struct trap_mbuf_s *t_mbuf = &part->t_mbuf;
+   struct trap_container_s *t_cont;
+
+   uint64_t first, lost, id;
+   size_t claimed;
+   size_t pending_bytes, total_bytes;
+   char *buffer;
+   int send_ret_code;
+
+   while (!c->is_terminated) {
+      // containers that can be claimed must not be overwritten in blocking mode
+      __sync_lock_test_and_set(&cl->container_id, __sync_fetch_and_add(&t_mbuf->dispatched, 0));
+
+      claimed = t_mbuf_claim(t_mbuf, c->claim_count, &first, &lost);
+      if (claimed == 0) {
+         wait_for_container(part);
+         continue;
+      }
+
+      cl->claims++;
+      cl->lost_containers += lost;
+
+      for (id = first; id < first + claimed; id++) {
+         __sync_lock_test_and_set(&cl->container_id, id);
+         t_cont = t_rb_at(&t_mbuf->to_send, id);
+
+         // container is no longer available
+         if (t_cont == NULL || t_cont_acquiere(t_cont) < 1 || __sync_fetch_and_add(&t_cont->idx, 0) != id) {
+            if (t_cont != NULL) {
+               t_cont_release(t_cont);
+            }
+            cl->lost_containers++;
+            continue;
+         }
+
+         buffer = get_container_data(cl, t_cont, &total_bytes);
+         pending_bytes = total_bytes;
+
+again:
+         send_ret_code = send(cl->sd, &buffer[total_bytes - pending_bytes], pending_bytes, MSG_NOSIGNAL);
+         if (send_ret_code < 0) { // Send failed
+            if (c->is_terminated) {
+               t_cont_release(t_cont);
+               goto cleanup;
+            }
+            switch (errno) {
+            case EAGAIN:
+               goto again;
+            case EBADF:
+            case EPIPE:
+            case EFAULT:
+               break;
+            default:
+               VERBOSE(CL_VERBOSE_OFF, "Unhandled error from send in send_work_queue_mode (errno: %i)", errno);
+               break;
+            }
+            t_cont_release(t_cont);
+            goto cleanup;
+         } else {
+            pending_bytes -= send_ret_code;
+            if (pending_bytes) { // buffer was not send completely. Try again send pending bytes.
+               goto again;
+            }
+         }
+
+         // increase statistics
+         cl->sent_containers++;
+         cl->sent_messages += t_cont->size;
+         t_cont_release(t_cont);
+      }
+   }
+
+cleanup:
+   disconnect_client(c, cl);
+   free(arg);
+   pthread_exit(NULL);
+}
+
+/**
+ * \brief Connect a new client, it is called by the sender thread of the client.
+ *
+ * The request of the client (projection and filter) is received here, so
+ * a slow client does not delay accepting of other clients. The client is
+ * negotiated and added to the list of clients under the lock of the IFC.
+ *
+ * \param[in] c   Pointer to interface's private data structure.
+ * \param[in] cl  New client.
+ * \return 0 on success, -1 if the client was refused and freed.
+ */
+static int
+connect_client(tcpip_sender_private_t *c, client_t *cl)
+{
+   char *req_fmt_spec = NULL, *req_filter = NULL;
+   int result = -1;
+
+   cl->sender_thread_id = pthread_self();
+
+   // client can request projection and filter of records before the negotiation
+   if (c->projection || c->filter) {
+      receive_client_request(cl->sd, &req_fmt_spec, &req_filter);
+   }
+
+   // lock interface to connect new client
+   __sync_add_and_fetch(&c->clients_waiting_for_connection, 1);
+
+   pthread_mutex_lock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+
+   __sync_sub_and_fetch(&c->clients_waiting_for_connection, 1);
+
+   if (c->is_terminated) {
+      goto unlock;
+   }
+
+   cl->partition = assign_partition(c);
+   cl->container_id = t_rb_head_id(&c->partitions[cl->partition].t_mbuf.to_send);
+   if (c->dispatch == TCPIP_DISPATCH_WORKQUEUE) {
+      struct trap_mbuf_s *t_mbuf = &c->partitions[cl->partition].t_mbuf;
+      if (c->partitions[cl->partition].clients == 0) {
+         // nobody claimed containers so far, start with new data as in broadcast
+         __sync_lock_test_and_set(&t_mbuf->dispatched, cl->container_id);
+      } else {
+         cl->container_id = __sync_fetch_and_add(&t_mbuf->dispatched, 0);
+      }
+   }
+   open_client_spill(c, cl);
+
+   if (c->ctx->out_ifc_list[c->ifc_idx].data_type == TRAP_FMT_UNIREC) {
+      const char *data_fmt_spec = c->ctx->out_ifc_list[c->ifc_idx].data_fmt_spec;
+      if (c->projection && req_fmt_spec != NULL) {
+         cl->projection = create_projection(data_fmt_spec, req_fmt_spec);
+         if (cl->projection != NULL) {
+            VERBOSE(CL_VERBOSE_ADVANCED, "Client %u requested projection of records to: %s", cl->id, cl->projection->fmt_spec);
+            c->negotiation_fmt_spec = cl->projection->fmt_spec;
+         }
+      }
+      if (c->filter && req_filter != NULL) {
+         cl->filter = create_filter(data_fmt_spec, req_filter);
+         if (cl->filter != NULL) {
+            VERBOSE(CL_VERBOSE_ADVANCED, "Client %u requested filter: %s", cl->id, req_filter);
+         } else {
+            VERBOSE(CL_WARNING, "Filter \"%s\" requested by client %u is not valid, all records will be sent.", req_filter, cl->id);
+         }
+      }
+   }
+
+#ifdef ENABLE_NEGOTIATION
+   int ret_val = output_ifc_negotiation(c, TRAP_IFC_TYPE_TCPIP, cl->sd, NULL);
+   c->negotiation_fmt_spec = NULL;
+   if (ret_val == NEG_RES_OK) {
+      VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: success.");
+   } else if (ret_val == NEG_RES_FMT_UNKNOWN) {
+      VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: failed (unknown data format of this output interface -> refuse client).");
+      goto unlock;
+   } else { // ret_val == NEG_RES_FAILED, sending the data to input interface failed, refuse client
+      VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: failed (error while sending hello message to input interface).");
+      goto unlock;
+   }
+#endif
+   pthread_mutex_lock(&c->client_list_mtx);
+   LIST_INSERT_HEAD(&c->clients_list_head, cl, entries);
+   pthread_mutex_unlock(&c->client_list_mtx);
+   __sync_add_and_fetch(&c->partitions[cl->partition].clients, 1);
+   __sync_add_and_fetch(&c->connected_clients, 1);
+   result = 0;
+
+unlock:
+   pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+   if (result != 0) {
+      free_client(cl);
+   }
+   free(req_fmt_spec);
+   free(req_filter);
+   __sync_sub_and_fetch(&c->connecting_clients, 1);
+   return result;
+}
+
+/**
+ * \brief This function runs in a separate thread for every client. It connects
+ *        the client and continues with sending of data according to the mode of the IFC.
+ * \param[in] arg pointer to thread_data
+ */
+static void *
+client_thread(void *arg)
+{
+   tcpip_sender_private_t *c = ((struct thread_data *) arg)->arg;
+   client_t *cl = ((struct thread_data *) arg)->client;
+
+   if (connect_client(c, cl) != 0) {
+      free(arg);
+      pthread_exit(NULL);
+   }
+   if (c->dispatch == TCPIP_DISPATCH_WORKQUEUE) {
+      return send_work_queue_mode(arg);
+   } else if (c->timeout == TRAP_WAIT || c->timeout == TRAP_HALFWAIT) {
+      return send_blocking_mode(arg);
+   }
+   return send_non_blocking_mode(arg);
+}
+
 /**
  * \brief This function runs in a separate thread and handles new client's connection requests.
  *
@@ -1336,6 +2857,8 @@ static void *accept_clients_thread(void *arg)
    uint32_t ucredlen = sizeof(struct ucred);
    uint32_t client_id = 0;
    struct pollfd pfds;
+   struct thread_data *client_thread_data;
+   pthread_t thread;
 
    /* handle new connections */
    addrlen = sizeof(remoteaddr);
@@ -1357,6 +2880,7 @@ static void *accept_clients_thread(void *arg)
       }
 
       cl = NULL;
+      client_thread_data = NULL;
 
       if (pfds.revents & POLLIN) {
          newclient = accept(c->server_sd, (struct sockaddr *) &remoteaddr, &addrlen);
@@ -1386,61 +2910,29 @@ static void *accept_clients_thread(void *arg)
                     inet_ntop(remoteaddr.ss_family, get_in_addr((struct sockaddr*) &remoteaddr), remoteIP, INET6_ADDRSTRLEN),
                     newclient);
 
-            cl = calloc(1, sizeof(struct client_s));
-            if (cl == NULL) {
-                VERBOSE(CL_VERBOSE_LIBRARY, "Client's memory allocation failed. Refuse connection.");
-               goto refuse_client;
-            }
-
-            if (c->connected_clients < c->max_clients) {
-               // lock interface to connect new client
-
-               __sync_add_and_fetch(&c->clients_waiting_for_connection, 1);
-
-               pthread_mutex_lock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
-
-               __sync_sub_and_fetch(&c->clients_waiting_for_connection, 1);
-
-               cl->container_id = t_rb_head_id(&c->t_mbuf.to_send);
+            // clients being connected by their sender threads count as connected
+            if (__sync_add_and_fetch(&c->connected_clients, 0) + __sync_add_and_fetch(&c->connecting_clients, 0) < c->max_clients) {
+               cl = calloc(1, sizeof(struct client_s));
+               client_thread_data = malloc(sizeof(struct thread_data));
+               if (cl == NULL || client_thread_data == NULL) {
+                  VERBOSE(CL_VERBOSE_LIBRARY, "Client's memory allocation failed. Refuse connection.");
+                  goto refuse_client;
+               }
+               cl->spill_fd = -1;
                cl->sd = newclient;
                cl->pfds_index = -1;
                cl->id = client_id;
 
-#ifdef ENABLE_NEGOTIATION
-               int ret_val = output_ifc_negotiation(c, TRAP_IFC_TYPE_TCPIP, newclient, NULL);
-               if (ret_val == NEG_RES_OK) {
-                  VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: success.");
-               } else if (ret_val == NEG_RES_FMT_UNKNOWN) {
-                  VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: failed (unknown data format of this output interface -> refuse client).");
-                  pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
-                  goto refuse_client;
-               } else { // ret_val == NEG_RES_FAILED, sending the data to input interface failed, refuse client
-                  VERBOSE(CL_VERBOSE_LIBRARY, "Output_ifc_negotiation result: failed (error while sending hello message to input interface).");
-                  pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
-                  goto refuse_client;
-               }
-#endif
-               pthread_mutex_lock(&c->client_list_mtx);
-               LIST_INSERT_HEAD(&c->clients_list_head, cl, entries);
-               pthread_mutex_unlock(&c->client_list_mtx);
-               struct thread_data *client_thread_data = malloc(sizeof(struct thread_data));
-               if (client_thread_data == NULL) {
-                	VERBOSE(CL_VERBOSE_LIBRARY, "Client's memory allocation failed. Refuse connection.");
-                	pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
-                	goto refuse_client;
-               }
-
                client_thread_data->arg = c;
                client_thread_data->client = cl;
 
-               if (c->timeout == TRAP_WAIT || c->timeout == TRAP_HALFWAIT) {
-                  pthread_create(&cl->sender_thread_id, NULL, send_blocking_mode, client_thread_data);
-               } else {
-                  pthread_create(&cl->sender_thread_id, NULL, send_non_blocking_mode, client_thread_data);
+               // request of the client is received by its sender thread, accepting is not blocked by it
+               __sync_add_and_fetch(&c->connecting_clients, 1);
+               if (pthread_create(&thread, NULL, client_thread, client_thread_data) != 0) {
+                  __sync_sub_and_fetch(&c->connecting_clients, 1);
+                  VERBOSE(CL_VERBOSE_LIBRARY, "Client's thread could not be started. Refuse connection.");
+                  goto refuse_client;
                }
-               
-               __sync_add_and_fetch(&c->connected_clients, 1);
-               pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
             } else {
                VERBOSE(CL_VERBOSE_LIBRARY, "Shutting down client we do not have additional resources (%u/%u)", 
                   c->connected_clients, c->max_clients);
@@ -1448,6 +2940,7 @@ refuse_client:
                shutdown(newclient, SHUT_RDWR);
                close(newclient);
                free(cl);
+               free(client_thread_data);
             }
          }
       }
@@ -1457,17 +2950,19 @@ refuse_client:
 }
 
 static void 
-finish_container(tcpip_sender_private_t *c, struct trap_mbuf_s *t_mbuf)
+finish_container(tcpip_sender_private_t *c, uint32_t partition)
 {
+   tcpip_partition_t *part = &c->partitions[partition];
+   struct trap_mbuf_s *t_mbuf = &part->t_mbuf;
    t_cont_write_header(t_mbuf->active, t_mbuf->to_send.head_);
    uint64_t current_sleep = 1;
     
-   if ((c->timeout == TRAP_WAIT || (c->timeout == TRAP_HALFWAIT && c->connected_clients))  
-      && c->lowest_container_id <= t_mbuf->to_send.tail_ 
+   if ((c->timeout == TRAP_WAIT || (c->timeout == TRAP_HALFWAIT && part->clients))  
+      && part->lowest_container_id <= t_mbuf->to_send.tail_ 
       && (t_mbuf->to_send.head_ - t_mbuf->to_send.tail_ >= t_mbuf->to_send.size - 1) ) {
 repeat:
-      c->lowest_container_id = find_lowest_container_id(c); 
-      if (c->lowest_container_id <= t_mbuf->to_send.tail_) {
+      part->lowest_container_id = find_lowest_container_id(c, partition); 
+      if (part->lowest_container_id <= t_mbuf->to_send.tail_) {
          if (c->is_terminated) {
             return;
          }
@@ -1485,6 +2980,11 @@ repeat:
       }
    }        
 
+   if (c->spill_limit != 0 && t_mbuf->to_send.head_ - t_mbuf->to_send.tail_ == t_mbuf->to_send.size - 1) {
+      // container at tail is going to be overwritten, slow clients continue from their spill files
+      spill_container(c, partition, t_mbuf->to_send.tail_);
+   }
+
     struct trap_container_s *old_container = t_rb_get_old_write_new(&t_mbuf->to_send, t_mbuf->active);
     if (old_container != NULL) {
       uint8_t ref = __sync_sub_and_fetch(&old_container->ref_counter, 0);
@@ -1503,6 +3003,12 @@ repeat:
       }
    }
 
+   if (c->dispatch == TCPIP_DISPATCH_WORKQUEUE && __sync_add_and_fetch(&part->claim_waiters, 0) != 0) {
+      pthread_mutex_lock(&part->claim_mtx);
+      pthread_cond_signal(&part->claim_cond);
+      pthread_mutex_unlock(&part->claim_mtx);
+   }
+
    c->autoflush_timestamp = get_cur_timestamp();
 }
 
@@ -1514,43 +3020,109 @@ repeat:
 void tcpip_sender_flush(void *priv)
 {
    tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
+   bool flushed = false;
+   uint32_t i;
 
    pthread_mutex_lock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
-   struct trap_mbuf_s *t_mbuf = &c->t_mbuf;
+   for (i = 0; i < c->partition_count; i++) {
+      struct trap_mbuf_s *t_mbuf = &c->partitions[i].t_mbuf;
+
+      // buffer is empty, only header inside
+      if (t_mbuf->active->used_bytes == TRAP_HEADER_SIZE) {
+         continue;
+      }
 
-   // buffer is empty, only header inside
-   if (t_mbuf->active->used_bytes == TRAP_HEADER_SIZE) {
-      pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+      finish_container(c, i);
+      c->max_container_id++;
+      struct trap_container_s *t_cont = t_mbuf_get_empty_container(t_mbuf);
+      t_cont_set_seq_num(t_cont, t_mbuf->processed_messages);
+      flushed = true;
+   }
+
+   if (flushed) {
+      __sync_add_and_fetch(&c->ctx->counter_autoflush[c->ifc_idx], 1);
+   }
+   pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+}
+
+/**
+ * \brief Adjust container size and autoflush timeout in adaptive mode.
+ *
+ * Containers are finished when they contain the amount of data stored within
+ * the latency budget according to the measured rate, partially filled ones are
+ * flushed after the latency budget. When clients lag behind, full containers
+ * and the autoflush timeout of the module are used to decrease the overhead.
+ *
+ * \param[in] c  pointer to interface private data
+ */
+static void adapt_containers(tcpip_sender_private_t *c)
+{
+   uint64_t now = get_cur_timestamp();
+   uint64_t elapsed = now - c->adaptive_timestamp;
+   uint64_t bytes, head, lowest;
+   uint32_t min_size = c->buffer_size < ADAPTIVE_MIN_CONTAINER_SIZE ? c->buffer_size : ADAPTIVE_MIN_CONTAINER_SIZE;
+   double threshold;
+   bool lagging = false;
+   uint32_t i;
+
+   if (elapsed < ADAPTIVE_PERIOD) {
       return;
    }
+   bytes = __sync_lock_test_and_set(&c->adaptive_bytes, 0);
+   c->adaptive_timestamp = now;
+   c->adaptive_rate = (3 * c->adaptive_rate + (double) bytes / elapsed) / 4;
 
-   finish_container(c, t_mbuf);
-   c->max_container_id++;
-   struct trap_container_s *t_cont = t_mbuf_get_empty_container(t_mbuf);
-   t_cont_set_seq_num(t_cont, t_mbuf->processed_messages);
+   for (i = 0; i < c->partition_count; i++) {
+      if (__sync_add_and_fetch(&c->partitions[i].clients, 0) == 0) {
+         continue;
+      }
+      head = __sync_add_and_fetch(&c->partitions[i].t_mbuf.to_send.head_, 0);
+      lowest = find_lowest_container_id(c, i);
+      if (head > lowest && head - lowest > c->buffer_count / 2) {
+         lagging = true;
+      }
+   }
 
-   __sync_add_and_fetch(&c->ctx->counter_autoflush[c->ifc_idx], 1);
-   pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
+   if (lagging) {
+      __atomic_store_n(&c->flush_threshold, c->buffer_size, __ATOMIC_RELAXED);
+      __atomic_store_n(&c->autoflush_interval, c->ctx->out_ifc_list[c->ifc_idx].timeout > c->latency ?
+                       c->ctx->out_ifc_list[c->ifc_idx].timeout : c->latency, __ATOMIC_RELAXED);
+   } else {
+      threshold = TRAP_HEADER_SIZE + c->adaptive_rate * c->latency / c->partition_count;
+      if (threshold < min_size) {
+         threshold = min_size;
+      } else if (threshold > c->buffer_size) {
+         threshold = c->buffer_size;
+      }
+      __atomic_store_n(&c->flush_threshold, (uint32_t) threshold, __ATOMIC_RELAXED);
+      __atomic_store_n(&c->autoflush_interval, c->latency, __ATOMIC_RELAXED);
+   }
 }
 
 static void *autoflush_thread(void *priv)
 {
    tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
-   int64_t time_since_flush;
+   int64_t time_since_flush, timeout;
 
    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
 
    while (!c->is_terminated) {
+      if (c->latency != 0) {
+         adapt_containers(c);
+         timeout = __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED);
+      } else {
+         timeout = c->ctx->out_ifc_list[c->ifc_idx].timeout;
+      }
       if (c->connected_clients == 0) {
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout);
+         usleep(timeout);
          continue;
       }
       time_since_flush = get_cur_timestamp() - c->autoflush_timestamp;
-      if (time_since_flush >= c->ctx->out_ifc_list[c->ifc_idx].timeout) {
+      if (time_since_flush >= timeout) {
          tcpip_sender_flush(c);
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout);
+         usleep(timeout);
       } else {
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout - time_since_flush);    
+         usleep(timeout - time_since_flush);    
       }
    }
    pthread_exit(NULL);
@@ -1571,9 +3143,10 @@ static void *autoflush_thread(void *priv)
 int tcpip_sender_send(void *priv, const void *data, uint16_t size, int timeout)
 {
    tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
+   uint32_t partition;
 
    // Can we put message at least into empty buffer? 
-   if (t_cont_has_capacity(size + sizeof(size)) == false) {
+   if (t_cont_has_capacity(c->partitions[0].t_mbuf.containers, size + sizeof(size)) == false) {
       VERBOSE(CL_ERROR, "Container is too small for message of size [%u B]. Skipping...", size);
       return TRAP_E_OK;
    }
@@ -1583,7 +3156,8 @@ repeat:
       return TRAP_E_TERMINATED;
    }
 
-   if (timeout == TRAP_WAIT && c->connected_clients == 0) {
+   partition = get_partition(c, data, size);
+   if (timeout == TRAP_WAIT && c->partitions[partition].clients == 0) {
       usleep(NO_CLIENTS_SLEEP);
       goto repeat;
    }
@@ -1591,7 +3165,7 @@ repeat:
    // lock critical section
    pthread_mutex_lock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);      
 
-   struct trap_mbuf_s *t_mbuf = &c->t_mbuf;
+   struct trap_mbuf_s *t_mbuf = &c->partitions[partition].t_mbuf;
    struct trap_container_s *t_cont = t_mbuf->active;
 
    // check if container has enough space to insert new message
@@ -1599,16 +3173,19 @@ repeat:
    if (t_cont_has_space(t_cont, size + sizeof(size))) {
       t_cont_insert(t_cont, data, size);
    } else {
-      finish_container(c, t_mbuf);
+      finish_container(c, partition);
       c->max_container_id++;
       t_cont = t_mbuf_get_empty_container(t_mbuf);
       t_cont_set_seq_num(t_cont, t_mbuf->processed_messages);
       t_cont_insert(t_cont, data, size);
    }
+   if (c->latency != 0) {
+      __sync_add_and_fetch(&c->adaptive_bytes, size + sizeof(size));
+   }
 
    /* If bufferswitch is 0, only 1 message is allowed to be stored in buffer */
-   if (c->ctx->out_ifc_list[c->ifc_idx].bufferswitch == 0) {
-      finish_container(c, t_mbuf);
+   if (c->ctx->out_ifc_list[c->ifc_idx].bufferswitch == 0 || t_cont->used_bytes >= __atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED)) {
+      finish_container(c, partition);
       c->max_container_id++;
       t_cont = t_mbuf_get_empty_container(t_mbuf);
       t_cont_set_seq_num(t_cont, t_mbuf->processed_messages);
@@ -1635,8 +3212,15 @@ void tcpip_sender_terminate(void *priv)
    }
    
    do {
-      size_t lowest_container_id = find_lowest_container_id(c);
-      if (lowest_container_id == c->t_mbuf.to_send.head_) {
+      bool pending = false;
+      uint32_t i;
+      for (i = 0; i < c->partition_count; i++) {
+         if (c->partitions[i].clients != 0 &&
+             find_lowest_container_id(c, i) != c->partitions[i].t_mbuf.to_send.head_) {
+            pending = true;
+         }
+      }
+      if (!pending) {
          break;
       }
 
@@ -1678,11 +3262,17 @@ void tcpip_sender_destroy(void *priv)
    if (c->server_port != NULL) {
       X(c->server_port);
    }
+   X(c->spill_dir);
  
    if (c->initialized) {
       pthread_cancel(c->accept_thr);
       pthread_join(c->accept_thr, &res);
 
+      // clients being connected are not in the list of clients yet
+      while (__sync_add_and_fetch(&c->connecting_clients, 0) != 0) {
+         usleep(1000);
+      }
+
       pthread_cancel(c->autoflush_thr);
       pthread_join(c->autoflush_thr, &res);
 
@@ -1694,7 +3284,11 @@ void tcpip_sender_destroy(void *priv)
          cl = next;
       }
 
-      t_mbuf_clear(&c->t_mbuf);
+      for (uint32_t i = 0; i < c->partition_count; i++) {
+         t_mbuf_clear(&c->partitions[i].t_mbuf);
+         pthread_cond_destroy(&c->partitions[i].claim_cond);
+         pthread_mutex_destroy(&c->partitions[i].claim_mtx);
+      }
    }
 
 
@@ -1708,6 +3302,7 @@ void tcpip_sender_destroy(void *priv)
 
    /* disconnect all clients */
    tcpip_server_disconnect_all_clients(priv);
+   X(c->partitions);
    X(c)
 #undef X
 }
@@ -1781,6 +3376,38 @@ int8_t tcpip_sender_get_client_stats_json(void *priv, json_t *client_stats_arr)
          pthread_mutex_unlock(&c->client_list_mtx);
 	      return 0;
 	   }
+      if (c->dispatch == TCPIP_DISPATCH_WORKQUEUE) {
+         char claims_buf[40];
+         char lost_containers_buf[40];
+
+         sprintf(claims_buf, "%" PRIu64, cl->claims);
+         sprintf(lost_containers_buf, "%" PRIu64, cl->lost_containers);
+         json_object_set_new(client_stats, "claims", json_string(claims_buf));
+         json_object_set_new(client_stats, "lost_containers", json_string(lost_containers_buf));
+      }
+      if (cl->spill_fd != -1) {
+         char spilled_containers_buf[40];
+         char spill_overflows_buf[40];
+         char spill_size_buf[40];
+         char lag_buf[40];
+
+         pthread_mutex_lock(&cl->spill_mtx);
+         sprintf(spilled_containers_buf, "%" PRIu64, cl->spilled_containers);
+         sprintf(spill_overflows_buf, "%" PRIu64, cl->spill_overflows);
+         sprintf(spill_size_buf, "%" PRIu64, cl->spill_head - cl->spill_tail);
+         pthread_mutex_unlock(&cl->spill_mtx);
+         sprintf(lag_buf, "%" PRIu64, c->partitions[cl->partition].t_mbuf.to_send.head_ - cl->container_id);
+         json_object_set_new(client_stats, "spilled_containers", json_string(spilled_containers_buf));
+         json_object_set_new(client_stats, "spill_overflows", json_string(spill_overflows_buf));
+         json_object_set_new(client_stats, "spill_size", json_string(spill_size_buf));
+         json_object_set_new(client_stats, "lag", json_string(lag_buf));
+      }
+      if (cl->filter != NULL) {
+         char filtered_messages_buf[40];
+
+         sprintf(filtered_messages_buf, "%" PRIu64, cl->filtered_messages);
+         json_object_set_new(client_stats, "filtered_messages", json_string(filtered_messages_buf));
+      }
 
 	   if (json_array_append_new(client_stats_arr, client_stats) == -1) {
          pthread_mutex_unlock(&c->client_list_mtx);
@@ -1791,6 +3418,19 @@ int8_t tcpip_sender_get_client_stats_json(void *priv, json_t *client_stats_arr)
    return 1;
 }
 
+static void tcpip_sender_get_stats_json(void *priv, json_t *ifc_stats)
+{
+   tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
+   int64_t timeout;
+
+   if (c == NULL) {
+      return;
+   }
+   timeout = c->latency != 0 ? __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED) : c->ctx->out_ifc_list[c->ifc_idx].timeout;
+   json_object_set_new(ifc_stats, "container_size", json_integer(__atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED)));
+   json_object_set_new(ifc_stats, "autoflush_timeout", json_integer(timeout));
+}
+
 static void tcpip_sender_create_dump(void *priv, uint32_t idx, const char *path)
 {
    tcpip_sender_private_t *c = (tcpip_sender_private_t *) priv;
@@ -1814,26 +3454,35 @@ static void tcpip_sender_create_dump(void *priv, uint32_t idx, const char *path)
               "Max clients: %d\n"
               "Buffer count: %u\n"
               "Buffer size: %u\n"
+              "Partitions: %u\n"
+              "Dispatch: %s (claim %u)\n"
               "Terminated: %d\n"
               "Initialized: %d\n"
               "Socket type: %s\n"
-              "Timeout: %u us\n",
+              "Timeout: %u us\n"
+              "Latency: %u us (container size %u, autoflush %" PRId64 " us)\n",
               c->server_port,
               c->server_sd,
               c->connected_clients,
               c->max_clients,
+              c->buffer_count,
               c->buffer_size,
-              c->buffer_size,
+              c->partition_count,
+              c->dispatch == TCPIP_DISPATCH_WORKQUEUE ? "workqueue" : "broadcast",
+              c->claim_count,
               c->is_terminated,
               c->initialized,
               TCPIP_SOCKETTYPE_STR(c->socket_type),
-              c->ctx->out_ifc_list[idx].datatimeout);
+              c->ctx->out_ifc_list[idx].datatimeout,
+              c->latency,
+              __atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED),
+              __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED));
    fprintf(f, "Clients:\n");
-   fprintf(f, "SD, Sent containers, sent messages, skipped messages, current container id:\n");
+   fprintf(f, "SD, Sent containers, sent messages, skipped messages, current container id, partition:\n");
    pthread_mutex_lock(&c->client_list_mtx);
    LIST_FOREACH(cl, &c->clients_list_head, entries) {
-      fprintf(f, "\t{%d, %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %" PRIu64 "}\n", 
-         cl->sd, cl->sent_containers, cl->sent_messages, cl->skipped_messages, cl->container_id);
+      fprintf(f, "\t{%d, %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %" PRIu32 "}\n", 
+         cl->sd, cl->sent_containers, cl->sent_messages, cl->skipped_messages, cl->container_id, cl->partition);
    }
    pthread_mutex_unlock(&c->client_list_mtx);
 
@@ -1878,6 +3527,16 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
    unsigned int max_clients = DEFAULT_MAX_CLIENTS;
    unsigned int buffer_count = DEFAULT_BUFFER_COUNT;
    unsigned int buffer_size = DEFAULT_BUFFER_SIZE;
+   unsigned int partition_count = 1;
+   unsigned int claim_count = 1;
+   enum tcpip_dispatch dispatch = TCPIP_DISPATCH_BROADCAST;
+   unsigned int projection = 0;
+   unsigned int filter = 0;
+   unsigned int hugepages = 0;
+   unsigned int latency = 0;
+   unsigned int spill = 0;
+   char *spill_dir = NULL;
+   unsigned int i;
 
 #define X(pointer) free(pointer); \
    pointer = NULL;
@@ -1924,6 +3583,52 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
             VERBOSE(CL_ERROR, "Optional max clients number given, but it is probably in wrong format.");
             max_clients = DEFAULT_MAX_CLIENTS;
          }
+      } else if (strncmp(param_str, "partitions=x", PARTITIONS_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + PARTITIONS_PARAM_LENGTH, "%u", &partition_count) != 1 || partition_count == 0 || partition_count > 64) {
+            VERBOSE(CL_ERROR, "Optional partitions number given, but it is probably in wrong format.");
+            partition_count = 1;
+         }
+      } else if (strncmp(param_str, "dispatch=x", DISPATCH_PARAM_LENGTH) == 0) {
+         if (strcmp(param_str + DISPATCH_PARAM_LENGTH, "workqueue") == 0) {
+            dispatch = TCPIP_DISPATCH_WORKQUEUE;
+         } else if (strcmp(param_str + DISPATCH_PARAM_LENGTH, "broadcast") == 0) {
+            dispatch = TCPIP_DISPATCH_BROADCAST;
+         } else {
+            VERBOSE(CL_ERROR, "Unknown dispatch mode \"%s\", expected broadcast or workqueue.", param_str + DISPATCH_PARAM_LENGTH);
+         }
+      } else if (strncmp(param_str, "claim=x", CLAIM_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + CLAIM_PARAM_LENGTH, "%u", &claim_count) != 1 || claim_count == 0) {
+            VERBOSE(CL_ERROR, "Optional claim count given, but it is probably in wrong format.");
+            claim_count = 1;
+         }
+      } else if (strncmp(param_str, "projection=x", PROJECTION_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + PROJECTION_PARAM_LENGTH, "%u", &projection) != 1) {
+            VERBOSE(CL_ERROR, "Optional projection given, but it is probably in wrong format.");
+            projection = 0;
+         }
+      } else if (strncmp(param_str, "filter=x", FILTER_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + FILTER_PARAM_LENGTH, "%u", &filter) != 1) {
+            VERBOSE(CL_ERROR, "Optional filter given, but it is probably in wrong format.");
+            filter = 0;
+         }
+      } else if (strncmp(param_str, "hugepages=x", HUGEPAGES_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + HUGEPAGES_PARAM_LENGTH, "%u", &hugepages) != 1) {
+            VERBOSE(CL_ERROR, "Optional hugepages given, but it is probably in wrong format.");
+            hugepages = 0;
+         }
+      } else if (strncmp(param_str, "latency=x", LATENCY_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + LATENCY_PARAM_LENGTH, "%u", &latency) != 1) {
+            VERBOSE(CL_ERROR, "Optional latency given, but it is probably in wrong format.");
+            latency = 0;
+         }
+      } else if (strncmp(param_str, "spill=x", SPILL_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + SPILL_PARAM_LENGTH, "%u", &spill) != 1) {
+            VERBOSE(CL_ERROR, "Optional spill given, but it is probably in wrong format.");
+            spill = 0;
+         }
+      } else if (strncmp(param_str, "spill_dir=x", SPILL_DIR_PARAM_LENGTH) == 0) {
+         X(spill_dir);
+         spill_dir = strdup(param_str + SPILL_DIR_PARAM_LENGTH);
       } else {
          VERBOSE(CL_ERROR, "Unknown parameter \"%s\".", param_str);
       }
@@ -1931,13 +3636,33 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
    }
    /* Parsing params ended */
 
-   if (t_mbuf_init(&priv->t_mbuf, buffer_count, max_clients)) {
-      VERBOSE(CL_ERROR, "Trap mbuf initialization failed");
-      result = TRAP_E_MEMORY;
-      goto failsafe_cleanup;	
+   if (partition_count > max_clients) {
+      VERBOSE(CL_WARNING, "Number of partitions (%u) is higher than max_clients, using %u.", partition_count, max_clients);
+      partition_count = max_clients;
    }
 
-   t_cont_set_len(buffer_size);
+   /* Every partition has its own ring of containers shared by its clients. */
+   priv->partitions = (tcpip_partition_t *) calloc(partition_count, sizeof(tcpip_partition_t));
+   if (priv->partitions == NULL) {
+      result = TRAP_E_MEMORY;
+      goto failsafe_cleanup;
+   }
+   priv->partition_count = partition_count;
+   priv->dispatch = dispatch;
+   priv->claim_count = claim_count;
+   priv->projection = projection ? 1 : 0;
+   priv->filter = filter ? 1 : 0;
+   for (i = 0; i < partition_count; i++) {
+      pthread_mutex_init(&priv->partitions[i].claim_mtx, NULL);
+      pthread_cond_init(&priv->partitions[i].claim_cond, NULL);
+      // spill jobs keep references of overwritten containers
+      if (t_mbuf_init(&priv->partitions[i].t_mbuf, buffer_count, max_clients + (spill != 0 ? TCPIP_SPILL_QUEUE_LENGTH : 0),
+                      buffer_size, hugepages != 0)) {
+         VERBOSE(CL_ERROR, "Trap mbuf initialization failed");
+         result = TRAP_E_MEMORY;
+         goto failsafe_cleanup;	
+      }
+   }
 
    priv->ctx = ctx;
    priv->timeout = ifc->datatimeout;
@@ -1945,12 +3670,29 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
    priv->ifc_idx = idx;
    priv->server_port = server_port;
    priv->max_clients = max_clients;
+   priv->buffer_count = buffer_count;
+   priv->buffer_size = buffer_size;
    priv->connected_clients = 0;
+   priv->connecting_clients = 0;
    priv->is_terminated = 0;
    priv->autoflush_timestamp = get_cur_timestamp();
 
-   VERBOSE(CL_VERBOSE_ADVANCED, "config:\nserver_port:\t%s\nmax_clients:\t%u\nactive_containers:\t%u\nbuffer size:\t%uB\n",
-      priv->server_port, priv->max_clients, buffer_count, buffer_size);
+   /* adaptive mode starts with small containers until the rate is measured */
+   priv->latency = latency;
+   priv->flush_threshold = latency != 0 && buffer_size > ADAPTIVE_MIN_CONTAINER_SIZE ? ADAPTIVE_MIN_CONTAINER_SIZE : buffer_size;
+   priv->autoflush_interval = latency;
+   priv->adaptive_timestamp = priv->autoflush_timestamp;
+
+   priv->spill_limit = (uint64_t) spill * 1024 * 1024;
+   priv->spill_dir = spill_dir != NULL ? spill_dir : strdup(TCPIP_SPILL_DIR);
+   spill_dir = NULL;
+   if (priv->spill_dir == NULL) {
+      result = TRAP_E_MEMORY;
+      goto failsafe_cleanup;
+   }
+
+   VERBOSE(CL_VERBOSE_ADVANCED, "config:\nserver_port:\t%s\nmax_clients:\t%u\nactive_containers:\t%u\nbuffer size:\t%uB\npartitions:\t%u\nlatency:\t%uus\n",
+      priv->server_port, priv->max_clients, buffer_count, buffer_size, priv->partition_count, latency);
 
    result = server_socket_open(priv);
    if (result != TRAP_E_OK) {
@@ -1971,6 +3713,7 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
    ifc->destroy = tcpip_sender_destroy;
    ifc->get_client_count = tcpip_sender_get_client_count;
    ifc->get_client_stats_json = tcpip_sender_get_client_stats_json;
+   ifc->get_stats_json = tcpip_sender_get_stats_json;
    ifc->create_dump = tcpip_sender_create_dump;
    ifc->priv = priv;
    ifc->get_id = tcpip_send_ifc_get_id;
@@ -1979,11 +3722,20 @@ int create_tcpip_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_outpu
 failsafe_cleanup:
    X(server_port);
    X(param_str);
+   X(spill_dir);
    if (priv != NULL) {
       if (priv->clients_pfds != NULL) {
          X(priv->clients_pfds);
       }
-      t_mbuf_clear(&priv->t_mbuf);
+      X(priv->spill_dir);
+      if (priv->partitions != NULL) {
+         for (i = 0; i < priv->partition_count; i++) {
+            t_mbuf_clear(&priv->partitions[i].t_mbuf);
+            pthread_cond_destroy(&priv->partitions[i].claim_cond);
+            pthread_mutex_destroy(&priv->partitions[i].claim_mtx);
+         }
+         X(priv->partitions);
+      }
       X(priv);
    }
 #undef X
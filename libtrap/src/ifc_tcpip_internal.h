@@ -63,6 +63,150 @@
  * @{
  */
 
+/**
+ * \brief Magic number of client request ("TRPJ").
+ */
+#define TCPIP_REQUEST_MAGIC 0x5452504a
+
+/**
+ * \brief Time to wait for request of a new client [ms], it is waited in the sender thread of the client.
+ */
+#define TCPIP_REQUEST_TIMEOUT 100
+
+/**
+ * \brief Maximal size of data format specifier or filter in client request.
+ */
+#define TCPIP_REQUEST_MAX_SIZE 65535
+
+/**
+ * \brief Default directory of spill files of slow clients.
+ */
+#define TCPIP_SPILL_DIR "/tmp"
+
+/**
+ * \brief Maximal number of containers waiting for spill writers of a partition (and of a client).
+ *
+ * Containers that do not fit into the queue are not spilled, the sender
+ * never waits for the disk. The container pool of a partition is enlarged
+ * by this number when spilling is enabled.
+ */
+#define TCPIP_SPILL_QUEUE_LENGTH 16
+
+/**
+ * \brief Header of client request.
+ *
+ * Input IFC with enabled projection or filter sends the request right after
+ * connection, before the negotiation. The header is followed by data format
+ * specifier with the fields required by the input IFC (used for projection)
+ * and by filter expression.
+ */
+typedef struct tcpip_client_request_s {
+    uint32_t magic; /**< TCPIP_REQUEST_MAGIC in network byte order */
+    uint32_t data_fmt_spec_size; /**< Size of following data format specifier in network byte order, 0 without projection */
+    uint32_t filter_size; /**< Size of following filter expression in network byte order, 0 without filter */
+} tcpip_client_request_t;
+
+/**
+ * \brief Field of UniRec record sent to a client with projection.
+ */
+typedef struct tcpip_projection_field_s {
+    uint16_t offset; /**< Offset of the field in the original record */
+    int16_t size; /**< Size of static field, -1 for variable-length field */
+} tcpip_projection_field_t;
+
+/**
+ * \brief Projection of UniRec records to the fields required by a client.
+ */
+typedef struct tcpip_projection_s {
+    char *fmt_spec; /**< Data format specifier of projected records */
+    uint16_t static_size; /**< Size of static part of original records */
+    uint16_t projected_static_size; /**< Size of static part of projected records */
+    uint16_t field_count; /**< Number of projected fields */
+    tcpip_projection_field_t *fields; /**< Projected fields in the order of projected template */
+} tcpip_projection_t;
+
+/**
+ * \brief Comparison operators of filter terms.
+ */
+enum tcpip_filter_op {
+    TCPIP_FILTER_EQ,
+    TCPIP_FILTER_NE,
+    TCPIP_FILTER_LT,
+    TCPIP_FILTER_LE,
+    TCPIP_FILTER_GT,
+    TCPIP_FILTER_GE
+};
+
+/**
+ * \brief Types of values compared by filter terms.
+ */
+enum tcpip_filter_type {
+    TCPIP_FILTER_UINT,
+    TCPIP_FILTER_INT,
+    TCPIP_FILTER_FLOAT
+};
+
+/**
+ * \brief Compiled term of filter - comparison of a static UniRec field with a constant.
+ */
+typedef struct tcpip_filter_term_s {
+    uint16_t offset; /**< Offset of the field in the record */
+    uint8_t size; /**< Size of the field */
+    uint8_t type; /**< Type of compared values (enum tcpip_filter_type) */
+    uint8_t op; /**< Comparison operator (enum tcpip_filter_op) */
+    uint8_t last; /**< Nonzero if the term is the last one of its conjunction */
+    union {
+        uint64_t u;
+        int64_t i;
+        double d;
+    } value; /**< Constant the field is compared with */
+} tcpip_filter_term_t;
+
+/**
+ * \brief Filter of UniRec records requested by a client.
+ *
+ * Filter is a disjunction of conjunctions of terms, terms of one conjunction
+ * are stored consecutively.
+ */
+typedef struct tcpip_filter_s {
+    uint16_t static_size; /**< Size of static part of records */
+    uint16_t term_count; /**< Number of terms */
+    tcpip_filter_term_t *terms; /**< Terms of the filter */
+} tcpip_filter_t;
+
+/**
+ * \brief Header of a container stored in the spill file of a client.
+ *
+ * It is followed by used_bytes bytes of the container (including its header).
+ */
+typedef struct tcpip_spill_record_s {
+    uint64_t idx; /**< ID of the container */
+    uint64_t seq_num; /**< Sequence number of the first message of the container */
+    uint32_t size; /**< Number of messages in the container */
+    uint32_t used_bytes; /**< Size of the container */
+} tcpip_spill_record_t;
+
+/**
+ * \brief Container waiting to be written into spill files.
+ *
+ * The job holds a reference of the container, so the container is not reused
+ * until the last spill writer releases the job.
+ */
+typedef struct tcpip_spill_job_s {
+    char used; /**< Job is taken by the producer, cleared when the container is released */
+    uint32_t refs; /**< Number of clients that did not write the job yet */
+    struct trap_container_s *t_cont; /**< Referenced container */
+    tcpip_spill_record_t rec; /**< Header written into the spill file */
+} tcpip_spill_job_t;
+
+/**
+ * \brief Distribution of containers among clients of output IFC.
+ */
+enum tcpip_dispatch {
+    TCPIP_DISPATCH_BROADCAST = 0, /**< Every client receives every container (default) */
+    TCPIP_DISPATCH_WORKQUEUE = 1 /**< Every container is sent to one idle client */
+};
+
 /**
  * \brief Structure for TCP/IP IFC client information.
  */
@@ -78,6 +222,29 @@ typedef struct client_s {
     uint64_t sent_messages; /**< Sent messages counter */
     uint64_t skipped_messages; /**< Skipped messages counter */
     uint64_t container_id; /**< ID of current container. */
+    uint32_t partition; /**< Index of partition the client receives */
+    uint64_t claims; /**< Number of claims of containers (work-queue dispatch) */
+    uint64_t lost_containers; /**< Containers overwritten before they were sent (work-queue dispatch) */
+    tcpip_projection_t *projection; /**< Projection of records requested by the client, NULL to send whole records */
+    tcpip_filter_t *filter; /**< Filter of records requested by the client, NULL to send all records */
+    uint64_t filtered_messages; /**< Number of messages not sent because of the filter */
+    char *buffer; /**< Container modified by projection or filter */
+    size_t buffer_size; /**< Allocated size of buffer */
+    int spill_fd; /**< Spill file of containers overwritten before they were sent, -1 if spilling is disabled */
+    pthread_mutex_t spill_mtx; /**< Lock of spill file offsets and spill queue */
+    pthread_cond_t spill_cond; /**< Signaled when a job is queued or written */
+    pthread_t spill_thread; /**< Thread writing queued jobs into the spill file */
+    char spill_stop; /**< Spill writer should exit */
+    tcpip_spill_job_t *spill_queue[TCPIP_SPILL_QUEUE_LENGTH]; /**< Jobs waiting for the spill writer */
+    uint32_t spill_queue_head; /**< Number of queued jobs since connection */
+    uint32_t spill_queue_tail; /**< Number of written jobs since connection */
+    uint64_t spill_queued; /**< Size of queued jobs in the spill file */
+    uint64_t spill_head; /**< Offset of the end of the spill file */
+    uint64_t spill_tail; /**< Offset of the first unsent container in the spill file */
+    uint64_t spilled_containers; /**< Number of containers stored into the spill file */
+    uint64_t spill_overflows; /**< Number of containers not stored because the spill file was full */
+    char *spill_buffer; /**< Container read from the spill file */
+    size_t spill_buffer_size; /**< Allocated size of spill_buffer */
     LIST_ENTRY(client_s)
     entries;
 } client_t __attribute__((aligned(64)));
@@ -89,6 +256,24 @@ struct client_container_s {
 
 LIST_HEAD(clients_head_s, client_s);
 
+/**
+ * \brief Partition of TCP/IP output IFC.
+ *
+ * Every message is stored into containers of one partition chosen by
+ * the partition function (#TRAPCTL_PARTITION_FUNC) and it is sent only
+ * to the clients assigned to the partition. Without "partitions" parameter
+ * there is one partition and all clients receive all messages.
+ */
+typedef struct tcpip_partition_s {
+    struct trap_mbuf_s t_mbuf; /**< Containers of the partition */
+    uint64_t lowest_container_id; /**< Lowest container ID of clients of the partition */
+    uint32_t clients; /**< Number of clients assigned to the partition */
+    pthread_mutex_t claim_mtx; /**< Mutex of claim_cond */
+    pthread_cond_t claim_cond; /**< Signaled when a container is finished (work-queue dispatch) */
+    uint32_t claim_waiters; /**< Number of clients waiting on claim_cond */
+    tcpip_spill_job_t spill_jobs[TCPIP_SPILL_QUEUE_LENGTH]; /**< Containers waiting for spill writers */
+} tcpip_partition_t;
+
 /**
  * \brief Structure for TCP/IP IFC private information.
  */
@@ -118,11 +303,27 @@ typedef struct tcpip_sender_private_s {
 
     int timeout;
     uint32_t max_clients;
-    struct trap_mbuf_s t_mbuf;
+    tcpip_partition_t *partitions; /**< Array of partitions */
+    uint32_t partition_count; /**< Number of partitions */
+    enum tcpip_dispatch dispatch; /**< Distribution of containers among clients */
+    uint32_t claim_count; /**< Maximal number of containers claimed by a client at once (work-queue dispatch) */
+    char projection; /**< Accept projection requests of clients */
+    char filter; /**< Accept filter requests of clients */
+    const char *negotiation_fmt_spec; /**< Data format specifier sent to the client being negotiated instead of the IFC one */
     uint64_t max_container_id;
 
+    uint32_t latency; /**< Latency budget of adaptive mode [us], 0 if adaptive mode is disabled */
+    uint32_t flush_threshold; /**< Containers are finished when they contain at least this number of bytes, accessed atomically */
+    int64_t autoflush_interval; /**< Autoflush timeout chosen by adaptive mode [us], accessed atomically */
+    uint64_t adaptive_bytes; /**< Bytes stored since the last adjustment of adaptive mode */
+    uint64_t adaptive_timestamp; /**< Time of the last adjustment of adaptive mode */
+    double adaptive_rate; /**< Smoothed rate of stored bytes [B/us] */
+
+    uint64_t spill_limit; /**< Maximal size of spill file of a client [bytes], 0 if spilling is disabled */
+    char *spill_dir; /**< Directory of spill files */
+
     uint32_t clients_waiting_for_connection;
-    uint64_t lowest_container_id;
+    uint32_t connecting_clients; /**< Number of accepted clients not connected by their sender thread yet */
     struct clients_head_s clients_list_head; /**< clients container list */
     pthread_mutex_t client_list_mtx;
 
@@ -165,6 +366,12 @@ typedef struct tcpip_receiver_private_s {
     uint32_t ext_buffer_size; /**< size of content of the extbuffer */
     trap_buffer_header_t int_mess_header; /**< Internal message header - used for message_buffer payload size \note message_buffer size is sizeof(tcpip_tdu_header_t) + payload size */
     uint32_t ifc_idx;
+    char projection; /**< Request projection of records to the required fields from output IFC */
+    char *filter; /**< Filter expression sent to output IFC, NULL without filter */
+    char *readahead; /**< Read-ahead buffer holding received data of following containers, allocated on first use */
+    uint32_t readahead_size; /**< Size of read-ahead buffer, 0 disables read-ahead */
+    uint32_t readahead_head; /**< Offset of the first unprocessed byte in read-ahead buffer */
+    uint32_t readahead_tail; /**< Offset of the end of received data in read-ahead buffer */
 } tcpip_receiver_private_t;
 
 /**
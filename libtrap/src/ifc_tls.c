@@ -93,6 +93,7 @@
 #define USEC_IN_SEC        1000000
 #define ACK_MESS_SIZE      1
 #define CRIT_1VS2SEND      10000
+#define TLS_SESSION_ID_CONTEXT "libtrap"
 #ifndef MAX
 #define MAX(a,b) ((a)<(b)?(b):(a))
 #endif
@@ -131,6 +132,25 @@ static SSL_CTX *tlsserver_create_context()
    return ctx;
 }
 
+/**
+ * \brief Store new session of input IFC to resume it after reconnection.
+ *
+ * Called by OpenSSL when the server issues a session (ticket).
+ * \param[in] ssl   connection of the input IFC
+ * \param[in] sess  new session
+ * \return 1, the session is owned by the input IFC
+ */
+static int tlsclient_new_session(SSL *ssl, SSL_SESSION *sess)
+{
+   tls_receiver_private_t *c = (tls_receiver_private_t *) SSL_get_app_data(ssl);
+
+   if (c->session != NULL) {
+      SSL_SESSION_free(c->session);
+   }
+   c->session = sess;
+   return 1;
+}
+
 static SSL_CTX *tlsclient_create_context()
 {
    const SSL_METHOD *method;
@@ -142,8 +162,13 @@ static SSL_CTX *tlsclient_create_context()
    if (!ctx) {
       perror("Unable to create SSL context");
       ERR_print_errors_fp(stderr);
+      return NULL;
    }
 
+   /* every input IFC keeps only its last session, see tlsclient_new_session() */
+   SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+   SSL_CTX_sess_set_new_cb(ctx, tlsclient_new_session);
+
    return ctx;
 }
 
@@ -201,6 +226,9 @@ static int tls_server_configure_ctx(const char *cert, SSL_CTX *ctx)
    SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1);
    SSL_CTX_set_options(ctx, SSL_OP_NO_TLSv1_1);
 
+   /* sessions are resumed only with the same context, it is required together with client verification */
+   SSL_CTX_set_session_id_context(ctx, (const unsigned char *) TLS_SESSION_ID_CONTEXT, strlen(TLS_SESSION_ID_CONTEXT));
+
    X509_free(certificate);
    BIO_free_all(bio_cert);
    return EXIT_SUCCESS;
@@ -635,8 +663,9 @@ void tls_receiver_destroy(void *priv)
       if (config->connected == 1) {
          close(config->sd);
       }
-      free(config->ssl);
-      free(config->sslctx);
+      SSL_free(config->ssl);
+      SSL_CTX_free(config->sslctx);
+      SSL_SESSION_free(config->session);
       free(config->dest_addr);
       free(config->dest_port);
       free(config->keyfile);
@@ -673,13 +702,14 @@ static void tls_receiver_create_dump(void *priv, uint32_t idx, const char *path)
            "Terminated: %d\nSocket descriptor: %d\n"
            "Data pointer: %p\nData wait size: %"PRIu32"\nMessage header: %"PRIu32"\n"
            "Extern buffer pointer: %p\nExtern buffer data size: %"PRIu32"\n"
-           "Timeout: %"PRId32"us (%s)\nPrivate key: %s\nCertificate: %s\n",
+           "Timeout: %"PRId32"us (%s)\nPrivate key: %s\nCertificate: %s\n"
+           "Resumed connections: %"PRIu32"\n",
            c->dest_addr, c->dest_port, c->connected, c->is_terminated, c->sd,
            c->data_pointer, c->data_wait_size, c->int_mess_header.data_length,
            c->ext_buffer, c->ext_buffer_size,
            c->ctx->in_ifc_list[idx].datatimeout,
            TRAP_TIMEOUT_STR(c->ctx->in_ifc_list[idx].datatimeout),
-           c->keyfile, c->certfile);
+           c->keyfile, c->certfile, c->resumed_connections);
    fclose(f);
    f = NULL;
 
@@ -1056,6 +1086,10 @@ static int client_socket_connect(tls_receiver_private_t *c, struct timeval *tv)
       return TRAP_E_IO_ERROR;
    }
    SSL_set_connect_state(c->ssl);
+   SSL_set_app_data(c->ssl, c);
+   if (c->session != NULL) {
+      SSL_set_session(c->ssl, c->session);
+   }
 
    do {
       rv = SSL_connect(c->ssl);
@@ -1079,12 +1113,18 @@ static int client_socket_connect(tls_receiver_private_t *c, struct timeval *tv)
       }
    } while (rv < 1);
    VERBOSE(CL_VERBOSE_BASIC, "SSL successfully connected")
+   if (SSL_session_reused(c->ssl)) {
+      c->resumed_connections++;
+      VERBOSE(CL_VERBOSE_LIBRARY, "TLS session resumed.");
+   }
 
    int ret_ver = verify_certificate(c->ssl); /* server certificate verification */
    if (ret_ver != 0){
       VERBOSE(CL_VERBOSE_LIBRARY, "verify_certificate: failed to verify server's certificate");
       SSL_free(c->ssl);
       c->ssl = NULL;
+      SSL_SESSION_free(c->session);
+      c->session = NULL;
       return TRAP_E_BAD_CERT;
    }
 
@@ -1548,6 +1588,19 @@ static void *accept_clients_thread(void *arg)
                   goto refuse_client;
                }
 
+#ifdef SSL_OP_ENABLE_KTLS
+               if (c->ktls) {
+                  if (BIO_get_ktls_send(SSL_get_wbio(cl->ssl))) {
+                     cl->ktls = 1;
+                  } else {
+                     VERBOSE(CL_WARNING, "kTLS could not be enabled for client %u, records are encrypted in user space.", client_id);
+                  }
+               }
+#endif
+               VERBOSE(CL_VERBOSE_LIBRARY, "Client %u connected using %s (%s%s).", client_id, SSL_get_version(cl->ssl),
+                       SSL_session_reused(cl->ssl) ? "resumed session" : "full handshake",
+                       cl->ktls ? ", kTLS" : "");
+
                /** Verifying SSL certificate of client. */
                int ret_ver = verify_certificate(cl->ssl);
                if (ret_ver != 0){
@@ -1634,24 +1687,71 @@ void tls_sender_flush(void *priv)
    pthread_mutex_unlock(&c->ctx->out_ifc_list[c->ifc_idx].ifc_mtx);
 }
 
+/**
+ * \brief Adjust container size and autoflush timeout in adaptive mode.
+ *
+ * Same rule as in the TCP/UNIX output IFC: containers hold data stored within
+ * the latency budget, lagging clients switch back to full containers.
+ *
+ * \param[in] c  pointer to interface private data
+ */
+static void adapt_containers(tls_sender_private_t *c)
+{
+   uint64_t now = get_cur_timestamp();
+   uint64_t elapsed = now - c->adaptive_timestamp;
+   uint64_t bytes, head, lowest;
+   uint32_t min_size = c->buffer_size < ADAPTIVE_MIN_CONTAINER_SIZE ? c->buffer_size : ADAPTIVE_MIN_CONTAINER_SIZE;
+   double threshold;
+
+   if (elapsed < ADAPTIVE_PERIOD) {
+      return;
+   }
+   bytes = __sync_lock_test_and_set(&c->adaptive_bytes, 0);
+   c->adaptive_timestamp = now;
+   c->adaptive_rate = (3 * c->adaptive_rate + (double) bytes / elapsed) / 4;
+
+   head = __sync_add_and_fetch(&c->t_mbuf.to_send.head_, 0);
+   lowest = find_lowest_container_id(c);
+   if (c->connected_clients != 0 && head > lowest && head - lowest > c->buffer_count / 2) {
+      __atomic_store_n(&c->flush_threshold, c->buffer_size, __ATOMIC_RELAXED);
+      __atomic_store_n(&c->autoflush_interval, c->ctx->out_ifc_list[c->ifc_idx].timeout > c->latency ?
+                       c->ctx->out_ifc_list[c->ifc_idx].timeout : c->latency, __ATOMIC_RELAXED);
+   } else {
+      threshold = TRAP_HEADER_SIZE + c->adaptive_rate * c->latency;
+      if (threshold < min_size) {
+         threshold = min_size;
+      } else if (threshold > c->buffer_size) {
+         threshold = c->buffer_size;
+      }
+      __atomic_store_n(&c->flush_threshold, (uint32_t) threshold, __ATOMIC_RELAXED);
+      __atomic_store_n(&c->autoflush_interval, c->latency, __ATOMIC_RELAXED);
+   }
+}
+
 static void *autoflush_thread(void *priv)
 {
    tls_sender_private_t *c = (tls_sender_private_t *) priv;
-   int64_t time_since_flush;
+   int64_t time_since_flush, timeout;
 
    pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
 
    while (!c->is_terminated) {
+      if (c->latency != 0) {
+         adapt_containers(c);
+         timeout = __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED);
+      } else {
+         timeout = c->ctx->out_ifc_list[c->ifc_idx].timeout;
+      }
 	  if (c->connected_clients == 0) {
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout);
+         usleep(timeout);
          continue;
       }
       time_since_flush = get_cur_timestamp() - c->autoflush_timestamp;
-      if (time_since_flush >= c->ctx->out_ifc_list[c->ifc_idx].timeout) {
+      if (time_since_flush >= timeout) {
          tls_sender_flush(c);
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout);
+         usleep(timeout);
       } else {
-         usleep(c->ctx->out_ifc_list[c->ifc_idx].timeout - time_since_flush);    
+         usleep(timeout - time_since_flush);    
       }
    }
    pthread_exit(NULL);
@@ -1674,7 +1774,7 @@ int tls_sender_send(void *priv, const void *data, uint16_t size, int timeout)
    tls_sender_private_t *c = (tls_sender_private_t *) priv;
 
    // Can we put message at least into empty buffer? 
-   if (t_cont_has_capacity(size + sizeof(size)) == false) {
+   if (t_cont_has_capacity(c->t_mbuf.containers, size + sizeof(size)) == false) {
       VERBOSE(CL_ERROR, "Container is too small for message of size [%u B]. Skipping...", size);
       return TRAP_E_OK;
    }
@@ -1706,9 +1806,12 @@ repeat:
       t_cont_set_seq_num(t_cont, t_mbuf->processed_messages);
       t_cont_insert(t_cont, data, size);
    }
+   if (c->latency != 0) {
+      __sync_add_and_fetch(&c->adaptive_bytes, size + sizeof(size));
+   }
 
    /* If bufferswitch is 0, only 1 message is allowed to be stored in buffer */
-   if (c->ctx->out_ifc_list[c->ifc_idx].bufferswitch == 0) {
+   if (c->ctx->out_ifc_list[c->ifc_idx].bufferswitch == 0 || t_cont->used_bytes >= __atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED)) {
       finish_container(c, t_mbuf);
       c->max_container_id++;
       t_cont = t_mbuf_get_empty_container(t_mbuf);
@@ -1833,6 +1936,7 @@ int8_t tls_sender_get_client_stats_json(void* priv, json_t *client_stats_arr)
          pthread_mutex_unlock(&c->client_list_mtx);
 	      return 0;
 	   }
+      json_object_set_new(client_stats, "ktls", json_boolean(cl->ktls));
 
 	   if (json_array_append_new(client_stats_arr, client_stats) == -1) {
          pthread_mutex_unlock(&c->client_list_mtx);
@@ -1843,6 +1947,19 @@ int8_t tls_sender_get_client_stats_json(void* priv, json_t *client_stats_arr)
    return 1;
 }
 
+static void tls_sender_get_stats_json(void *priv, json_t *ifc_stats)
+{
+   tls_sender_private_t *c = (tls_sender_private_t *) priv;
+   int64_t timeout;
+
+   if (c == NULL) {
+      return;
+   }
+   timeout = c->latency != 0 ? __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED) : c->ctx->out_ifc_list[c->ifc_idx].timeout;
+   json_object_set_new(ifc_stats, "container_size", json_integer(__atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED)));
+   json_object_set_new(ifc_stats, "autoflush_timeout", json_integer(timeout));
+}
+
 static void tls_sender_create_dump(void *priv, uint32_t idx, const char *path)
 {
    tls_sender_private_t *c = (tls_sender_private_t *) priv;
@@ -1868,22 +1985,28 @@ static void tls_sender_create_dump(void *priv, uint32_t idx, const char *path)
               "Buffer size: %u\n"
               "Terminated: %d\n"
               "Initialized: %d\n"
-              "Timeout: %u us\n",
+              "Timeout: %u us\n"
+              "Latency: %u us (container size %u, autoflush %" PRId64 " us)\n"
+              "kTLS: %d\n",
            c->server_port,
            c->server_sd,
            c->connected_clients,
            c->max_clients,
-           c->buffer_size,
+           c->buffer_count,
            c->buffer_size,
            c->is_terminated,
            c->initialized,
-           c->ctx->out_ifc_list[idx].datatimeout);
+           c->ctx->out_ifc_list[idx].datatimeout,
+           c->latency,
+           __atomic_load_n(&c->flush_threshold, __ATOMIC_RELAXED),
+           __atomic_load_n(&c->autoflush_interval, __ATOMIC_RELAXED),
+           c->ktls);
    fprintf(f, "Clients:\n");
-   fprintf(f, "SD, Sent containers, sent messages, skipped messages, current container id:\n");
+   fprintf(f, "SD, Sent containers, sent messages, skipped messages, current container id, kTLS:\n");
    pthread_mutex_lock(&c->client_list_mtx);
    LIST_FOREACH(cl, &c->tlsclients_list_head, entries) {
-      fprintf(f, "\t{%d, %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %" PRIu64 "}\n", 
-         cl->sd, cl->sent_containers, cl->sent_messages, cl->skipped_messages, cl->container_id);
+      fprintf(f, "\t{%d, %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %" PRIu64 ", %d}\n", 
+         cl->sd, cl->sent_containers, cl->sent_messages, cl->skipped_messages, cl->container_id, cl->ktls);
    }
    pthread_mutex_unlock(&c->client_list_mtx);
    fclose(f);
@@ -1930,6 +2053,9 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
    unsigned int max_clients = DEFAULT_MAX_CLIENTS;
    unsigned int buffer_count = DEFAULT_BUFFER_COUNT;
    unsigned int buffer_size = DEFAULT_BUFFER_SIZE;
+   unsigned int hugepages = 0;
+   unsigned int latency = 0;
+   unsigned int ktls = 0;
 
 #define X(pointer) free(pointer); \
    pointer = NULL;
@@ -1996,6 +2122,21 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
             VERBOSE(CL_ERROR, "Optional max clients number given, but it is probably in wrong format.");
             max_clients = DEFAULT_MAX_CLIENTS;
          }
+      } else if (strncmp(param_str, "hugepages=x", HUGEPAGES_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + HUGEPAGES_PARAM_LENGTH, "%u", &hugepages) != 1) {
+            VERBOSE(CL_ERROR, "Optional hugepages given, but it is probably in wrong format.");
+            hugepages = 0;
+         }
+      } else if (strncmp(param_str, "latency=x", LATENCY_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + LATENCY_PARAM_LENGTH, "%u", &latency) != 1) {
+            VERBOSE(CL_ERROR, "Optional latency given, but it is probably in wrong format.");
+            latency = 0;
+         }
+      } else if (strncmp(param_str, "ktls=x", KTLS_PARAM_LENGTH) == 0) {
+         if (sscanf(param_str + KTLS_PARAM_LENGTH, "%u", &ktls) != 1) {
+            VERBOSE(CL_ERROR, "Optional ktls given, but it is probably in wrong format.");
+            ktls = 0;
+         }
       } else {
          VERBOSE(CL_ERROR, "Unknown parameter \"%s\".", param_str);
       }
@@ -2003,14 +2144,12 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
    }
    /* Parsing params ended */
 
-   if (t_mbuf_init(&priv->t_mbuf, buffer_count, max_clients)) {
+   if (t_mbuf_init(&priv->t_mbuf, buffer_count, max_clients, buffer_size, hugepages != 0)) {
       VERBOSE(CL_ERROR, "Trap mbuf initialization failed");
       result = TRAP_E_MEMORY;
       goto failsafe_cleanup;	
    }
 
-   t_cont_set_len(buffer_size);
-
    priv->ctx = ctx;
    priv->timeout = ifc->datatimeout;
    priv->ifc_idx = idx;
@@ -2026,8 +2165,14 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
    priv->buffer_size = buffer_size;
    priv->buffer_count = buffer_count;
 
-   VERBOSE(CL_VERBOSE_ADVANCED, "config:\nserver_port:\t%s\nmax_clients:\t%u\nbuffer count:\t%u\nbuffer size:\t%uB\n",
-                                priv->server_port, priv->max_clients,priv->buffer_count, priv->buffer_size);
+   /* adaptive mode starts with small containers until the rate is measured */
+   priv->latency = latency;
+   priv->flush_threshold = latency != 0 && buffer_size > ADAPTIVE_MIN_CONTAINER_SIZE ? ADAPTIVE_MIN_CONTAINER_SIZE : buffer_size;
+   priv->autoflush_interval = latency;
+   priv->adaptive_timestamp = priv->autoflush_timestamp;
+
+   VERBOSE(CL_VERBOSE_ADVANCED, "config:\nserver_port:\t%s\nmax_clients:\t%u\nbuffer count:\t%u\nbuffer size:\t%uB\nlatency:\t%uus\n",
+                                priv->server_port, priv->max_clients,priv->buffer_count, priv->buffer_size, priv->latency);
 
    result = server_socket_open(priv);
    if (result != TRAP_E_OK) {
@@ -2056,6 +2201,16 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
       goto failsafe_cleanup;
    }
 
+   if (ktls) {
+#ifdef SSL_OP_ENABLE_KTLS
+      /* SSL_write() sends records encrypted by kernel if it supports negotiated cipher */
+      SSL_CTX_set_options(priv->sslctx, SSL_OP_ENABLE_KTLS);
+      priv->ktls = 1;
+#else
+      VERBOSE(CL_WARNING, "kTLS is not supported by the OpenSSL library, records are encrypted in user space.");
+#endif
+   }
+
    /* Fill struct defining the interface */
    ifc->disconn_clients = tls_server_disconnect_all_clients;
    ifc->send = tls_sender_send;
@@ -2064,6 +2219,7 @@ int create_tls_sender_ifc(trap_ctx_priv_t *ctx, const char *params, trap_output_
    ifc->destroy = tls_sender_destroy;
    ifc->get_client_count = tls_sender_get_client_count;
    ifc->get_client_stats_json = tls_sender_get_client_stats_json;
+   ifc->get_stats_json = tls_sender_get_stats_json;
    ifc->create_dump = tls_sender_create_dump;
    ifc->priv = priv;
    ifc->get_id = tls_send_ifc_get_id;
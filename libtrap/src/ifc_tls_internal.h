@@ -80,6 +80,7 @@ typedef struct tlsclient_s {
    uint64_t sent_messages; /**< Sent messages counter */
    uint64_t skipped_messages; /**< Skipped messages counter */
    uint64_t container_id; /**< ID of current container. */
+   char ktls;                               /**< Records are encrypted by kernel (kTLS) */
    LIST_ENTRY(tlsclient_s) entries;
 } tlsclient_t __attribute__((aligned(64)));
 
@@ -125,6 +126,15 @@ typedef struct tls_sender_private_s {
     struct trap_mbuf_s t_mbuf;
     uint64_t max_container_id;
 
+    uint32_t latency;                       /**< Latency budget of adaptive mode [us], 0 if adaptive mode is disabled */
+    uint32_t flush_threshold;               /**< Containers are finished when they contain at least this number of bytes, accessed atomically */
+    int64_t autoflush_interval;             /**< Autoflush timeout chosen by adaptive mode [us], accessed atomically */
+    uint64_t adaptive_bytes;                /**< Bytes stored since the last adjustment of adaptive mode */
+    uint64_t adaptive_timestamp;            /**< Time of the last adjustment of adaptive mode */
+    double adaptive_rate;                   /**< Smoothed rate of stored bytes [B/us] */
+
+    char ktls;                              /**< Offload encryption of sent records to kernel (kTLS) if possible */
+
     uint32_t clients_waiting_for_connection;
     uint64_t lowest_container_id;
     struct tlsclients_head_s tlsclients_list_head; /**< clients container list */
@@ -150,6 +160,8 @@ typedef struct tls_receiver_private_s {
 
    SSL_CTX *sslctx;                         /**< Whole client SSL context. */
    SSL *ssl;                                /**< SSL conection info of client */
+   SSL_SESSION *session;                    /**< Session of the last connection used to resume the next one, NULL if not known */
+   uint32_t resumed_connections;            /**< Number of connections that resumed the previous session */
 
    uint64_t total_msg;                      /**< Total messages seen on interface. */
    uint64_t total_missed;                   /**< Total messages missed on interface. */
@@ -76,6 +76,7 @@
 #include "ifc_service.h"
 #include "ifc_service_internal.h"
 #include "ifc_file.h"
+#include "ifc_inproc.h"
 
 #if HAVE_OPENSSL
 #  include "ifc_tls.h"
@@ -120,6 +121,7 @@ char trap_ifc_type_supported[] = {
    TRAP_IFC_TYPE_UNIX,
    TRAP_IFC_TYPE_SERVICE,
    TRAP_IFC_TYPE_FILE,
+   TRAP_IFC_TYPE_INPROC,
    0
 };
 
@@ -268,7 +270,12 @@ static inline int trap_read_from_buffer(trap_ctx_priv_t *ctx, uint32_t ifc_idx,
       uint32_t buffer_size_tmp = 0;
 
       ifc->buffer_pointer = ifc->buffer;
-      if (!ifc->recv_with_seq_number || !seq_number) {
+      if (ifc->recv_buffer != NULL) {
+         result = ifc->recv_buffer(ifc->priv, &ifc->buffer_pointer, &buffer_size_tmp, timeout, seq_number);
+         if (result == TRAP_E_OK && seq_number != NULL) {
+            ifc->sequence_number = *seq_number;
+         }
+      } else if (!ifc->recv_with_seq_number || !seq_number) {
          if (seq_number != NULL) {
             *seq_number = 0;
          }
@@ -283,7 +290,7 @@ static inline int trap_read_from_buffer(trap_ctx_priv_t *ctx, uint32_t ifc_idx,
          __sync_fetch_and_add(&ctx->counter_recv_buffer[ifc_idx], 1);
 
 #ifdef BUFFERING_CHECK_HEADERS
-         if (trap_check_buffer_content(ifc->buffer, buffer_size_tmp) != 0) {
+         if (trap_check_buffer_content(ifc->buffer_pointer, buffer_size_tmp) != 0) {
             VERBOSE(CL_ERROR, "Buffer is not valid.");
          }
 #endif
@@ -634,7 +641,7 @@ void trap_get_input_ifc_stats(uint32_t ifcidx,  struct input_ifc_stats* stats)
  */
 void trap_get_internal_buffer(trap_ctx_priv_t *ctx, uint16_t ifc_idx, const void **data, uint32_t *size)
 {
-   (*data) = ctx->in_ifc_list[ifc_idx].buffer;
+   (*data) = ctx->in_ifc_list[ifc_idx].buffer_pointer;
    (*size) = ctx->in_ifc_list[ifc_idx].buffer_unread_bytes;
 
    /* mark internal buffer as free for next reading */
@@ -1626,6 +1633,12 @@ static inline int trapifc_in_construct(trap_ctx_priv_t *ctx, trap_ifc_spec_t *if
          goto error;
       }
       break;
+   case TRAP_IFC_TYPE_INPROC:
+      if ((ret = create_inproc_receiver_ifc(ctx, ifc_spec->params[idx], &ctx->in_ifc_list[idx], idx)) != TRAP_E_OK) {
+         VERBOSE(CL_ERROR, "Initialization of INPROC input interface no. %i failed.", idx);
+         goto error;
+      }
+      break;
    default:
       VERBOSE(CL_ERROR, "Unknown input interface type '%c'.", ifc_spec->types[idx]);
       ret = TRAP_E_BADPARAMS;
@@ -1763,6 +1776,12 @@ static inline int trapifc_out_construct(trap_ctx_priv_t *ctx, trap_ifc_spec_t *i
          goto error;
       }
       break;
+   case TRAP_IFC_TYPE_INPROC:
+      if ((ret = create_inproc_sender_ifc(ctx, ifc_spec->params[ctx->num_ifc_in + idx], &ctx->out_ifc_list[idx], idx)) != TRAP_E_OK) {
+         VERBOSE(CL_ERROR, "Initialization of INPROC output interface no. %i failed.", idx);
+         goto error;
+      }
+      break;
    default:
       VERBOSE(CL_ERROR, "Unknown output interface type '%c'.", ifc_spec->types[ctx->num_ifc_in + idx]);
       ret = TRAP_E_BADPARAMS;
@@ -2081,6 +2100,7 @@ int trap_ctx_vifcctl(trap_ctx_t *ctx, int8_t type, uint32_t ifcidx, int32_t requ
    char en_dis_switch = 0;
    uint64_t timeout = 0;
    int32_t datatimeout;
+   trap_partition_func_t partition_func;
    trap_ctx_priv_t *c = ctx;
 
    if ((ifcidx >= c->num_ifc_out) && (ifcidx >= c->num_ifc_in)) {
@@ -2138,6 +2158,17 @@ int trap_ctx_vifcctl(trap_ctx_t *ctx, int8_t type, uint32_t ifcidx, int32_t requ
          }
       }
       break;
+   case TRAPCTL_PARTITION_FUNC:
+      if (type == TRAPIFC_OUTPUT && ifcidx < c->num_ifc_out) {
+         VERBOSE(CL_VERBOSE_BASIC, "%s ifc %d: Setting partition function.",
+                 ifcdir2str(type), (int)ifcidx);
+         partition_func = va_arg(ap, trap_partition_func_t);
+         c->out_ifc_list[ifcidx].partition_arg = va_arg(ap, void *);
+         c->out_ifc_list[ifcidx].partition_func = partition_func;
+      } else {
+         VERBOSE(CL_ERROR, "There is no output IFC with this index. Bad index passed.");
+      }
+      break;
 
    default:
       VERBOSE(CL_ERROR, "Unknown type of request.");
@@ -2305,6 +2336,9 @@ int encode_cnts_to_json(char **data, trap_ctx_priv_t *ctx)
               "dropped-messages", __sync_fetch_and_add(&ctx->counter_dropped_message[x], 0),
               "buffers", __sync_fetch_and_add(&ctx->counter_send_buffer[x], 0),
               "autoflushes", __sync_fetch_and_add(&ctx->counter_autoflush[x],0));
+      if (out_ifc_cnts != NULL && ctx->out_ifc_list[x].get_stats_json != NULL) {
+         ctx->out_ifc_list[x].get_stats_json(ctx->out_ifc_list[x].priv, out_ifc_cnts);
+      }
       if (json_array_append_new(out_ifces_arr, out_ifc_cnts) == -1) {
          VERBOSE(CL_ERROR, "Service thread - could not append new item to out_ifces_arr while creating json string with counters..\n");
          goto clean_up;
@@ -2921,6 +2955,10 @@ int output_ifc_negotiation(void *ifc_priv_data, char ifc_type, int client_sd, vo
       tcp_ifc_priv = (tcpip_sender_private_t *) ifc_priv_data;
       data_type = tcp_ifc_priv->ctx->out_ifc_list[tcp_ifc_priv->ifc_idx].data_type;
       data_fmt_spec = tcp_ifc_priv->ctx->out_ifc_list[tcp_ifc_priv->ifc_idx].data_fmt_spec;
+      if (tcp_ifc_priv->negotiation_fmt_spec != NULL) {
+         // client requested projection of records
+         data_fmt_spec = (char *) tcp_ifc_priv->negotiation_fmt_spec;
+      }
       ifc_idx = tcp_ifc_priv->ifc_idx;
       sock_d = client_sd;
    } else {
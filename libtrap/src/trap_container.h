@@ -51,39 +51,28 @@
 
 #include "trap_error.h"
 
-// default container buffer length
-#define CONTAINER_DEFAULT_LEN 100000
-
 #define TRAP_HEADER_SIZE 14
 
-static size_t container_buff_len = CONTAINER_DEFAULT_LEN;
-
 struct trap_container_s {
     uint8_t ref_counter __attribute__((aligned(64))); // number of clients referencing this container
     uint64_t seq_num; // initial sequence number
     uint64_t idx; // TODO comment
     size_t size; // number of inserted elements
     size_t used_bytes; // number of used bytes in buffer
+    size_t capacity; // length of buffer
     char* buffer;
 };
 
-static inline void
-t_cont_set_len(size_t len)
-{
-    container_buff_len = len;
-}
-
 /**
  * @brief Check if buffer in container has a sufficient capacity.
  *
- * If container length is not initialized return false.
- *
+ * @param t_cont   Container
  * @param capacity Required capacity.
  */
 static inline bool
-t_cont_has_capacity(size_t capacity)
+t_cont_has_capacity(const struct trap_container_s* t_cont, size_t capacity)
 {
-    return capacity <= (container_buff_len - TRAP_HEADER_SIZE);
+    return capacity <= (t_cont->capacity - TRAP_HEADER_SIZE);
 }
 
 /**
@@ -104,28 +93,28 @@ t_cont_clear(struct trap_container_s* t_cont)
 /**
  * @brief Initialize and set container to the default state container .
  *
- * @param t_cont Container
- *
- * @return 0 success
- * @return 1 error
+ * @param t_cont   Container
+ * @param buffer   Buffer of the container, it is owned by the container pool of mbuf
+ * @param capacity Length of buffer
  */
-static inline int
-t_cont_init(struct trap_container_s* t_cont)
+static inline void
+t_cont_init(struct trap_container_s* t_cont, char* buffer, size_t capacity)
 {
     t_cont_clear(t_cont);
-    t_cont->buffer = malloc(container_buff_len * sizeof t_cont->buffer);
-    return t_cont->buffer ? 0 : 1;
+    t_cont->buffer = buffer;
+    t_cont->capacity = capacity;
 }
 
 /**
- * @brief Destriy container.
+ * @brief Destroy container.
  *
  * @param t_cont Container
  */
 static inline void
 t_cont_destroy(struct trap_container_s* t_cont)
 {
-    free(t_cont->buffer);
+    t_cont->buffer = NULL;
+    t_cont->capacity = 0;
 }
 
 /**
@@ -185,7 +174,7 @@ t_cont_insert(struct trap_container_s* t_cont, const char* data, size_t size)
 static inline bool
 t_cont_has_space(struct trap_container_s* t_cont, size_t size)
 {
-    return container_buff_len - t_cont->used_bytes >= size;
+    return t_cont->capacity - t_cont->used_bytes >= size;
 }
 
 /**
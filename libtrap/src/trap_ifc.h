@@ -102,6 +102,25 @@ typedef int (*ifc_recv_func_t)(void *p, void *d, uint32_t *s, int t);
  */
 typedef int (*ifc_recv_with_seq_number_func_t)(void* p, void* d, uint32_t* s, int t, uint64_t *seq_number);
 
+/**
+ * Receive buffer of messages owned by this IFC.
+ *
+ * This function is called from trap_read_from_buffer() instead of
+ * ifc_recv_func_t when there is a need to get new data. The messages are
+ * read directly from the buffer of the IFC (without copying), the buffer
+ * must stay valid until the next call of this function.
+ *
+ * \param[in] p   pointer to IFC's private memory allocated by constructor
+ * \param[out] d  pointer to buffer with received messages
+ * \param[out] s  size (in bytes) of received messages (must be set by this IFC)
+ * \param[in] t   timeout, see \ref trap_timeout
+ * \param[out] seq_number   sequence number of the first received message, may be NULL
+ * \returns TRAP_E_OK on success
+ *
+ * \note This function is optional.
+ */
+typedef int (*ifc_recv_buffer_func_t)(void *p, char **d, uint32_t *s, int t, uint64_t *seq_number);
+
 
 struct input_ifc_stats; // forward declaration
 
@@ -187,6 +206,14 @@ typedef int32_t (*ifc_get_client_count_func_t)(void *p);
  */
 typedef int8_t (*ifc_get_client_stats_json_func_t)(void *p, json_t *client_stats_arr);
 
+/**
+ * Add interface specific values to JSON object with counters of output interface
+ *
+ * \param[in] p   pointer to IFC's private memory allocated by constructor
+ * \param[out] ifc_stats   pointer to JSON object with counters of the interface
+ */
+typedef void (*ifc_get_stats_json_func_t)(void *p, json_t *ifc_stats);
+
 /**
  * Get identifier of the interface
  *
@@ -216,6 +243,7 @@ typedef struct trap_input_ifc_s {
    ifc_get_id_func_t get_id;               ///< Pointer to get_id function
    ifc_recv_func_t recv;                   ///< Pointer to receive function
    ifc_recv_with_seq_number_func_t recv_with_seq_number; ///< Pointer to receive function
+   ifc_recv_buffer_func_t recv_buffer;     ///< Pointer to receive function without copying (optional)
    ifc_get_input_stats_func_t get_input_stats; ///< Pointer to stats function
    ifc_terminate_func_t terminate;         ///< Pointer to terminate function
    ifc_destroy_func_t destroy;             ///< Pointer to destructor function
@@ -279,12 +307,15 @@ typedef struct trap_output_ifc_s {
    ifc_create_dump_func_t create_dump;                     ///< Pointer to function for generating of dump
    ifc_get_client_count_func_t get_client_count;           ///< Pointer to get_client_count function
    ifc_get_client_stats_json_func_t get_client_stats_json; ///< Pointer to get_client_stats_json function
+   ifc_get_stats_json_func_t get_stats_json;               ///< Pointer to get_stats_json function (optional)
    void *priv;                                             ///< Pointer to instance's private data
    pthread_mutex_t ifc_mtx;                                ///< Locking mutex for interface.
    int64_t timeout;                                        ///< Internal structure to send partial data after timeout (autoflush).
    int32_t datatimeout;                                    ///< Timeout for *_send() calls
    char ifc_type;                                          ///< Type of interface
    char bufferswitch;                                      ///< Enable (1) or Disable (0) buffering, default is Enabled (1).
+   trap_partition_func_t partition_func;                   ///< Function selecting partition of message (#TRAPCTL_PARTITION_FUNC)
+   void *partition_arg;                                    ///< Argument of partition_func
 
    /**
     * If 1 do not allow to change autoflush timeout by module.  If 0 - autoflush can
@@ -42,15 +42,57 @@
  */
 
 #include <string.h>
+#include <sys/mman.h>
 
 #include "trap_mbuf.h"
 #include "ifc_tcpip.h"
 
+// size of huge page backing the container pool
+#define T_MBUF_HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+// alignment of container buffers, neighbouring containers do not share cache lines
+#define T_MBUF_CONT_ALIGN 64
+
+static int
+t_mbuf_pool_alloc(struct trap_mbuf_s *t_mbuf, size_t container_len, bool hugepages)
+{
+    size_t stride = (container_len + T_MBUF_CONT_ALIGN - 1) & ~((size_t) T_MBUF_CONT_ALIGN - 1);
+    size_t size = stride * t_mbuf->total_size;
+    void *pool = MAP_FAILED;
+
+    if (hugepages) {
+        size = (size + T_MBUF_HUGEPAGE_SIZE - 1) & ~((size_t) T_MBUF_HUGEPAGE_SIZE - 1);
+        pool = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (pool == MAP_FAILED) {
+        pool = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pool == MAP_FAILED) {
+            return 1;
+        }
+        if (hugepages) {
+            // no reserved huge pages, ask for transparent ones
+            madvise(pool, size, MADV_HUGEPAGE);
+        }
+    }
+    t_mbuf->pool = pool;
+    t_mbuf->pool_size = size;
+
+    for (size_t i = 0; i < t_mbuf->total_size; i++) {
+        t_cont_init(&t_mbuf->containers[i], t_mbuf->pool + i * stride, container_len);
+    }
+    return 0;
+}
+
 int
-t_mbuf_init(struct trap_mbuf_s *t_mbuf, size_t active_containers, size_t max_clients)
+t_mbuf_init(struct trap_mbuf_s *t_mbuf, size_t active_containers, size_t max_clients,
+            size_t container_len, bool hugepages)
 {
     memset(t_mbuf, 0, sizeof *t_mbuf);
 
+    if (container_len <= TRAP_HEADER_SIZE) {
+        return 1;
+    }
+
     t_mbuf->total_size = active_containers + max_clients + 1;
 
     // allocate array of containers
@@ -60,10 +102,8 @@ t_mbuf_init(struct trap_mbuf_s *t_mbuf, size_t active_containers, size_t max_cli
     }
 
     // initialize containers
-    for (size_t i = 0; i < t_mbuf->total_size; i++) {
-        if (t_cont_init(&t_mbuf->containers[i]) != 0) {
-            goto failure;
-        }
+    if (t_mbuf_pool_alloc(t_mbuf, container_len, hugepages) != 0) {
+        goto failure;
     }
 
     // initialize ring buffer
@@ -91,6 +131,8 @@ t_mbuf_init(struct trap_mbuf_s *t_mbuf, size_t active_containers, size_t max_cli
 
 failure:
     t_mbuf_clear(t_mbuf);
+    // callers clear mbufs of failed IFCs again
+    memset(t_mbuf, 0, sizeof *t_mbuf);
     return 1;
 }
 
@@ -104,12 +146,41 @@ t_mbuf_clear(struct trap_mbuf_s *t_mbuf)
         }
     }
     free(t_mbuf->containers);
+    if (t_mbuf->pool) {
+        munmap(t_mbuf->pool, t_mbuf->pool_size);
+        t_mbuf->pool = NULL;
+    }
     t_rb_destroy(&t_mbuf->to_send);
     t_stack_destroy(&t_mbuf->empty);
     t_stack_destroy(&t_mbuf->deferred);
 }
 
 
+size_t
+t_mbuf_claim(struct trap_mbuf_s *t_mbuf, size_t count, uint64_t *first, uint64_t *lost)
+{
+    uint64_t id, from, head, tail;
+    size_t n;
+
+    do {
+        id = __sync_fetch_and_add(&t_mbuf->dispatched, 0);
+        head = __sync_fetch_and_add(&t_mbuf->to_send.head_, 0);
+        tail = __sync_fetch_and_add(&t_mbuf->to_send.tail_, 0);
+
+        // containers older than tail were overwritten
+        from = id < tail ? tail : id;
+        if (from >= head) {
+            return 0;
+        }
+        n = head - from < count ? head - from : count;
+    } while (!__sync_bool_compare_and_swap(&t_mbuf->dispatched, id, from + n));
+
+    *first = from;
+    *lost = from - id;
+    return n;
+}
+
+
 struct trap_container_s *
 t_mbuf_get_empty_container(struct trap_mbuf_s *t_mbuf)
 {
@@ -70,23 +70,51 @@ struct trap_mbuf_s {
     // deffered containers
     struct trap_stack_s deferred;
 
+    // id of the next container to be claimed (work-queue dispatch)
+    uint64_t dispatched;
+
     // private
     size_t total_size;
+
+    // memory of container buffers
+    char* pool;
+    size_t pool_size;
 };
 
 /**
  * @brief Initialize mbuf structure.
  *
+ * Buffers of all containers are allocated as one pool mapped by mmap(). The
+ * pool is not touched here, its pages are allocated on the NUMA node of the
+ * thread filling the containers (first-touch policy).
+ *
  * @param active_containers Maximal number of active containers at one time.
  * @param max_clients Maximal number of connected clients at one time.
+ * @param container_len Length of container buffer including header.
+ * @param hugepages Back the pool with 2 MiB huge pages, transparent huge pages are used if none are reserved.
  */
-int t_mbuf_init(struct trap_mbuf_s* t_mbuf, size_t active_containers, size_t max_clients);
+int t_mbuf_init(struct trap_mbuf_s* t_mbuf, size_t active_containers, size_t max_clients,
+                size_t container_len, bool hugepages);
 
 /**
  * @brief Deallocates memory needed by mbuf structure.
  */
 void t_mbuf_clear(struct trap_mbuf_s* t_mbuf);
 
+/**
+ * @brief Claim finished containers for one consumer (work-queue dispatch).
+ *
+ * Every finished container is claimed exactly once. Containers that were
+ * overwritten before anybody claimed them are skipped.
+ *
+ * @param count Maximal number of claimed containers.
+ * @param first Id of the first claimed container.
+ * @param lost  Number of skipped (overwritten) containers.
+ *
+ * @return Number of claimed containers, 0 if there is no finished container.
+ */
+size_t t_mbuf_claim(struct trap_mbuf_s* t_mbuf, size_t count, uint64_t* first, uint64_t* lost);
+
 /**
  * @brief Get empty container.
  */
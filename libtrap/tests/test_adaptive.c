@@ -0,0 +1,156 @@
+/**
+ * \file test_adaptive.c
+ * \brief Send single messages and a burst of messages through output IFC in adaptive mode and check latency and content of received messages.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_SINGLE_MESSAGES 10
+#define NO_MESSAGES 100000
+#define SOCKET_NAME "test_adaptive"
+
+/* maximal delay of a single message, much shorter than the autoflush timeout of the module */
+#define MAX_DELAY 100000
+
+static volatile uint32_t received = 0;
+static volatile int sent_all = 0;
+static int recv_ret = 0;
+
+static void *receiver_thread(void *arg)
+{
+   trap_ctx_t *ctx = (trap_ctx_t *) arg;
+   const void *data;
+   uint16_t size;
+   uint32_t key;
+   int ret;
+
+   while (received < NO_SINGLE_MESSAGES + NO_MESSAGES) {
+      ret = trap_ctx_recv(ctx, 0, &data, &size);
+      if (ret == TRAP_E_TIMEOUT) {
+         if (sent_all) {
+            fprintf(stderr, "Received only %" PRIu32 " messages.\n", received);
+            recv_ret = 1;
+            break;
+         }
+         continue;
+      }
+      if (ret != TRAP_E_OK) {
+         fprintf(stderr, "Receiving failed.\n");
+         recv_ret = 1;
+         break;
+      }
+      memcpy(&key, data, sizeof(key));
+      if (size != sizeof(key) || key != received) {
+         fprintf(stderr, "Received message %" PRIu32 ", expected %" PRIu32 ".\n", key, received);
+         recv_ret = 1;
+         break;
+      }
+      __sync_add_and_fetch(&received, 1);
+   }
+   return NULL;
+}
+
+int main(int argc, char **argv)
+{
+   pthread_t thread;
+   uint32_t key, waited;
+   int ret = 0;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":latency=1000", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_AUTOFLUSH_TIMEOUT, (uint64_t) 2000000);
+
+   trap_ctx_t *recv_ctx = trap_ctx_init3("testmodule", "test description", 1, 0, "u:" SOCKET_NAME, NULL);
+   if (recv_ctx == NULL || trap_ctx_get_last_error(recv_ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_required_fmt(recv_ctx, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(recv_ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+   pthread_create(&thread, NULL, receiver_thread, recv_ctx);
+
+   while (trap_ctx_get_client_count(ctx, 0) < 1) {
+      usleep(10000);
+   }
+
+   /* single messages must be flushed within the latency, not the autoflush timeout */
+   for (key = 0; key < NO_SINGLE_MESSAGES && ret == 0; key++) {
+      trap_ctx_send(ctx, 0, &key, sizeof(key));
+      for (waited = 0; __sync_add_and_fetch(&received, 0) <= key; waited += 1000) {
+         if (waited >= MAX_DELAY || recv_ret != 0) {
+            fprintf(stderr, "Message %" PRIu32 " was not received in time.\n", key);
+            ret = 1;
+            break;
+         }
+         usleep(1000);
+      }
+   }
+
+   /* burst of messages, containers grow with the rate */
+   for (key = NO_SINGLE_MESSAGES; key < NO_SINGLE_MESSAGES + NO_MESSAGES && ret == 0; key++) {
+      trap_ctx_send(ctx, 0, &key, sizeof(key));
+   }
+   trap_ctx_send_flush(ctx, 0);
+   sleep(1);
+   sent_all = 1;
+
+   pthread_join(thread, NULL);
+   if (recv_ret != 0) {
+      ret = 1;
+   }
+
+   trap_ctx_finalize(&recv_ctx);
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
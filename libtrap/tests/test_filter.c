@@ -0,0 +1,200 @@
+/**
+ * \file test_filter.c
+ * \brief Send UniRec records to output IFC with filter enabled and check that the clients receive only the records matching their filters.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_MESSAGES 1000
+#define NO_RECEIVERS 3
+#define SOCKET_NAME "test_filter"
+#define SENT_FMT "uint32 A,uint16 B,string S"
+#define REQUIRED_FMT "uint16 B,string S"
+
+/*
+ * Records of SENT_FMT are laid out as A (4B), B (2B), header of S (offset
+ * and length, 2B each) and content of S; projected records as B, header of
+ * S and content of S.
+ */
+#define FULL_SIZE 13
+#define PROJECTED_SIZE 9
+
+typedef struct receiver_s {
+   trap_ctx_t *ctx;
+   pthread_t thread;
+   const char *params;
+   uint16_t expected_size;
+   int (*match)(uint16_t b);
+   uint64_t received;
+   int ret;
+} receiver_t;
+
+static volatile int sent_all = 0;
+
+static int match_all(uint16_t b)
+{
+   (void) b;
+   return 1;
+}
+
+static int match_ranges(uint16_t b)
+{
+   return b < 100 || b >= 900;
+}
+
+static int match_one(uint16_t b)
+{
+   return b == 7;
+}
+
+static void *receiver_thread(void *arg)
+{
+   receiver_t *r = (receiver_t *) arg;
+   const uint8_t *data;
+   uint16_t size, b, expected = 0;
+   int ret;
+
+   while (1) {
+      ret = trap_ctx_recv(r->ctx, 0, (const void **) &data, &size);
+      if (ret == TRAP_E_TIMEOUT) {
+         if (sent_all) {
+            break;
+         }
+         continue;
+      }
+      if (ret != TRAP_E_OK && ret != TRAP_E_FORMAT_CHANGED) {
+         fprintf(stderr, "Receiving failed.\n");
+         r->ret = 1;
+         break;
+      }
+      if (size != r->expected_size) {
+         fprintf(stderr, "Receiver %s: unexpected size %d of record.\n", r->params, size);
+         r->ret = 1;
+         break;
+      }
+      memcpy(&b, data + (size == FULL_SIZE ? 4 : 0), sizeof(b));
+      while (!r->match(expected)) {
+         expected++;
+      }
+      if (b != expected) {
+         fprintf(stderr, "Receiver %s: unexpected record %d, expected %d.\n", r->params, b, expected);
+         r->ret = 1;
+         break;
+      }
+      expected++;
+      r->received++;
+   }
+   while (expected < NO_MESSAGES && !r->match(expected)) {
+      expected++;
+   }
+   if (r->ret == 0 && expected != NO_MESSAGES) {
+      fprintf(stderr, "Receiver %s: record %d was not received.\n", r->params, expected);
+      r->ret = 1;
+   }
+   return NULL;
+}
+
+int main(void)
+{
+   receiver_t receivers[NO_RECEIVERS] = {
+      {.params = "u:" SOCKET_NAME ":filter=B < 100 || B >= 900 && A == 0x11223344",
+       .expected_size = FULL_SIZE, .match = match_ranges},
+      {.params = "u:" SOCKET_NAME ":projection=1:filter=B==7", .expected_size = PROJECTED_SIZE, .match = match_one},
+      {.params = "u:" SOCKET_NAME ":filter=UNKNOWN==1", .expected_size = FULL_SIZE, .match = match_all}
+   };
+   uint8_t record[FULL_SIZE];
+   uint32_t a = 0x11223344;
+   uint16_t key, header[2] = {0, 3};
+   int ret = 0;
+   int i;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":projection=1:filter=1", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_UNIREC, SENT_FMT);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+
+   for (i = 0; i < NO_RECEIVERS; i++) {
+      receivers[i].ctx = trap_ctx_init3("testmodule", "test description", 1, 0, receivers[i].params, NULL);
+      if (receivers[i].ctx == NULL || trap_ctx_get_last_error(receivers[i].ctx) != TRAP_E_OK) {
+         fprintf(stderr, "Failed trap_ctx_init.\n");
+         return 1;
+      }
+      trap_ctx_set_required_fmt(receivers[i].ctx, 0, TRAP_FMT_UNIREC, REQUIRED_FMT);
+      trap_ctx_ifcctl(receivers[i].ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+      pthread_create(&receivers[i].thread, NULL, receiver_thread, &receivers[i]);
+   }
+
+   while (trap_ctx_get_client_count(ctx, 0) < NO_RECEIVERS) {
+      usleep(10000);
+   }
+
+   memcpy(record, &a, sizeof(a));
+   memcpy(record + 6, header, sizeof(header));
+   memcpy(record + 10, "abc", 3);
+   for (key = 0; key < NO_MESSAGES; key++) {
+      memcpy(record + 4, &key, sizeof(key));
+      trap_ctx_send(ctx, 0, record, sizeof(record));
+   }
+   trap_ctx_send_flush(ctx, 0);
+   sleep(1);
+   sent_all = 1;
+
+   for (i = 0; i < NO_RECEIVERS; i++) {
+      pthread_join(receivers[i].thread, NULL);
+      if (receivers[i].ret != 0) {
+         ret = 1;
+      }
+      trap_ctx_finalize(&receivers[i].ctx);
+   }
+
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
@@ -0,0 +1,225 @@
+/**
+ * \file test_inproc.c
+ * \brief Pass UniRec records between two contexts of one process via in-process IFC and check their order, sequence numbers and format changes.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#define NO_MESSAGES 100000
+#define CHANNEL_NAME "test_inproc"
+#define LATE_CHANNEL_NAME "test_inproc_late"
+#define SENT_FMT "uint32 A,uint16 B"
+#define CHANGED_FMT "uint32 A,uint16 B,uint8 C"
+#define REQUIRED_FMT "uint32 A"
+
+static trap_ctx_t *sender_ctx;
+static int sender_ret = 0;
+
+/*
+ * Records are sent in two halves, the second one with CHANGED_FMT that has
+ * one more byte, field A holds the sequence number of the record.
+ */
+static void *sender_thread(void *arg)
+{
+   uint8_t record[7] = {0};
+   uint32_t key;
+
+   (void) arg;
+   for (key = 0; key < NO_MESSAGES; key++) {
+      if (key == NO_MESSAGES / 2) {
+         trap_ctx_set_data_fmt(sender_ctx, 0, TRAP_FMT_UNIREC, CHANGED_FMT);
+      }
+      memcpy(record, &key, sizeof(key));
+      if (trap_ctx_send(sender_ctx, 0, record, key < NO_MESSAGES / 2 ? 6 : 7) != TRAP_E_OK) {
+         fprintf(stderr, "Sending failed.\n");
+         sender_ret = 1;
+         break;
+      }
+   }
+   trap_ctx_send_flush(sender_ctx, 0);
+   return NULL;
+}
+
+/*
+ * Input IFC attached after some messages were sent skips them and numbers
+ * the following messages from 1, the output IFC does not wait for it forever
+ * when it stops reading.
+ */
+static int test_late_receiver(void)
+{
+   trap_ctx_t *out, *in;
+   const void *data;
+   uint16_t size;
+   uint64_t seq;
+   uint32_t key;
+   struct timespec start, end;
+   int ret = 0;
+
+   out = trap_ctx_init3("testmodule", "test description", 0, 1, "i:" LATE_CHANNEL_NAME ":buffer_count=2:buffer_size=100", NULL);
+   if (out == NULL || trap_ctx_get_last_error(out) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(out, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(out, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_NO_WAIT);
+
+   /* one message per container, dropped without input IFC */
+   for (key = 0; key < 5; key++) {
+      trap_ctx_send(out, 0, &key, sizeof(key));
+      trap_ctx_send_flush(out, 0);
+   }
+
+   in = trap_ctx_init3("testmodule", "test description", 1, 0, "i:" LATE_CHANNEL_NAME, NULL);
+   if (in == NULL || trap_ctx_get_last_error(in) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_required_fmt(in, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(in, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+   for (key = 5; key < 7; key++) {
+      trap_ctx_send(out, 0, &key, sizeof(key));
+      trap_ctx_send_flush(out, 0);
+   }
+   for (key = 5; key < 7; key++) {
+      uint32_t got;
+      int rv = trap_ctx_recv_with_seq_number(in, 0, &data, &size, &seq);
+      if (rv != TRAP_E_OK) {
+         fprintf(stderr, "Receiving of late receiver failed (%d).\n", rv);
+         ret = 1;
+         break;
+      }
+      memcpy(&got, data, sizeof(got));
+      if (got != key || seq != key - 4) {
+         fprintf(stderr, "Late receiver got message %" PRIu32 " with sequence number %" PRIu64 ", expected %" PRIu32 " and %" PRIu32 ".\n",
+                 got, seq, key, key - 4);
+         ret = 1;
+      }
+   }
+
+   /* the input IFC stops reading, termination of the output IFC is bounded */
+   trap_ctx_send(out, 0, &key, sizeof(key));
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   trap_ctx_finalize(&out);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   if (end.tv_sec - start.tv_sec > 5) {
+      fprintf(stderr, "Termination of output IFC took %ld s.\n", (long) (end.tv_sec - start.tv_sec));
+      ret = 1;
+   }
+   trap_ctx_finalize(&in);
+   return ret;
+}
+
+int main(void)
+{
+   pthread_t thread;
+   trap_ctx_t *ctx, *second;
+   const void *data;
+   uint16_t size;
+   uint64_t seq;
+   uint32_t key, expected = 0;
+   int changes = 0;
+   int ret = 0;
+
+   sender_ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "i:" CHANNEL_NAME ":buffer_count=4:buffer_size=1000", NULL);
+   if (sender_ctx == NULL || trap_ctx_get_last_error(sender_ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(sender_ctx, 0, TRAP_FMT_UNIREC, SENT_FMT);
+   trap_ctx_ifcctl(sender_ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+
+   ctx = trap_ctx_init3("testmodule", "test description", 1, 0, "i:" CHANNEL_NAME, NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_required_fmt(ctx, 0, TRAP_FMT_UNIREC, REQUIRED_FMT);
+   trap_ctx_ifcctl(ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+
+   /* only one input IFC can be connected to a channel */
+   second = trap_ctx_init3("testmodule", "test description", 1, 0, "i:" CHANNEL_NAME, NULL);
+   if (second != NULL && trap_ctx_get_last_error(second) == TRAP_E_OK) {
+      fprintf(stderr, "Second input IFC of a channel was created.\n");
+      ret = 1;
+   }
+   trap_ctx_finalize(&second);
+
+   pthread_create(&thread, NULL, sender_thread, NULL);
+
+   while (expected < NO_MESSAGES) {
+      int rv = trap_ctx_recv_with_seq_number(ctx, 0, &data, &size, &seq);
+      if (rv == TRAP_E_FORMAT_CHANGED) {
+         changes++;
+      } else if (rv != TRAP_E_OK) {
+         fprintf(stderr, "Receiving failed (%d) after %" PRIu32 " messages.\n", rv, expected);
+         ret = 1;
+         break;
+      }
+      memcpy(&key, data, sizeof(key));
+      if (key != expected || size != (key < NO_MESSAGES / 2 ? 6 : 7) || seq != (uint64_t) expected + 1) {
+         fprintf(stderr, "Unexpected message %" PRIu32 " of size %d with sequence number %" PRIu64 ", expected %" PRIu32 ".\n",
+                 key, size, seq, expected);
+         ret = 1;
+         break;
+      }
+      expected++;
+   }
+   pthread_join(thread, NULL);
+
+   if (changes != 2) {
+      fprintf(stderr, "Format change reported %d times, expected 2.\n", changes);
+      ret = 1;
+   }
+
+   trap_ctx_finalize(&ctx);
+   trap_ctx_finalize(&sender_ctx);
+
+   ret |= test_late_receiver();
+
+   return ret | sender_ret;
+}
@@ -0,0 +1,168 @@
+/**
+ * \file test_partitions.c
+ * \brief Send messages to output IFC with partitions and check that each client gets one partition.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_MESSAGES 100000
+#define NO_PARTITIONS 2
+#define SOCKET_NAME "test_partitions"
+
+typedef struct message_s {
+   uint32_t key;
+   uint32_t end;
+} message_t;
+
+typedef struct receiver_s {
+   trap_ctx_t *ctx;
+   pthread_t thread;
+   uint64_t received;
+   int64_t partition;
+   int ret;
+} receiver_t;
+
+static uint32_t partition_by_key(const void *data, uint16_t size, void *arg)
+{
+   (void) size;
+   (void) arg;
+   return ((const message_t *) data)->key;
+}
+
+static void *receiver_thread(void *arg)
+{
+   receiver_t *r = (receiver_t *) arg;
+   const message_t *m;
+   const void *data;
+   uint16_t size;
+
+   while (1) {
+      if (trap_ctx_recv(r->ctx, 0, &data, &size) != TRAP_E_OK || size != sizeof(message_t)) {
+         fprintf(stderr, "Receiving failed.\n");
+         r->ret = 1;
+         break;
+      }
+      m = (const message_t *) data;
+      if (r->partition == -1) {
+         r->partition = m->key % NO_PARTITIONS;
+      } else if (r->partition != m->key % NO_PARTITIONS) {
+         fprintf(stderr, "Message with key %" PRIu32 " received by client of partition %" PRId64 ".\n", m->key, r->partition);
+         r->ret = 1;
+         break;
+      }
+      if (m->end) {
+         break;
+      }
+      r->received++;
+   }
+   return NULL;
+}
+
+int main(void)
+{
+   receiver_t receivers[NO_PARTITIONS];
+   message_t m;
+   uint64_t received = 0;
+   int ret = 0;
+   int i;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":partitions=2", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_PARTITION_FUNC, partition_by_key, NULL);
+
+   for (i = 0; i < NO_PARTITIONS; i++) {
+      receivers[i].received = 0;
+      receivers[i].partition = -1;
+      receivers[i].ret = 0;
+      receivers[i].ctx = trap_ctx_init3("testmodule", "test description", 1, 0, "u:" SOCKET_NAME, NULL);
+      if (receivers[i].ctx == NULL || trap_ctx_get_last_error(receivers[i].ctx) != TRAP_E_OK) {
+         fprintf(stderr, "Failed trap_ctx_init.\n");
+         return 1;
+      }
+      trap_ctx_set_required_fmt(receivers[i].ctx, 0, TRAP_FMT_RAW);
+      trap_ctx_ifcctl(receivers[i].ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+      pthread_create(&receivers[i].thread, NULL, receiver_thread, &receivers[i]);
+   }
+
+   while (trap_ctx_get_client_count(ctx, 0) < NO_PARTITIONS) {
+      usleep(10000);
+   }
+
+   m.end = 0;
+   for (m.key = 0; m.key < NO_MESSAGES; m.key++) {
+      trap_ctx_send(ctx, 0, &m, sizeof(m));
+   }
+   m.end = 1;
+   for (m.key = 0; m.key < NO_PARTITIONS; m.key++) {
+      trap_ctx_send(ctx, 0, &m, sizeof(m));
+   }
+   trap_ctx_send_flush(ctx, 0);
+
+   for (i = 0; i < NO_PARTITIONS; i++) {
+      pthread_join(receivers[i].thread, NULL);
+      if (receivers[i].ret != 0) {
+         ret = 1;
+      } else if (receivers[i].received != NO_MESSAGES / NO_PARTITIONS) {
+         fprintf(stderr, "Client of partition %" PRId64 " received %" PRIu64 " messages, expected %d.\n",
+                 receivers[i].partition, receivers[i].received, NO_MESSAGES / NO_PARTITIONS);
+         ret = 1;
+      }
+      received += receivers[i].received;
+      trap_ctx_finalize(&receivers[i].ctx);
+   }
+   if (received != NO_MESSAGES) {
+      fprintf(stderr, "Received %" PRIu64 " messages, expected %d.\n", received, NO_MESSAGES);
+      ret = 1;
+   }
+
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
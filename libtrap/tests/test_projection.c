@@ -0,0 +1,198 @@
+/**
+ * \file test_projection.c
+ * \brief Send UniRec records to output IFC with projection enabled and check that the client requesting projection receives only the required fields.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_MESSAGES 1000
+#define SOCKET_NAME "test_projection"
+#define SENT_FMT "uint32 A,uint16 B,string S"
+#define REQUIRED_FMT "uint16 B,string S"
+
+/*
+ * Records of SENT_FMT are laid out as A (4B), B (2B), header of S (offset
+ * and length, 2B each) and content of S; projected records as B, header of
+ * S and content of S.
+ */
+#define FULL_SIZE 13
+#define PROJECTED_SIZE 9
+
+typedef struct receiver_s {
+   trap_ctx_t *ctx;
+   pthread_t thread;
+   const char *params;
+   uint16_t expected_size;
+   uint64_t received;
+   int ret;
+} receiver_t;
+
+static volatile int sent_all = 0;
+
+static int check_record(const uint8_t *data, uint16_t size, uint16_t expected_size, uint16_t key)
+{
+   uint16_t b, header[2];
+   const uint8_t *rec = data;
+
+   if (size != expected_size) {
+      fprintf(stderr, "Unexpected size %d of record, expected %d.\n", size, expected_size);
+      return 1;
+   }
+   if (expected_size == FULL_SIZE) {
+      uint32_t a;
+      memcpy(&a, rec, sizeof(a));
+      if (a != 0x11223344) {
+         fprintf(stderr, "Unexpected value of field A.\n");
+         return 1;
+      }
+      rec += sizeof(a);
+   }
+   memcpy(&b, rec, sizeof(b));
+   memcpy(header, rec + sizeof(b), sizeof(header));
+   if (b != key || header[0] != 0 || header[1] != 3 ||
+       memcmp(rec + sizeof(b) + sizeof(header), "abc", 3) != 0) {
+      fprintf(stderr, "Unexpected content of record %d.\n", key);
+      return 1;
+   }
+   return 0;
+}
+
+static void *receiver_thread(void *arg)
+{
+   receiver_t *r = (receiver_t *) arg;
+   const void *data;
+   uint16_t size;
+   int ret;
+
+   while (r->received < NO_MESSAGES) {
+      ret = trap_ctx_recv(r->ctx, 0, &data, &size);
+      if (ret == TRAP_E_TIMEOUT) {
+         if (sent_all) {
+            fprintf(stderr, "Receiver %s received only %d messages.\n", r->params, (int) r->received);
+            r->ret = 1;
+            break;
+         }
+         continue;
+      }
+      if (ret == TRAP_E_FORMAT_CHANGED) {
+         ret = TRAP_E_OK;
+      }
+      if (ret != TRAP_E_OK || check_record(data, size, r->expected_size, r->received) != 0) {
+         fprintf(stderr, "Receiving failed.\n");
+         r->ret = 1;
+         break;
+      }
+      r->received++;
+   }
+   return NULL;
+}
+
+int main(void)
+{
+   receiver_t receivers[2] = {
+      {.params = "u:" SOCKET_NAME ":projection=1", .expected_size = PROJECTED_SIZE},
+      {.params = "u:" SOCKET_NAME, .expected_size = FULL_SIZE}
+   };
+   uint8_t record[FULL_SIZE];
+   uint32_t a = 0x11223344;
+   uint16_t key, header[2] = {0, 3};
+   const char *spec;
+   uint8_t type;
+   int ret = 0;
+   int i;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":projection=1", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_UNIREC, SENT_FMT);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+
+   for (i = 0; i < 2; i++) {
+      receivers[i].ctx = trap_ctx_init3("testmodule", "test description", 1, 0, receivers[i].params, NULL);
+      if (receivers[i].ctx == NULL || trap_ctx_get_last_error(receivers[i].ctx) != TRAP_E_OK) {
+         fprintf(stderr, "Failed trap_ctx_init.\n");
+         return 1;
+      }
+      trap_ctx_set_required_fmt(receivers[i].ctx, 0, TRAP_FMT_UNIREC, REQUIRED_FMT);
+      trap_ctx_ifcctl(receivers[i].ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+      pthread_create(&receivers[i].thread, NULL, receiver_thread, &receivers[i]);
+   }
+
+   while (trap_ctx_get_client_count(ctx, 0) < 2) {
+      usleep(10000);
+   }
+
+   memcpy(record, &a, sizeof(a));
+   memcpy(record + 6, header, sizeof(header));
+   memcpy(record + 10, "abc", 3);
+   for (key = 0; key < NO_MESSAGES; key++) {
+      memcpy(record + 4, &key, sizeof(key));
+      trap_ctx_send(ctx, 0, record, sizeof(record));
+   }
+   trap_ctx_send_flush(ctx, 0);
+   sleep(1);
+   sent_all = 1;
+
+   for (i = 0; i < 2; i++) {
+      pthread_join(receivers[i].thread, NULL);
+      if (receivers[i].ret != 0) {
+         ret = 1;
+      }
+      if (trap_ctx_get_data_fmt(receivers[i].ctx, TRAPIFC_INPUT, 0, &type, &spec) != TRAP_E_OK ||
+          strcmp(spec, i == 0 ? REQUIRED_FMT : SENT_FMT) != 0) {
+         fprintf(stderr, "Unexpected data format of receiver %s.\n", receivers[i].params);
+         ret = 1;
+      }
+      trap_ctx_finalize(&receivers[i].ctx);
+   }
+
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
@@ -0,0 +1,174 @@
+/**
+ * \file test_readahead.c
+ * \brief Receive messages of various sizes with different read-ahead buffer sizes of input IFC and check their content and order.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_MESSAGES 100000
+#define NO_RECEIVERS 4
+#define SOCKET_NAME "test_readahead"
+
+typedef struct receiver_s {
+   trap_ctx_t *ctx;
+   pthread_t thread;
+   const char *params;
+   uint32_t received;
+   int ret;
+} receiver_t;
+
+static volatile int sent_all = 0;
+
+/* size of message with the given key, between 4 and 203 bytes */
+static inline uint16_t message_size(uint32_t key)
+{
+   return sizeof(key) + key % 200;
+}
+
+static void *receiver_thread(void *arg)
+{
+   receiver_t *r = (receiver_t *) arg;
+   const uint8_t *data;
+   uint16_t size, i;
+   uint32_t key;
+   int ret;
+
+   while (r->received < NO_MESSAGES) {
+      ret = trap_ctx_recv(r->ctx, 0, (const void **) &data, &size);
+      if (ret == TRAP_E_TIMEOUT) {
+         if (sent_all) {
+            fprintf(stderr, "Receiver %s received only %" PRIu32 " messages.\n", r->params, r->received);
+            r->ret = 1;
+            break;
+         }
+         continue;
+      }
+      if (ret != TRAP_E_OK) {
+         fprintf(stderr, "Receiving failed.\n");
+         r->ret = 1;
+         break;
+      }
+      memcpy(&key, data, sizeof(key));
+      if (key != r->received || size != message_size(key)) {
+         fprintf(stderr, "Receiver %s got message %" PRIu32 " of size %d, expected %" PRIu32 ".\n",
+                 r->params, key, size, r->received);
+         r->ret = 1;
+         break;
+      }
+      for (i = sizeof(key); i < size; i++) {
+         if (data[i] != (uint8_t) (key + i)) {
+            fprintf(stderr, "Receiver %s got corrupted message %" PRIu32 ".\n", r->params, key);
+            r->ret = 1;
+            return NULL;
+         }
+      }
+      r->received++;
+   }
+   return NULL;
+}
+
+int main(int argc, char **argv)
+{
+   /* disabled by default, disabled explicitly, large buffer and a buffer smaller than a container */
+   receiver_t receivers[NO_RECEIVERS] = {
+      {.params = "u:" SOCKET_NAME},
+      {.params = "u:" SOCKET_NAME ":readahead=0"},
+      {.params = "u:" SOCKET_NAME ":readahead=1048576"},
+      {.params = "u:" SOCKET_NAME ":readahead=100"}
+   };
+   uint8_t message[256];
+   uint32_t key;
+   uint16_t i;
+   int ret = 0;
+   int r;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":buffer_size=5000", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+
+   for (r = 0; r < NO_RECEIVERS; r++) {
+      receivers[r].ctx = trap_ctx_init3("testmodule", "test description", 1, 0, receivers[r].params, NULL);
+      if (receivers[r].ctx == NULL || trap_ctx_get_last_error(receivers[r].ctx) != TRAP_E_OK) {
+         fprintf(stderr, "Failed trap_ctx_init.\n");
+         return 1;
+      }
+      trap_ctx_set_required_fmt(receivers[r].ctx, 0, TRAP_FMT_RAW);
+      trap_ctx_ifcctl(receivers[r].ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+      pthread_create(&receivers[r].thread, NULL, receiver_thread, &receivers[r]);
+   }
+
+   while (trap_ctx_get_client_count(ctx, 0) < NO_RECEIVERS) {
+      usleep(10000);
+   }
+
+   for (key = 0; key < NO_MESSAGES; key++) {
+      memcpy(message, &key, sizeof(key));
+      for (i = sizeof(key); i < message_size(key); i++) {
+         message[i] = key + i;
+      }
+      trap_ctx_send(ctx, 0, message, message_size(key));
+   }
+   trap_ctx_send_flush(ctx, 0);
+   sleep(1);
+   sent_all = 1;
+
+   for (r = 0; r < NO_RECEIVERS; r++) {
+      pthread_join(receivers[r].thread, NULL);
+      if (receivers[r].ret != 0) {
+         ret = 1;
+      }
+      trap_ctx_finalize(&receivers[r].ctx);
+   }
+
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
@@ -71,24 +71,35 @@ if [ "`pgrep "^$PROG_ECHO_REPLY$"`" != "" ]; then
    exit 1
 fi
 
+# sender that refused the client with wrong certificate is not used for measurement
+kill -9 $echopid 2> /dev/null
+wait $echopid 2> /dev/null
+
 INTERFACE_RECEIVER="T:12345:${srcdir}/tls-certificates/client.key:${srcdir}/tls-certificates/client.crt:${srcdir}/tls-certificates/ca.crt"
 
+# compare encryption in user space (send_blocking_mode with OpenSSL) with kernel TLS
+for SENDER_OPTS in ":timeout=WAIT" ":timeout=WAIT:ktls=1"; do
+./$PROG_ECHO -i $INTERFACE_SENDER$SENDER_OPTS -n $ERSIZE > "$ECHOOUT" 2>&1 &
+echopid=$!
+sleep 1
+
 #running the client with valid certificate
 ./$PROG_ECHO_REPLY -i $INTERFACE_RECEIVER > "$REPLYOUTOK" 2>&1 &
 replypid=$!
 
-echo "Running for ${ERTIME}s with ${ERSIZE}B messages"
+echo "Running for ${ERTIME}s with ${ERSIZE}B messages (sender options: '$SENDER_OPTS')"
 sleep $ERTIME
 echo "Shutting sender"
 kill -INT $echopid 2> /dev/null
 sleep 1
 kill -INT $replypid 2> /dev/null
+wait $echopid $replypid 2> /dev/null
 
 RECV=$(grep "Last received value" "$REPLYOUTOK" | sed 's/.* \([0-9]*\)/\1/')
 SENT=$(grep "Last sent" "$ECHOOUT" | sed 's/.* \([0-9]*\)/\1/')
 ERRCOUNT=$(grep Error "$REPLYOUTOK" | cut -f2 -d" ")
 echo "Errors: $ERRCOUNT"
-if [ $ERRCOUNT != "0" ]; then
+if [ "$ERRCOUNT" != "0" ]; then
    echo "Some errors occured. ($ERRCOUNT)"
    exit 1
 fi
@@ -99,7 +110,25 @@ else
    echo "FAILED: $RECV/$SENT (R/S)"
    exit 1
 fi
-echo "Average MPS: $((RECV/ERTIME))"
+MPS=$((RECV/ERTIME))
+echo "Average MPS: $MPS"
+# the first run is the baseline
+BASE_MPS=${BASE_MPS:-$MPS}
 
 echo "scale=3; print \"AVG speed: \", (($RECV*$ERSIZE*8)/1000000)/$ERTIME, \" Mbps\"" | bc
 echo ""
+done
+
+# the sender warns when kTLS is not supported or could not be enabled for the client
+if grep -q -e "kTLS is not supported" -e "kTLS could not be enabled" "$ECHOOUT"; then
+   echo "SKIP: kTLS did not engage, comparison with user space encryption skipped."
+   exit 0
+fi
+
+KTLS_MPS=$MPS
+# kTLS must not be slower than encryption in user space (with 20% tolerance for noise)
+if [ $((KTLS_MPS * 100)) -lt $((BASE_MPS * 80)) ]; then
+   echo "FAILED: kTLS is slower than user space encryption: $KTLS_MPS/$BASE_MPS MPS"
+   exit 1
+fi
+echo "OK: kTLS $KTLS_MPS MPS, user space $BASE_MPS MPS"
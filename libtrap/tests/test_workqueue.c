@@ -0,0 +1,162 @@
+/**
+ * \file test_workqueue.c
+ * \brief Send messages to output IFC in work-queue dispatch mode and check that every message is received once.
+ * \date 2026
+ */
+/*
+ * Copyright (C) 2026 CESNET
+ *
+ * LICENSE TERMS
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name of the Company nor the names of its contributors
+ *    may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * ALTERNATIVELY, provided that this notice is retained in full, this
+ * product may be distributed under the terms of the GNU General Public
+ * License (GPL) version 2 or later, in which case the provisions
+ * of the GPL apply INSTEAD OF those given above.
+ *
+ * This software is provided ``as is'', and any express or implied
+ * warranties, including, but not limited to, the implied warranties of
+ * merchantability and fitness for a particular purpose are disclaimed.
+ * In no event shall the company or contributors be liable for any
+ * direct, indirect, incidental, special, exemplary, or consequential
+ * damages (including, but not limited to, procurement of substitute
+ * goods or services; loss of use, data, or profits; or business
+ * interruption) however caused and on any theory of liability, whether
+ * in contract, strict liability, or tort (including negligence or
+ * otherwise) arising in any way out of the use of this software, even
+ * if advised of the possibility of such damage.
+ *
+ */
+
+
+#include <libtrap/trap.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NO_MESSAGES 100000
+#define NO_CLIENTS 2
+#define SOCKET_NAME "test_workqueue"
+
+typedef struct receiver_s {
+   trap_ctx_t *ctx;
+   pthread_t thread;
+   uint64_t received;
+   int ret;
+} receiver_t;
+
+static uint8_t received_keys[NO_MESSAGES];
+static volatile int sent_all = 0;
+
+static void *receiver_thread(void *arg)
+{
+   receiver_t *r = (receiver_t *) arg;
+   const void *data;
+   uint16_t size;
+   uint32_t key;
+   int ret;
+
+   while (1) {
+      ret = trap_ctx_recv(r->ctx, 0, &data, &size);
+      if (ret == TRAP_E_TIMEOUT) {
+         if (sent_all) {
+            break;
+         }
+         continue;
+      }
+      if (ret != TRAP_E_OK || size != sizeof(key)) {
+         fprintf(stderr, "Receiving failed.\n");
+         r->ret = 1;
+         break;
+      }
+      key = *(const uint32_t *) data;
+      if (key >= NO_MESSAGES) {
+         fprintf(stderr, "Unexpected key %" PRIu32 ".\n", key);
+         r->ret = 1;
+         break;
+      }
+      __sync_add_and_fetch(&received_keys[key], 1);
+      r->received++;
+   }
+   return NULL;
+}
+
+int main(void)
+{
+   receiver_t receivers[NO_CLIENTS];
+   uint64_t received = 0;
+   uint32_t key;
+   int ret = 0;
+   int i;
+
+   trap_ctx_t *ctx = trap_ctx_init3("testmodule", "test description", 0, 1, "u:" SOCKET_NAME ":dispatch=workqueue:buffer_size=1000", NULL);
+   if (ctx == NULL || trap_ctx_get_last_error(ctx) != TRAP_E_OK) {
+      fprintf(stderr, "Failed trap_ctx_init.\n");
+      return 1;
+   }
+   trap_ctx_set_data_fmt(ctx, 0, TRAP_FMT_RAW);
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, 0, TRAPCTL_SETTIMEOUT, TRAP_WAIT);
+
+   for (i = 0; i < NO_CLIENTS; i++) {
+      receivers[i].received = 0;
+      receivers[i].ret = 0;
+      receivers[i].ctx = trap_ctx_init3("testmodule", "test description", 1, 0, "u:" SOCKET_NAME, NULL);
+      if (receivers[i].ctx == NULL || trap_ctx_get_last_error(receivers[i].ctx) != TRAP_E_OK) {
+         fprintf(stderr, "Failed trap_ctx_init.\n");
+         return 1;
+      }
+      trap_ctx_set_required_fmt(receivers[i].ctx, 0, TRAP_FMT_RAW);
+      trap_ctx_ifcctl(receivers[i].ctx, TRAPIFC_INPUT, 0, TRAPCTL_SETTIMEOUT, 500000);
+      pthread_create(&receivers[i].thread, NULL, receiver_thread, &receivers[i]);
+   }
+
+   while (trap_ctx_get_client_count(ctx, 0) < NO_CLIENTS) {
+      usleep(10000);
+   }
+
+   for (key = 0; key < NO_MESSAGES; key++) {
+      trap_ctx_send(ctx, 0, &key, sizeof(key));
+   }
+   trap_ctx_send_flush(ctx, 0);
+   sleep(1);
+   sent_all = 1;
+
+   for (i = 0; i < NO_CLIENTS; i++) {
+      pthread_join(receivers[i].thread, NULL);
+      if (receivers[i].ret != 0) {
+         ret = 1;
+      }
+      // share of clients depends on scheduling, only the total is checked
+      received += receivers[i].received;
+      trap_ctx_finalize(&receivers[i].ctx);
+   }
+   if (received != NO_MESSAGES) {
+      fprintf(stderr, "Received %" PRIu64 " messages, expected %d.\n", received, NO_MESSAGES);
+      ret = 1;
+   }
+   for (key = 0; key < NO_MESSAGES; key++) {
+      if (received_keys[key] != 1) {
+         fprintf(stderr, "Message %" PRIu32 " received %d times.\n", key, received_keys[key]);
+         ret = 1;
+         break;
+      }
+   }
+
+   trap_ctx_finalize(&ctx);
+
+   return ret;
+}
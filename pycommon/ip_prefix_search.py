@@ -73,10 +73,37 @@ def main(argv):
         print("There is no match in this network context")
 
 **************************************
+
+    NativeIPPSContext has the same interface as IPPSContext, but the intervals
+are created and searched by the C implementation of libunirec (ipps_init(),
+ipps_search()) via pytrap.UnirecIPList. It is much faster to create from
+large files and it provides ip_search_many() to search many addresses at once
+without the GIL. It does not provide interval_list_v4 and interval_list_v6.
+
+    search_context = NativeIPPSContext.fromFile("blacklist.txt")
+    results = search_context.ip_search_many([pytrap.UnirecIPAddr("1.2.3.4"), pytrap.UnirecIPAddr("aab::bba")])
 """
 import sys, os.path
 import pytrap
 
+
+def _parse_line(line):
+    """ Parse line of blacklist file
+    Args:
+        line: <ip address>[/<mask>][,<data>]
+    Return:
+        tuple of prefix string and list of data (None if there are no data)
+    """
+    parse = line.rstrip().split(",")
+    prefix = parse[0].strip()
+    if '/' not in prefix:
+        if ':' in prefix:
+            prefix += "/128"
+        else:
+            prefix += "/32"
+    return prefix, (parse[1:] if len(parse) > 1 else None)
+
+
 class IPPSNetwork(object):
     """ Network class
     Represent network with associated data.
@@ -223,18 +250,8 @@ class IPPSContext(object):
                 for line in f:
                     if line.isspace():
                         continue
-                    parse = line.rstrip().split(",")
-                    parse[0] = parse[0].strip()
-                    if '/' not in parse[0]:
-                        if ':' in parse[0]:
-                            parse[0] += "/128"
-                        else:
-                            parse[0] += "/32"
-
-                    if len(parse) == 1:
-                        network_list.append(IPPSNetwork(parse[0]))
-                    else:
-                        network_list.append(IPPSNetwork(parse[0], parse[1:]))
+                    prefix, data = _parse_line(line)
+                    network_list.append(IPPSNetwork(prefix, data))
             f.close()
             return cls(network_list)
         else:
@@ -435,3 +452,103 @@ class IPPSContext(object):
                 # ip address is higher then current midpoint
                 first = middleindex + 1
         return False
+
+
+class NativeIPPSContext(object):
+    """
+    IP prefix search Context class backed by the C implementation (pytrap.UnirecIPList)
+    Drop-in replacement of IPPSContext, see the module documentation.
+
+    Args:
+        val: list of IPPSNetwork objects
+    """
+
+    def __init__(self, val):
+        if not isinstance(val, list):
+            raise TypeError("Init need list of IPPSNetworks")
+
+        networks = []
+        for net in val:
+            if not isinstance(net, IPPSNetwork):
+                raise TypeError("Object isn't IPPSNetworks")
+            networks.append((pytrap.UnirecIPAddrRange(net.addr), net.data))
+        self._init_networks(networks)
+
+    def _init_networks(self, networks):
+        self._iplist = pytrap.UnirecIPList(networks) if networks else None
+
+    def __repr__(self):
+        return "NativeIPPSContext(" + str(self) + ")"
+
+    def __str__(self):
+        return str(self._iplist) if self._iplist is not None else ""
+
+    def __len__(self):
+        return len(self._iplist) if self._iplist is not None else 0
+
+    @classmethod
+    def fromFile(cls, path):
+        """ Initialize NativeIPPSContext from blacklist data file, see IPPSContext.fromFile()
+
+        Args:
+            path: path to source file
+        Return:
+            new NativeIPPSContext or None if path isn't string
+        """
+        if not isinstance(path, str):
+            return None
+
+        networks = []
+        with open(path, "r") as f:
+            for line in f:
+                if line.isspace():
+                    continue
+                prefix, data = _parse_line(line)
+                networks.append((pytrap.UnirecIPAddrRange(prefix), data))
+
+        context = cls.__new__(cls)
+        context._init_networks(networks)
+        return context
+
+    @staticmethod
+    def _result(values):
+        """ Convert values of all matching networks to the result of IPPSContext.ip_search() """
+        if values is None:
+            return False
+        data = []
+        for value in values:
+            if isinstance(value, list):
+                data.extend(value)
+            elif value is not None:
+                data.append(value)
+        return data if data else True
+
+    def ip_search(self, ip):
+        """ Search ip address, see IPPSContext.ip_search()
+        Args:
+            ip: IPAddr object, searched ip address
+        Return:
+            False, if ip address not match
+            True, if ip address is match, but list is empty (no data are set)
+            list with data, if ip address is match and data list is not empty
+        Raises:
+            TypeError: if ip is not a UnriecIPAddr object
+        """
+        if not isinstance(ip, pytrap.UnirecIPAddr):
+            raise TypeError("Can't search object. Required type is IP4Addr or IP6Addr.")
+        if self._iplist is None:
+            return False
+        return self._result(self._iplist.findAll(ip))
+
+    def ip_search_many(self, addresses):
+        """ Search many ip addresses at once, the search runs without the GIL
+        Args:
+            addresses: list of UnirecIPAddr or buffer of UniRec IP addresses
+                       (see pytrap.UnirecIPList.findMany())
+        Return:
+            list of results of ip_search() for all addresses
+        """
+        if self._iplist is None:
+            count = len(addresses) if isinstance(addresses, (list, tuple)) else memoryview(addresses).nbytes // 16
+            return [False] * count
+        return [self._result(values) for values in self._iplist.findMany(addresses, all=True)]
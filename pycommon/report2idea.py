@@ -363,5 +363,7 @@ def Run(module_name, module_desc, req_type, req_format, conv_func, arg_parser =
         print(config)
 
     if not args.dry:
+        # Finish asynchronous actions before their outputs are closed
+        config.stopActions()
         trap.finalize()
         del config
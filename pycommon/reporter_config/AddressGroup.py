@@ -2,6 +2,11 @@ import ipranges
 
 import logging as log
 
+try:
+    import pytrap
+except ImportError:
+    pytrap = None
+
 logger = log.getLogger(__name__)
 
 class AddressGroup:
@@ -9,6 +14,7 @@ class AddressGroup:
 
     def __init__(self, addrGroup):
         self.content = list()
+        self.unireciplist = None
         if not isinstance(addrGroup, dict):
             raise Exception("AddressGroup must be a dictionary")
 
@@ -34,6 +40,7 @@ class AddressGroup:
             raise Exception("Only 'file' or 'list' keys are supported.")
 
         self.id = addrGroup["id"]
+        self.unireciplist = self.__createIPList()
 
     def __str__(self):
         return "ID: '" + self.id + "' IPs: " + str(self.content)
@@ -41,6 +48,41 @@ class AddressGroup:
     def iplist(self):
         return repr([str(i) for i in self.content])
 
+    def __createIPList(self):
+        """
+        Create pytrap.UnirecIPList of the address group for fast lookup of
+        single addresses; None is returned when pytrap is not available.
+        """
+        if pytrap is None or not self.content:
+            return None
+        networks = dict()
+        try:
+            for rng in self.content:
+                s = str(rng)
+                if "/" in s:
+                    networks[pytrap.UnirecIPAddrRange(s)] = True
+                elif "-" in s:
+                    low, high = s.split("-", 1)
+                    networks[pytrap.UnirecIPAddrRange(low.strip(), high.strip())] = True
+                else:
+                    networks[pytrap.UnirecIPAddrRange(s, s)] = True
+            return pytrap.UnirecIPList(networks)
+        except Exception as e:
+            logger.warning("Address group '{0}' is not accelerated by pytrap: {1}".format(self.id, e))
+            return None
+
+    def __address(self, ip):
+        """Get pytrap.UnirecIPAddr of a single address, None for subnets and ranges."""
+        try:
+            return pytrap.UnirecIPAddr(str(ip))
+        except (pytrap.TrapError, TypeError, ValueError):
+            return None
+
+    def __matchRange(self, ip):
+        if isinstance(ip, str):
+            ip = ipranges.from_str(ip)
+        return any((ip in rng) for rng in self.content)
+
     def isPresent(self, ip):
         """
         Return True if `ip` is in the addressgroup.
@@ -50,6 +92,46 @@ class AddressGroup:
         :param str ip: IPv4 or IPv6 address or subnet
         :return: True if `ip` is present, False otherwise.
         """
-        ip = ipranges.from_str(ip)
-        return any((ip in rng) for rng in self.content)
+        return self.matchAny([ip])
+
+    def matchAny(self, ips):
+        """
+        Return True if any of `ips` is in the addressgroup.
+
+        :param list ips: IPv4 or IPv6 addresses or subnets (str or ipranges objects)
+        """
+        for ip in ips:
+            addr = self.__address(ip) if self.unireciplist is not None else None
+            if addr is not None:
+                if addr in self.unireciplist:
+                    return True
+            elif self.__matchRange(ip):
+                return True
+        return False
+
+    def matchMany(self, ips):
+        """
+        Batch version of matchAny(), single addresses of all items are looked
+        up by one call of pytrap.UnirecIPList.matchMany().
+
+        :param list ips: List of lists of IPv4 or IPv6 addresses or subnets
+        :return: List of bool, True if any address of the item is present.
+        """
+        if self.unireciplist is None:
+            return [self.matchAny(i) for i in ips]
+
+        result = [False] * len(ips)
+        addrs = list()
+        owners = list()
+        for index, item in enumerate(ips):
+            for ip in item:
+                addr = self.__address(ip)
+                if addr is not None:
+                    addrs.append(addr)
+                    owners.append(index)
+                elif not result[index] and self.__matchRange(ip):
+                    result[index] = True
+        for i in self.unireciplist.matchMany(addrs):
+            result[owners[i]] = True
+        return result
 
@@ -5,12 +5,14 @@ import logging
 
 from pynspect.compilers import IDEAFilterCompiler
 from pynspect.gparser import PynspectFilterParser
+from idea import lite
 
 from .actions.Drop import DropAction, DropMsg
 from .actions.Action import Action
 from .Parser import Parser
 from .AddressGroup import AddressGroup
 from .Rule import Rule, clearCounters, STAT_KEYPREFIX
+from .RuleFilter import RuleFilter
 
 logger = logging.getLogger(__name__)
 
@@ -66,6 +68,7 @@ class Config():
         self.addrGroups = dict()
         self.actions = dict()
         self.rules = list()
+        self.rulefilter = None
 
         try:
             self.loadConfig()
@@ -102,6 +105,8 @@ class Config():
             logger.info("Stopping configuration autoreload.")
             self.timer.cancel()
 
+        self.stopActions()
+
         if self.wardenclient:
             self.wardenclient.close()
 
@@ -221,20 +226,39 @@ class Config():
 
         # Parse all rules and match them with actions and address groups
         # There must be at least one rule (mandatory field)
+        rulefilter = RuleFilter()
         if "rules" in conf:
             if conf["rules"]:
                 for i in conf["rules"]:
                     r = Rule(i, actions, addrGroups,
                                            parser = self.parser, compiler = self.compiler,
-                                           module_name = self.module_name)
+                                           module_name = self.module_name, rulefilter = rulefilter)
                     rules.append(r)
             if not rules:
                 raise SyntaxError("YAML file should contain at least one `rule` in `rules`.")
         else:
             raise SyntaxError("YAML file must contain `rules`.")
 
+        # Evaluate common sub-expressions of all rules only once per message
+        for r, condition in zip(rules, rulefilter.share([r.getCondition() for r in rules])):
+            r.setCondition(condition)
+
+        # Run actions with `async` parameters in worker threads, the whole
+        # configuration is parsed, so threads are not left behind by a failed reload
+        try:
+            for i in conf.get("custom_actions") or []:
+                if i.get("async") and i["id"] in actions:
+                    actions[i["id"]].startExecutor(i["async"])
+        except Exception:
+            for a in actions.values():
+                a.stopExecutor()
+            raise
+
+        oldActions = self.actions
+
         self.conf = conf
         self.rules = rules
+        self.rulefilter = rulefilter
         self.actions = actions
         self.addrGroups = addrGroups
         self.smtp_conns = smtp_conns
@@ -245,6 +269,10 @@ class Config():
         else:
             self.name = self.module_name
 
+        # Records queued for actions of the previous configuration are processed
+        for a in oldActions.values():
+            a.stopExecutor()
+
         clearCounters(STAT_KEYPREFIX, self.module_name)
         logging.warning("Success: New configuration loaded, applied and counters reset.")
 
@@ -255,33 +283,77 @@ class Config():
 
         Return a list of bool values representing results of all tested rules.
         """
+        return self.__match(self.rules, self.rulefilter, msg, None)
+
+    def matchMany(self, msgs):
+        """
+        Check if messages match rules from config file.
+
+        Membership of addresses in address groups is looked up for all
+        messages at once, otherwise it is equal to calling match() for
+        every message.
+
+        Return a list of results of match().
+        """
+        rules, rulefilter = self.rules, self.rulefilter
+        records = [msg if isinstance(msg, lite.Idea) else lite.Idea(msg) for msg in msgs]
+        caches = rulefilter.prepare(records)
+        return [self.__match(rules, rulefilter, msg, cache, record)
+                for msg, record, cache in zip(msgs, records, caches)]
+
+    def __match(self, rules, rulefilter, msg, cache, record=None):
         results = []
         actionsDone = []
 
+        # The message is converted via idea module only once for all rules
+        if record is None:
+            record = msg if isinstance(msg, lite.Idea) else lite.Idea(msg)
+
+        rulefilter.begin(cache)
         try:
-            for rule in self.rules:
+            for rule in rules:
                 self.clearActionLog()
-                res = rule.filter(msg)
+                res = rule.filter(record)
                 #logger.debug("Filter by rule: %s \n message: %s\n\nresult: %s", rule, msg, res)
                 #print("Filter by rule: %s \n message: %s\n\nresult: %s" % (rule.rule(), msg, res))
 
                 results.append(res)
 
-                tmp_msg = copy.deepcopy(msg)
-                if res:
+                if not rule.hasActions(res):
+                    pass
+                elif res:
                     # condition is True
-                    rule.actions(tmp_msg)
+                    rule.actions(copy.deepcopy(msg))
                     logger.info("action running")
                 else:
                     # condition is False
-                    rule.elseactions(tmp_msg)
+                    rule.elseactions(copy.deepcopy(msg))
                     logger.info("else action running")
                 actionsDone.append(self.getActionLog())
         except DropMsg:
             # This exception breaks the processing of rule list.
             pass
+        finally:
+            rulefilter.end()
         return (results, actionsDone)
 
+    def flushActions(self):
+        """Wait until all records queued for asynchronous actions are processed."""
+        for a in list(self.actions.values()):
+            if a.executor:
+                a.executor.flush()
+
+    def stopActions(self):
+        """Process records queued for asynchronous actions and stop their workers,
+        the actions are run synchronously since now. It should be called before
+        the TRAP context or Warden client used by actions are closed."""
+        for a in list(self.actions.values()):
+            a.stopExecutor()
+
+    def actionStats(self):
+        """Get stats of asynchronous actions (see ActionExecutor.stats()) by action ID."""
+        return dict((key, a.stats()) for key, a in self.actions.items() if a.executor)
+
     def getActionLog(self):
         return Action.actionLog
 
@@ -310,7 +382,9 @@ class Config():
 
         s = "\n".join("{}:\n{}\n".format(smtp_id, params) for smtp_id, params in smtp.items())
         ag = "\n".join([str(self.addrGroups[key]) for key in self.addrGroups])
-        a = "\n".join([key + ":\n\t" + str(self.actions[key]) for key in self.actions])
+        a = "\n".join([key + ":\n\t" + str(self.actions[key]) +
+                       ("\t" + str(self.actions[key].executor) + "\n" if self.actions[key].executor else "")
+                       for key in self.actions])
         r = "\n".join([str(val) for val in self.rules])
         string = "Namespace: {0}\n----------------\nSmtp connections:\n{1}\n----------------\nAddress Groups:\n{2}\n"\
                  "----------------\nCustom Actions:\n{3}\n----------------\nRules:\n{4}\n".format(self.conf.get("namespace"), s, ag, a, r)
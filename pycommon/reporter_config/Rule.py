@@ -2,11 +2,12 @@ import re
 import logging
 import redis
 #from pynspect.rules import *
-from pynspect.filters import DataObjectFilter
 from pynspect.compilers import IDEAFilterCompiler
 from pynspect.gparser import PynspectFilterParser
 from idea import lite
 
+from .RuleFilter import RuleFilter
+
 logger = logging.getLogger(__name__)
 
 STAT_KEYPREFIX = "nemea"
@@ -41,7 +42,7 @@ def clearCounters(prefix, module):
         logging.error("redis: Could not update statistics.")
 
 class Rule():
-    def __init__(self, rule, actions, addrGroups, parser=None, compiler=None, module_name=""):
+    def __init__(self, rule, actions, addrGroups, parser=None, compiler=None, module_name="", rulefilter=None):
 
         if not "condition" in rule:
             raise SyntaxError("Missing 'condition' in the rule: " + str(rule))
@@ -62,22 +63,23 @@ class Rule():
         else:
             self.compiler = compiler
 
-        # Instantiate filter
-        self.__filter = DataObjectFilter()
+        # Check is we got filter instance (shared by rules of the config)
+        if rulefilter is None:
+            self.__filter = RuleFilter()
+        else:
+            self.__filter = rulefilter
 
 
         # Store rule condition in raw form
         self.__conditionRaw = rule["condition"]
-
-        if not self.__matchvar(rule["condition"], addrGroups):
-            self.__condition = self.__conditionRaw
+        self.__condition = self.__conditionRaw
 
         self.module_name = module_name
         # Set inner rule ID
         self.id = rule["id"]
 
         if (self.__condition != None):
-            self.parseRule()
+            self.parseRule(addrGroups)
 
         self.__actions = list()
         self.__elseactions = list()
@@ -100,18 +102,43 @@ class Rule():
                     raise SyntaxError("Missing elseaction with ID %s" % str(e))
 
 
-    def parseRule(self):
+    def parseRule(self, addrGroups=None):
         cond = str(self.__condition).lower()
         if cond in ["none", "null", "true"]:
             self.__condition = True
         elif cond == "false":
             self.__condition = False
         else:
-            try:
-                self.__condition = self.parser.parse(self.__condition)
-                self.__condition = self.compiler.compile(self.__condition)
-            except Exception as e:
-                raise SyntaxError("Error while parsing condition: {0}\nOriginal exception: {1}".format(self.__condition, e))
+            condition = None
+            if addrGroups:
+                # Try to evaluate address groups natively (see RuleFilter.bindAddressGroups()),
+                # otherwise substitute them by the list of their values
+                try:
+                    condition = self.compiler.compile(self.parser.parse(self.__condition))
+                    condition = self.__filter.bindAddressGroups(condition, addrGroups)
+                except Exception:
+                    condition = None
+                if condition is None:
+                    self.__matchvar(self.__condition, addrGroups)
+            if condition is None:
+                try:
+                    condition = self.parser.parse(self.__condition)
+                    condition = self.compiler.compile(condition)
+                except Exception as e:
+                    raise SyntaxError("Error while parsing condition: {0}\nOriginal exception: {1}".format(self.__condition, e))
+            self.__condition = condition
+
+    def getCondition(self):
+        """Get compiled condition (pynspect rule tree, True or False)"""
+        return self.__condition
+
+    def setCondition(self, condition):
+        """Replace compiled condition, used by RuleFilter.share()"""
+        self.__condition = condition
+
+    def hasActions(self, result):
+        """Return True if there are actions (result is True) or elseactions (result is False) to run"""
+        return bool(self.__actions if result else self.__elseactions)
 
     def filter(self, record):
         """
@@ -0,0 +1,237 @@
+"""
+Compiled evaluation of rule conditions shared by all rules of a configuration.
+
+Conditions of all rules are parsed by pynspect into expression trees.  The
+trees are post-processed here:
+
+- `<jpath> in <addressgroup>` comparisons are replaced by AddressGroupRule,
+  which looks the addresses up in the address group (backed by
+  pytrap.UnirecIPList when pytrap is available) instead of comparing them
+  with a literal list of all the group's networks,
+
+- structurally equal sub-expressions of all rules are merged into one
+  SharedRule node, whose result is computed only once per message,
+
+- results of AddressGroupRule can be computed for a whole batch of messages
+  at once by prepare().
+"""
+
+import threading
+import logging
+
+from pynspect.rules import Rule as PynspectRule, VariableRule, ComparisonBinOpRule
+from pynspect.filters import DataObjectFilter
+
+logger = logging.getLogger(__name__)
+
+def _children(node):
+    """Yield (attribute, value) of all sub-expressions of the node."""
+    for name, value in vars(node).items():
+        if isinstance(value, PynspectRule):
+            yield name, value
+        elif isinstance(value, list) and value and all(isinstance(i, PynspectRule) for i in value):
+            yield name, value
+
+def _rewrite(node, func):
+    """Rewrite the tree bottom-up, func is called for every node and returns its replacement."""
+    for name, value in list(_children(node)):
+        if isinstance(value, list):
+            setattr(node, name, [_rewrite(i, func) for i in value])
+        else:
+            setattr(node, name, _rewrite(value, func))
+    return func(node)
+
+
+class CachedRule(PynspectRule):
+    """
+    Base of nodes whose result is stored in the per-message cache of RuleFilter.
+
+    The cache is used only while RuleFilter evaluates a message (between
+    begin() and end()), otherwise the node is evaluated every time.
+    """
+    def __init__(self, key):
+        self.key = key
+
+    def evaluate(self, traverser, **kwargs):
+        raise NotImplementedError()
+
+    def traverse(self, traverser, **kwargs):
+        cache = getattr(traverser, "cache", None)
+        if cache is None:
+            return self.evaluate(traverser, **kwargs)
+        try:
+            return cache[self.key]
+        except KeyError:
+            pass
+        res = cache[self.key] = self.evaluate(traverser, **kwargs)
+        return res
+
+
+class SharedRule(CachedRule):
+    """Sub-expression that occurs more than once in conditions of the rules."""
+    def __init__(self, key, rule):
+        super().__init__(key)
+        self.rule = rule
+
+    def evaluate(self, traverser, **kwargs):
+        return self.rule.traverse(traverser, **kwargs)
+
+    def __repr__(self):
+        return repr(self.rule)
+
+    def __str__(self):
+        return str(self.rule)
+
+
+class AddressGroupRule(CachedRule):
+    """Membership of values of `variable` in the address group."""
+    def __init__(self, key, variable, group):
+        super().__init__(key)
+        self.variable = variable
+        self.group = group
+
+    def evaluate(self, traverser, **kwargs):
+        return self.group.matchAny(self.values(self.variable.traverse(traverser, **kwargs)))
+
+    @staticmethod
+    def values(values):
+        if values is None:
+            return []
+        if not isinstance(values, (list, tuple)):
+            return [values]
+        return values
+
+    def __repr__(self):
+        return "ADDRESSGROUP({0} IN {1})".format(repr(self.variable), self.group.id)
+
+    def __str__(self):
+        return "({0} in {1})".format(str(self.variable), self.group.id)
+
+
+class RuleFilter(DataObjectFilter):
+    """
+    Filter evaluating the compiled conditions of rules.
+
+    One instance is shared by all rules of a configuration, see Config.loadConfig().
+    """
+    def __init__(self):
+        super().__init__()
+        self.__local = threading.local()
+        self.__keys = dict()
+        self.__groupRules = dict()
+
+    @property
+    def cache(self):
+        return getattr(self.__local, "cache", None)
+
+    def begin(self, cache=None):
+        """Start evaluation of one message, results of shared nodes are cached until end()."""
+        self.__local.cache = dict() if cache is None else cache
+
+    def end(self):
+        self.__local.cache = None
+
+    def __key(self, node, memo):
+        """Get identifier of the node, structurally equal nodes get the same identifier."""
+        key = memo.get(id(node))
+        if key is not None:
+            return key
+        parts = [type(node).__name__]
+        for name in sorted(vars(node)):
+            value = getattr(node, name)
+            if isinstance(node, CachedRule) and name == "key":
+                continue
+            if isinstance(value, PynspectRule):
+                parts.append((name, self.__key(value, memo)))
+            elif isinstance(value, list) and value and all(isinstance(i, PynspectRule) for i in value):
+                parts.append((name, tuple(self.__key(i, memo) for i in value)))
+            elif name == "group":
+                parts.append((name, id(value)))
+            else:
+                parts.append((name, repr(value)))
+        key = self.__keys.setdefault(tuple(parts), len(self.__keys))
+        memo[id(node)] = key
+        return key
+
+    def bindAddressGroups(self, condition, addrGroups):
+        """
+        Replace `<jpath> in <addressgroup>` in the compiled condition by AddressGroupRule.
+
+        :param condition Condition compiled by pynspect, address groups are referenced by their IDs
+        :param addrGroups Dictionary of AddressGroup by ID
+        :return Rewritten condition, or None if some address group is used
+                in other way and must be substituted by its values.
+        """
+        def bind(node):
+            if (isinstance(node, ComparisonBinOpRule)
+                    and str(getattr(node, "operation", "")).upper() in ("OP_IN", "IN")
+                    and isinstance(node.right, VariableRule)
+                    and node.right.value in addrGroups):
+                group = addrGroups[node.right.value]
+                rule = AddressGroupRule(None, node.left, group)
+                rule.key = self.__key(rule, dict())
+                return self.__groupRules.setdefault(rule.key, rule)
+            return node
+
+        unbound = []
+
+        def check(node):
+            if isinstance(node, VariableRule) and node.value in addrGroups:
+                unbound.append(node.value)
+            return node
+
+        condition = _rewrite(condition, bind)
+        _rewrite(condition, check)
+        if unbound:
+            logger.debug("Address groups %s are not compiled, substituting their values.", unbound)
+            return None
+        return condition
+
+    def share(self, conditions):
+        """
+        Merge structurally equal sub-expressions of the conditions.
+
+        :param conditions List of compiled conditions (other values are kept as they are)
+        :return List of conditions with shared nodes
+        """
+        memo = dict()
+        counts = dict()
+
+        def count(node):
+            if list(_children(node)):
+                key = self.__key(node, memo)
+                counts[key] = counts.get(key, 0) + 1
+            return node
+
+        for c in conditions:
+            if isinstance(c, PynspectRule):
+                _rewrite(c, count)
+
+        shared = dict()
+
+        def merge(node):
+            if isinstance(node, CachedRule) or not list(_children(node)):
+                return node
+            key = self.__key(node, memo)
+            if counts.get(key, 0) < 2:
+                return node
+            return shared.setdefault(key, SharedRule(key, node))
+
+        result = [(_rewrite(c, merge) if isinstance(c, PynspectRule) else c) for c in conditions]
+        logger.debug("Shared %d sub-expressions of %d conditions.", len(shared), len(conditions))
+        return result
+
+    def prepare(self, records):
+        """
+        Evaluate address group membership of all records at once.
+
+        :param records List of IDEA messages (lite.Idea)
+        :return List of caches, one for each record, to be passed to begin()
+        """
+        caches = [dict() for i in records]
+        for key, rule in self.__groupRules.items():
+            values = [AddressGroupRule.values(self.filter(rule.variable, r)) for r in records]
+            for cache, res in zip(caches, rule.group.matchMany(values)):
+                cache[key] = res
+        return caches
+
@@ -1,13 +1,61 @@
+import copy
 import logging as log
 
 class Action(object):
+    """Base of actions
+
+    run() is called by Rule for every matching record. The action is
+    performed by execute(), or asynchronously by the executor (see
+    Executor.ActionExecutor) if `async` is set for the custom action; the
+    record is then converted by prepare() and the worker threads pass batches
+    of the prepared records to executeBatch().
+    """
     actionLog = []
+
+    # False for actions that must modify the record or stop processing synchronously
+    asyncSupported = True
+
     def __init__(self, actionId = None, actionType = None):
         super(Action, self).__init__()
         self.logger = log.getLogger(__name__)
         self.actionId = actionId
         self.actionType = actionType
+        self.executor = None
 
     def run(self, record):
         self.actionLog.append(self)
+        if self.executor:
+            self.executor.submit(self.prepare(record))
+        else:
+            return self.execute(record)
+
+    def execute(self, record):
+        pass
+
+    def prepare(self, record):
+        """Get a private copy of the record for asynchronous processing, the
+        record can be modified by the following actions of the rule."""
+        return copy.deepcopy(record)
+
+    def executeBatch(self, records):
+        """Perform the action for records returned by prepare()"""
+        for record in records:
+            self.execute(record)
+
+    def startExecutor(self, conf):
+        """Run the action asynchronously, conf is `async` item of the custom action"""
+        from .Executor import ActionExecutor
+        if not self.asyncSupported:
+            raise SyntaxError("Action {0} ({1}) cannot be run asynchronously.".format(self.actionId, self.actionType))
+        self.executor = ActionExecutor.fromConfig(self, conf)
+
+    def stopExecutor(self):
+        """Process all queued records and run the action synchronously since now"""
+        if self.executor:
+            self.executor.stop()
+            self.executor = None
+
+    def stats(self):
+        """Get stats of the executor, None for synchronous action"""
+        return self.executor.stats() if self.executor else None
 
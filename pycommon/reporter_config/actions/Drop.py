@@ -5,11 +5,12 @@ class DropMsg(Exception):
         super(type(self), self).__init__()
 
 class DropAction(Action):
+    asyncSupported = False
+
     def __init__(self):
         super(DropAction, self).__init__(actionId = "drop", actionType = "drop")
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
         raise DropMsg()
 
     def __str__(self):
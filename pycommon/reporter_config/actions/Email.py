@@ -74,13 +74,11 @@ class EmailAction(Action):
                 raise Exception("Loading default template file ({0}) failed. Check if path is valid.".format(self.template_path))
 
 
-    def run(self, record):
+    def execute(self, record):
         """Send the record via email
 
         Record is pretty printed and headers are set according to the config
         """
-        super(type(self), self).run(record)
-
         # Use Jinja2 to fill template with data from record
         try:
             env = Environment(loader=FileSystemLoader(os.path.dirname(self.template_path)))
@@ -90,7 +88,7 @@ class EmailAction(Action):
             raise
 
         # Set message body
-        self.message = MIMEText(body_template.render(idea=record))
+        message = MIMEText(body_template.render(idea=record))
 
         # Set "Subject" header
         category = ','.join(record.get('Category', [])) or 'N/A'
@@ -124,7 +122,7 @@ class EmailAction(Action):
 
         subject_template = jinja2.Template(self.subject)
 
-        self.message['Subject'] = subject_template.render({
+        message['Subject'] = subject_template.render({
             'category': category,
             'node': node,
             'src_ip': src_ip,
@@ -134,11 +132,11 @@ class EmailAction(Action):
         }, idea = record)
 
         # Set other headers
-        self.message['From'] = self.addrFrom
-        self.message['To'] = ",".join(self.addrsTo)
+        message['From'] = self.addrFrom
+        message['To'] = ",".join(self.addrsTo)
 
         # Send message
-        self.logger.info("Mail From: {0} To: {1} Subject: {2}".format(self.addrFrom, self.addrsTo, self.message['Subject']))
+        self.logger.info("Mail From: {0} To: {1} Subject: {2}".format(self.addrFrom, self.addrsTo, message['Subject']))
         smtp = None
         try:
             if self.smtpSSL:
@@ -150,7 +148,7 @@ class EmailAction(Action):
                     smtp.starttls(keyfile = self.smtpKey, certfile = self.smtpChain)
             if self.smtpUser and self.smtpPass:
                 smtp.login(self.smtpUser, self.smtpPass)
-            smtp.sendmail(self.addrFrom, self.addrsTo, self.message.as_string())
+            smtp.sendmail(self.addrFrom, self.addrsTo, message.as_string())
         except Exception as e:
             self.logger.error(e)
         if smtp:
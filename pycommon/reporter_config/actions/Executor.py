@@ -0,0 +1,180 @@
+import threading
+import queue
+import time
+import logging as log
+
+logger = log.getLogger(__name__)
+
+class ActionExecutor(object):
+    """Run an action asynchronously in a pool of worker threads
+
+    Records prepared by Action.prepare() are put into a bounded queue and the
+    workers pass them to Action.executeBatch() in batches of up to `batch`
+    records that are available in the queue (the workers never wait to fill
+    a batch).
+
+    When the queue is full, the producer (the reporter's receive loop) is
+    blocked until there is a free slot (`block: True`, default), or the
+    record is dropped (`block: False`). Both cases are counted in stats().
+
+    The executor is configured by `async` in the custom action, e.g.:
+
+        - id: store
+          mongo:
+            db: nemeadb
+          async:
+            workers: 1
+            queue: 10000
+            batch: 100
+            block: True
+    """
+    _STOP = object()
+
+    def __init__(self, action, workers=1, queue_size=1000, batch=1, block=True):
+        self.action = action
+        self.workers = int(workers)
+        self.queue_size = int(queue_size)
+        self.batch = int(batch)
+        self.block = bool(block)
+        if self.workers < 1 or self.queue_size < 1 or self.batch < 1:
+            raise SyntaxError("Async action {0}: workers, queue and batch must be positive numbers.".format(action.actionId))
+
+        self.queue = queue.Queue(maxsize=self.queue_size)
+        self.lock = threading.Lock()
+        self.running = True
+
+        self.submitted = 0
+        self.processed = 0
+        self.dropped = 0
+        self.errors = 0
+        self.batches = 0
+        self.blocked = 0
+        self.blocked_time = 0.0
+        self.max_queued = 0
+
+        self.threads = []
+        for i in range(self.workers):
+            t = threading.Thread(target=self.worker, name="action-{0}-{1}".format(action.actionId, i))
+            t.daemon = True
+            t.start()
+            self.threads.append(t)
+
+    @classmethod
+    def fromConfig(cls, action, conf):
+        """Create executor for the action from `async` item of the custom action"""
+        if conf is True:
+            conf = dict()
+        if not isinstance(conf, dict):
+            raise SyntaxError("Async action {0}: `async` must be a dictionary.".format(action.actionId))
+        unknown = set(conf) - set(["workers", "queue", "batch", "block"])
+        if unknown:
+            raise SyntaxError("Async action {0}: unknown parameters {1}.".format(action.actionId, ", ".join(sorted(unknown))))
+        return cls(action, workers=conf.get("workers", 1), queue_size=conf.get("queue", 1000),
+                   batch=conf.get("batch", 1), block=conf.get("block", True))
+
+    def submit(self, item):
+        """Put prepared record into the queue, it is processed synchronously after stop()"""
+        if not self.running:
+            self.action.executeBatch([item])
+            return
+        try:
+            self.queue.put_nowait(item)
+        except queue.Full:
+            if not self.block:
+                with self.lock:
+                    self.dropped += 1
+                return
+            start = time.monotonic()
+            self.queue.put(item)
+            with self.lock:
+                self.blocked += 1
+                self.blocked_time += time.monotonic() - start
+        with self.lock:
+            self.submitted += 1
+            self.max_queued = max(self.max_queued, self.queue.qsize())
+
+    def worker(self):
+        stop = False
+        while not stop:
+            items = [self.queue.get()]
+            while len(items) < self.batch:
+                try:
+                    items.append(self.queue.get_nowait())
+                except queue.Empty:
+                    break
+            if self._STOP in items:
+                stop = True
+                records = [i for i in items if i is not self._STOP]
+            else:
+                records = items
+            errors = 0
+            if records:
+                try:
+                    self.action.executeBatch(records)
+                except Exception as e:
+                    logger.error("Async action {0} failed: {1}".format(self.action.actionId, e))
+                    errors = 1
+            with self.lock:
+                self.processed += len(records)
+                self.errors += errors
+                self.batches += 1 if records else 0
+            for i in items:
+                self.queue.task_done()
+            if stop and len(items) - len(records) > 1:
+                # more stop marks were taken, return the rest to other workers
+                for i in range(len(items) - len(records) - 1):
+                    self.queue.put(self._STOP)
+
+    def flush(self):
+        """Wait until all submitted records are processed"""
+        self.queue.join()
+
+    def stop(self):
+        """Process all queued records and stop the workers"""
+        if not self.running:
+            return
+        self.running = False
+        for t in self.threads:
+            self.queue.put(self._STOP)
+        for t in self.threads:
+            t.join()
+        # records submitted concurrently with stop()
+        while True:
+            try:
+                item = self.queue.get_nowait()
+            except queue.Empty:
+                break
+            if item is not self._STOP:
+                self.action.executeBatch([item])
+
+    def stats(self):
+        """Get counters of the executor
+
+        submitted - records put into the queue
+        processed - records passed to the action
+        dropped - records dropped because of full queue (block: False)
+        errors - batches that raised an exception
+        batches - number of calls of Action.executeBatch()
+        blocked - number of times the producer waited for a free slot (block: True)
+        blocked_time - total time (s) the producer waited
+        queued - current length of the queue
+        max_queued - maximal observed length of the queue
+        """
+        with self.lock:
+            return {
+                "submitted": self.submitted,
+                "processed": self.processed,
+                "dropped": self.dropped,
+                "errors": self.errors,
+                "batches": self.batches,
+                "blocked": self.blocked,
+                "blocked_time": self.blocked_time,
+                "queued": self.queue.qsize(),
+                "max_queued": self.max_queued,
+            }
+
+    def __str__(self):
+        s = self.stats()
+        return "Async: workers {0}, queue {1}/{2} (max {3}), batch {4}, processed {5}, dropped {6}, blocked {7} ({8:.3f} s), errors {9}".format(
+            self.workers, s["queued"], self.queue_size, s["max_queued"], self.batch, s["processed"],
+            s["dropped"], s["blocked"], s["blocked_time"], s["errors"])
@@ -35,36 +35,50 @@ class FileAction(Action):
         except Exception:
             self.dir = False
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
+        self.executeBatch([self.prepare(record)])
+
+    def prepare(self, record):
+        """Serialize the record, returns tuple (ID, JSON)"""
+        return (record.get("ID"), json.dumps(record))
+
+    def executeBatch(self, records):
+        """Store serialized records, all records are written by a single write()"""
         try:
             if self.path in ['-', "/dev/stdout"]:
-                sys.stdout.write(json.dumps(record) + '\n')
+                sys.stdout.write("".join(r + '\n' for i, r in records))
                 sys.stdout.flush()
             elif self.path == "/dev/stderr":
-                sys.stderr.write(json.dumps(record) + '\n')
+                sys.stderr.write("".join(r + '\n' for i, r in records))
                 sys.stderr.flush()
             elif self.dir:
-                # Store record into separate file
-                filename = record["ID"] + ".idea"
-                outfile = os.path.join(self.save_path, filename)
-                with open(outfile, "w") as f:
-                    f.write(json.dumps(record))
-
-                # if the save_path is temporary, we need to move the file
-                if self.temp_path:
-                    targetfile = os.path.join(self.path, filename)
-                    os.rename(outfile, targetfile)
+                for msgid, r in records:
+                    self.storeFile(msgid, r)
             else:
                 # Open file if dir is not specified
                 with open(self.path, "a") as f:
                     fcntl.flock(f, fcntl.LOCK_EX)
-                    f.write(json.dumps(record) + '\n')
+                    f.write("".join(r + '\n' for i, r in records))
                     f.flush()
                     fcntl.flock(f, fcntl.LOCK_UN)
         except Exception as e:
             self.logger.error(e)
 
+    def storeFile(self, msgid, record):
+        """Store record into separate file"""
+        try:
+            filename = msgid + ".idea"
+            outfile = os.path.join(self.save_path, filename)
+            with open(outfile, "w") as f:
+                f.write(record)
+
+            # if the save_path is temporary, we need to move the file
+            if self.temp_path:
+                targetfile = os.path.join(self.path, filename)
+                os.rename(outfile, targetfile)
+        except Exception as e:
+            self.logger.error(e)
+
     def __str__(self):
         return "Path: " + self.path + (" (Directory)" if self.dir else "") + ((" using temp: " + self.temp_path) if self.temp_path else "") + "\n"
 
@@ -3,6 +3,8 @@ from .Action import Action
 from pynspect import jpath
 
 class MarkAction(Action):
+    asyncSupported = False
+
     def __init__(self, action):
         super(type(self), self).__init__(actionId = action["id"], actionType = "mark")
         # TODO: parse path according to mentat jpath
@@ -12,8 +14,7 @@ class MarkAction(Action):
     def mark(self, record):
         return jpath.jpath_set(record, self.path, self.value)
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
         return self.mark(record)
 
     def __str__(self):
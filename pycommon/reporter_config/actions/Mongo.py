@@ -41,6 +41,7 @@ class MongoAction(Action):
             self.collection = self.client[self.db][self.collection_name]
             if pymongo.version_tuple[0] < 3:
                 self.collection.insert_one = self.collection.insert
+                self.collection.insert_many = self.collection.insert
         except Exception:
             self.client = None
 
@@ -68,14 +69,27 @@ class MongoAction(Action):
 
         return record
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
         if self.client:
             return self.store(record)
         elif not self.err_printed:
             self.logger.warning("Skipping mongo action, pymongo is not initialized.")
             self.err_printed = True
 
+    def prepare(self, record):
+        return self.transform(copy.deepcopy(record))
+
+    def executeBatch(self, records):
+        """Store transformed records to MongoDB by one bulk insert"""
+        if self.client:
+            try:
+                self.collection.insert_many(records)
+            except Exception as e:
+                self.logger.error(e)
+        elif not self.err_printed:
+            self.logger.warning("Skipping mongo action, pymongo is not initialized.")
+            self.err_printed = True
+
     def __del__(self):
         self.logger.debug("Closing connection to mongoDB")
         if self.client:
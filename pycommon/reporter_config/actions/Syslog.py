@@ -51,10 +51,16 @@ class SyslogAction(Action):
             raise KeyError
         return retval
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
+        self.executeBatch([self.prepare(record)])
+
+    def prepare(self, record):
+        return json.dumps(record)
+
+    def executeBatch(self, records):
         try:
-            syslog.syslog(self.priority_code, json.dumps(record))
+            for r in records:
+                syslog.syslog(self.priority_code, r)
         except Exception as e:
             self.logger.error(e)
 
@@ -10,14 +10,20 @@ class TrapAction(Action):
         self.trap = trap
         self.err_printed = False
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
+        self.executeBatch([self.prepare(record)])
+
+    def prepare(self, record):
+        return json.dumps(record).encode('utf8')
+
+    def executeBatch(self, records):
         if self.trap:
             try:
-                self.trap.send(json.dumps(record).encode('utf8'), 0)
+                for r in records:
+                    self.trap.send(r, 0)
             except Exception as e:
                 self.logger.error(e)
-        elif not err_printed:
+        elif not self.err_printed:
             self.logger.warning("Skipping TRAP action, TRAP is not initialized.")
             self.err_printed = True
 
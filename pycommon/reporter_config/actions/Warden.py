@@ -10,11 +10,13 @@ class WardenAction(Action):
         self.client = client
         self.err_printed = False
 
-    def run(self, record):
-        super(type(self), self).run(record)
+    def execute(self, record):
+        self.executeBatch([record])
+
+    def executeBatch(self, records):
         try:
             if self.client != None:
-                self.client.sendEvents([record])
+                self.client.sendEvents(records)
             else:
                 if not self.err_printed:
                     self.logger.warning("No event was sent because there is no Warden Client instance")
@@ -353,3 +353,38 @@ class DataTypesIPPPContext(unittest.TestCase):
                              "IP search - no match ip address search - fail")
             self.assertFalse(context.ip_search(pytrap.UnirecIPAddr("bfff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")),
                              "IP search - no match ip address search - fail")
+
+class NativeIPPSContextTest(unittest.TestCase):
+        def runTest(self):
+            import ip_prefix_search
+            import pytrap
+            import tempfile
+
+            lines = ["192.168.1.5/25,a", "192.168.1.2/24,b", "192.168.1.130/25,c", "192.168.1.150/28,g,h",
+                     "0.0.0.0/1,i", "255.255.255.255/2,j", "10.10.10.10,l", "10.10.10.10/32,m",
+                     "172.16.0.0/16", "fd37:3b22:507d:a4f9::/64,x", "fd37:3b22:507d:a4f9::1,y"]
+            with tempfile.NamedTemporaryFile("w", suffix=".txt") as f:
+                f.write("\n".join(lines) + "\n\n")
+                f.flush()
+                context = ip_prefix_search.IPPSContext.fromFile(f.name)
+                native = ip_prefix_search.NativeIPPSContext.fromFile(f.name)
+
+            self.assertEqual(len(native), len(context))
+            addrs = [pytrap.UnirecIPAddr(ip) for ip in
+                     ["0.0.0.0", "10.10.10.10", "128.0.0.1", "172.16.1.1", "192.168.1.1", "192.168.1.150",
+                      "192.168.1.200", "255.255.255.255", "fd37:3b22:507d:a4f9::1", "fd37:3b22:507d:a4f9::2", "::1"]]
+            for ip in addrs:
+                self.assertEqual(native.ip_search(ip), context.ip_search(ip), str(ip))
+            self.assertEqual(native.ip_search_many(addrs), [context.ip_search(ip) for ip in addrs])
+            self.assertEqual(native.ip_search(pytrap.UnirecIPAddr("10.10.10.10")), ['i', 'l', 'm'])
+            self.assertTrue(native.ip_search(pytrap.UnirecIPAddr("172.16.1.1")) is True)
+            self.assertFalse(native.ip_search(pytrap.UnirecIPAddr("130.0.0.1")))
+
+            networks = [ip_prefix_search.IPPSNetwork(net, data) for net, data in
+                        [("192.168.1.0/24", "aaa"), ("192.168.1.0/25", "bbb"), ("192.168.1.128/25", "ccc")]]
+            native = ip_prefix_search.NativeIPPSContext(networks)
+            self.assertEqual(native.ip_search(pytrap.UnirecIPAddr("192.168.1.100")), ["aaa", "bbb"])
+            self.assertEqual(native.ip_search(pytrap.UnirecIPAddr("192.168.1.200")), ["aaa", "ccc"])
+            self.assertFalse(native.ip_search(pytrap.UnirecIPAddr("192.1.1.1")))
+            self.assertRaises(TypeError, native.ip_search, "192.168.1.1")
+            self.assertEqual(ip_prefix_search.NativeIPPSContext([]).ip_search_many(addrs), [False] * len(addrs))
@@ -0,0 +1,121 @@
+import unittest
+import os
+import json
+import threading
+
+from reporter_config.Config import Config
+from reporter_config.actions.Action import Action
+from reporter_config.actions.Executor import ActionExecutor
+
+class SlowAction(Action):
+    """Local stand-in of a slow backend, it waits until it is released"""
+    def __init__(self):
+        super(SlowAction, self).__init__(actionId = "slow", actionType = "slow")
+        self.entered = threading.Event()
+        self.release = threading.Event()
+        self.batches = []
+
+    def executeBatch(self, records):
+        self.entered.set()
+        self.release.wait()
+        self.batches.append(list(records))
+
+class RCAsyncTest(unittest.TestCase):
+
+    def setUp(self):
+        """
+        Example message created by a conv function in a reporter
+        """
+        with open(os.path.dirname(__file__) + '/rc_msg.json', 'r') as f:
+            self.msg = json.load(f)
+
+    def test_01_async_file(self):
+        """
+        Load async.yaml, all records must be stored after stopActions()
+        """
+        path = "/tmp/testfile-async.idea"
+        if os.path.exists(path):
+            os.remove(path)
+        self.config = Config(os.path.dirname(__file__) + '/rc_config/async.yaml');
+        self.assertNotEqual(self.config.actions["file"].executor, None)
+
+        for i in range(50):
+            results, actions = self.config.match(self.msg)
+            self.assertEqual(results, [True])
+            self.assertEqual([a.actionId for a in actions[0]], ["mark", "file"])
+
+        self.config.flushActions()
+        stats = self.config.actionStats()["file"]
+        self.assertEqual(stats["processed"], 50)
+        self.assertEqual(stats["dropped"], 0)
+        self.config.stopActions()
+        self.assertEqual(self.config.actionStats(), {})
+
+        with open(path, 'r') as f:
+            lines = f.readlines()
+        os.remove(path)
+        self.assertEqual(len(lines), 50)
+        self.assertTrue(json.loads(lines[0])["Test"])
+        # the message given to match() must not be modified
+        self.assertNotIn("Test", self.msg)
+
+    def test_02_backpressure(self):
+        """
+        Full queue blocks or drops records according to `block`
+        """
+        action = SlowAction()
+        executor = ActionExecutor(action, workers=1, queue_size=2, batch=5, block=False)
+        # the worker is blocked in the action with the first record, the queue holds other two
+        executor.submit(0)
+        self.assertTrue(action.entered.wait(5))
+        for i in range(1, 10):
+            executor.submit(i)
+        stats = executor.stats()
+        self.assertEqual(stats["submitted"], 3)
+        self.assertEqual(stats["dropped"], 7)
+        action.release.set()
+        executor.flush()
+        executor.stop()
+        self.assertEqual(action.batches, [[0], [1, 2]])
+        self.assertEqual(executor.stats()["processed"], 3)
+
+        action = SlowAction()
+        executor = ActionExecutor(action, workers=2, queue_size=1, batch=1, block=True)
+        threading.Timer(0.2, action.release.set).start()
+        for i in range(10):
+            executor.submit(i)
+        executor.stop()
+        stats = executor.stats()
+        self.assertEqual(stats["dropped"], 0)
+        self.assertGreater(stats["blocked"], 0)
+        self.assertEqual(sorted(r for b in action.batches for r in b), list(range(10)))
+
+        # submit after stop runs the action synchronously
+        executor.submit(10)
+        self.assertEqual(action.batches[-1], [10])
+
+    def test_03_sync_actions(self):
+        """
+        Drop and Mark actions cannot be asynchronous
+        """
+        from reporter_config.actions.Drop import DropAction
+        with self.assertRaises(SyntaxError):
+            DropAction().startExecutor({})
+        with self.assertRaises(SyntaxError):
+            ActionExecutor.fromConfig(SlowAction(), {"workers": 1, "unknown": 1})
+
+    def test_04_failed_reload(self):
+        """
+        Failed reload must not leave worker threads of the new actions running
+        """
+        self.config = Config(os.path.dirname(__file__) + '/rc_config/async.yaml');
+        executor = self.config.actions["file"].executor
+        threads = threading.active_count()
+
+        self.config.path = os.path.dirname(__file__) + '/rc_config/async_broken.yaml'
+        with self.assertRaises(SyntaxError):
+            self.config.loadConfig()
+        self.assertEqual(threading.active_count(), threads)
+        # the previous configuration is kept
+        self.assertIs(self.config.actions["file"].executor, executor)
+        self.config.stopActions()
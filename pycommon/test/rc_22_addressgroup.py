@@ -58,3 +58,24 @@ class RCAddressGroupTest(unittest.TestCase):
                         print("Test FAILED!!!")
 
 
+
+        def test_02_matchmany(self):
+                """
+                Batch matching must give the same results as matching one by one
+                """
+                self.config = Config(os.path.dirname(__file__) + '/rc_config/addressgroup.yaml');
+
+                messages = self.messages_pass + self.messages_notpass
+                expected = [self.config.match(idea)[0] for idea in messages]
+                results = [r[0] for r in self.config.matchMany(messages)]
+                self.assertEqual(results, expected)
+                for r in results[:len(self.messages_pass)]:
+                    self.assertIn(True, r)
+                for r in results[len(self.messages_pass):]:
+                    self.assertNotIn(True, r)
+
+                group = self.config.addrGroups["whitelist2"]
+                self.assertTrue(group.isPresent("192.168.0.1"))
+                self.assertTrue(group.isPresent("192.168.0.0/25"))
+                self.assertFalse(group.isPresent("192.168.1.1"))
+                self.assertEqual(group.matchMany([["1.1.1.1", "10.0.1.1"], [], ["192.168.1.0/24"]]), [True, False, False])
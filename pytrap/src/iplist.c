@@ -11,70 +11,103 @@
 /*    UnirecIPList   */
 /*********************/
 
+static void
+destroy_networks(ipps_network_list_t *network_list) {
+    uint32_t index;
+    for (index = 0; index < network_list->net_count; index++) {
+        free(network_list->networks[index].data);
+    }
+
+    free(network_list->networks);
+    free(network_list);
+}
+
+/**
+ * \brief Load networks for ipps_init().
+ *
+ * \param [in] obj    dict with UnirecIPAddrRange as key and any object as value,
+ *                    or a sequence of (UnirecIPAddrRange, object) pairs
+ * \param [out] values    list that gets references of all the values
+ * \return list of networks, NULL on error
+ */
 static ipps_network_list_t *
-load_networks(PyDictObject *d)
+load_networks(PyObject *obj, PyObject *values)
 {
-    uint32_t i = 0;
-    uint32_t struct_count = 50; // Starting v4_count of structs to alloc
-
-    // ************* LOAD NETWORKS ********************** //
+    Py_ssize_t i, count;
+    PyObject *items;
 
-    // Alloc memory for networks structs, if malloc fails return NULL
-    ipps_network_t *networks = malloc(struct_count * sizeof(ipps_network_t));
-    if (networks == NULL) {
-        PyErr_SetString(PyExc_MemoryError, "Failed allocating memory for IP prefix search structures.");
+    if (PyDict_Check(obj)) {
+        items = PyDict_Items(obj);
+    } else {
+        items = PySequence_Fast(obj, "Argument must be a dict or a sequence of (UnirecIPAddrRange, object) pairs.");
+    }
+    if (items == NULL) {
         return NULL;
     }
+    count = PySequence_Fast_GET_SIZE(items);
+
+    // ************* LOAD NETWORKS ********************** //
 
     // Alloc memory for networks list, if malloc fails return NULL
     ipps_network_list_t *networks_list = malloc(sizeof(ipps_network_list_t));
     if (networks_list == NULL) {
+        Py_DECREF(items);
+        PyErr_SetString(PyExc_MemoryError, "Failed allocating memory for IP prefix search structures.");
+        return NULL;
+    }
+    networks_list->net_count = 0;
+
+    // Alloc memory for networks structs, if malloc fails return NULL
+    networks_list->networks = malloc((count + 1) * sizeof(ipps_network_t));
+    if (networks_list->networks == NULL) {
+        free(networks_list);
+        Py_DECREF(items);
         PyErr_SetString(PyExc_MemoryError, "Failed allocating memory for IP prefix search structures.");
         return NULL;
     }
 
-    PyObject *key, *value;
-    Py_ssize_t pos = 0;
+    for (i = 0; i < count; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(items, i);
+        PyObject *key, *value;
+
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 2) {
+            PyErr_SetString(PyExc_TypeError, "Items must be (UnirecIPAddrRange, object) pairs.");
+            goto failure;
+        }
+        key = PyTuple_GET_ITEM(item, 0);
+        value = PyTuple_GET_ITEM(item, 1);
 
-    while (PyDict_Next((PyObject *) d, &pos, &key, NULL)) {
-        ipps_network_t *network = &networks[i];
+        ipps_network_t *network = &networks_list->networks[i];
         if (PyObject_IsInstance(key, (PyObject *) &pytrap_UnirecIPAddrRange)) {
             pytrap_unirecipaddrrange *r = (pytrap_unirecipaddrrange *) key;
             network->mask = r->mask;
             memcpy(&network->addr, &r->start->ip, sizeof(ip_addr_t));
-            // If limit is reached alloc new memory
-            if (i >= struct_count) {
-                struct_count += 10;
-                // If realloc fails return NULL
-                if ((networks = realloc(networks, struct_count * sizeof(ipps_network_t))) == NULL) {
-                    PyErr_SetString(PyExc_MemoryError, "Failed in reallocating network structure.");
-                    return NULL;
-                }
-            }
         } else {
             PyErr_SetString(PyExc_TypeError, "Unsupported type.");
-            return NULL;
+            goto failure;
         }
 
-        // store data - address of a pointer to value
+        // store data - address of a pointer to value, the reference is held by values list
         network->data_len = sizeof(PyObject **);
         network->data = malloc(network->data_len);
         if (network->data == NULL) {
             PyErr_SetString(PyExc_MemoryError, "Failed allocating memory for user data.");
-            return NULL;
+            goto failure;
+        }
+        networks_list->net_count++;
+        *((PyObject **) network->data) = value;
+        if (PyList_Append(values, value) != 0) {
+            goto failure;
         }
-        value = PyDict_GetItem((PyObject *) d, key);
-        Py_INCREF(value);
-        PyObject **pv = &value;
-        *((PyObject **) network->data) = *pv;
-
-        i++;
     }
 
-    networks_list->net_count = i;
-    networks_list->networks = networks;
-
+    Py_DECREF(items);
     return networks_list;
+
+failure:
+    Py_DECREF(items);
+    destroy_networks(networks_list);
+    return NULL;
 }
 
 static PyObject *
@@ -130,6 +163,241 @@ UnirecIPList_contains(PyObject *o, PyObject *value)
     return (search_result > 0);
 }
 
+/**
+ * \brief Get array of IP addresses for batch search.
+ *
+ * Addresses are given either by an object supporting the buffer protocol
+ * (bytes, numpy array, column of ipaddr field from recvColumns()) that
+ * contains 16 B UniRec IP addresses, or by a sequence of UnirecIPAddr.
+ *
+ * \param [in] obj    addresses
+ * \param [out] view    buffer of obj, it must be released by PyBuffer_Release() if view->obj is set
+ * \param [out] count    number of addresses
+ * \return pointer to addresses (view->buf or allocated array that must be freed by PyMem_Free()), NULL on error
+ */
+static ip_addr_t *
+UnirecIPList_get_addresses(PyObject *obj, Py_buffer *view, Py_ssize_t *count)
+{
+    ip_addr_t *addrs;
+    Py_ssize_t i;
+
+    view->obj = NULL;
+    if (PyObject_CheckBuffer(obj)) {
+        if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS) != 0) {
+            return NULL;
+        }
+        if (view->len % sizeof(ip_addr_t) != 0) {
+            PyErr_Format(PyExc_TypeError, "Size of buffer must be a multiple of %zu B (UniRec IP address).", sizeof(ip_addr_t));
+            PyBuffer_Release(view);
+            view->obj = NULL;
+            return NULL;
+        }
+        *count = view->len / sizeof(ip_addr_t);
+        return (ip_addr_t *) view->buf;
+    }
+
+    PyObject *seq = PySequence_Fast(obj, "Addresses must be a buffer or a sequence of UnirecIPAddr.");
+    if (seq == NULL) {
+        return NULL;
+    }
+    *count = PySequence_Fast_GET_SIZE(seq);
+    addrs = PyMem_Malloc((*count + 1) * sizeof(ip_addr_t));
+    if (addrs == NULL) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (i = 0; i < *count; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyObject_IsInstance(item, (PyObject *) &pytrap_UnirecIPAddr)) {
+            PyErr_SetString(PyExc_TypeError, "Addresses must be a buffer or a sequence of UnirecIPAddr.");
+            PyMem_Free(addrs);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        memcpy(&addrs[i], &((pytrap_unirecipaddr *) item)->ip, sizeof(ip_addr_t));
+    }
+    Py_DECREF(seq);
+    return addrs;
+}
+
+static void
+UnirecIPList_release_addresses(ip_addr_t *addrs, Py_buffer *view)
+{
+    if (view->obj != NULL) {
+        PyBuffer_Release(view);
+    } else {
+        PyMem_Free(addrs);
+    }
+}
+
+/**
+ * \brief Get value stored for a found address.
+ *
+ * \param [in] data    data array of the interval from ipps_search()
+ * \param [in] count    number of data in the array (result of ipps_search())
+ * \param [in] all    if nonzero, return list of values of all networks that contain the address
+ * \return new reference to value, list of values or None if not found
+ */
+static PyObject *
+UnirecIPList_get_values(void **data, int count, int all)
+{
+    PyObject *value;
+    int i;
+
+    if (count <= 0) {
+        Py_RETURN_NONE;
+    }
+    if (!all) {
+        // see UnirecIPList_find()
+        value = *((PyObject **) data[0]);
+        Py_INCREF(value);
+        return value;
+    }
+    PyObject *result = PyList_New(count);
+    if (result == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        value = *((PyObject **) data[i]);
+        Py_INCREF(value);
+        PyList_SET_ITEM(result, i, value);
+    }
+    return result;
+}
+
+static PyObject *
+UnirecIPList_findAll(PyObject *o, PyObject *args)
+{
+    pytrap_unireciplist *self = (pytrap_unireciplist *) o;
+    pytrap_unirecipaddr *ip;
+    void **data = NULL;
+
+    if (!PyArg_ParseTuple(args, "O!", &pytrap_UnirecIPAddr, &ip)) {
+        return NULL;
+    }
+
+    return UnirecIPList_get_values(data, ipps_search(&ip->ip, self->ipps_ctx, &data), 1);
+}
+
+static PyObject *
+UnirecIPList_findMany(PyObject *o, PyObject *args, PyObject *kwds)
+{
+    pytrap_unireciplist *self = (pytrap_unireciplist *) o;
+    PyObject *addrs_obj, *result, *value;
+    Py_buffer view;
+    ip_addr_t *addrs;
+    Py_ssize_t count, i;
+    void ***found;
+    int *found_cnt;
+    int all = 0;
+
+    static char *kwlist[] = {"addresses", "all", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", kwlist, &addrs_obj, &all)) {
+        return NULL;
+    }
+    addrs = UnirecIPList_get_addresses(addrs_obj, &view, &count);
+    if (addrs == NULL) {
+        return NULL;
+    }
+    found = PyMem_Malloc((count + 1) * sizeof(void **));
+    found_cnt = PyMem_Malloc((count + 1) * sizeof(int));
+    if (found == NULL || found_cnt == NULL) {
+        PyMem_Free(found);
+        PyMem_Free(found_cnt);
+        UnirecIPList_release_addresses(addrs, &view);
+        return PyErr_NoMemory();
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < count; i++) {
+        found_cnt[i] = ipps_search(&addrs[i], self->ipps_ctx, &found[i]);
+    }
+    Py_END_ALLOW_THREADS
+
+    UnirecIPList_release_addresses(addrs, &view);
+
+    result = PyList_New(count);
+    for (i = 0; result != NULL && i < count; i++) {
+        value = UnirecIPList_get_values(found[i], found_cnt[i], all);
+        if (value == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, i, value);
+    }
+    PyMem_Free(found);
+    PyMem_Free(found_cnt);
+    return result;
+}
+
+static PyObject *
+UnirecIPList_matchMany(PyObject *o, PyObject *args, PyObject *kwds)
+{
+    pytrap_unireciplist *self = (pytrap_unireciplist *) o;
+    PyObject *addrs_obj, *out_obj = NULL, *result = NULL;
+    Py_buffer view, out;
+    ip_addr_t *addrs;
+    Py_ssize_t count, i, matched = 0;
+    Py_ssize_t *indices = NULL;
+    char *mask = NULL;
+    void **data;
+
+    static char *kwlist[] = {"addresses", "out", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", kwlist, &addrs_obj, &out_obj)) {
+        return NULL;
+    }
+    addrs = UnirecIPList_get_addresses(addrs_obj, &view, &count);
+    if (addrs == NULL) {
+        return NULL;
+    }
+
+    if (out_obj != NULL && out_obj != Py_None) {
+        if (PyObject_GetBuffer(out_obj, &out, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE) != 0) {
+            goto cleanup;
+        }
+        if (out.itemsize != 1 || out.len < count) {
+            PyErr_Format(PyExc_TypeError, "Argument out must be a writable buffer of at least %zd bytes.", count);
+            PyBuffer_Release(&out);
+            goto cleanup;
+        }
+        mask = out.buf;
+    } else {
+        indices = PyMem_Malloc((count + 1) * sizeof(Py_ssize_t));
+        if (indices == NULL) {
+            PyErr_NoMemory();
+            goto cleanup;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 0; i < count; i++) {
+        int res = ipps_search(&addrs[i], self->ipps_ctx, &data) > 0;
+        if (mask != NULL) {
+            mask[i] = res;
+            matched += res;
+        } else if (res) {
+            indices[matched++] = i;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (mask != NULL) {
+        PyBuffer_Release(&out);
+        result = PyLong_FromSsize_t(matched);
+    } else {
+        result = PyList_New(matched);
+        for (i = 0; result != NULL && i < matched; i++) {
+            PyList_SET_ITEM(result, i, PyLong_FromSsize_t(indices[i]));
+        }
+    }
+
+cleanup:
+    PyMem_Free(indices);
+    UnirecIPList_release_addresses(addrs, &view);
+    return result;
+}
+
 static PyMethodDef pytrap_unireciplist_methods[] = {
     {"find", (PyCFunction) UnirecIPList_find, METH_VARARGS,
         "Find an IP address in the list and get stored value.\n\n"
@@ -137,11 +405,50 @@ static PyMethodDef pytrap_unireciplist_methods[] = {
         "    object: None if the value was not found.\n"
         },
 
+    {"findAll", (PyCFunction) UnirecIPList_findAll, METH_VARARGS,
+        "Find an IP address in the list and get values of all networks that contain it.\n\n"
+        "Values are ordered by network address, the larger of networks with\n"
+        "the same address first.\n\n"
+        "Returns:\n"
+        "    list(object): None if the value was not found.\n"
+        },
+
+    {"findMany", (PyCFunction) UnirecIPList_findMany, METH_VARARGS | METH_KEYWORDS,
+        "Find many IP addresses in the list and get stored values.\n\n"
+        "The search runs without the GIL.\n\n"
+        "Args:\n"
+        "    addresses (buffer or list(UnirecIPAddr)): Buffer of 16 B UniRec IP addresses\n"
+        "        (e.g. bytes or column of ipaddr field filled by TrapCtx.recvColumns())\n"
+        "        or a sequence of UnirecIPAddr.\n"
+        "    all (Optional[bool]): Get list of values of all matching networks as findAll() does (default False).\n\n"
+        "Returns:\n"
+        "    list(object): Stored value for every address, None if it was not found.\n"
+        },
+
+    {"matchMany", (PyCFunction) UnirecIPList_matchMany, METH_VARARGS | METH_KEYWORDS,
+        "Find many IP addresses in the list and get indices of the matching ones.\n\n"
+        "The search runs without the GIL.\n\n"
+        "Args:\n"
+        "    addresses (buffer or list(UnirecIPAddr)): Buffer of 16 B UniRec IP addresses\n"
+        "        or a sequence of UnirecIPAddr, see findMany().\n"
+        "    out (Optional[buffer]): Writable buffer (e.g. numpy bool array) that is filled\n"
+        "        by 1 for matching and 0 for not matching addresses.\n\n"
+        "Returns:\n"
+        "    list(int) or int: Indices of matching addresses, or number of matching\n"
+        "        addresses if out was given.\n"
+        },
+
     {NULL, NULL, 0, NULL}
 };
 
+static Py_ssize_t
+UnirecIPList_len(pytrap_unireciplist *self)
+{
+    return self->ipps_ctx ? self->ipps_ctx->v4_count + self->ipps_ctx->v6_count : 0;
+}
+
 static PySequenceMethods UnirecIPList_seqmethods = {
-    0, /* lenfunc sq_length; */
+    (lenfunc) UnirecIPList_len, /* lenfunc sq_length; */
     0, /* binaryfunc sq_concat; */
     0, /* ssizeargfunc sq_repeat; */
     0, /* ssizeargfunc sq_item; */
@@ -153,47 +460,46 @@ static PySequenceMethods UnirecIPList_seqmethods = {
     0 /* ssizeargfunc sq_inplace_repeat; */
 };
 
-static void
-destroy_networks(ipps_network_list_t *network_list) {
-    uint32_t index;
-    for (index = 0; index < network_list->net_count; index++) {
-        free(network_list->networks[index].data);
-    }
-
-    free(network_list->networks);
-    free(network_list);
-}
-
 int
 UnirecIPList_init(pytrap_unireciplist *s, PyObject *args, PyObject *kwds)
 {
     if (s == NULL) {
         return -1;
     }
-    PyDictObject *dict = NULL;
-    if (!PyArg_ParseTuple(args, "O!", &PyDict_Type, &dict)) {
+    PyObject *networks = NULL;
+    if (!PyArg_ParseTuple(args, "O", &networks)) {
         return -1;
     }
 
-    Py_ssize_t len = PyDict_Size((PyObject *) dict);
-    if (len == 0) {
+    Py_ssize_t len = PyObject_Length(networks);
+    if (len < 0) {
+        return -1;
+    } else if (len == 0) {
         PyErr_SetString(PyExc_ValueError, "Empty dictionary is not supported.");
         return -1;
     }
 
-    ipps_network_list_t *network_list = load_networks(dict);
+    PyObject *values = PyList_New(0);
+    if (values == NULL) {
+        return -1;
+    }
+    ipps_network_list_t *network_list = load_networks(networks, values);
     if (network_list == NULL) {
         // Exception was set by load_networks
+        Py_DECREF(values);
         return -1;
     }
 
     s->ipps_ctx = ipps_init(network_list);
+    destroy_networks(network_list);
 
     if (s->ipps_ctx == NULL) {
+        Py_DECREF(values);
         PyErr_SetString(PyExc_TypeError, "Init of ip_prefix_search module failed.");
         return -1;
     }
-    destroy_networks(network_list);
+    Py_XDECREF(s->values);
+    s->values = values;
 
     return 0;
 }
@@ -269,26 +575,11 @@ UnirecIPList_str(pytrap_unireciplist *self)
 
 static void UnirecIPList_dealloc(pytrap_unireciplist *self)
 {
-    uint32_t index;
     if (self->ipps_ctx) {
-        /* Remove IPv4 user data */
-        for (index = 0; index < self->ipps_ctx->v4_count; ++index)
-        {
-            if (self->ipps_ctx->v4_prefix_intervals && self->ipps_ctx->v4_prefix_intervals[index].data_array) {
-                PyObject **p = (PyObject **) self->ipps_ctx->v4_prefix_intervals[index].data_array[0];
-                Py_XDECREF(*p);
-            }
-        }
-        /* Remove IPv6 user data */
-        for (index = 0; index < self->ipps_ctx->v6_count; ++index)
-        {
-            if (self->ipps_ctx->v6_prefix_intervals && self->ipps_ctx->v6_prefix_intervals[index].data_array) {
-                PyObject **p = (PyObject **) self->ipps_ctx->v6_prefix_intervals[index].data_array[0];
-                Py_XDECREF(*p);
-            }
-        }
         ipps_destroy(self->ipps_ctx);
     }
+    /* user data */
+    Py_XDECREF(self->values);
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
@@ -341,7 +632,9 @@ PyTypeObject pytrap_UnirecIPList = {
         Py_TPFLAGS_BASETYPE,   /* tp_flags */
     "UnirecIPList(dict)\n"
     "    Class for list of UniRec IP Address Ranges that allows look-up.\n"
-    "    The list is created from a dictionary with UnirecIPAddrRange as key and any object as value.\n"
+    "    The list is created from a dictionary with UnirecIPAddrRange as key and any object as value,\n"
+    "    or from a sequence of (UnirecIPAddrRange, object) pairs, which may contain the same range more times.\n"
+    "    Overlapping ranges are split into disjoint intervals, len() returns the number of the intervals.\n"
     "    After initialization, find() or __contains__() can be used to find UnirecIPAddr in the list.\n\n"
     "    Example:\n"
     "    >>> import pytrap\n"
@@ -355,7 +648,7 @@ PyTypeObject pytrap_UnirecIPList = {
     "    >>> print(iplist.find(pytrap.UnirecIPAddr(\"10.0.0.1\")))\n"
     "    None\n\n"
     "    Args:\n"
-    "        dict(UnirecIPAddrRange: object): dictionary with IP range as key and any object as value\n", /* tp_doc */
+    "        dict(UnirecIPAddrRange: object) or list((UnirecIPAddrRange, object)): IP ranges with any object as value\n", /* tp_doc */
     0,                         /* tp_traverse */
     0,                         /* tp_clear */
     (richcmpfunc) UnirecIPList_compare, /* tp_richcompare */
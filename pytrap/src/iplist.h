@@ -9,6 +9,7 @@ extern "C" {
 typedef struct {
     PyObject_HEAD
     ipps_context_t *ipps_ctx;
+    PyObject *values; /* references of user data */
 } pytrap_unireciplist;
 
 PyAPI_DATA(PyTypeObject) pytrap_UnirecIPList;
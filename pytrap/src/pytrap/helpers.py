@@ -1,6 +1,134 @@
 import pytrap
 
-def read_nemea(ifc_spec, nrows=-1, array=False):
+# numpy types of fixed-size UniRec fields, ipaddr, macaddr and time are kept raw
+NUMPY_TYPES = {
+    "char": "S1",
+    "uint8": "u1",
+    "int8": "i1",
+    "uint16": "u2",
+    "int16": "i2",
+    "uint32": "u4",
+    "int32": "i4",
+    "uint64": "u8",
+    "int64": "i8",
+    "float": "f4",
+    "double": "f8",
+    "ipaddr": "V16",
+    "macaddr": "V6",
+    "time": "u8",
+}
+
+def time_to_datetime64(column):
+    """
+    Convert numpy array of raw UniRec timestamps (uint64) into numpy.datetime64[ns].
+
+    Args:
+        column (numpy.ndarray): Raw UniRec timestamps, e.g., from read_nemea_columns().
+
+    Returns:
+        numpy.ndarray: Array of numpy.datetime64[ns].
+    """
+    import numpy as np
+    column = np.asarray(column, dtype=np.uint64)
+    sec = column >> np.uint64(32)
+    frac = ((column & np.uint64(0xFFFFFFFF)) * np.uint64(1000000000)) >> np.uint64(32)
+    return (sec * np.uint64(1000000000) + frac).astype("datetime64[ns]")
+
+def _raw_to_ipaddr(raw):
+    import socket
+    raw = bytes(raw)
+    if raw[:8] == bytes(8) and raw[12:] == b"\xff\xff\xff\xff":
+        return pytrap.UnirecIPAddr(socket.inet_ntop(socket.AF_INET, raw[8:12]))
+    return pytrap.UnirecIPAddr(socket.inet_ntop(socket.AF_INET6, raw))
+
+def _raw_to_macaddr(raw):
+    return pytrap.UnirecMACAddr(":".join("%02x" % b for b in bytes(raw)))
+
+def read_nemea_columns(ifc_spec, nrows=-1, chunk_size=65536, convert=False):
+    """
+    Read `nrows` records from NEMEA TRAP interface given by `ifc_spec` into numpy arrays, one per UniRec field.
+
+    Values of fixed-size fields are copied into the arrays in C (see
+    TrapCtx.recvColumns()), no Python object is created per record.  Types
+    of arrays are given by NUMPY_TYPES: ipaddr is stored as raw 16 B
+    (numpy.void), macaddr as raw 6 B and time as raw uint64 (see
+    time_to_datetime64()).  Variable-size fields are returned as lists.
+
+    Example:
+        >>> import pytrap
+        >>> cols = pytrap.read_nemea_columns("f:/tmp/testunirechelper")
+        >>> cols["SRC_PORT"]
+        array([0, 1, 2, 3, 4, 5, 6, 7, 8, 9], dtype=uint16)
+
+    Args:
+        ifc_spec (str): IFC specifier for TRAP input IFC, see https://nemea.liberouter.org/trap-ifcspec/
+        nrows (int): Number of records, read until end of stream (zero size message) if -1.
+        chunk_size (int): Number of records received into preallocated arrays at once.
+        convert (bool): Convert time fields to numpy.datetime64[ns] and ipaddr, macaddr
+            fields to lists of UnirecIPAddr, UnirecMACAddr.
+
+    Returns:
+        dict(str, numpy.ndarray or list): Columns indexed by field names.
+
+    Raises:
+        ModuleNotFoundError: When numpy is not installed.
+    """
+    import numpy as np
+    c = pytrap.TrapCtx()
+    c.init(["-i", ifc_spec], 1, 0)
+    c.setRequiredFmt(0)
+    result = dict()
+    try:
+        if nrows == 0:
+            return result
+        try:
+            data = c.recv()
+            fmttype, fmtspec = c.getDataFmt(0)
+        except pytrap.FormatChanged as e:
+            fmttype, fmtspec = c.getDataFmt(0)
+            data = e.data
+        fields = [f.split(" ") for f in fmtspec.split(",")] if fmtspec else []
+        fixed = {name: NUMPY_TYPES[ftype] for ftype, name in fields if ftype in NUMPY_TYPES}
+        varlen = {name: [] for ftype, name in fields if ftype not in NUMPY_TYPES}
+        chunks = {name: [] for name in fixed}
+        if len(data) > 1:
+            rec = pytrap.UnirecTemplate(fmtspec)
+            rec.setData(data)
+            offset = 1
+            done = False
+            while not done:
+                size = chunk_size if nrows < 0 else min(chunk_size, nrows)
+                cols = {name: np.empty(size, dtype=t) for name, t in fixed.items()}
+                cols.update(varlen)
+                if offset:
+                    rec.storeColumns(cols, 0)
+                    if nrows > 0:
+                        nrows = nrows - 1
+                want = size - offset
+                got = c.recvColumns(rec, cols, want, offset=offset) if want > 0 else 0
+                for name in fixed:
+                    chunks[name].append(cols[name][:offset + got])
+                if nrows > 0:
+                    nrows = nrows - got
+                done = got < want or nrows == 0
+                offset = 0
+        for ftype, name in fields:
+            if name in varlen:
+                result[name] = varlen[name]
+                continue
+            col = np.concatenate(chunks[name]) if chunks[name] else np.empty(0, dtype=fixed[name])
+            if convert and ftype == "time":
+                col = time_to_datetime64(col)
+            elif convert and ftype == "ipaddr":
+                col = [_raw_to_ipaddr(v) for v in col]
+            elif convert and ftype == "macaddr":
+                col = [_raw_to_macaddr(v) for v in col]
+            result[name] = col
+        return result
+    finally:
+        c.finalize()
+
+def read_nemea(ifc_spec, nrows=-1, array=False, columnar=False):
     """
     Read `nrows` records from NEMEA TRAP interface given by `ifc_spec` and convert then into Pandas DataFrame.
 
@@ -13,6 +141,10 @@ def read_nemea(ifc_spec, nrows=-1, array=False):
         ifc_spec (str): IFC specifier for TRAP input IFC, see https://nemea.liberouter.org/trap-ifcspec/
         nrows (int): Number of records, read until end of stream (zero size message) if -1.
         array (bool): Set output type to list of dictionary instead of pandas.DataFrame
+        columnar (bool): Build the DataFrame from columns received by read_nemea_columns(),
+            which is much faster for large data.  Numeric fields keep their numpy types,
+            time fields are converted to datetime64[ns], ipaddr and macaddr fields
+            are converted to UnirecIPAddr and UnirecMACAddr.
 
     Returns:
         pandas.DataFrame or list of dictionary: DataFrame if array is False, otherwise, list of dictionary
@@ -20,6 +152,10 @@ def read_nemea(ifc_spec, nrows=-1, array=False):
     Raises:
         ModuleNotFoundError: When pandas is not installed.
     """
+    if columnar and not array:
+        import pandas as pd
+        return pd.DataFrame(read_nemea_columns(ifc_spec, nrows, convert=True))
+
     c = pytrap.TrapCtx()
     c.init(["-i", ifc_spec], 1, 0)
     c.setRequiredFmt(0)
@@ -9,6 +9,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <time.h>
+#include <pthread.h>
 
 #include "pytrapexceptions.h"
 #include "unirectemplate.h"
@@ -31,14 +32,407 @@ static ur_template_t *in_tmplt = NULL;
 
 extern void *trap_glob_ctx;
 
+/** Minimal size of prefetch queue in bytes, it must hold at least two messages of maximal size */
+#define PREFETCH_MIN_SIZE (256 * 1024)
+
+/** Default size of prefetch queue in bytes */
+#define PREFETCH_DEFAULT_SIZE (4 * 1024 * 1024)
+
+/** Status of the entry that fills the end of the queue, the next entry is at the beginning */
+#define PREFETCH_WRAP -1
+
+#define PREFETCH_ALIGN(x) (((x) + 7) & ~((size_t) 7))
+
+/**
+ * Header of a message stored in prefetch queue, the message follows the header.
+ * Entries with TRAP_E_FORMAT_CHANGED carry also the new data format, its
+ * specifier follows the message.
+ */
+typedef struct {
+    uint32_t len;       /**< Length of the whole entry (aligned) */
+    int16_t status;     /**< Return value of trap_ctx_recv() */
+    uint16_t size;      /**< Size of the message */
+    uint32_t spec_size; /**< Size of data format specifier including terminating zero, 0 if not stored */
+    uint8_t data_type;  /**< Data format type (TRAP_FMT_*) */
+} pytrap_prefetch_entry;
+
+/**
+ * Background thread receiving messages of one input IFC into a bounded ring buffer.
+ */
+typedef struct {
+    trap_ctx_t *trap;
+    uint32_t ifcidx;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond_data;  /**< Signaled when an entry was added or the thread finished */
+    pthread_cond_t cond_space; /**< Signaled when an entry was read */
+    char *buffer;
+    size_t size;
+    size_t head;   /**< Position of the next written entry */
+    size_t tail;   /**< Position of the next read entry */
+    size_t used;   /**< Number of used bytes including the entry held by the reader */
+    size_t held;   /**< Length of the entry returned by the last read, it is released by the next read */
+    char running;
+    char stop;
+    char timeout_pending;
+    int status;    /**< Error that finished the thread */
+    uint8_t data_type; /**< Data format of the last read message, owned by the reader */
+    char *data_fmt_spec;
+    uint64_t messages;
+    uint64_t full_waits;
+} pytrap_prefetch;
+
 typedef struct {
     PyObject_HEAD
     /**
      * Libtrap context
      */
     trap_ctx_t *trap;
+    /**
+     * Number of input IFCs
+     */
+    uint32_t ifcin;
+    /**
+     * Prefetching threads indexed by input IFC, NULL when prefetching was not started
+     */
+    pytrap_prefetch **prefetch;
 } pytrap_trapcontext;
 
+/**
+ * Store entry into prefetch queue, wait for free space if the queue is full.
+ * It must be called with locked pf->lock.
+ *
+ * \param[in] spec  Data format specifier stored with the message, NULL if the format did not change.
+ * \return 1 on success, 0 when the thread was stopped.
+ */
+static int
+pytrap_prefetch_push(pytrap_prefetch *pf, int status, const void *data, uint16_t size,
+                     uint8_t data_type, const char *spec)
+{
+    size_t spec_size = spec != NULL ? strlen(spec) + 1 : 0;
+    size_t len = PREFETCH_ALIGN(sizeof(pytrap_prefetch_entry) + size + spec_size);
+    size_t pad;
+    char waited = 0;
+    pytrap_prefetch_entry *e;
+
+    while (1) {
+        /* entries are contiguous, skip the end of buffer if the entry does not fit */
+        pad = (pf->head + len > pf->size) ? pf->size - pf->head : 0;
+        if (pf->stop || pf->used + pad + len <= pf->size) {
+            break;
+        }
+        if (!waited) {
+            pf->full_waits++;
+            waited = 1;
+        }
+        pthread_cond_wait(&pf->cond_space, &pf->lock);
+    }
+    if (pf->stop) {
+        return 0;
+    }
+
+    if (pad > 0) {
+        e = (pytrap_prefetch_entry *) (pf->buffer + pf->head);
+        e->len = pad;
+        e->status = PREFETCH_WRAP;
+        pf->used += pad;
+        pf->head = 0;
+    }
+    e = (pytrap_prefetch_entry *) (pf->buffer + pf->head);
+    e->len = len;
+    e->status = status;
+    e->size = size;
+    e->spec_size = spec_size;
+    e->data_type = data_type;
+    memcpy(e + 1, data, size);
+    if (spec_size > 0) {
+        memcpy((char *) (e + 1) + size, spec, spec_size);
+    }
+    pf->head = (pf->head + len) % pf->size;
+    pf->used += len;
+    if (status != TRAP_E_TIMEOUT) {
+        pf->messages++;
+    }
+    pthread_cond_signal(&pf->cond_data);
+    return 1;
+}
+
+static void *
+pytrap_prefetch_thread(void *arg)
+{
+    pytrap_prefetch *pf = (pytrap_prefetch *) arg;
+    const void *data;
+    uint16_t size;
+    int ret;
+
+    while (1) {
+        ret = trap_ctx_recv(pf->trap, pf->ifcidx, &data, &size);
+
+        pthread_mutex_lock(&pf->lock);
+        if (pf->stop) {
+            pf->status = TRAP_E_TERMINATED;
+            break;
+        }
+        if (ret == TRAP_E_TIMEOUT) {
+            if (pf->used == pf->held) {
+                /* nothing is prefetched, pass the timeout to the reader and wait until it is read */
+                pytrap_prefetch_push(pf, TRAP_E_TIMEOUT, NULL, 0, 0, NULL);
+                pf->timeout_pending = 1;
+                while (pf->timeout_pending && !pf->stop) {
+                    pthread_cond_wait(&pf->cond_space, &pf->lock);
+                }
+                pthread_mutex_unlock(&pf->lock);
+            } else {
+                /* the reader is busy, avoid busy waiting with TRAP_NO_WAIT */
+                pthread_mutex_unlock(&pf->lock);
+                usleep(1000);
+            }
+            continue;
+        } else if (ret != TRAP_E_OK && ret != TRAP_E_FORMAT_CHANGED) {
+            pf->status = ret;
+            break;
+        }
+        if (ret == TRAP_E_FORMAT_CHANGED) {
+            /* the reader must not access the IFC, it may be already receiving a newer format */
+            uint8_t data_type = TRAP_FMT_UNKNOWN;
+            const char *spec = NULL;
+            trap_ctx_get_data_fmt(pf->trap, TRAPIFC_INPUT, pf->ifcidx, &data_type, &spec);
+            pytrap_prefetch_push(pf, ret, data, size, data_type, spec != NULL ? spec : "");
+        } else {
+            pytrap_prefetch_push(pf, ret, data, size, 0, NULL);
+        }
+        pthread_mutex_unlock(&pf->lock);
+    }
+
+    pf->running = 0;
+    pthread_cond_broadcast(&pf->cond_data);
+    pthread_mutex_unlock(&pf->lock);
+    return NULL;
+}
+
+/**
+ * Get the next prefetched message, the same semantics as trap_ctx_recv(),
+ * i.e. data are valid until the next call. It must be called without GIL.
+ */
+static int
+pytrap_prefetch_recv(pytrap_prefetch *pf, const void **data, uint16_t *size)
+{
+    pytrap_prefetch_entry *e;
+    int status;
+
+    pthread_mutex_lock(&pf->lock);
+    if (pf->held > 0) {
+        pf->tail = (pf->tail + pf->held) % pf->size;
+        pf->used -= pf->held;
+        pf->held = 0;
+        pthread_cond_signal(&pf->cond_space);
+    }
+    while (1) {
+        while (pf->used == 0 && pf->running) {
+            pthread_cond_wait(&pf->cond_data, &pf->lock);
+        }
+        if (pf->used == 0) {
+            /* thread finished and everything was read */
+            status = pf->status;
+            pthread_mutex_unlock(&pf->lock);
+            return status;
+        }
+        e = (pytrap_prefetch_entry *) (pf->buffer + pf->tail);
+        if (e->status != PREFETCH_WRAP) {
+            break;
+        }
+        pf->used -= e->len;
+        pf->tail = 0;
+        pthread_cond_signal(&pf->cond_space);
+    }
+
+    *data = e + 1;
+    *size = e->size;
+    status = e->status;
+    pf->held = e->len;
+    if (e->spec_size > 0) {
+        char *spec = strdup((char *) (e + 1) + e->size);
+        if (spec == NULL) {
+            status = TRAP_E_MEMORY;
+        } else {
+            free(pf->data_fmt_spec);
+            pf->data_fmt_spec = spec;
+            pf->data_type = e->data_type;
+        }
+    }
+    if (status == TRAP_E_TIMEOUT) {
+        pf->timeout_pending = 0;
+        pthread_cond_signal(&pf->cond_space);
+    }
+    pthread_mutex_unlock(&pf->lock);
+    return status;
+}
+
+/**
+ * Receive message from input IFC, either from prefetch queue or directly by trap_ctx_recv().
+ * It must be called without GIL.
+ */
+static inline int
+pytrap_ctx_recv(pytrap_trapcontext *self, uint32_t ifcidx, const void **data, uint16_t *size)
+{
+    if (self->prefetch != NULL && ifcidx < self->ifcin && self->prefetch[ifcidx] != NULL) {
+        return pytrap_prefetch_recv(self->prefetch[ifcidx], data, size);
+    }
+    return trap_ctx_recv(self->trap, ifcidx, data, size);
+}
+
+/**
+ * Get data format of input IFC. With prefetching, it is the format of the
+ * last message read from prefetch queue, not of the last received one.
+ */
+static int
+pytrap_ctx_get_data_fmt(pytrap_trapcontext *self, uint32_t ifcidx, uint8_t *data_type, const char **spec)
+{
+    pytrap_prefetch *pf;
+
+    if (self->prefetch != NULL && ifcidx < self->ifcin && (pf = self->prefetch[ifcidx]) != NULL) {
+        if (pf->data_fmt_spec == NULL) {
+            /* no message was read yet */
+            return TRAP_E_NOT_INITIALIZED;
+        }
+        *data_type = pf->data_type;
+        *spec = pf->data_fmt_spec;
+        return TRAP_E_OK;
+    }
+    return trap_ctx_get_data_fmt(self->trap, TRAPIFC_INPUT, ifcidx, data_type, spec);
+}
+
+/**
+ * Stop and free all prefetching threads, the context is terminated to interrupt blocking receive.
+ */
+static void
+pytrap_prefetch_stop_all(pytrap_trapcontext *self)
+{
+    uint32_t i;
+    pytrap_prefetch *pf;
+
+    if (self->prefetch == NULL) {
+        return;
+    }
+    for (i = 0; i < self->ifcin; i++) {
+        if ((pf = self->prefetch[i]) != NULL) {
+            pthread_mutex_lock(&pf->lock);
+            pf->stop = 1;
+            pthread_cond_broadcast(&pf->cond_space);
+            pthread_mutex_unlock(&pf->lock);
+        }
+    }
+    trap_ctx_terminate(self->trap);
+    for (i = 0; i < self->ifcin; i++) {
+        if ((pf = self->prefetch[i]) != NULL) {
+            Py_BEGIN_ALLOW_THREADS
+            pthread_join(pf->thread, NULL);
+            Py_END_ALLOW_THREADS
+            pthread_cond_destroy(&pf->cond_data);
+            pthread_cond_destroy(&pf->cond_space);
+            pthread_mutex_destroy(&pf->lock);
+            free(pf->buffer);
+            free(pf->data_fmt_spec);
+            free(pf);
+        }
+    }
+    free(self->prefetch);
+    self->prefetch = NULL;
+}
+
+static PyObject *
+pytrap_startPrefetch(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
+{
+    uint32_t ifcidx = 0;
+    Py_ssize_t size = PREFETCH_DEFAULT_SIZE;
+    pytrap_prefetch *pf;
+
+    static char *kwlist[] = {"ifcidx", "size", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|In", kwlist, &ifcidx, &size)) {
+        return NULL;
+    }
+    if (self->trap == NULL) {
+        PyErr_SetString(TrapError, "TrapCtx is not initialized.");
+        return NULL;
+    }
+    if (ifcidx >= self->ifcin) {
+        PyErr_SetString(TrapError, "Bad index of IFC.");
+        return NULL;
+    }
+    if (size < PREFETCH_MIN_SIZE) {
+        PyErr_Format(PyExc_ValueError, "Size of prefetch queue must be at least %d B.", PREFETCH_MIN_SIZE);
+        return NULL;
+    }
+    if (self->prefetch == NULL) {
+        self->prefetch = calloc(self->ifcin, sizeof(pytrap_prefetch *));
+        if (self->prefetch == NULL) {
+            return PyErr_NoMemory();
+        }
+    }
+    if (self->prefetch[ifcidx] != NULL) {
+        PyErr_SetString(TrapError, "Prefetching was already started.");
+        return NULL;
+    }
+
+    pf = calloc(1, sizeof(pytrap_prefetch));
+    if (pf == NULL) {
+        return PyErr_NoMemory();
+    }
+    pf->trap = self->trap;
+    pf->ifcidx = ifcidx;
+    pf->size = size & ~((size_t) 7);
+    pf->buffer = malloc(pf->size);
+    if (pf->buffer == NULL) {
+        free(pf);
+        return PyErr_NoMemory();
+    }
+    pthread_mutex_init(&pf->lock, NULL);
+    pthread_cond_init(&pf->cond_data, NULL);
+    pthread_cond_init(&pf->cond_space, NULL);
+    pf->status = TRAP_E_OK;
+    pf->running = 1;
+    if (pthread_create(&pf->thread, NULL, pytrap_prefetch_thread, pf) != 0) {
+        pthread_cond_destroy(&pf->cond_data);
+        pthread_cond_destroy(&pf->cond_space);
+        pthread_mutex_destroy(&pf->lock);
+        free(pf->buffer);
+        free(pf);
+        PyErr_SetString(TrapError, "Could not start prefetching thread.");
+        return NULL;
+    }
+    self->prefetch[ifcidx] = pf;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+pytrap_getPrefetchStats(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
+{
+    uint32_t ifcidx = 0;
+    pytrap_prefetch *pf;
+    PyObject *result;
+
+    static char *kwlist[] = {"ifcidx", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|I", kwlist, &ifcidx)) {
+        return NULL;
+    }
+    if (self->prefetch == NULL || ifcidx >= self->ifcin || self->prefetch[ifcidx] == NULL) {
+        PyErr_SetString(TrapError, "Prefetching was not started.");
+        return NULL;
+    }
+    pf = self->prefetch[ifcidx];
+
+    pthread_mutex_lock(&pf->lock);
+    result = Py_BuildValue("{s:K,s:n,s:n,s:K,s:O}",
+                           "messages", (unsigned long long) pf->messages,
+                           "queue_used", (Py_ssize_t) pf->used,
+                           "queue_size", (Py_ssize_t) pf->size,
+                           "full_waits", (unsigned long long) pf->full_waits,
+                           "running", pf->running ? Py_True : Py_False);
+    pthread_mutex_unlock(&pf->lock);
+    return result;
+}
+
 static PyObject *
 pytrap_init(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 {
@@ -125,6 +519,8 @@ pytrap_init(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
         service_ifcname = NULL;
     }
 
+    self->ifcin = ifcin;
+    self->prefetch = NULL;
     self->trap = trap_ctx_init3(module_name,
                                 module_desc,
                                 ifcin, ifcout,
@@ -198,9 +594,10 @@ pytrap_recv(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
     uint16_t in_rec_size;
     PyObject *data;
     PyObject *attr;
+    int zerocopy = 0;
 
-    static char *kwlist[] = {"ifcidx", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|I", kwlist, &ifcidx)) {
+    static char *kwlist[] = {"ifcidx", "zerocopy", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "|Ip", kwlist, &ifcidx, &zerocopy)) {
         return NULL;
     }
     if (self->trap == NULL) {
@@ -210,7 +607,7 @@ pytrap_recv(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 
     int ret;
     Py_BEGIN_ALLOW_THREADS
-    ret = trap_ctx_recv(self->trap, ifcidx, &in_rec, &in_rec_size);
+    ret = pytrap_ctx_recv(self, ifcidx, &in_rec, &in_rec_size);
     Py_END_ALLOW_THREADS
 
     if (ret == TRAP_E_TIMEOUT) {
@@ -228,8 +625,14 @@ pytrap_recv(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
     } else if (ret == TRAP_E_NOT_INITIALIZED) {
         PyErr_SetString(TrapError, "TrapCtx is not initialized.");
         return NULL;
+    } else if (ret == TRAP_E_MEMORY) {
+        return PyErr_NoMemory();
     }
 
+    if (zerocopy && ret != TRAP_E_FORMAT_CHANGED) {
+        /* read-only view of the libtrap buffer, valid until the next recv() */
+        return PyMemoryView_FromMemory((char *) in_rec, in_rec_size, PyBUF_READ);
+    }
     data = PyByteArray_FromStringAndSize(in_rec, in_rec_size);
     if (ret == TRAP_E_FORMAT_CHANGED) {
         attr = Py_BuildValue("s", "data");
@@ -298,6 +701,75 @@ pytrap_sendBulk(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+pytrap_sendColumns(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
+{
+    uint32_t ifcidx = 0;
+    Py_ssize_t count = -1, ncols = 0, sent = 0;
+    int ret = TRAP_E_OK, size = 0;
+    PyObject *columns;
+    pytrap_column *cols;
+    pytrap_unirectemplate *pyurtempl = NULL;
+    char *rec;
+
+    if (self->trap == NULL) {
+        PyErr_SetString(TrapError, "TrapCtx is not initialized.");
+        return NULL;
+    }
+
+    static char *kwlist[] = {"urtempl", "columns", "count", "ifcidx", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!O!|nI", kwlist, &pytrap_UnirecTemplate, &pyurtempl,
+                                     &PyDict_Type, &columns, &count, &ifcidx)) {
+        return NULL;
+    }
+
+    cols = UnirecTemplate_columnsInitSend(pyurtempl, columns, &count, &ncols);
+    if (cols == NULL) {
+        return NULL;
+    }
+    rec = PyMem_Malloc(UR_MAX_SIZE);
+    if (rec == NULL) {
+        UnirecTemplate_columnsRelease(cols, ncols);
+        return PyErr_NoMemory();
+    }
+
+    /* records are packed and sent without GIL */
+    Py_BEGIN_ALLOW_THREADS
+    for (sent = 0; sent < count; sent++) {
+        size = UnirecTemplate_columnsLoad(pyurtempl, cols, ncols, rec, sent);
+        if (size < 0) {
+            break;
+        }
+        ret = trap_ctx_send(self->trap, ifcidx, rec, (uint16_t) size);
+        if (ret != TRAP_E_OK) {
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    PyMem_Free(rec);
+    UnirecTemplate_columnsRelease(cols, ncols);
+
+    if (size < 0) {
+        PyErr_Format(TrapError, "Bad offsets or size of record %zd.", sent);
+        return NULL;
+    } else if (ret == TRAP_E_TIMEOUT) {
+        PyErr_SetString(TimeoutError, "Timeout");
+        return NULL;
+    } else if (ret == TRAP_E_BAD_IFC_INDEX) {
+        PyErr_SetString(TrapError, "Bad index of IFC.");
+        return NULL;
+    } else if (ret == TRAP_E_TERMINATED) {
+        PyErr_SetString(TrapTerminated, "IFC was terminated.");
+        return NULL;
+    } else if (ret != TRAP_E_OK) {
+        PyErr_Format(TrapError, "Sending failed: %s", trap_ctx_get_last_error_msg(self->trap));
+        return NULL;
+    }
+
+    return PyLong_FromSsize_t(sent);
+}
+
 static PyObject *
 pytrap_recvBulk(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 {
@@ -332,7 +804,7 @@ pytrap_recvBulk(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 
     while (endtime > time(NULL) && count != 0) {
         Py_BEGIN_ALLOW_THREADS
-        ret = trap_ctx_recv(self->trap, ifcidx, &in_rec, &in_rec_size);
+        ret = pytrap_ctx_recv(self, ifcidx, &in_rec, &in_rec_size);
         Py_END_ALLOW_THREADS
 
         if (ret == TRAP_E_TIMEOUT || ret == TRAP_E_TERMINATED) {
@@ -344,11 +816,14 @@ pytrap_recvBulk(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
         } else if (ret == TRAP_E_FORMAT_MISMATCH) {
             PyErr_SetString(TrapError, "Connection to incompatible IFC - format mismatch.");
             goto error_cleanup;
+        } else if (ret == TRAP_E_MEMORY) {
+            PyErr_NoMemory();
+            goto error_cleanup;
         } else if (ret == TRAP_E_FORMAT_CHANGED) {
             // recreate UnirecTemplate
             const char *spec;
             uint8_t data_type;
-            trap_ctx_get_data_fmt(self->trap, TRAPIFC_INPUT, ifcidx, &data_type, &spec);
+            pytrap_ctx_get_data_fmt(self, ifcidx, &data_type, &spec);
             pyurtempl->urtmplt = ur_define_fields_and_update_template(spec, pyurtempl->urtmplt);
             if (pyurtempl->urtmplt == NULL) {
                 PyErr_SetString(TrapError, "Creation of UniRec template failed.");
@@ -364,13 +839,18 @@ pytrap_recvBulk(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
             count--;
         }
 
-        // setData()
+        // setData() without copy, the dict is created from the libtrap buffer
         pyurtempl->data = (void *) in_rec;
         pyurtempl->data_size = in_rec_size;
+        pyurtempl->data_readonly = 1;
         if (pyurtempl->data_obj != NULL) {
             Py_DECREF(pyurtempl->data_obj);
         }
-        pyurtempl->data_obj = PyByteArray_FromStringAndSize(in_rec, in_rec_size);;
+        pyurtempl->data_obj = PyMemoryView_FromMemory((char *) in_rec, in_rec_size, PyBUF_READ);
+        if (pyurtempl->data_obj == NULL) {
+            pyurtempl->data = NULL;
+            goto error_cleanup;
+        }
 
         // Convert to dictionary
         pydict = UnirecTemplate_getDict(pyurtempl);
@@ -394,6 +874,110 @@ error_cleanup:
     return NULL;
 }
 
+static PyObject *
+pytrap_recvColumns(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
+{
+    uint32_t ifcidx = 0;
+    // time (in seconds) to interrupt capturing, 0 means no limit
+    uint32_t timeout = 0;
+    Py_ssize_t count, offset = 0, stored = 0, ncols = 0;
+    int has_varlen = 0, ret = TRAP_E_OK, failed = 0;
+    const void *in_rec;
+    uint16_t in_rec_size;
+    PyObject *columns;
+    pytrap_column *cols;
+    pytrap_unirectemplate *pyurtempl = NULL;
+
+    if (self->trap == NULL) {
+        PyErr_SetString(TrapError, "TrapCtx is not initialized.");
+        return NULL;
+    }
+
+    static char *kwlist[] = {"urtempl", "columns", "count", "offset", "time", "ifcidx", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O!O!n|nII", kwlist, &pytrap_UnirecTemplate, &pyurtempl,
+                                     &PyDict_Type, &columns, &count, &offset, &timeout, &ifcidx)) {
+        return NULL;
+    }
+    if (count < 0 || offset < 0) {
+        PyErr_SetString(PyExc_IndexError, "count and offset must not be negative.");
+        return NULL;
+    }
+
+    cols = UnirecTemplate_columnsInit(pyurtempl, columns, offset + count, &ncols, &has_varlen);
+    if (cols == NULL) {
+        return NULL;
+    }
+
+    time_t endtime = time(NULL) + (time_t) timeout;
+
+    /* GIL is held only when the template changes or a variable-size field
+     * has to be converted into Python object */
+    Py_BEGIN_ALLOW_THREADS
+    while (stored < count && (timeout == 0 || endtime > time(NULL))) {
+        ret = pytrap_ctx_recv(self, ifcidx, &in_rec, &in_rec_size);
+
+        if (ret == TRAP_E_TIMEOUT || ret == TRAP_E_TERMINATED) {
+            // nothing to read, return current data
+            break;
+        } else if (ret == TRAP_E_BAD_IFC_INDEX || ret == TRAP_E_FORMAT_MISMATCH || ret == TRAP_E_MEMORY) {
+            failed = 1;
+            break;
+        } else if (ret == TRAP_E_FORMAT_CHANGED) {
+            const char *spec;
+            uint8_t data_type;
+            Py_BLOCK_THREADS
+            pytrap_ctx_get_data_fmt(self, ifcidx, &data_type, &spec);
+            pyurtempl->urtmplt = ur_define_fields_and_update_template(spec, pyurtempl->urtmplt);
+            if (pyurtempl->urtmplt == NULL) {
+                PyErr_SetString(TrapError, "Creation of UniRec template failed.");
+                failed = 1;
+            } else {
+                pyurtempl = UnirecTemplate_init(pyurtempl);
+                if (UnirecTemplate_columnsCheck(pyurtempl, cols, ncols) != 0) {
+                    failed = 1;
+                }
+            }
+            Py_UNBLOCK_THREADS
+            if (failed) {
+                break;
+            }
+        }
+
+        if (in_rec_size <= 1) {
+            // end of stream
+            break;
+        }
+
+        if (has_varlen) {
+            Py_BLOCK_THREADS
+            failed = UnirecTemplate_columnsStore(pyurtempl, cols, ncols, (char *) in_rec, offset + stored);
+            Py_UNBLOCK_THREADS
+            if (failed) {
+                break;
+            }
+        } else {
+            UnirecTemplate_columnsStore(pyurtempl, cols, ncols, (char *) in_rec, offset + stored);
+        }
+        stored++;
+    }
+    Py_END_ALLOW_THREADS
+
+    UnirecTemplate_columnsRelease(cols, ncols);
+
+    if (failed) {
+        if (ret == TRAP_E_BAD_IFC_INDEX) {
+            PyErr_SetString(TrapError, "Bad index of IFC.");
+        } else if (ret == TRAP_E_FORMAT_MISMATCH) {
+            PyErr_SetString(TrapError, "Connection to incompatible IFC - format mismatch.");
+        } else if (ret == TRAP_E_MEMORY) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+
+    return PyLong_FromSsize_t(stored);
+}
+
 static PyObject *
 pytrap_ifcctl(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 {
@@ -429,6 +1013,7 @@ pytrap_terminate(pytrap_trapcontext *self, PyObject *args)
 static PyObject *
 pytrap_finalize(pytrap_trapcontext *self, PyObject *args)
 {
+    pytrap_prefetch_stop_all(self);
     TRAP_DEFAULT_FINALIZATION();
     trap_ctx_finalize(&self->trap);
     self->trap = NULL;
@@ -478,7 +1063,7 @@ pytrap_setDataFmt(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 static PyObject *
 pytrap_getDataFmt(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
 {
-    uint8_t data_type;
+    uint8_t data_type = TRAP_FMT_UNKNOWN;
     uint32_t ifcidx = 0;
     const char *fmtspec = "";
 
@@ -492,7 +1077,7 @@ pytrap_getDataFmt(pytrap_trapcontext *self, PyObject *args, PyObject *keywds)
         return NULL;
     }
 
-    trap_ctx_get_data_fmt(self->trap, TRAPIFC_INPUT, ifcidx, &data_type, &fmtspec);
+    pytrap_ctx_get_data_fmt(self, ifcidx, &data_type, &fmtspec);
     return Py_BuildValue("(is)", data_type, fmtspec);
 }
 
@@ -579,9 +1164,13 @@ static PyMethodDef pytrap_TrapContext_methods[] = {
     {"recv",        (PyCFunction) pytrap_recv, METH_VARARGS | METH_KEYWORDS,
         "Receive data via TRAP interface.\n\n"
         "Args:\n"
-        "    ifcidx (Optional[int]): Index of input IFC (default: 0).\n\n"
+        "    ifcidx (Optional[int]): Index of input IFC (default: 0).\n"
+        "    zerocopy (Optional[bool]): Return read-only memoryview of the internal\n"
+        "        buffer instead of a copy of the data (default: False).  The memoryview\n"
+        "        is valid only until the next call of recv(), it can be passed to\n"
+        "        UnirecTemplate.setData() without copying.\n\n"
         "Returns:\n"
-        "    bytearray: Received data.\n\n"
+        "    bytearray or memoryview: Received data.\n\n"
         "Raises:\n"
         "    TimeoutError: Receiving data failed due to elapsed timeout.\n"
         "    TrapError: Bad index given.\n"
@@ -615,6 +1204,34 @@ static PyMethodDef pytrap_TrapContext_methods[] = {
         "Raises:\n"
         "    TrapError: Bad index given.\n"},
 
+    {"sendColumns", (PyCFunction) pytrap_sendColumns, METH_VARARGS | METH_KEYWORDS,
+        "Send records from columns (e.g. numpy arrays) at once via TRAP interface.\n\n"
+        "Records are packed from the columns and sent in C without GIL.\n"
+        "Fixed-size fields are taken from buffers with item size equal to\n"
+        "the size of the field (or 1), variable-size fields are given as\n"
+        "a tuple (values, offsets) like in Apache Arrow: value of record i is\n"
+        "values[offsets[i]:offsets[i + 1]], offsets are 32 or 64 bit integers.\n"
+        "Fields of the template missing in columns are set to zero.\n\n"
+        "Example:\n"
+        "    >>> import numpy\n"
+        "    >>> t = pytrap.UnirecTemplate(\"uint16 SRC_PORT,string URL\")\n"
+        "    >>> cols = {\"SRC_PORT\": numpy.array([1, 2], dtype=numpy.uint16),\n"
+        "    ...         \"URL\": (b\"ab\", numpy.array([0, 1, 2], dtype=numpy.int32))}\n"
+        "    >>> c.sendColumns(t, cols)\n\n"
+        "Args:\n"
+        "    urtempl (UnirecTemplate): UnirecTemplate matching the format of the output IFC.\n\n"
+        "    columns (dict(str, object)): Field names and their buffers or (values, offsets) tuples.\n\n"
+        "    count (Optional[int]): Number of records to send (default: all records in columns).\n\n"
+        "    ifcidx (Optional[int]): Index of output IFC (default: 0).\n\n"
+        "Returns:\n"
+        "    int: Number of sent records.\n\n"
+        "Raises:\n"
+        "    TimeoutError: Sending data failed due to elapsed timeout.\n"
+        "    TrapError: Bad index given, bad offsets or too big record.\n"
+        "    Terminated: The TRAP IFC was terminated.\n"
+        "    TypeError: Column has bad type or item size.\n"
+        "    IndexError: Columns are too small.\n"},
+
     {"recvBulk",    (PyCFunction) pytrap_recvBulk, METH_VARARGS | METH_KEYWORDS,
         "Receive sequence of records at once via TRAP interface.\n\n"
         "Args:\n"
@@ -627,6 +1244,32 @@ static PyMethodDef pytrap_TrapContext_methods[] = {
         "Raises:\n"
         "    TrapError: Bad index given.\n"},
 
+    {"recvColumns", (PyCFunction) pytrap_recvColumns, METH_VARARGS | METH_KEYWORDS,
+        "Receive records into columns (e.g. numpy arrays) at once via TRAP interface.\n\n"
+        "Values of fixed-size fields are copied directly into preallocated writable\n"
+        "buffers without creating Python objects, values of variable-size fields\n"
+        "are appended to lists.  Receiving stops after `count` records, at the end\n"
+        "of stream (empty message), on timeout or termination of the IFC.\n\n"
+        "Example:\n"
+        "    >>> import numpy\n"
+        "    >>> t = pytrap.UnirecTemplate(\"ipaddr SRC_IP,uint16 SRC_PORT,string URL\")\n"
+        "    >>> cols = {\"SRC_IP\": numpy.zeros(1000, dtype=\"V16\"),\n"
+        "    ...         \"SRC_PORT\": numpy.zeros(1000, dtype=numpy.uint16), \"URL\": []}\n"
+        "    >>> n = c.recvColumns(t, cols, 1000)\n\n"
+        "Args:\n"
+        "    urtempl (UnirecTemplate): Created UnirecTemplate with the template, it is updated internally when the format is changed.\n\n"
+        "    columns (dict(str, object)): Field names and their buffers (item size must be equal to the size of the field, or 1) or lists for variable-size fields.\n\n"
+        "    count (int): Maximum number of records to receive.\n\n"
+        "    offset (Optional[int]): Index of the first record in buffers (default: 0).\n\n"
+        "    time (Optional[int]): Timeout in seconds before interrupt of capture, 0 for no limit (default: 0).\n\n"
+        "    ifcidx (Optional[int]): Index of input IFC (default: 0).\n\n"
+        "Returns:\n"
+        "    int: Number of received records.\n\n"
+        "Raises:\n"
+        "    TrapError: Bad index given, a field is not in the template or format mismatch.\n"
+        "    TypeError: Column has bad type or item size.\n"
+        "    IndexError: Column is too small.\n"},
+
     {"send",        (PyCFunction) pytrap_send, METH_VARARGS | METH_KEYWORDS,
         "Send data via TRAP interface.\n\n"
         "Args:\n"
@@ -660,6 +1303,33 @@ static PyMethodDef pytrap_TrapContext_methods[] = {
         "    Tuple(int, string): Type of format and specifier (see setRequiredFmt()).\n\n"
         },
 
+    {"startPrefetch", (PyCFunction) pytrap_startPrefetch, METH_VARARGS | METH_KEYWORDS,
+        "Start receiving from input IFC in a background thread.\n\n"
+        "The thread keeps receiving messages into a bounded queue while Python\n"
+        "processes the previous ones, recv(), recvBulk() and recvColumns() then\n"
+        "read messages from the queue.  When the queue is full, the thread waits\n"
+        "and the sender is slowed down as without prefetching.  Timeout of IFC\n"
+        "is reported by recv() only when the queue is empty.  Prefetching runs\n"
+        "until terminate() or finalize().\n\n"
+        "Args:\n"
+        "    ifcidx (Optional[int]): Index of input IFC (default: 0).\n"
+        "    size (Optional[int]): Size of the queue in bytes (default: 4 MiB, minimum: 256 KiB).\n\n"
+        "Raises:\n"
+        "    TrapError: Bad index of IFC or prefetching was already started.\n"
+        },
+
+    {"getPrefetchStats", (PyCFunction) pytrap_getPrefetchStats, METH_VARARGS | METH_KEYWORDS,
+        "Get statistics of prefetching of input IFC.\n\n"
+        "Args:\n"
+        "    ifcidx (Optional[int]): Index of input IFC (default: 0).\n\n"
+        "Returns:\n"
+        "    dict: Number of prefetched messages (messages), used and total size\n"
+        "        of the queue in bytes (queue_used, queue_size), number of times\n"
+        "        the queue was full (full_waits) and state of thread (running).\n\n"
+        "Raises:\n"
+        "    TrapError: Prefetching was not started.\n"
+        },
+
     {"terminate",   (PyCFunction) pytrap_terminate, METH_VARARGS,
         "Terminate TRAP."},
 
@@ -746,6 +746,168 @@ UnirecTemplate_get_local(pytrap_unirectemplate *self, char *data, int32_t field_
     Py_RETURN_NONE;
 }
 
+/*
+ * Type-specialized getters, they expect valid data and a field present in the template.
+ */
+static PyObject *
+UnirecTemplate_get_uint8(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromUnsignedLong(*(uint8_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_uint16(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromUnsignedLong(*(uint16_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_uint32(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromUnsignedLong(*(uint32_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_uint64(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromUnsignedLongLong(*(uint64_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_int16(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromLong(*(int16_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_int32(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromLong(*(int32_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_int64(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromLongLong(*(int64_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_char(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyLong_FromLong(*(signed char *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_float(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyFloat_FromDouble(*(float *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_double(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyFloat_FromDouble(*(double *) ur_get_ptr_by_id(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_ip(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    pytrap_unirecipaddr *new_ip = (pytrap_unirecipaddr *) pytrap_UnirecIPAddr.tp_alloc(&pytrap_UnirecIPAddr, 0);
+    if (new_ip != NULL) {
+        memcpy(&new_ip->ip, ur_get_ptr_by_id(self->urtmplt, data, field_id), sizeof(ip_addr_t));
+    }
+    return (PyObject *) new_ip;
+}
+
+static PyObject *
+UnirecTemplate_get_mac(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    pytrap_unirecmacaddr *new_mac = (pytrap_unirecmacaddr *) pytrap_UnirecMACAddr.tp_alloc(&pytrap_UnirecMACAddr, 0);
+    if (new_mac != NULL) {
+        memcpy(&new_mac->mac, ur_get_ptr_by_id(self->urtmplt, data, field_id), sizeof(mac_addr_t));
+    }
+    return (PyObject *) new_mac;
+}
+
+static PyObject *
+UnirecTemplate_get_time(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    pytrap_unirectime *new_time = (pytrap_unirectime *) pytrap_UnirecTime.tp_alloc(&pytrap_UnirecTime, 0);
+    if (new_time != NULL) {
+        new_time->timestamp = *(ur_time_t *) ur_get_ptr_by_id(self->urtmplt, data, field_id);
+    }
+    return (PyObject *) new_time;
+}
+
+static PyObject *
+UnirecTemplate_get_string(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyUnicode_DecodeUTF8(ur_get_ptr_by_id(self->urtmplt, data, field_id),
+                                ur_get_var_len(self->urtmplt, data, field_id), "replace");
+}
+
+static PyObject *
+UnirecTemplate_get_bytes(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return PyByteArray_FromStringAndSize(ur_get_ptr_by_id(self->urtmplt, data, field_id),
+                                         ur_get_var_len(self->urtmplt, data, field_id));
+}
+
+static PyObject *
+UnirecTemplate_get_generic(pytrap_unirectemplate *self, char *data, int32_t field_id)
+{
+    return UnirecTemplate_get_local(self, data, field_id);
+}
+
+/**
+ * \brief Get getter of field value specialized for the type of field.
+ *
+ * Returned functions produce the same values as UnirecTemplate_get_local()
+ * without the type dispatch on every call.
+ *
+ * \param [in] type    UniRec type of field
+ * \return getter function
+ */
+static pytrap_getter
+UnirecTemplate_get_func(int type)
+{
+    switch (type) {
+    case UR_TYPE_UINT8:
+        return UnirecTemplate_get_uint8;
+    case UR_TYPE_UINT16:
+        return UnirecTemplate_get_uint16;
+    case UR_TYPE_UINT32:
+        return UnirecTemplate_get_uint32;
+    case UR_TYPE_UINT64:
+        return UnirecTemplate_get_uint64;
+    case UR_TYPE_INT16:
+        return UnirecTemplate_get_int16;
+    case UR_TYPE_INT32:
+        return UnirecTemplate_get_int32;
+    case UR_TYPE_INT64:
+        return UnirecTemplate_get_int64;
+    case UR_TYPE_CHAR:
+        return UnirecTemplate_get_char;
+    case UR_TYPE_FLOAT:
+        return UnirecTemplate_get_float;
+    case UR_TYPE_DOUBLE:
+        return UnirecTemplate_get_double;
+    case UR_TYPE_IP:
+        return UnirecTemplate_get_ip;
+    case UR_TYPE_MAC:
+        return UnirecTemplate_get_mac;
+    case UR_TYPE_TIME:
+        return UnirecTemplate_get_time;
+    case UR_TYPE_STRING:
+        return UnirecTemplate_get_string;
+    case UR_TYPE_BYTES:
+        return UnirecTemplate_get_bytes;
+    default:
+        /* arrays and int8 */
+        return UnirecTemplate_get_generic;
+    }
+}
+
 static PyObject *
 UnirecTemplate_getByID(pytrap_unirectemplate *self, PyObject *args, PyObject *keywds)
 {
@@ -830,6 +992,10 @@ UnirecTemplate_set_local(pytrap_unirectemplate *self, char *data, int32_t field_
         PyErr_SetString(TrapError, "Data was not set yet.");
         return NULL;
     }
+    if (data == self->data && self->data_readonly) {
+        PyErr_SetString(TrapError, "Data is read-only, use createMessage() or copy the data to set fields.");
+        return NULL;
+    }
     PY_LONG_LONG longval;
     double floatval;
 
@@ -1490,6 +1656,11 @@ UnirecTemplate_setFromDict(pytrap_unirectemplate *self, PyObject *dict, int skip
         return NULL;
     }
 
+    if (self->data_readonly) {
+        PyErr_SetString(TrapError, "Data is read-only, use createMessage() or copy the data to set fields.");
+        return NULL;
+    }
+
     if (!PyDict_Size((PyObject *) dict)) {
         Py_RETURN_NONE;
     }
@@ -1557,6 +1728,7 @@ UnirecTemplate_setData(pytrap_unirectemplate *self, PyObject *args, PyObject *kw
     PyObject *dataObj;
     char *data;
     Py_ssize_t data_size;
+    char readonly = 0;
 
     static char *kwlist[] = {"data", NULL};
     if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &dataObj)) {
@@ -1568,8 +1740,19 @@ UnirecTemplate_setData(pytrap_unirectemplate *self, PyObject *args, PyObject *kw
         data = PyByteArray_AsString(dataObj);
     } else if (PyBytes_Check(dataObj)) {
         PyBytes_AsStringAndSize(dataObj, &data, &data_size);
+    } else if (PyObject_CheckBuffer(dataObj)) {
+        /* memoryview (e.g. from TrapCtx.recv(zerocopy=True)) or other buffer,
+         * the memory is not copied, the object is kept referenced instead */
+        Py_buffer view;
+        if (PyObject_GetBuffer(dataObj, &view, PyBUF_SIMPLE) != 0) {
+            return NULL;
+        }
+        data = (char *) view.buf;
+        data_size = view.len;
+        readonly = (char) view.readonly;
+        PyBuffer_Release(&view);
     } else {
-        PyErr_SetString(PyExc_TypeError, "Argument data must be of bytes or bytearray type.");
+        PyErr_SetString(PyExc_TypeError, "Argument data must be of bytes, bytearray or memoryview type.");
         return NULL;
     }
 
@@ -1579,6 +1762,7 @@ UnirecTemplate_setData(pytrap_unirectemplate *self, PyObject *args, PyObject *kw
     }
     self->data = data;
     self->data_size = data_size;
+    self->data_readonly = readonly;
 
     self->data_obj = dataObj;
     /* Increment refCount for the original object, so it's not free'd */
@@ -1610,6 +1794,7 @@ UnirecTemplate_createMessage(pytrap_unirectemplate *self, uint32_t dynamic_size)
     PyObject *res = PyByteArray_FromStringAndSize(data, data_size);
 
     self->data_obj = res;
+    self->data_readonly = 0;
     self->data_size = PyByteArray_Size(res);
     self->data = PyByteArray_AsString(res);
     /* Increment refCount for the original object, so it's not free'd */
@@ -1637,6 +1822,7 @@ UnirecTemplate_init(pytrap_unirectemplate *self)
 {
     self->data = NULL;
     self->data_size = 0;
+    self->data_readonly = 0;
     if (self->data_obj != NULL) {
         Py_DECREF(self->data_obj);
         self->data_obj = NULL;
@@ -1650,6 +1836,16 @@ UnirecTemplate_init(pytrap_unirectemplate *self)
     self->urdict = (PyDictObject *) UnirecTemplate_getFieldsDict_local(self, 0);
     self->fields_dict = (PyDictObject *) UnirecTemplate_getFieldsDict_local(self, 1);
 
+    /* bind getters, fields are dispatched by type only once per template */
+    PyMem_Free(self->getters);
+    self->getters = PyMem_Calloc(self->urtmplt->offset_size, sizeof(pytrap_getter));
+    if (self->getters != NULL) {
+        ur_field_id_t id = UR_ITER_BEGIN;
+        while ((id = ur_iter_fields(self->urtmplt, id)) != UR_ITER_END) {
+            self->getters[id] = UnirecTemplate_get_func(ur_get_type(id));
+        }
+    }
+
     self->iter_index = 0;
     self->field_count = PyDict_Size((PyObject *) self->urdict);
     return self;
@@ -1706,6 +1902,10 @@ UnirecTemplate_copyMessage(pytrap_unirectemplate *self, PyObject *args, PyObject
         PyErr_SetString(PyExc_TypeError, "UnirecTemplate src does not have any data to copy.");
         return NULL;
     }
+    if (self->data_readonly) {
+        PyErr_SetString(TrapError, "Data is read-only, use createMessage() or copy the data to set fields.");
+        return NULL;
+    }
 
     ur_copy_fields(self->urtmplt, self->data, src->urtmplt, src->data);
 
@@ -1760,7 +1960,7 @@ UnirecTemplate_getDict(pytrap_unirectemplate *self)
     ur_field_id_t id = UR_ITER_BEGIN;
     while ((id = ur_iter_fields(self->urtmplt, id)) != UR_ITER_END) {
         key = PyUnicode_FromString(ur_get_name(id));
-        val = UnirecTemplate_get_local(self, self->data, id);
+        val = self->getters ? self->getters[id](self, self->data, id) : UnirecTemplate_get_local(self, self->data, id);
         if (val) {
             PyDict_SetItem(d, key, val);
             Py_DECREF(val);
@@ -1776,6 +1976,269 @@ UnirecTemplate_getDict(pytrap_unirectemplate *self)
     return d;
 }
 
+pytrap_column *
+UnirecTemplate_columnsInit(pytrap_unirectemplate *self, PyObject *columns, Py_ssize_t rows, Py_ssize_t *ncols, int *has_varlen)
+{
+    PyObject *name, *column;
+    Py_ssize_t pos = 0, i = 0;
+    pytrap_column *cols;
+
+    if (!PyDict_Check(columns)) {
+        PyErr_SetString(PyExc_TypeError, "Argument columns must be dict() of field names and buffers.");
+        return NULL;
+    }
+
+    *has_varlen = 0;
+    *ncols = PyDict_Size(columns);
+    cols = PyMem_Calloc(*ncols > 0 ? *ncols : 1, sizeof(pytrap_column));
+    if (cols == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    while (PyDict_Next(columns, &pos, &name, &column)) {
+        pytrap_column *c = &cols[i];
+        c->field_id = UnirecTemplate_get_field_id(self, name);
+        if (c->field_id == UR_ITER_END) {
+            PyErr_Format(TrapError, "Field %S was not found in the template.", name);
+            goto failure;
+        }
+        if (ur_is_varlen(c->field_id)) {
+            if (!PyList_Check(column)) {
+                PyErr_Format(PyExc_TypeError, "Column of variable-size field %S must be a list.", name);
+                goto failure;
+            }
+            c->size = -1;
+            c->list = column;
+            Py_INCREF(column);
+            *has_varlen = 1;
+        } else {
+            c->size = ur_get_size(c->field_id);
+            if (PyObject_GetBuffer(column, &c->view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0) {
+                goto failure;
+            }
+            if (c->view.itemsize != c->size && c->view.itemsize != 1) {
+                PyErr_Format(PyExc_TypeError, "Item size of column %S is %zd B, but the field has %zd B.",
+                             name, c->view.itemsize, c->size);
+                goto failure;
+            }
+            if (c->view.len < rows * c->size) {
+                PyErr_Format(PyExc_IndexError, "Column %S is too small for %zd records.", name, rows);
+                goto failure;
+            }
+        }
+        i++;
+    }
+    return cols;
+
+failure:
+    UnirecTemplate_columnsRelease(cols, i + 1);
+    return NULL;
+}
+
+int
+UnirecTemplate_columnsCheck(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols)
+{
+    Py_ssize_t i;
+    for (i = 0; i < ncols; i++) {
+        if (!ur_is_present(self->urtmplt, cols[i].field_id)) {
+            PyErr_Format(TrapError, "Field %s is not in the new template.", ur_get_name(cols[i].field_id));
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int
+UnirecTemplate_columnsStore(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols, char *data, Py_ssize_t row)
+{
+    Py_ssize_t i;
+    PyObject *val;
+    for (i = 0; i < ncols; i++) {
+        pytrap_column *c = &cols[i];
+        if (c->size >= 0) {
+            /* fixed-size fields are copied directly, GIL is not needed */
+            memcpy((char *) c->view.buf + row * c->size,
+                   ur_get_ptr_by_id(self->urtmplt, data, c->field_id), c->size);
+        } else {
+            val = UnirecTemplate_get_local(self, data, c->field_id);
+            if (val == NULL || PyList_Append(c->list, val) != 0) {
+                Py_XDECREF(val);
+                return -1;
+            }
+            Py_DECREF(val);
+        }
+    }
+    return 0;
+}
+
+pytrap_column *
+UnirecTemplate_columnsInitSend(pytrap_unirectemplate *self, PyObject *columns, Py_ssize_t *rows, Py_ssize_t *ncols)
+{
+    PyObject *name, *column;
+    Py_ssize_t pos = 0, i = 0, avail, min_avail = -1;
+    pytrap_column *cols;
+
+    if (!PyDict_Check(columns)) {
+        PyErr_SetString(PyExc_TypeError, "Argument columns must be dict() of field names and buffers.");
+        return NULL;
+    }
+
+    *ncols = PyDict_Size(columns);
+    cols = PyMem_Calloc(*ncols > 0 ? *ncols : 1, sizeof(pytrap_column));
+    if (cols == NULL) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    while (PyDict_Next(columns, &pos, &name, &column)) {
+        pytrap_column *c = &cols[i];
+        c->field_id = UnirecTemplate_get_field_id(self, name);
+        if (c->field_id == UR_ITER_END) {
+            PyErr_Format(TrapError, "Field %S was not found in the template.", name);
+            goto failure;
+        }
+        if (ur_is_varlen(c->field_id)) {
+            /* values and offsets, value of record i is values[offsets[i]:offsets[i + 1]] */
+            PyObject *values, *offsets;
+            c->size = -1;
+            if (!PyTuple_Check(column) || PyTuple_Size(column) != 2) {
+                PyErr_Format(PyExc_TypeError, "Column of variable-size field %S must be a tuple (values, offsets).", name);
+                goto failure;
+            }
+            values = PyTuple_GET_ITEM(column, 0);
+            offsets = PyTuple_GET_ITEM(column, 1);
+            if (PyObject_GetBuffer(values, &c->view, PyBUF_C_CONTIGUOUS) != 0 ||
+                PyObject_GetBuffer(offsets, &c->offsets, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+                goto failure;
+            }
+            if (c->offsets.itemsize != 4 && c->offsets.itemsize != 8) {
+                PyErr_Format(PyExc_TypeError, "Offsets of column %S must be 32 or 64 bit integers.", name);
+                goto failure;
+            }
+            avail = c->offsets.len / c->offsets.itemsize - 1;
+        } else {
+            c->size = ur_get_size(c->field_id);
+            if (PyObject_GetBuffer(column, &c->view, PyBUF_C_CONTIGUOUS) != 0) {
+                goto failure;
+            }
+            if (c->view.itemsize != c->size && c->view.itemsize != 1) {
+                PyErr_Format(PyExc_TypeError, "Item size of column %S is %zd B, but the field has %zd B.",
+                             name, c->view.itemsize, c->size);
+                goto failure;
+            }
+            avail = c->view.len / c->size;
+        }
+        if (avail < 0) {
+            avail = 0;
+        }
+        if (min_avail < 0 || avail < min_avail) {
+            min_avail = avail;
+        }
+        i++;
+    }
+
+    if (*rows < 0) {
+        *rows = min_avail < 0 ? 0 : min_avail;
+    } else if (min_avail >= 0 && *rows > min_avail) {
+        PyErr_Format(PyExc_IndexError, "Columns contain only %zd records.", min_avail);
+        UnirecTemplate_columnsRelease(cols, *ncols);
+        return NULL;
+    }
+    return cols;
+
+failure:
+    UnirecTemplate_columnsRelease(cols, i + 1);
+    return NULL;
+}
+
+static inline Py_ssize_t
+UnirecTemplate_offset(Py_buffer *offsets, Py_ssize_t index)
+{
+    if (offsets->itemsize == 4) {
+        return ((int32_t *) offsets->buf)[index];
+    }
+    return (Py_ssize_t) ((int64_t *) offsets->buf)[index];
+}
+
+int
+UnirecTemplate_columnsLoad(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols, char *rec, Py_ssize_t row)
+{
+    Py_ssize_t i, start, end;
+    Py_ssize_t size = ur_rec_fixlen_size(self->urtmplt);
+
+    /* GIL is not needed, fields missing in columns are zero */
+    memset(rec, 0, size);
+    for (i = 0; i < ncols; i++) {
+        pytrap_column *c = &cols[i];
+        if (c->size >= 0) {
+            memcpy(ur_get_ptr_by_id(self->urtmplt, rec, c->field_id),
+                   (char *) c->view.buf + row * c->size, c->size);
+        } else {
+            start = UnirecTemplate_offset(&c->offsets, row);
+            end = UnirecTemplate_offset(&c->offsets, row + 1);
+            if (start < 0 || end < start || end > c->view.len || size + (end - start) > UR_MAX_SIZE) {
+                return -1;
+            }
+            ur_set_var(self->urtmplt, rec, c->field_id, (char *) c->view.buf + start, (int) (end - start));
+            size += end - start;
+        }
+    }
+    return (int) size;
+}
+
+void
+UnirecTemplate_columnsRelease(pytrap_column *cols, Py_ssize_t ncols)
+{
+    Py_ssize_t i;
+    if (cols == NULL) {
+        return;
+    }
+    for (i = 0; i < ncols; i++) {
+        Py_XDECREF(cols[i].list);
+        if (cols[i].view.obj != NULL) {
+            PyBuffer_Release(&cols[i].view);
+        }
+        if (cols[i].offsets.obj != NULL) {
+            PyBuffer_Release(&cols[i].offsets);
+        }
+    }
+    PyMem_Free(cols);
+}
+
+static PyObject *
+UnirecTemplate_storeColumns(pytrap_unirectemplate *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *columns;
+    Py_ssize_t row, ncols;
+    pytrap_column *cols;
+    int has_varlen, res;
+
+    static char *kwlist[] = {"columns", "row", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!n", kwlist, &PyDict_Type, &columns, &row)) {
+        return NULL;
+    }
+    if (self->data == NULL) {
+        PyErr_SetString(TrapError, "Data was not set yet.");
+        return NULL;
+    }
+    if (row < 0) {
+        PyErr_SetString(PyExc_IndexError, "Row must not be negative.");
+        return NULL;
+    }
+
+    cols = UnirecTemplate_columnsInit(self, columns, row + 1, &ncols, &has_varlen);
+    if (cols == NULL) {
+        return NULL;
+    }
+    res = UnirecTemplate_columnsStore(self, cols, ncols, self->data, row);
+    UnirecTemplate_columnsRelease(cols, ncols);
+    if (res != 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 UnirecTemplate_getFieldType(pytrap_unirectemplate *self, PyObject *args)
 {
@@ -1922,6 +2385,184 @@ UnirecTemplate_recSize(pytrap_unirectemplate *self, PyObject *args, PyObject *ke
     return Py_BuildValue("H", rec_size);
 }
 
+/*********************/
+/*    UnirecField    */
+/*********************/
+static PyTypeObject pytrap_UnirecField;
+
+/* size of raw value of cached IP, MAC or time objects */
+#define UNIRECFIELD_CACHE_SIZE 16
+
+typedef struct {
+    PyObject_HEAD
+    pytrap_unirectemplate *urtempl;
+    int32_t field_id;
+    pytrap_getter get; // bound getter of the field type
+    char cache; // return the last object if the raw value is the same (IP, MAC and time only)
+    PyObject *cached;
+    char cached_value[UNIRECFIELD_CACHE_SIZE];
+} pytrap_unirecfield;
+
+static PyObject *
+UnirecField_call(pytrap_unirecfield *self, PyObject *args, PyObject *kwds)
+{
+    pytrap_unirectemplate *t = self->urtempl;
+    const char *value;
+
+    if (t->data == NULL) {
+        PyErr_SetString(TrapError, "Data was not set yet.");
+        return NULL;
+    }
+    if (!ur_is_present(t->urtmplt, self->field_id)) {
+        PyErr_Format(TrapError, "Field %s is not in the template.", ur_get_name(self->field_id));
+        return NULL;
+    }
+    if (!self->cache) {
+        return self->get(t, t->data, self->field_id);
+    }
+
+    value = ur_get_ptr_by_id(t->urtmplt, t->data, self->field_id);
+    if (self->cached != NULL && memcmp(self->cached_value, value, ur_get_size(self->field_id)) == 0) {
+        Py_INCREF(self->cached);
+        return self->cached;
+    }
+    Py_XDECREF(self->cached);
+    self->cached = self->get(t, t->data, self->field_id);
+    if (self->cached == NULL) {
+        return NULL;
+    }
+    memcpy(self->cached_value, value, ur_get_size(self->field_id));
+    Py_INCREF(self->cached);
+    return self->cached;
+}
+
+static PyObject *
+UnirecField_set(pytrap_unirecfield *self, PyObject *value)
+{
+    return UnirecTemplate_set_local(self->urtempl, self->urtempl->data, self->field_id, value);
+}
+
+static PyObject *
+UnirecField_getName(pytrap_unirecfield *self, void *closure)
+{
+    return PyUnicode_FromString(ur_get_name(self->field_id));
+}
+
+static PyObject *
+UnirecField_getID(pytrap_unirecfield *self, void *closure)
+{
+    return PyLong_FromLong(self->field_id);
+}
+
+static PyObject *
+UnirecField_repr(pytrap_unirecfield *self)
+{
+    return PyUnicode_FromFormat("UnirecField('%s')", ur_get_name(self->field_id));
+}
+
+static void
+UnirecField_dealloc(pytrap_unirecfield *self)
+{
+    Py_XDECREF(self->urtempl);
+    Py_XDECREF(self->cached);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static PyMethodDef pytrap_unirecfield_methods[] = {
+        {"set", (PyCFunction) UnirecField_set, METH_O,
+            "Set value of the field in the current data of the template.\n\n"
+            "Args:\n"
+            "    value (object): New value.\n\n"
+            "Raises:\n"
+            "    TrapError: Data was not set or it is read-only.\n"
+        },
+
+        {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef pytrap_unirecfield_getset[] = {
+        {"name", (getter) UnirecField_getName, NULL, "Name of the field.", NULL},
+        {"id", (getter) UnirecField_getID, NULL, "ID of the field.", NULL},
+        {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject pytrap_UnirecField = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "pytrap.UnirecField",          /* tp_name */
+    sizeof(pytrap_unirecfield),    /* tp_basicsize */
+    0,                         /* tp_itemsize */
+    (destructor) UnirecField_dealloc, /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_reserved */
+    (reprfunc) UnirecField_repr, /* tp_repr */
+    0,                         /* tp_as_number */
+    0,                         /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    0,                         /* tp_hash  */
+    (ternaryfunc) UnirecField_call, /* tp_call */
+    0,                         /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    0,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,        /* tp_flags */
+    "UnirecField\n"
+    "    Accessor of one field of UnirecTemplate, see UnirecTemplate.getAccessor().\n\n"
+    "    Calling the accessor returns value of the field in the current data of the\n"
+    "    template. The field ID and the getter specialized for the field type are\n"
+    "    resolved when the accessor is created, so there is no lookup per access.\n", /* tp_doc */
+    0,                         /* tp_traverse */
+    0,                         /* tp_clear */
+    0,                         /* tp_richcompare */
+    0,                         /* tp_weaklistoffset */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    pytrap_unirecfield_methods, /* tp_methods */
+    0,                         /* tp_members */
+    pytrap_unirecfield_getset, /* tp_getset */
+};
+
+static PyObject *
+UnirecTemplate_getAccessor(pytrap_unirectemplate *self, PyObject *args, PyObject *keywds)
+{
+    PyObject *field_name;
+    int cache = 0;
+    int32_t field_id;
+    pytrap_unirecfield *f;
+
+    static char *kwlist[] = {"field_name", "cache", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|p", kwlist, &field_name, &cache)) {
+        return NULL;
+    }
+
+    field_id = UnirecTemplate_get_field_id(self, field_name);
+    if (field_id == UR_ITER_END) {
+        PyErr_SetString(TrapError, "Field was not found.");
+        return NULL;
+    }
+
+    f = (pytrap_unirecfield *) pytrap_UnirecField.tp_alloc(&pytrap_UnirecField, 0);
+    if (f == NULL) {
+        return NULL;
+    }
+    Py_INCREF(self);
+    f->urtempl = self;
+    f->field_id = field_id;
+    f->get = UnirecTemplate_get_func(ur_get_type(field_id));
+    switch (ur_get_type(field_id)) {
+    case UR_TYPE_IP:
+    case UR_TYPE_MAC:
+    case UR_TYPE_TIME:
+        f->cache = cache;
+        break;
+    default:
+        /* other objects are cheap or mutable */
+        f->cache = 0;
+    }
+    return (PyObject *) f;
+}
+
 static PyMethodDef pytrap_unirectemplate_methods[] = {
         {"getFieldType", (PyCFunction) UnirecTemplate_getFieldType, METH_VARARGS,
             "Get type of given field.\n\n"
@@ -1931,12 +2572,44 @@ static PyMethodDef pytrap_unirectemplate_methods[] = {
             "    type: Type object (e.g. int, str or pytrap.UnirecIPAddr).\n"
         },
 
+        {"getAccessor", (PyCFunction) UnirecTemplate_getAccessor, METH_VARARGS | METH_KEYWORDS,
+            "Get accessor object of given field for fast access in loops.\n\n"
+            "The accessor is bound to this template, calling it returns value\n"
+            "of the field in the current data (set by setData() or recv).\n\n"
+            "Example:\n"
+            "    >>> src_ip = t.getAccessor(\"SRC_IP\", cache=True)\n"
+            "    >>> t.setData(data)\n"
+            "    >>> src_ip()\n\n"
+            "Args:\n"
+            "    field_name (str): Field name.\n"
+            "    cache (Optional[bool]): Reuse the last returned UnirecIPAddr, UnirecMACAddr\n"
+            "        or UnirecTime object when the value did not change (default False).\n\n"
+            "Returns:\n"
+            "    UnirecField: Accessor of the field.\n\n"
+            "Raises:\n"
+            "    TrapError: Field was not found.\n"
+        },
+
         {"getDict", (PyCFunction) UnirecTemplate_getDict, METH_NOARGS,
             "Get UniRec record as a dictionary.\n\n"
             "Returns:\n"
             "    dict(str, object): Dictionary of field names and field values.\n"
         },
 
+        {"storeColumns", (PyCFunction) UnirecTemplate_storeColumns, METH_VARARGS | METH_KEYWORDS,
+            "Store current UniRec record into columns.\n\n"
+            "Values of fixed-size fields are copied into writable buffers\n"
+            "(e.g. numpy.ndarray with item size equal to the field size) at index `row`,\n"
+            "values of variable-size fields are appended to lists.\n\n"
+            "Args:\n"
+            "    columns (dict(str, object)): Field names and their buffers or lists.\n"
+            "    row (int): Index of the record in buffers.\n\n"
+            "Raises:\n"
+            "    TrapError: Data was not set or a field is not in the template.\n"
+            "    TypeError: Column has bad type or item size.\n"
+            "    IndexError: Column is too small.\n"
+        },
+
         {"setFromDict", (PyCFunction) UnirecTemplate_setFromDict_py, METH_VARARGS | METH_KEYWORDS,
             "Set UniRec record from a give dictionary. UniRec template is used to iterate over fields, so the fields from dict not in UniRec template are skipped.\n\n"
             "Example:\n"
@@ -2007,8 +2680,11 @@ static PyMethodDef pytrap_unirectemplate_methods[] = {
 
         {"setData", (PyCFunction) UnirecTemplate_setData, METH_VARARGS | METH_KEYWORDS,
             "Set data for attribute access.\n\n"
+            "The data is not copied, the template keeps a reference to the object.\n"
+            "A memoryview returned by TrapCtx.recv(zerocopy=True) is accepted as well,\n"
+            "it is valid until the next recv() and its fields cannot be set.\n\n"
             "Args:\n"
-            "    data (bytearray or bytes): Data - UniRec message.\n"
+            "    data (bytearray, bytes or memoryview): Data - UniRec message.\n"
         },
 
         {"getFieldsDict", (PyCFunction) UnirecTemplate_getFieldsDict, METH_VARARGS,
@@ -2136,6 +2812,7 @@ static void UnirecTemplate_dealloc(pytrap_unirectemplate *self)
 {
     Py_XDECREF(self->urdict);
     Py_XDECREF(self->fields_dict);
+    PyMem_Free(self->getters);
     if (self->urtmplt) {
         ur_free_template(self->urtmplt);
     }
@@ -2161,8 +2838,15 @@ UnirecTemplate_getAttr(pytrap_unirectemplate *self, PyObject *attr)
     if (field_id == UR_ITER_END) {
         return PyObject_GenericGetAttr((PyObject *) self, attr);
     }
+    if (self->data == NULL) {
+        PyErr_SetString(TrapError, "Data was not set yet.");
+        return NULL;
+    }
+    if (self->getters == NULL) {
+        return UnirecTemplate_get_local(self, self->data, field_id);
+    }
 
-    return UnirecTemplate_get_local(self, self->data, field_id);
+    return self->getters[field_id](self, self->data, field_id);
 }
 
 static int
@@ -2322,6 +3006,13 @@ init_unirectemplate(PyObject *m)
     Py_INCREF(&pytrap_UnirecMACAddrRange);
     PyModule_AddObject(m, "UnirecMACAddrRange", (PyObject *) &pytrap_UnirecMACAddrRange);
 
+    /* Add Field */
+    if (PyType_Ready(&pytrap_UnirecField) < 0) {
+        return EXIT_FAILURE;
+    }
+    Py_INCREF(&pytrap_UnirecField);
+    PyModule_AddObject(m, "UnirecField", (PyObject *) &pytrap_UnirecField);
+
     /* Add Template */
     if (PyType_Ready(&pytrap_UnirecTemplate) < 0) {
         return EXIT_FAILURE;
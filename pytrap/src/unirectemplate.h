@@ -4,22 +4,38 @@
 extern "C" {
 #endif
 
-typedef struct {
+typedef struct pytrap_unirectemplate_s pytrap_unirectemplate;
+
+/* Type-specialized getter of a field value, see UnirecTemplate_get_func() */
+typedef PyObject *(*pytrap_getter)(pytrap_unirectemplate *self, char *data, int32_t field_id);
+
+struct pytrap_unirectemplate_s {
     PyObject_HEAD
     ur_template_t *urtmplt;
     char *data;
     Py_ssize_t data_size;
     PyObject *data_obj; // Pointer to object containing the data we are pointing to
+    char data_readonly; // data points to read-only memory (e.g. memoryview of the libtrap buffer)
     PyDictObject *urdict;
     PyDictObject *fields_dict; // dictionary of field names indexed by field ID
+    pytrap_getter *getters; // getters indexed by field ID, bound in UnirecTemplate_init()
 
     /* for iteration */
     Py_ssize_t iter_index;
     Py_ssize_t field_count;
-} pytrap_unirectemplate;
+};
 
 PyAPI_DATA(PyTypeObject) pytrap_UnirecTemplate;
 
+/* Column (output buffer) of one UniRec field for columnar receive */
+typedef struct {
+    int32_t field_id;
+    Py_ssize_t size; // size of the fixed-size field, -1 for variable-size field
+    Py_buffer view; // buffer of fixed-size field or values of variable-size field
+    Py_buffer offsets; // offsets of values of variable-size field (send only)
+    PyObject *list; // list of values of variable-size field (receive only)
+} pytrap_column;
+
 PyAPI_FUNC(PyObject *) UnirecTemplate_getAttr(pytrap_unirectemplate *self, PyObject *attr);
 
 PyAPI_FUNC(PyObject *) UnirecTemplate_setData(pytrap_unirectemplate *self, PyObject *args, PyObject *kwds);
@@ -32,6 +48,18 @@ PyAPI_FUNC(PyObject *) UnirecTemplate_setFromDict(pytrap_unirectemplate *self, P
 
 PyAPI_FUNC(pytrap_unirectemplate *) UnirecTemplate_init(pytrap_unirectemplate *self);
 
+PyAPI_FUNC(pytrap_column *) UnirecTemplate_columnsInit(pytrap_unirectemplate *self, PyObject *columns, Py_ssize_t rows, Py_ssize_t *ncols, int *has_varlen);
+
+PyAPI_FUNC(int) UnirecTemplate_columnsCheck(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols);
+
+PyAPI_FUNC(int) UnirecTemplate_columnsStore(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols, char *data, Py_ssize_t row);
+
+PyAPI_FUNC(pytrap_column *) UnirecTemplate_columnsInitSend(pytrap_unirectemplate *self, PyObject *columns, Py_ssize_t *rows, Py_ssize_t *ncols);
+
+PyAPI_FUNC(int) UnirecTemplate_columnsLoad(pytrap_unirectemplate *self, pytrap_column *cols, Py_ssize_t ncols, char *rec, Py_ssize_t row);
+
+PyAPI_FUNC(void) UnirecTemplate_columnsRelease(pytrap_column *cols, Py_ssize_t ncols);
+
 #ifdef __cplusplus
 }
 #endif
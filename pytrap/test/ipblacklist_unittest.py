@@ -125,3 +125,61 @@ class AnyIPCase(unittest.TestCase):
         res = iplist.find(pytrap.UnirecIPAddr("1::1"))
         self.assertEqual(res, "abc")
 
+
+class BatchSearch(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        iplist = pytrap.UnirecIPList({
+            pytrap.UnirecIPAddrRange("192.168.1.0/24"): "ip4",
+            pytrap.UnirecIPAddrRange("2001::1/48"): "ipv6"})
+        addrs = [pytrap.UnirecIPAddr(a) for a in ["10.0.0.1", "192.168.1.1", "2001::5", "::1"]]
+
+        self.assertEqual(iplist.findMany(addrs), [None, "ip4", "ipv6", None])
+        self.assertEqual(iplist.matchMany(addrs), [1, 2])
+        self.assertEqual(iplist.matchMany([]), [])
+
+        # buffer of raw UniRec IP addresses
+        t = pytrap.UnirecTemplate("ipaddr SRC_IP")
+        t.createMessage()
+        buf = bytearray()
+        for a in addrs:
+            t.SRC_IP = a
+            buf += t.getData()
+        self.assertEqual(len(buf), 64)
+        self.assertEqual(iplist.findMany(bytes(buf)), [None, "ip4", "ipv6", None])
+        self.assertEqual(iplist.matchMany(buf), [1, 2])
+        mask = bytearray(4)
+        self.assertEqual(iplist.matchMany(buf, out=mask), 2)
+        self.assertEqual(mask, bytearray([0, 1, 1, 0]))
+
+        with self.assertRaises(TypeError):
+            iplist.findMany(b"abc")
+        with self.assertRaises(TypeError):
+            iplist.findMany(["10.0.0.1"])
+        with self.assertRaises(TypeError):
+            iplist.matchMany(buf, out=bytearray(3))
+
+
+class FindAll(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        # the same network can be given more times in a list of pairs
+        iplist = pytrap.UnirecIPList([
+            (pytrap.UnirecIPAddrRange("192.168.0.0/16"), "a"),
+            (pytrap.UnirecIPAddrRange("192.168.1.0/24"), "b"),
+            (pytrap.UnirecIPAddrRange("192.168.1.0/24"), "c")])
+        self.assertEqual(len(iplist), 3)
+        self.assertEqual(iplist.find(pytrap.UnirecIPAddr("192.168.1.1")), "a")
+        self.assertEqual(iplist.findAll(pytrap.UnirecIPAddr("192.168.1.1")), ["a", "b", "c"])
+        self.assertEqual(iplist.findAll(pytrap.UnirecIPAddr("192.168.2.1")), ["a"])
+        self.assertEqual(iplist.findAll(pytrap.UnirecIPAddr("10.0.0.1")), None)
+        addrs = [pytrap.UnirecIPAddr(a) for a in ["192.168.1.1", "10.0.0.1", "192.168.2.1"]]
+        self.assertEqual(iplist.findMany(addrs, all=True), [["a", "b", "c"], None, ["a"]])
+        self.assertEqual(iplist.findMany(addrs), ["a", None, "a"])
+
+        with self.assertRaises(TypeError):
+            pytrap.UnirecIPList([(pytrap.UnirecIPAddrRange("192.168.0.0/16"), "a", "b")])
+        with self.assertRaises(TypeError):
+            pytrap.UnirecIPList([("192.168.0.0/16", "a")])
+        with self.assertRaises(ValueError):
+            pytrap.UnirecIPList([])
@@ -163,6 +163,304 @@ class StoreAndLoadMessage(unittest.TestCase):
 
         os.unlink("/tmp/pytrap_test")
 
+class StoreAndLoadMessageZeroCopy(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import os
+
+        urtempl = "ipaddr IP,uint16 PORT"
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_zc"], 0, 1)
+        c.setDataFmt(0, pytrap.FMT_UNIREC, urtempl)
+
+        t = pytrap.UnirecTemplate(urtempl)
+        t.createMessage()
+        t.IP = pytrap.UnirecIPAddr("192.168.0.1")
+        for i in range(10):
+            t.PORT = i
+            c.send(t.getData())
+        c.sendFlush()
+        c.finalize()
+
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_zc"], 1)
+        c.setRequiredFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+        for i in range(10):
+            data = c.recv(zerocopy=True)
+            self.assertIsInstance(data, memoryview)
+            self.assertTrue(data.readonly)
+            t.setData(data)
+            self.assertEqual(t.IP, pytrap.UnirecIPAddr("192.168.0.1"))
+            self.assertEqual(t.PORT, i)
+            # data points to the receive buffer, it must not be modified
+            with self.assertRaises(pytrap.TrapError):
+                t.PORT = 1
+            with self.assertRaises(pytrap.TrapError):
+                t.setFromDict({"PORT": 1})
+
+        # createMessage() makes the template writable again
+        t.createMessage()
+        t.PORT = 1
+        self.assertEqual(t.PORT, 1)
+        c.finalize()
+
+        os.unlink("/tmp/pytrap_test_zc")
+
+class ReceiveColumns(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import os
+        import array
+
+        urtempl = "ipaddr IP,uint16 PORT,string URL"
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_cols"], 0, 1)
+        c.setDataFmt(0, pytrap.FMT_UNIREC, urtempl)
+
+        t = pytrap.UnirecTemplate(urtempl)
+        t.createMessage(100)
+        t.IP = pytrap.UnirecIPAddr("192.168.0.1")
+        for i in range(100):
+            t.PORT = i
+            t.URL = "url%d" % i
+            c.send(t.getData())
+        c.sendFlush()
+        c.finalize()
+
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_cols"], 1)
+        c.setRequiredFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+        ports = array.array("H", bytes(2 * 120))
+        ips = bytearray(16 * 120)
+        urls = []
+        cols = {"PORT": ports, "IP": ips, "URL": urls}
+        self.assertEqual(c.recvColumns(t, cols, 60), 60)
+        # the rest of records until the end of stream
+        self.assertEqual(c.recvColumns(t, cols, 60, offset=60), 40)
+        self.assertEqual(list(ports[:100]), list(range(100)))
+        self.assertEqual(urls, ["url%d" % i for i in range(100)])
+        self.assertEqual(ips[16 * 99 + 8:16 * 99 + 12], bytes([192, 168, 0, 1]))
+
+        # storeColumns() stores the current record
+        t.setData(t.createMessage(100))
+        t.PORT = 1234
+        t.storeColumns({"PORT": ports}, 110)
+        self.assertEqual(ports[110], 1234)
+        with self.assertRaises(TypeError):
+            t.storeColumns({"PORT": array.array("L", [0])}, 0)
+        with self.assertRaises(IndexError):
+            t.storeColumns({"PORT": ports}, 120)
+        with self.assertRaises(pytrap.TrapError):
+            t.storeColumns({"NOT_IN_TEMPLATE": ports}, 0)
+        c.finalize()
+
+        os.unlink("/tmp/pytrap_test_cols")
+
+class ReadNemeaColumns(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import os
+        try:
+            import numpy as np
+            import pandas as pd
+        except ImportError:
+            self.skipTest("numpy or pandas is not installed")
+
+        urtempl = "ipaddr IP,macaddr MAC,time TIME,uint16 PORT,double SCORE,string URL"
+        count = 250
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_readcols"], 0, 1)
+        c.setDataFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+        t.createMessage(100)
+        for i in range(count):
+            t.IP = pytrap.UnirecIPAddr("10.0.0.%d" % (i % 256))
+            t.MAC = pytrap.UnirecMACAddr("00:11:22:33:44:%02x" % (i % 256))
+            t.TIME = pytrap.UnirecTime(1500000000 + i, 500)
+            t.PORT = i
+            t.SCORE = i / 2
+            t.URL = "url%d" % i
+            c.send(t.getData())
+        c.sendFlush()
+        c.finalize()
+
+        # chunk_size is not a divisor of count, the last chunk is partial
+        cols = pytrap.read_nemea_columns("f:/tmp/pytrap_test_readcols", chunk_size=64)
+        self.assertEqual(sorted(cols.keys()), ["IP", "MAC", "PORT", "SCORE", "TIME", "URL"])
+        self.assertEqual(cols["PORT"].dtype, np.uint16)
+        self.assertEqual(cols["SCORE"].dtype, np.float64)
+        self.assertEqual(cols["TIME"].dtype, np.uint64)
+        self.assertEqual(len(cols["PORT"]), count)
+        self.assertEqual(list(cols["PORT"]), list(range(count)))
+        self.assertEqual(list(cols["SCORE"]), [i / 2 for i in range(count)])
+        self.assertEqual(cols["URL"], ["url%d" % i for i in range(count)])
+        self.assertEqual(int(cols["TIME"][3]) >> 32, 1500000003)
+        self.assertEqual(bytes(cols["IP"][5])[8:12], bytes([10, 0, 0, 5]))
+        self.assertEqual(bytes(cols["MAC"][7]), bytes([0, 0x11, 0x22, 0x33, 0x44, 7]))
+
+        # nrows across chunks and within the first chunk
+        for nrows, chunk_size in ((100, 64), (10, 64), (1, 1), (count + 10, 32)):
+            cols = pytrap.read_nemea_columns("f:/tmp/pytrap_test_readcols", nrows, chunk_size)
+            n = min(nrows, count)
+            self.assertEqual(len(cols["PORT"]), n)
+            self.assertEqual(len(cols["URL"]), n)
+            self.assertEqual(list(cols["PORT"]), list(range(n)))
+        self.assertEqual(pytrap.read_nemea_columns("f:/tmp/pytrap_test_readcols", 0), {})
+
+        # conversion of time, ipaddr and macaddr
+        cols = pytrap.read_nemea_columns("f:/tmp/pytrap_test_readcols", chunk_size=100, convert=True)
+        self.assertEqual(cols["TIME"].dtype, np.dtype("datetime64[ns]"))
+        self.assertEqual(cols["TIME"][1], np.datetime64("2017-07-14T02:40:01.500"))
+        self.assertEqual(cols["IP"][5], pytrap.UnirecIPAddr("10.0.0.5"))
+        self.assertEqual(cols["MAC"][7], pytrap.UnirecMACAddr("00:11:22:33:44:07"))
+
+        # columnar DataFrame has the same content as the default one
+        df = pytrap.read_nemea("f:/tmp/pytrap_test_readcols", columnar=True)
+        self.assertIsInstance(df, pd.DataFrame)
+        self.assertEqual(df.shape, (count, 6))
+        self.assertEqual(df["PORT"].dtype, np.uint16)
+        ref = pytrap.read_nemea("f:/tmp/pytrap_test_readcols")
+        self.assertEqual(list(df["PORT"]), list(ref["PORT"]))
+        self.assertEqual(list(df["URL"]), list(ref["URL"]))
+        self.assertEqual([str(ip) for ip in df["IP"]], [str(ip) for ip in ref["IP"]])
+        df = pytrap.read_nemea("f:/tmp/pytrap_test_readcols", 42, columnar=True)
+        self.assertEqual(len(df), 42)
+
+        os.unlink("/tmp/pytrap_test_readcols")
+
+class SendColumns(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import os
+        import array
+
+        urtempl = "uint32 ID,uint16 PORT,string URL"
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_sendcols"], 0, 1)
+        c.setDataFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+
+        urls = ["url%d" % i for i in range(100)]
+        offsets = array.array("i", [0])
+        for u in urls:
+            offsets.append(offsets[-1] + len(u))
+        cols = {"ID": array.array("I", range(100)),
+                "PORT": array.array("H", range(100)),
+                "URL": ("".join(urls).encode(), offsets)}
+        self.assertEqual(c.sendColumns(t, cols), 100)
+        self.assertEqual(c.sendColumns(t, cols, count=10), 10)
+        with self.assertRaises(IndexError):
+            c.sendColumns(t, cols, count=101)
+        with self.assertRaises(TypeError):
+            c.sendColumns(t, {"ID": array.array("H", range(100))})
+        with self.assertRaises(TypeError):
+            c.sendColumns(t, {"URL": b"abc"})
+        with self.assertRaises(pytrap.TrapError):
+            c.sendColumns(t, {"URL": (b"abc", array.array("i", [0, 4]))})
+        c.sendFlush()
+        c.finalize()
+
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_sendcols"], 1)
+        c.setRequiredFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+        data = c.recvBulk(t, time=5, count=110)
+        c.finalize()
+        self.assertEqual(len(data), 110)
+        self.assertEqual([d["ID"] for d in data], list(range(100)) + list(range(10)))
+        self.assertEqual([d["URL"] for d in data[:100]], urls)
+
+        os.unlink("/tmp/pytrap_test_sendcols")
+
+class ReceivePrefetch(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import os
+        import array
+
+        urtempl = "uint32 ID,string URL"
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_prefetch"], 0, 1)
+        c.setDataFmt(0, pytrap.FMT_UNIREC, urtempl)
+        t = pytrap.UnirecTemplate(urtempl)
+        # enough data to wrap the queue several times
+        n = 20000
+        offsets = array.array("i", [i * 40 for i in range(n + 1)])
+        c.sendColumns(t, {"ID": array.array("I", range(n)), "URL": (b"x" * (40 * n), offsets)})
+        c.sendFlush()
+        c.finalize()
+
+        c = pytrap.TrapCtx()
+        c.init(["-i", "f:/tmp/pytrap_test_prefetch"], 1)
+        c.setRequiredFmt(0, pytrap.FMT_UNIREC, urtempl)
+        with self.assertRaises(pytrap.TrapError):
+            c.getPrefetchStats()
+        with self.assertRaises(pytrap.TrapError):
+            c.startPrefetch(ifcidx=1)
+        with self.assertRaises(ValueError):
+            c.startPrefetch(size=1024)
+        c.startPrefetch(size=256 * 1024)
+        with self.assertRaises(pytrap.TrapError):
+            c.startPrefetch()
+
+        t = pytrap.UnirecTemplate(urtempl)
+        data = c.recvBulk(t, time=5, count=100)
+        ids = [d["ID"] for d in data]
+        while True:
+            try:
+                data = c.recv()
+            except pytrap.FormatChanged as e:
+                data = e.data
+            if len(data) <= 1:
+                break
+            t.setData(data)
+            ids.append(t.ID)
+        self.assertEqual(ids, list(range(n)))
+        stats = c.getPrefetchStats()
+        self.assertGreaterEqual(stats["messages"], n)
+        self.assertEqual(stats["queue_size"], 256 * 1024)
+        c.finalize()
+
+        os.unlink("/tmp/pytrap_test_prefetch")
+
+class ReceivePrefetchFormatChange(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        import time
+
+        c = pytrap.TrapCtx()
+        c.init(["-i", "i:pytrap_test_prefetch_fmt"], 1)
+        c.setRequiredFmt(0, pytrap.FMT_UNIREC, "uint32 ID")
+        c.startPrefetch()
+
+        s = pytrap.TrapCtx()
+        s.init(["-i", "i:pytrap_test_prefetch_fmt"], 0, 1)
+        formats = ["uint32 ID", "uint64 BIG,uint32 ID", "uint32 ID,uint16 PORT"]
+        for f, fmt in enumerate(formats):
+            s.setDataFmt(0, pytrap.FMT_UNIREC, fmt)
+            t = pytrap.UnirecTemplate(fmt)
+            t.createMessage()
+            for i in range(f * 50, f * 50 + 50):
+                t.ID = i
+                s.send(t.getData())
+            s.sendFlush()
+        s.send(b"0")
+        s.sendFlush()
+
+        # all format changes are prefetched before the first message is read,
+        # every message must be parsed by the template of its own format
+        end = time.time() + 5
+        while c.getPrefetchStats()["messages"] < 151 and time.time() < end:
+            time.sleep(0.01)
+        t = pytrap.UnirecTemplate("uint32 ID")
+        data = c.recvBulk(t, time=5, count=-1)
+        self.assertEqual([d["ID"] for d in data], list(range(150)))
+        self.assertEqual(c.getDataFmt(0), (pytrap.FMT_UNIREC, formats[-1]))
+        s.finalize()
+        c.finalize()
+
 class StoreAndLoadStringMessage(unittest.TestCase):
     def runTest(self):
         #"""json.dump returns str object, which was formerly not supported by pytrep send()"""
@@ -1050,3 +1050,34 @@ class IPAddrRangeToPython(unittest.TestCase):
         out = ip.to_ipaddress()
         self.assertEqual(out, ipaddress.ip_network("2001::/48"))
 
+
+class FieldAccessor(unittest.TestCase):
+    def runTest(self):
+        import pytrap
+        a = pytrap.UnirecTemplate("ipaddr SRC_IP,uint16 SRC_PORT,time TIME_FIRST,string URL,uint32* ARR")
+        src_ip = a.getAccessor("SRC_IP", cache=True)
+        port = a.getAccessor("SRC_PORT")
+        url = a.getAccessor("URL")
+        arr = a.getAccessor("ARR")
+        self.assertEqual(src_ip.name, "SRC_IP")
+        self.assertRaises(pytrap.TrapError, src_ip)
+        self.assertRaises(pytrap.TrapError, a.getAccessor, "NOT_EXISTING")
+
+        a.createMessage(100)
+        a.SRC_IP = pytrap.UnirecIPAddr("10.0.0.1")
+        a.URL = "example.com"
+        a.ARR = [1, 2, 3]
+        port.set(53)
+        self.assertEqual(a.SRC_PORT, 53)
+        self.assertEqual(port(), 53)
+        self.assertEqual(url(), "example.com")
+        self.assertEqual(arr(), [1, 2, 3])
+        self.assertEqual(src_ip(), pytrap.UnirecIPAddr("10.0.0.1"))
+        # cached object is returned until the value changes
+        first = src_ip()
+        self.assertIs(src_ip(), first)
+        a.SRC_IP = pytrap.UnirecIPAddr("10.0.0.2")
+        self.assertEqual(src_ip(), pytrap.UnirecIPAddr("10.0.0.2"))
+        self.assertIsNot(src_ip(), first)
+        self.assertEqual(a.getAccessor("TIME_FIRST")(), a.TIME_FIRST)
+
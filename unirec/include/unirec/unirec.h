@@ -197,6 +197,8 @@ typedef struct {
    uint16_t static_size;   ///< Size of static part
    ur_tmplt_direction direction; ///< Direction of data input, output, bidirection, no direction
    uint32_t ifc_out;   ///< output interface number (stored only if the direction == UR_TMPLT_DIRECTION_BI)
+   ur_field_id_t *partition_ids; ///< Fields selecting partition of output interface (see ur_ctx_set_output_partition())
+   uint16_t partition_count; ///< Count of fields in partition_ids
 } ur_template_t;
 
 /**
@@ -847,6 +849,32 @@ int ur_ctx_set_output_template(trap_ctx_t *ctx, int ifc, ur_template_t *tmplt);
 #define  ur_set_output_template(ifc, tmplt) \
    ur_ctx_set_output_template(trap_get_global_ctx(), ifc, tmplt)
 
+/** \brief Select partition of output interface by fields of records on specified context
+ * Records with the same values of given fields are sent to the same partition
+ * (i.e. the same client) of output interface with partitions (parameter
+ * partitions= of TCP and UNIX socket IFC). Fields are hashed by the function
+ * registered by #TRAPCTL_PARTITION_FUNC, the template must stay valid while
+ * the interface is used, the function has to be called again when the
+ * template is replaced (e.g. by ur_define_fields_and_update_template()).
+ * \param[in] ctx specified context
+ * \param[in] ifc interface number
+ * \param[in] tmplt pointer to a template of records sent via the interface
+ * \param[in] fields String with names of fields delimited by comma, NULL to hash whole records
+ * \return UR_OK on success, UR_E_INVALID_NAME if a field is not present in the template,
+ * UR_E_MEMORY on memory allocation error.
+ */
+int ur_ctx_set_output_partition(trap_ctx_t *ctx, int ifc, ur_template_t *tmplt, const char *fields);
+
+/** \brief Select partition of output interface by fields of records
+ * \param[in] ifc interface number
+ * \param[in] tmplt pointer to a template of records sent via the interface
+ * \param[in] fields String with names of fields delimited by comma, NULL to hash whole records
+ * \return UR_OK on success, UR_E_INVALID_NAME if a field is not present in the template,
+ * UR_E_MEMORY on memory allocation error.
+ */
+#define ur_set_output_partition(ifc, tmplt, fields) \
+   ur_ctx_set_output_partition(trap_get_global_ctx(), ifc, tmplt, fields)
+
 /** \brief Set UniRec template to input interface on specified context
  * \param[in] ctx specified context
  * \param[in] ifc interface number
@@ -47,6 +47,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unirec/ip_prefix_search.h>
 #include "ipps_internal.h"
 
@@ -335,41 +336,77 @@ void ip_inc(const ip_addr_t *ip, ip_addr_t *ip_inc)
    }
 }
 
+/**
+ * Compare pointers, used to sort pointers to data in ipps_destroy()
+ */
+static int cmp_data_ptr(const void *v1, const void *v2)
+{
+   uintptr_t p1 = (uintptr_t) *(void * const *) v1;
+   uintptr_t p2 = (uintptr_t) *(void * const *) v2;
+
+   return (p1 > p2) - (p1 < p2);
+}
+
+/**
+ * Move pointers to data of all 'intervals' to 'data' array and dealloc data arrays of intervals
+ * \param[in] intervals Array of intervals
+ * \param[in] count Number of intervals
+ * \param[out] data Array of data pointers
+ * \param[inout] data_cnt Number of pointers in 'data'
+ */
+static void collect_data(ipps_interval_t *intervals, uint32_t count, void **data, size_t *data_cnt)
+{
+   uint32_t i;
+
+   for (i = 0; i < count; ++i) {
+      memcpy(data + *data_cnt, intervals[i].data_array, intervals[i].data_cnt * sizeof(void *));
+      *data_cnt += intervals[i].data_cnt;
+      free(intervals[i].data_array);
+   }
+}
+
 /**
  * Deinitialize interval_search_context structure
  * Dealloc all memory, garbage collector
+ * Data of a network are shared by all intervals it overlaps, pointers to data
+ * are sorted to free every data only once
  * \param[in] prefix_context Pointer to interval_search_context struct
  * return 0 if dealloc is OK, 1 if free fails
  */
 int ipps_destroy(ipps_context_t *prefix_context)
 {
-   int i;
-   void **data_collector;                // Array with freed memory pointers
-   uint32_t data_collector_cnt = 0;       // Number of pointers in 'data_collector'
+   uint32_t i;
+   void **data_collector;                // Array with pointers to data of all intervals
+   size_t data_collector_cnt = 0;        // Number of pointers in 'data_collector'
 
    if (prefix_context == NULL) {
       fprintf(stderr, "ERROR NULL pointer passed to ipps_destroy\n");
       return 1;
    }
 
-   data_collector = malloc(COLLECTORSLOTS * sizeof(void *));
+   for (i = 0; i < prefix_context->v4_count; ++i) {
+      data_collector_cnt += prefix_context->v4_prefix_intervals[i].data_cnt;
+   }
+   for (i = 0; i < prefix_context->v6_count; ++i) {
+      data_collector_cnt += prefix_context->v6_prefix_intervals[i].data_cnt;
+   }
+
+   data_collector = malloc((data_collector_cnt + 1) * sizeof(void *));
    if (data_collector == NULL) {
       fprintf(stderr, "ERROR allocating memory for freed data collector\n");
       return 1;
    }
 
-   // Dealloc all IPv4 data and intervals
-   for (i = 0; i < prefix_context->v4_count; ++i) {
-      if (free_data(&prefix_context->v4_prefix_intervals[i], &data_collector, &data_collector_cnt)) {
-         return 1;
-      }
-   }
-
-   // Dealloc all IPv6 data and intervals
+   // Dealloc all IPv4 and IPv6 intervals, collect their data
    data_collector_cnt = 0;
-   for (i = 0; i < prefix_context->v6_count; ++i) {
-      if (free_data(&prefix_context->v6_prefix_intervals[i], &data_collector, &data_collector_cnt)) {
-         return 1;
+   collect_data(prefix_context->v4_prefix_intervals, prefix_context->v4_count, data_collector, &data_collector_cnt);
+   collect_data(prefix_context->v6_prefix_intervals, prefix_context->v6_count, data_collector, &data_collector_cnt);
+
+   // Dealloc all data, each only once
+   qsort(data_collector, data_collector_cnt, sizeof(void *), cmp_data_ptr);
+   for (i = 0; i < data_collector_cnt; ++i) {
+      if (i == 0 || data_collector[i] != data_collector[i - 1]) {
+         free(data_collector[i]);
       }
    }
 
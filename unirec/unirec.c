@@ -859,6 +859,64 @@ int ur_ctx_set_output_template(trap_ctx_t *ctx, int ifc, ur_template_t *tmplt)
    return UR_OK;
 }
 
+/** \brief Hash values of fields selecting partition of record (trap_partition_func_t). */
+static uint32_t ur_partition_hash(const void *data, uint16_t size, void *arg)
+{
+   const ur_template_t *tmplt = (const ur_template_t *) arg;
+   uint32_t hash = 2166136261U;
+   (void) size;
+
+   for (int i = 0; i < tmplt->partition_count; i++) {
+      ur_field_id_t id = tmplt->partition_ids[i];
+      const uint8_t *p = (const uint8_t *) ur_get_ptr_by_id(tmplt, data, id);
+      uint16_t len = ur_get_len(tmplt, data, id);
+      for (uint16_t j = 0; j < len; j++) {
+         hash = (hash ^ p[j]) * 16777619U;
+      }
+   }
+   return hash;
+}
+
+int ur_ctx_set_output_partition(trap_ctx_t *ctx, int ifc, ur_template_t *tmplt, const char *fields)
+{
+   char *list, *name, *saveptr = NULL;
+   int count = 0, id;
+
+   if (tmplt == NULL) {
+      return UR_OK;
+   }
+   free(tmplt->partition_ids);
+   tmplt->partition_ids = NULL;
+   tmplt->partition_count = 0;
+   if (fields == NULL) {
+      trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, ifc, TRAPCTL_PARTITION_FUNC, (trap_partition_func_t) NULL, NULL);
+      return UR_OK;
+   }
+
+   list = strdup(fields);
+   tmplt->partition_ids = (ur_field_id_t *) malloc(tmplt->count * sizeof(ur_field_id_t));
+   if (list == NULL || tmplt->partition_ids == NULL) {
+      free(list);
+      free(tmplt->partition_ids);
+      tmplt->partition_ids = NULL;
+      return UR_E_MEMORY;
+   }
+   for (name = strtok_r(list, ",", &saveptr); name != NULL; name = strtok_r(NULL, ",", &saveptr)) {
+      id = ur_get_id_by_name(name);
+      if (id < 0 || !ur_is_present(tmplt, id) || count >= tmplt->count) {
+         free(list);
+         free(tmplt->partition_ids);
+         tmplt->partition_ids = NULL;
+         return UR_E_INVALID_NAME;
+      }
+      tmplt->partition_ids[count++] = id;
+   }
+   free(list);
+   tmplt->partition_count = count;
+   trap_ctx_ifcctl(ctx, TRAPIFC_OUTPUT, ifc, TRAPCTL_PARTITION_FUNC, ur_partition_hash, (void *) tmplt);
+   return UR_OK;
+}
+
 int ur_ctx_set_input_template(trap_ctx_t *ctx, int ifc, ur_template_t *tmplt)
 {
    if (tmplt == NULL) {
@@ -1103,6 +1161,7 @@ void ur_free_template(ur_template_t *tmplt) {
    if (tmplt->ids != NULL) {
       free(tmplt->ids);
    }
+   free(tmplt->partition_ids);
    free(tmplt);
 }
 